@@ -22,6 +22,15 @@ struct PSInput {
 
 static const float PI = 3.14159265358979323846;
 
+// Keywords, specialized per material variant (see Shader::declareKeyword). Keep the defaults
+// in sync with the declarations.
+[[vk::constant_id(0)]] const bool ENABLE_SPECULAR = true;   // false: Lambert diffuse only
+[[vk::constant_id(1)]] const uint TONEMAP = 1;              // 0 None, 1 Reinhard, 2 ACES
+
+static const uint TONEMAP_NONE = 0;
+static const uint TONEMAP_REINHARD = 1;
+static const uint TONEMAP_ACES = 2;
+
 float DistributionGGX(float3 N, float3 H, float roughness)
 {
     float a = roughness * roughness;
@@ -76,25 +85,35 @@ float4 PSMain(PSInput input) : SV_Target
     float attenuation = 1.0 / (distance * distance);
     float3 radiance = lightColor * attenuation;
 
-    float NDF = DistributionGGX(N, H, roughness);
-    float G = GeometrySmith(N, V, L, roughness);
-    float3 F = fresnelSchlick(max(dot(H, V), 0.0), F0);
+    float NdotL = max(dot(N, L), 0.0);
+    float3 Lo;
+    if (ENABLE_SPECULAR) {
+        float NDF = DistributionGGX(N, H, roughness);
+        float G = GeometrySmith(N, V, L, roughness);
+        float3 F = fresnelSchlick(max(dot(H, V), 0.0), F0);
 
-    float3 kS = F;
-    float3 kD = (1.0 - kS) * (1.0 - metallic);
+        float3 kS = F;
+        float3 kD = (1.0 - kS) * (1.0 - metallic);
 
-    float3 numerator = NDF * G * F;
-    float denom = 4.0 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.0001;
-    float3 specular = numerator / denom;
+        float3 numerator = NDF * G * F;
+        float denom = 4.0 * max(dot(N, V), 0.0) * NdotL + 0.0001;
+        float3 specular = numerator / denom;
 
-    float NdotL = max(dot(N, L), 0.0);
-    float3 Lo = (kD * albedo / PI + specular) * radiance * NdotL;
+        Lo = (kD * albedo / PI + specular) * radiance * NdotL;
+    } else {
+        Lo = (1.0 - metallic) * albedo / PI * radiance * NdotL;
+    }
 
     // float3 ambient = float3(0.03, 0.03, 0.03) * albedo;
     float3 color = Lo;
 
     // tone mapping
-    color = color / (color + float3(1.0,1.0,1.0));
+    if (TONEMAP == TONEMAP_REINHARD) {
+        color = color / (color + float3(1.0,1.0,1.0));
+    } else if (TONEMAP == TONEMAP_ACES) {
+        // Narkowicz ACES filmic fit
+        color = saturate((color * (2.51 * color + 0.03)) / (color * (2.43 * color + 0.59) + 0.14));
+    }
     // gamma
     color = pow(color, float3(1.0/2.2,1.0/2.2,1.0/2.2));
 
@@ -10,6 +10,12 @@ void FEditorModule::StartupModule()
 	// Initialize editor systems: material editor, UI tools, etc.
 }
 
+void FEditorModule::GetModuleDescriptor(FModuleDescriptor& OutDescriptor) const
+{
+	OutDescriptor.Dependencies.Add("Renderer");
+	OutDescriptor.Dependencies.Add("Input");
+}
+
 void FEditorModule::ShutdownModule()
 {
 	LOG("EditorModule: Shutdown");
@@ -1,6 +1,7 @@
 #include "MaterialEditor.h"
 #include "Material.h"
 #include "Renderer.h"
+#include "ShaderHotReload.h"
 #include "Platform/ImGuiContext.h"
 #include <imgui.h>
 #include <iostream>
@@ -10,80 +11,116 @@
 #include "CoreUtils.h"
 #include "Misc/Path.h"
 namespace CarrotToy {
-// 新增：从文件加载到 buffer 的小工具
-static void loadFileToBuffer(const std::string& path, char* buf, size_t bufSize) {
-    std::string loadFilePath = path;
-    if (bufSize == 0) 
-    {
-        LOG("buffer = 0");
-        return;
+// Source file the editor shows for a shader path. Cooked SPIR-V maps back to its HLSL source in
+// the project's shader folder, e.g. "shaders/default.vs.spv" -> "<Project>/shaders/default.vs.hlsl".
+static std::string getEditableSourcePath(const std::string& path) {
+    if (!Path::endsWith(path, ".spv", false)) {
+        return path;
+    }
+    std::string shaderDir = Path::ShaderWorkingDir();
+    if (shaderDir.empty()) {
+        LOG("ShaderWorkingDir not set, cannot map .spv to .hlsl");
+        return {};
+    }
+    if (shaderDir.back() != '/' && shaderDir.back() != '\\') shaderDir.push_back('/');
+    return shaderDir + Path::getFilename(Path::removeExtension(path)) + ".hlsl";
+}
+
+static bool loadFileToString(const std::string& path, std::string& out) {
+    out.clear();
+    if (path.empty()) return false;
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        LOG("File NOT found at: " << std::filesystem::absolute(path).string());
+        return false;
     }
-    if (Path::endsWith(path, ".spv", false)) {
-        // Map SPIR-V binary name back to the original HLSL source in the project's shader folder.
-        // Example: "default.vs.spv" -> "<Project>/shaders/default.vs.hlsl"
-        std::string noSpv = Path::removeExtension(path); // removes .spv -> may be "shaders/default.vs" or "default.vs"
-        std::string fname = Path::getFilename(noSpv); // e.g. "default.vs"
-        std::string shaderDir = Path::ShaderWorkingDir();
-        if (shaderDir.empty()) {
-            LOG("ShaderWorkingDir not set, cannot map .spv to .hlsl");
-            buf[0] = '\0';
-            return;
+    out.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool saveStringToFile(const std::string& path, const std::string& content) {
+    if (path.empty()) return false;
+    try {
+        auto p = std::filesystem::path(path);
+        if (p.has_parent_path()) {
+            std::filesystem::create_directories(p.parent_path());
+        }
+        std::ofstream out(path, std::ios::trunc | std::ios::binary);
+        if (out.write(content.data(), content.size())) {
+            LOG("Saved to: " << std::filesystem::absolute(p).string());
+            return true;
         }
-        if (shaderDir.back() != '/' && shaderDir.back() != '\\') shaderDir.push_back('/');
-        loadFilePath = shaderDir + fname + ".hlsl";
-        LOG("Mapped .spv to HLSL source: " << loadFilePath);
+    } catch (const std::exception& e) {
+        LOG("Exception saving file: " << e.what());
     }
-    // Find file
-    auto absPath = std::filesystem::absolute(loadFilePath);
-    if (!std::filesystem::exists(absPath)) {
-        LOG("File NOT found at: " << absPath.string());
-        LOG("Current working dir: " << std::filesystem::current_path().string());
-        return;
-    } else {
-        LOG("Opening file: " << absPath.string());
+    LOG("Failed to save file: " << path);
+    return false;
+}
+
+// Lets ImGui grow a std::string while typing (same approach as imgui_stdlib)
+static int resizeStringCallback(ImGuiInputTextCallbackData* data) {
+    if (data->EventFlag == ImGuiInputTextFlags_CallbackResize) {
+        auto* str = static_cast<std::string*>(data->UserData);
+        str->resize(data->BufTextLen);
+        data->Buf = str->data();
     }
+    return 0;
+}
 
-    std::ifstream ifs(absPath);
-    if (!ifs) { buf[0] = '\0'; LOG("failed to open file: " << absPath); return; }
-    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
-    size_t n = std::min(content.size(), bufSize - 1);
-    memcpy(buf, content.data(), n);
-    buf[n] = '\0';
+static bool inputTextMultiline(const char* label, std::string& text, const ImVec2& size) {
+    return ImGui::InputTextMultiline(label, text.data(), text.capacity() + 1, size,
+                                     ImGuiInputTextFlags_CallbackResize, resizeStringCallback, &text);
 }
 
-// 新增：尝试从 shader 对象或约定路径加载当前 shader 源
 void MaterialEditor::loadCurrentShaderSources() {
-    vertexShaderBuffer[0] = '\0';
-    fragmentShaderBuffer[0] = '\0';
-    if (selectedMaterialName.empty()) return;
+    vertexShaderBuffer.clear();
+    fragmentShaderBuffer.clear();
+    if (selectedMaterialName.IsNone()) return;
 
     auto material = MaterialManager::getInstance().getMaterial(selectedMaterialName);
-    LOG(material->getName());
-
     if (!material) return;
     auto shader = material->getShader();
     if (!shader) return;
 
-    // 尝试通过 Shader 提供的路径接口加载（假定 getVertexPath/getFragmentPath 存在）
-    // 如果你的 Shader 类使用不同命名，请替换为对应的 getter。
-    std::string vpath, fpath;
+    loadFileToString(getEditableSourcePath(shader->getVertexPath()), vertexShaderBuffer);
+    loadFileToString(getEditableSourcePath(shader->getFragmentPath()), fragmentShaderBuffer);
+}
 
-    // Fallback: try conventional shader file names under shaders/
-    vpath = shader->getVertexPath();
-    fpath = shader->getFragmentPath();
+void MaterialEditor::applyShaderEdits(Material& material, bool save) {
+    auto shader = material.getShader();
+    if (!shader) return;
 
-    LOG(vpath);
-    LOG(fpath);
-    // 如果文件存在则读取到 buffer
-    loadFileToBuffer(vpath, vertexShaderBuffer, sizeof(vertexShaderBuffer));
-    loadFileToBuffer(fpath, fragmentShaderBuffer, sizeof(fragmentShaderBuffer));
+    const bool cooked = Path::endsWith(shader->getVertexPath(), ".spv", false) ||
+                        Path::endsWith(shader->getFragmentPath(), ".spv", false);
+    if (save || cooked) {
+        bool vSaved = saveStringToFile(getEditableSourcePath(shader->getVertexPath()), vertexShaderBuffer);
+        bool fSaved = saveStringToFile(getEditableSourcePath(shader->getFragmentPath()), fragmentShaderBuffer);
+        if (!vSaved || !fSaved) return;
+    }
+
+    if (cooked) {
+        // HLSL goes through dxc: the hot reloader cooks the saved sources on a worker thread and
+        // swaps the new program in at a frame boundary
+        ShaderHotReloader* reloader = renderer ? renderer->getShaderHotReloader() : nullptr;
+        if (reloader && reloader->isRunning()) {
+            reloader->requestCook();
+            LOG("Shader sources saved, recompiling in the background");
+        } else {
+            LOG("Shader sources saved; shader hot reload is off, rebuild to apply");
+        }
+        return;
+    }
 
+    // GLSL compiles directly; the old program renders until the new one is ready
+    if (shader->compileAsync(vertexShaderBuffer, fragmentShaderBuffer)) {
+        LOG("Shader compile submitted, applying when ready");
+    } else {
+        LOG("Shader compilation failed!");
+    }
 }
 
 MaterialEditor::MaterialEditor() 
     : renderer(nullptr), imguiContext(nullptr), shaderEditorOpen(false) {
-    vertexShaderBuffer[0] = '\0';
-    fragmentShaderBuffer[0] = '\0';
 }
 
 MaterialEditor::~MaterialEditor() {
@@ -140,7 +177,7 @@ void MaterialEditor::render() {
 }
 
 std::shared_ptr<Material> MaterialEditor::getSelectedMaterial() const {
-    if (selectedMaterialName.empty()) return nullptr;
+    if (selectedMaterialName.IsNone()) return nullptr;
     return MaterialManager::getInstance().getMaterial(selectedMaterialName);
 }
 
@@ -169,7 +206,8 @@ void MaterialEditor::showMaterialList() {
                 materialName, 
                 defaultShader
             );
-            defaultShader->reload();
+            // Compiles and links on driver threads; the material renders with the placeholder until then
+            defaultShader->reloadAsync();
             defaultMaterial->setVec3("albedo", 0.8f, 0.2f, 0.2f);
             defaultMaterial->setFloat("metallic", 0.5f);
             defaultMaterial->setFloat("roughness", 0.5f);
@@ -184,7 +222,10 @@ void MaterialEditor::showMaterialList() {
     for (auto& [name, material] : materials) {
         if (ImGui::Selectable(name.c_str(), selectedMaterialName == name)) {
             selectedMaterialName = name;
-            material->getShader()->linkProgram();
+            auto shader = material->getShader();
+            if (shader && !shader->hasProgram() && !shader->isLinkPending()) {
+                shader->linkProgramAsync();
+            }
             printf("Getting selected material: %s\n", selectedMaterialName.c_str());
         }
     }
@@ -195,7 +236,7 @@ void MaterialEditor::showMaterialList() {
 void MaterialEditor::showMaterialProperties() {
     ImGui::Begin("Material Properties");
     
-    if (!selectedMaterialName.empty()) {
+    if (!selectedMaterialName.IsNone()) {
         auto material = MaterialManager::getInstance().getMaterial(selectedMaterialName);
         if (material) {
             ImGui::Text("Material: %s", selectedMaterialName.c_str());
@@ -206,6 +247,8 @@ void MaterialEditor::showMaterialProperties() {
                 renderMaterialParameter(name, param.data, static_cast<int>(param.type));
             }
             
+            renderMaterialKeywords(*material);
+            
             if (ImGui::Button("Edit Shader")) {
                 loadCurrentShaderSources();
                 shaderEditorOpen = true;
@@ -226,50 +269,10 @@ void MaterialEditor::showShaderEditor() {
     if (ImGui::BeginMenuBar()) {
         if (ImGui::BeginMenu("File")) {
             if (ImGui::MenuItem("Save")) {
-                // TODO : Save shader to source file
-                // Currently saves to the build directory.
-
-                if (!selectedMaterialName.empty()) {
+                if (!selectedMaterialName.IsNone()) {
                     auto material = MaterialManager::getInstance().getMaterial(selectedMaterialName);
-                    if (material && material->getShader()) {
-                        // 1. 获取路径
-                        std::string vPath = material->getShader()->getVertexPath();
-                        std::string fPath = material->getShader()->getFragmentPath();
-
-                        // 2. 定义保存辅助 lambda
-                        auto saveFile = [](const std::string& path, const char* content) -> bool {
-                            try {
-                                // 确保父目录存在 (例如 shaders/ 文件夹)
-                                auto p = std::filesystem::path(path);
-                                if (p.has_parent_path()) {
-                                    std::filesystem::create_directories(p.parent_path());
-                                }
-                                
-                                std::ofstream out(path, std::ios::trunc | std::ios::binary);
-                                if (out.is_open()) {
-                                    out << content;
-                                    LOG("Saved to: " << std::filesystem::absolute(p).string());
-                                    return true;
-                                }
-                            } catch (const std::exception& e) {
-                                LOG("Exception saving file: " << e.what());
-                            }
-                            LOG("Failed to save file: " << path);
-                            return false;
-                        };
-
-                        // 3. 执行保存
-                        bool vSaved = saveFile(vPath, vertexShaderBuffer);
-                        bool fSaved = saveFile(fPath, fragmentShaderBuffer);
-
-                        // 4. 保存成功后自动重新编译
-                        if (vSaved && fSaved) {
-                            if (material->getShader()->compile(vertexShaderBuffer, fragmentShaderBuffer)) {
-                                LOG("Shader recompiled successfully after save.");
-                            } else {
-                                LOG("Shader compilation failed after save!");
-                            }
-                        }
+                    if (material) {
+                        applyShaderEdits(*material, true);
                     }
                 }
             }
@@ -285,24 +288,18 @@ void MaterialEditor::showShaderEditor() {
 
 
     ImGui::Text("Vertex Shader:");
-    ImGui::InputTextMultiline("##vertex", vertexShaderBuffer, sizeof(vertexShaderBuffer), 
-                              ImVec2(-1.0f, ImGui::GetTextLineHeight() * 16));
+    inputTextMultiline("##vertex", vertexShaderBuffer, ImVec2(-1.0f, ImGui::GetTextLineHeight() * 16));
     
     ImGui::Separator();
     
     ImGui::Text("Fragment Shader:");
-    ImGui::InputTextMultiline("##fragment", fragmentShaderBuffer, sizeof(fragmentShaderBuffer), 
-                              ImVec2(-1.0f, ImGui::GetTextLineHeight() * 16));
+    inputTextMultiline("##fragment", fragmentShaderBuffer, ImVec2(-1.0f, ImGui::GetTextLineHeight() * 16));
     
     if (ImGui::Button("Compile and Apply")) {
-        if (!selectedMaterialName.empty()) {
+        if (!selectedMaterialName.IsNone()) {
             auto material = MaterialManager::getInstance().getMaterial(selectedMaterialName);
-            if (material && material->getShader()) {
-                if (material->getShader()->compile(vertexShaderBuffer, fragmentShaderBuffer)) {
-                    std::cout << "Shader recompiled successfully!" << std::endl;
-                } else {
-                    std::cout << "Shader compilation failed!" << std::endl;
-                }
+            if (material) {
+                applyShaderEdits(*material, false);
             }
         }
     }
@@ -334,7 +331,39 @@ void MaterialEditor::showPreviewWindow() {
     ImGui::End();
 }
 
-void MaterialEditor::renderMaterialParameter(const std::string& name, void* data, int type) {
+void MaterialEditor::renderMaterialKeywords(Material& material) {
+    const ShaderKeywordLayout* layout = material.getKeywordLayout();
+    if (!layout || layout->isEmpty()) return;
+    
+    ImGui::Separator();
+    ImGui::Text("Shader Keywords");
+    for (const ShaderKeyword& keyword : layout->getKeywords()) {
+        const uint32_t value = material.getKeyword(keyword.name);
+        if (keyword.isBool()) {
+            bool enabled = value != 0;
+            if (ImGui::Checkbox(keyword.name.c_str(), &enabled)) {
+                material.setKeyword(keyword.name, enabled ? 1 : 0);
+            }
+        } else {
+            const char* preview = value < keyword.valueNames.size() ? keyword.valueNames[value].c_str() : "?";
+            if (ImGui::BeginCombo(keyword.name.c_str(), preview)) {
+                for (uint32_t i = 0; i < keyword.getNumValues(); ++i) {
+                    if (ImGui::Selectable(keyword.valueNames[i].c_str(), i == value)) {
+                        material.setKeyword(keyword.name, i);
+                    }
+                }
+                ImGui::EndCombo();
+            }
+        }
+    }
+    
+    auto shader = material.getShader();
+    if (shader && shader->isVariant() && !shader->hasProgram()) {
+        ImGui::TextDisabled("Compiling variant...");
+    }
+}
+
+void MaterialEditor::renderMaterialParameter(const FName& name, void* data, int type) {
     using ParamType = CarrotToy::ShaderParamType;
     switch (static_cast<ParamType>(type)) {
         case ParamType::Float:
@@ -3,6 +3,7 @@
 #include <string>
 #include <functional>
 #include <memory>
+#include "CoreUtils.h"
 #include "EditorAPI.h"
 
 namespace CarrotToy {
@@ -41,17 +42,21 @@ private:
 
     Renderer* renderer;
     std::shared_ptr<ImGuiContext> imguiContext;
-    std::string selectedMaterialName;
+    FName selectedMaterialName;
     
     // Shader editor state
-    char vertexShaderBuffer[8192];
-    char fragmentShaderBuffer[8192];
+    std::string vertexShaderBuffer;
+    std::string fragmentShaderBuffer;
     bool shaderEditorOpen;
     
     std::function<void()> onShaderRecompile;
     
-    void renderMaterialParameter(const std::string& name, void* data, int type);
+    void renderMaterialParameter(const FName& name, void* data, int type);
+    void renderMaterialKeywords(Material& material);
     void loadCurrentShaderSources();
+    // Saves the editor buffers to the shader sources and recompiles; save=false applies GLSL
+    // without writing it
+    void applyShaderEdits(Material& material, bool save);
 };
 
 } // namespace CarrotToy
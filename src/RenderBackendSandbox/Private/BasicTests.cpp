@@ -1,8 +1,16 @@
 #include "BasicTests.h"
 #include "CoreUtils.h"
+#include "Misc/StartupProfiler.h"
+#include "Image/TextureCompression.h"
+#include "RHI/OpenGLRHI.h"
+#include "RHI/RHIHandle.h"
+#include "RHI/RHIVertexPacking.h"
 #include <cstring>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <unordered_map>
 
 BasicTests::BasicTests()
 {
@@ -61,6 +69,15 @@ void BasicTests::RunTests()
     TestMathOperations();
     TestPlatformDetection();
     TestBufferOperations();
+    TestNameInterning();
+    TestArrayContainer();
+    TestMapContainer();
+    BenchmarkMapContainer();
+    TestStartupProfiler();
+    TestTextureCompression();
+    TestResourceHandles();
+    TestProgramBinding();
+    TestVertexPacking();
     
     LOG("=== Basic Tests Complete ===");
     LOG("BasicTests: Total tests: " + std::to_string(PassedTests + FailedTests) +
@@ -429,6 +446,86 @@ void BasicTests::TestBufferOperations()
     LogTestResult("Buffer Operations", passed, details);
 }
 
+void BasicTests::TestNameInterning()
+{
+    LOG("BasicTests: Test - Name Interning");
+    
+    bool passed = true;
+    std::string details;
+    
+    try
+    {
+        // Test 1: Same spelling interns to the same entry
+        FName a("MaterialBlock");
+        FName b(std::string("MaterialBlock"));
+        if (a != b || !a.IsEqualCaseSensitive(b))
+        {
+            passed = false;
+            details = "Identical names did not intern to the same entry";
+        }
+        
+        // Test 2: Comparison is case-insensitive, display keeps the spelling
+        if (passed)
+        {
+            FName lower("materialblock");
+            if (lower != a || lower.IsEqualCaseSensitive(a) || lower.ToString() != "materialblock")
+            {
+                passed = false;
+                details = "Case-insensitive compare or case-preserving display failed";
+            }
+        }
+        
+        // Test 3: Distinct names differ, None is empty
+        if (passed)
+        {
+            FName other("LightBlock");
+            FName none;
+            if (other == a || !none.IsNone() || !none.ToString().empty() || FName("") != none)
+            {
+                passed = false;
+                details = "Distinct or None names compared incorrectly";
+            }
+        }
+        
+        // Test 4: Find does not add new names
+        if (passed)
+        {
+            uint32 before = FName::GetNumNames();
+            FName missing = FName::Find("BasicTests_NeverInternedName");
+            if (!missing.IsNone() || FName::GetNumNames() != before || FName::Find("MATERIALBLOCK") != a)
+            {
+                passed = false;
+                details = "FName::Find returned wrong result or modified the table";
+            }
+        }
+        
+        // Test 5: Usable as a hash map key
+        if (passed)
+        {
+            FMap<FName, int> map;
+            map[a] = 1;
+            map["LightBlock"] = 2;
+            if (map.size() != 2 || map["MATERIALBLOCK"] != 1)
+            {
+                passed = false;
+                details = "FName hash map lookup failed";
+            }
+        }
+        
+        if (passed)
+        {
+            details = "Interning, case-insensitive compare and lookup validated successfully";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        passed = false;
+        details = std::string("Exception: ") + e.what();
+    }
+    
+    LogTestResult("Name Interning", passed, details);
+}
+
 void BasicTests::LogTestResult(const std::string& testName, bool passed, const std::string& details)
 {
     std::string result = testName + ": " + (passed ? "PASS" : "FAIL");
@@ -496,3 +593,631 @@ bool BasicTests::ValidateBuffer(uint8_t expectedValue)
     
     return true;
 }
+
+void BasicTests::TestArrayContainer()
+{
+    LOG("BasicTests: Test - Array Container");
+    
+    bool passed = true;
+    std::string details;
+    
+    try
+    {
+        // Test 1: Inline storage is used until the array outgrows it
+        TInlineArray<int, 4> small;
+        for (int i = 0; i < 4; ++i) small.Add(i);
+        if (!small.IsInline() || small.Num() != 4)
+        {
+            passed = false;
+            details = "Inline array allocated before exceeding its inline capacity";
+        }
+        small.Add(4);
+        if (passed && (small.IsInline() || small[4] != 4 || small[0] != 0))
+        {
+            passed = false;
+            details = "Inline array did not spill to the heap correctly";
+        }
+        
+        // Test 2: Move keeps contents for both inline and heap storage
+        if (passed)
+        {
+            TInlineArray<std::string, 2> names;
+            names.Emplace("a");
+            names.Emplace(3, 'b');
+            TInlineArray<std::string, 2> moved(std::move(names));
+            TArray<std::string> heap;
+            heap.Reserve(8);
+            heap.Add("x");
+            const std::string* heapData = heap.GetData();
+            TArray<std::string> stolen(std::move(heap));
+            if (moved.Num() != 2 || moved[1] != "bbb" || !names.IsEmpty() ||
+                stolen.GetData() != heapData || !heap.IsEmpty())
+            {
+                passed = false;
+                details = "Move construction lost elements or copied a heap buffer";
+            }
+        }
+        
+        // Test 3: RemoveAtSwap / RemoveSwap / RemoveAt
+        if (passed)
+        {
+            TArray<int> values = { 0, 1, 2, 3, 4, 5 };
+            values.RemoveAtSwap(1);       // 0 5 2 3 4
+            values.RemoveSwap(3);         // 0 5 2 4
+            values.RemoveAt(0);           // 5 2 4
+            if (values != TArray<int>({ 5, 2, 4 }) || values.Find(4) != 2 || values.Contains(0))
+            {
+                passed = false;
+                details = "Remove operations produced the wrong contents";
+            }
+        }
+        
+        // Test 4: Arena allocator
+        if (passed)
+        {
+            FMemArena arena(1024);
+            TArray<uint64, FArenaAllocator> scratch{ FArenaAllocator(arena) };
+            for (uint64 i = 0; i < 100; ++i) scratch.Add(i * i);
+            if (scratch.Num() != 100 || scratch[99] != 99 * 99 || arena.GetBytesUsed() < 100 * sizeof(uint64))
+            {
+                passed = false;
+                details = "Arena-backed array returned wrong contents";
+            }
+        }
+        
+        if (passed)
+        {
+            details = "Inline storage, move, remove and arena allocation validated successfully";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        passed = false;
+        details = std::string("Exception: ") + e.what();
+    }
+    
+    LogTestResult("Array Container", passed, details);
+}
+
+void BasicTests::TestMapContainer()
+{
+    LOG("BasicTests: Test - Map Container");
+    
+    bool passed = true;
+    std::string details;
+    
+    try
+    {
+        // Test 1: Insert, overwrite, grow past several rehashes
+        TMap<int, int> ints;
+        for (int i = 0; i < 1000; ++i) ints.Add(i, i * 2);
+        ints.Add(10, -1);
+        if (ints.Num() != 1000 || *ints.Find(10) != -1 || *ints.Find(999) != 1998 || ints.Find(1000) != nullptr)
+        {
+            passed = false;
+            details = "Insert/overwrite/find returned wrong results";
+        }
+        
+        // Test 2: Remove leaves the rest intact and slots are reused
+        if (passed)
+        {
+            for (int i = 0; i < 1000; i += 2) ints.Remove(i);
+            size_t sum = 0;
+            for (const auto& kv : ints) sum += static_cast<size_t>(kv.first);
+            for (int i = 0; i < 1000; i += 2) ints.Add(i, i);
+            if (sum != 250000 || ints.Num() != 1000 || ints.Contains(1001) || *ints.Find(998) != 998)
+            {
+                passed = false;
+                details = "Remove/iterate/re-add produced wrong contents";
+            }
+        }
+        
+        // Test 3: Heterogeneous lookup with raw strings
+        if (passed)
+        {
+            TMap<FString, int> strings;
+            strings.Add("albedo", 1);
+            TMap<FName, int> names;
+            names.Add("RoughnessScale", 2);
+            const uint32 namesBefore = FName::GetNumNames();
+            if (strings.Find("albedo") == nullptr || strings.Contains("Albedo") ||
+                names.Find("roughnessscale") == nullptr || *names.Find("RoughnessScale") != 2 ||
+                names.Contains("BasicTests_MissingMapKey") || FName::GetNumNames() != namesBefore)
+            {
+                passed = false;
+                details = "Heterogeneous lookup failed or interned the lookup key";
+            }
+        }
+        
+        if (passed)
+        {
+            details = "Insert, remove, iteration and heterogeneous lookup validated successfully";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        passed = false;
+        details = std::string("Exception: ") + e.what();
+    }
+    
+    LogTestResult("Map Container", passed, details);
+}
+
+void BasicTests::BenchmarkMapContainer()
+{
+    LOG("BasicTests: Benchmark - TMap vs std::unordered_map");
+    
+    // Mirrors the engine's hot maps: FName keys (modules, uniform locations) with small values
+    constexpr int NumKeys = 4096;
+    constexpr int NumRounds = 64;
+    
+    std::vector<FName> keys;
+    std::vector<FName> missingKeys;
+    keys.reserve(NumKeys);
+    missingKeys.reserve(NumKeys);
+    for (int i = 0; i < NumKeys; ++i)
+    {
+        keys.emplace_back("BenchKey_" + std::to_string(i));
+        missingKeys.emplace_back("BenchMissing_" + std::to_string(i));
+    }
+    
+    using Clock = std::chrono::steady_clock;
+    auto measureNs = [](auto&& body) {
+        const auto start = Clock::now();
+        body();
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    };
+    
+    TMap<FName, int> flatMap;
+    std::unordered_map<FName, int> stdMap;
+    int64_t checksum = 0;
+    
+    const double flatInsert = measureNs([&]() { for (int i = 0; i < NumKeys; ++i) flatMap.Add(keys[i], i); });
+    const double stdInsert = measureNs([&]() { for (int i = 0; i < NumKeys; ++i) stdMap.emplace(keys[i], i); });
+    
+    const double flatHit = measureNs([&]() {
+        for (int r = 0; r < NumRounds; ++r)
+            for (const FName& key : keys) checksum += *flatMap.Find(key);
+    });
+    const double stdHit = measureNs([&]() {
+        for (int r = 0; r < NumRounds; ++r)
+            for (const FName& key : keys) checksum += stdMap.find(key)->second;
+    });
+    
+    const double flatMiss = measureNs([&]() {
+        for (int r = 0; r < NumRounds; ++r)
+            for (const FName& key : missingKeys) checksum += flatMap.Contains(key) ? 1 : 0;
+    });
+    const double stdMiss = measureNs([&]() {
+        for (int r = 0; r < NumRounds; ++r)
+            for (const FName& key : missingKeys) checksum += stdMap.count(key);
+    });
+    
+    const double lookups = static_cast<double>(NumKeys) * NumRounds;
+    auto fmt = [](double value) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.1f", value);
+        return std::string(buffer);
+    };
+    
+    LOG("BasicTests:   insert  ns/op  TMap " << fmt(flatInsert / NumKeys) << "  std " << fmt(stdInsert / NumKeys));
+    LOG("BasicTests:   hit     ns/op  TMap " << fmt(flatHit / lookups) << "  std " << fmt(stdHit / lookups));
+    LOG("BasicTests:   miss    ns/op  TMap " << fmt(flatMiss / lookups) << "  std " << fmt(stdMiss / lookups));
+    
+    // The benchmark itself only fails if the two containers disagree
+    const bool passed = flatMap.Num() == stdMap.size() && checksum != 0;
+    LogTestResult("Map Benchmark", passed,
+        "hit ns/op TMap " + fmt(flatHit / lookups) + " vs std " + fmt(stdHit / lookups));
+}
+
+void BasicTests::TestStartupProfiler()
+{
+    LOG("BasicTests: Test - Startup Profiler");
+    
+    bool passed = true;
+    std::string details;
+    
+    try
+    {
+        // A standalone profiler, so the engine's own startup report is left alone
+        using FClock = FStartupProfiler::FClock;
+        const FClock::time_point origin = FClock::now();
+        FStartupProfiler profiler(origin);
+        
+        // Test 1: Scopes and explicit events are recorded with their category
+        {
+            FStartupScope scope("Module", "BasicTestsModule", profiler);
+        }
+        profiler.AddEvent("Shader", "Link default", origin + std::chrono::milliseconds(10), origin + std::chrono::milliseconds(25));
+        const TArray<FStartupProfiler::FEvent> events = profiler.GetEvents();
+        if (events.Num() != 2 || events[0].Category != "Module" || events[1].Name != "Link default" ||
+            std::fabs(events[1].DurationMs - 15.0) > 1e-6 || std::fabs(profiler.GetCategoryTotalMs("Shader") - 15.0) > 1e-6)
+        {
+            passed = false;
+            details = "Recorded events or category totals are wrong";
+        }
+        
+        // Test 2: Time to first frame is a queryable metric, fixed by the first mark
+        if (passed)
+        {
+            const bool hadFirstFrame = profiler.HasFirstFrame();
+            profiler.MarkFirstFrame(origin + std::chrono::milliseconds(40));
+            profiler.MarkFirstFrame(origin + std::chrono::milliseconds(90));
+            if (hadFirstFrame || std::fabs(profiler.GetTimeToFirstFrameMs() - 40.0) > 1e-6)
+            {
+                passed = false;
+                details = "Time to first frame was not recorded once";
+            }
+        }
+        
+        // Test 3: Nothing is recorded after the first frame
+        if (passed)
+        {
+            profiler.AddEvent("Shader", "Hot reload", FClock::now(), FClock::now());
+            if (profiler.GetEvents().Num() != 2)
+            {
+                passed = false;
+                details = "Events recorded after the first frame";
+            }
+        }
+        
+        if (passed)
+        {
+            details = "Scopes, category totals and time to first frame validated successfully";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        passed = false;
+        details = std::string("Exception: ") + e.what();
+    }
+    
+    LogTestResult("Startup Profiler", passed, details);
+}
+
+void BasicTests::TestTextureCompression()
+{
+    LOG("BasicTests: Test - Texture Compression");
+    
+    bool passed = true;
+    std::string details;
+    
+    try
+    {
+        // A smooth color ramp with a slight vertical tint, with a size that is not a multiple of
+        // the 4x4 block
+        const uint32 Width = 22, Height = 13;
+        TArray<uint8_t> image;
+        image.SetNum(Width * Height * 4);
+        for (uint32 y = 0; y < Height; ++y)
+        {
+            for (uint32 x = 0; x < Width; ++x)
+            {
+                uint8_t* texel = &image[(y * Width + x) * 4];
+                texel[0] = uint8_t(x * 11 + y);
+                texel[1] = uint8_t(x * 6 + y * 2);
+                texel[2] = uint8_t(240 - x * 10);
+                texel[3] = uint8_t(255 - x * 4 - y * 3);
+            }
+        }
+        
+        struct FCase { EBlockCompression Format; const char* Name; uint32 Channels; };
+        const FCase cases[] = {
+            { EBlockCompression::BC1, "BC1", 3 },
+            { EBlockCompression::BC3, "BC3", 4 },
+            { EBlockCompression::BC5, "BC5", 2 },
+            { EBlockCompression::BC7, "BC7", 4 },
+        };
+        
+        // Test 1: Each format round-trips with a small error and the expected block size
+        for (const FCase& test : cases)
+        {
+            const TArray<uint8_t> blocks = FTextureCompression::Compress(test.Format, image.GetData(), Width, Height);
+            const size_t expectedSize = size_t(6 * 4) * FTextureCompression::GetBlockBytes(test.Format);
+            if (blocks.Num() != expectedSize || FTextureCompression::GetCompressedSize(test.Format, Width, Height) != expectedSize)
+            {
+                passed = false;
+                details = std::string(test.Name) + ": wrong compressed size";
+                break;
+            }
+            
+            const TArray<uint8_t> decoded = FTextureCompression::Decompress(test.Format, blocks.GetData(), Width, Height);
+            double squaredError = 0.0;
+            for (uint32 i = 0; i < Width * Height; ++i)
+            {
+                for (uint32 c = 0; c < test.Channels; ++c)
+                {
+                    const double delta = double(image[i * 4 + c]) - double(decoded[i * 4 + c]);
+                    squaredError += delta * delta;
+                }
+            }
+            const double rmsError = std::sqrt(squaredError / (Width * Height * test.Channels));
+            if (decoded.Num() != image.Num() || rmsError > 4.0)
+            {
+                passed = false;
+                details = std::string(test.Name) + ": round trip error " + std::to_string(rmsError);
+                break;
+            }
+        }
+        
+        // Test 2: The mip chain halves each size down to 1x1
+        if (passed)
+        {
+            TArray<uint8_t> level = FTextureCompression::DownsampleRGBA8(image.GetData(), Width, Height);
+            uint32 width = Width / 2, height = Height / 2, levels = 1;
+            while (width > 1 || height > 1)
+            {
+                level = FTextureCompression::DownsampleRGBA8(level.GetData(), width, height);
+                width = std::max(1u, width / 2);
+                height = std::max(1u, height / 2);
+                ++levels;
+            }
+            if (levels != 4 || level.Num() != 4)
+            {
+                passed = false;
+                details = "Mip chain has the wrong length";
+            }
+        }
+        
+        if (passed)
+        {
+            details = "BC1/BC3/BC5/BC7 round trips and mip chain validated successfully";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        passed = false;
+        details = std::string("Exception: ") + e.what();
+    }
+    
+    LogTestResult("Texture Compression", passed, details);
+}
+
+void BasicTests::TestResourceHandles()
+{
+    LOG("BasicTests: Test - Resource Handles");
+    
+    bool passed = true;
+    std::string details;
+    
+    try
+    {
+        // The pool only stores pointers, so plain ints stand in for RHI resources
+        using FHandle = CarrotToy::RHI::RHIHandle<int>;
+        CarrotToy::RHI::RHIResourcePool<int> pool("Test");
+        
+        // Test 1: The null handle is invalid and resolves to nothing
+        const FHandle none;
+        if (none.isValid() || pool.get(none) != nullptr || pool.add(nullptr).isValid())
+        {
+            passed = false;
+            details = "Null handle is valid or resolves to a resource";
+        }
+        
+        // Test 2: Add, remove, then add again reuses the slot with a new generation
+        FHandle first, second;
+        if (passed)
+        {
+            auto firstValue = std::make_shared<int>(1);
+            first = pool.add(firstValue);
+            const std::shared_ptr<int> removed = pool.remove(first);
+            second = pool.add(std::make_shared<int>(2));
+            if (!first.isValid() || removed != firstValue || !second.isValid() ||
+                second.getIndex() != first.getIndex() || second.getGeneration() == first.getGeneration() ||
+                pool.get(second) == nullptr || *pool.get(second) != 2 || pool.size() != 1)
+            {
+                passed = false;
+                details = "Re-adding after remove did not yield a new generation of the slot";
+            }
+        }
+        
+        // Test 3: A stale handle no longer resolves. tryGet() is what command list replay uses;
+        // unlike get() it does not assert in debug builds.
+        if (passed)
+        {
+            bool staleResolved = pool.tryGet(first) != nullptr || pool.tryGet(first) != nullptr ||
+                pool.remove(first) != nullptr || pool.size() != 1 || pool.tryGet(second) == nullptr;
+            pool.clear();
+            staleResolved = staleResolved || pool.tryGet(second) != nullptr || pool.remove(second) != nullptr ||
+                pool.size() != 0;
+            if (staleResolved)
+            {
+                passed = false;
+                details = "Stale handle still resolved to a resource";
+            }
+        }
+        
+        if (passed)
+        {
+            details = "Null handle, slot reuse with new generation and stale handles validated successfully";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        passed = false;
+        details = std::string("Exception: ") + e.what();
+    }
+    
+    LogTestResult("Resource Handles", passed, details);
+}
+
+void BasicTests::TestProgramBinding()
+{
+    LOG("BasicTests: Test - Program Binding");
+    
+    bool passed = true;
+    std::string details;
+    
+    try
+    {
+        // Replays what OpenGLShaderProgram reports, without a GL context. setPipelineState binds
+        // its program again whenever isBound() is false.
+        using CarrotToy::RHI::OpenGLProgramBinding;
+        const uint32_t Program = 7, OtherProgram = 8;
+        
+        // Test 1: A pipeline's program stays bound across pipelines sharing it
+        OpenGLProgramBinding::onBind(Program);
+        if (!OpenGLProgramBinding::isBound(Program) || OpenGLProgramBinding::isBound(OtherProgram) ||
+            OpenGLProgramBinding::isBound(0))
+        {
+            passed = false;
+            details = "Bound program not reported as bound";
+        }
+        
+        // Test 2: Unbinding outside the device (IRHIShaderProgram::unbind, Material::unbind) makes
+        // the same pipeline bind its program again
+        if (passed)
+        {
+            OpenGLProgramBinding::onBind(0);
+            if (OpenGLProgramBinding::isBound(Program))
+            {
+                passed = false;
+                details = "Program still reported bound after an unbind outside the device";
+            }
+        }
+        
+        // Test 3: So does binding another program outside the device (command list replay)
+        if (passed)
+        {
+            OpenGLProgramBinding::onBind(Program);
+            OpenGLProgramBinding::onBind(OtherProgram);
+            if (OpenGLProgramBinding::isBound(Program) || !OpenGLProgramBinding::isBound(OtherProgram))
+            {
+                passed = false;
+                details = "Program still reported bound after another one was bound outside the device";
+            }
+        }
+        
+        // Test 4: Deleting the bound program forgets it, so a new program reusing its GL name binds
+        if (passed)
+        {
+            OpenGLProgramBinding::onRelease(Program);
+            const bool otherKept = OpenGLProgramBinding::isBound(OtherProgram);
+            OpenGLProgramBinding::onRelease(OtherProgram);
+            if (!otherKept || OpenGLProgramBinding::isBound(OtherProgram))
+            {
+                passed = false;
+                details = "Released program still reported bound";
+            }
+        }
+        OpenGLProgramBinding::onBind(0);
+        
+        if (passed)
+        {
+            details = "Program binding tracked across binds and unbinds outside the device";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        passed = false;
+        details = std::string("Exception: ") + e.what();
+    }
+    
+    LogTestResult("Program Binding", passed, details);
+}
+
+void BasicTests::TestVertexPacking()
+{
+    LOG("BasicTests: Test - Vertex Packing");
+    
+    bool passed = true;
+    std::string details;
+    
+    try
+    {
+        using namespace CarrotToy::RHI;
+        
+        // Test 1: Halves round to nearest, overflow to infinity and keep denormals
+        struct FHalfCase { float Value; uint16_t Bits; };
+        const FHalfCase halves[] = {
+            { 1.0f, 0x3c00 }, { 0.5f, 0x3800 }, { -2.75f, 0xc180 }, { 0.333333f, 0x3555 },
+            { 65504.0f, 0x7bff }, { 70000.0f, 0x7c00 }, { 6e-8f, 0x0001 },
+        };
+        for (const FHalfCase& test : halves)
+        {
+            if (packHalf(test.Value) != test.Bits)
+            {
+                passed = false;
+                details = "packHalf(" + std::to_string(test.Value) + ") returned the wrong bits";
+                break;
+            }
+        }
+        
+        // Test 2: 10_10_10_2 puts x in the low bits and saturates at +-1
+        if (passed && (packSnorm10_10_10_2(1.0f, -1.0f, 0.5f, -1.0f) != 0xd00805ffu ||
+                       packSnorm10_10_10_2(2.0f, -2.0f, 0.0f) != packSnorm10_10_10_2(1.0f, -1.0f, 0.0f)))
+        {
+            passed = false;
+            details = "packSnorm10_10_10_2 returned the wrong bits";
+        }
+        
+        // Test 3: Octahedral normals decode (as the shader does) to nearly the same direction, on
+        // both hemispheres and the axes
+        if (passed)
+        {
+            double maxError = 0.0;
+            for (int i = 0; i < 500 && passed; ++i)
+            {
+                const float theta = float(i) * 2.399963f;
+                const float z = 1.0f - 2.0f * (float(i) + 0.5f) / 500.0f;
+                const float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+                const float n[3] = { r * std::cos(theta), r * std::sin(theta), z };
+                
+                int16_t encoded[2];
+                packOctahedralNormal(n[0], n[1], n[2], encoded);
+                float d[3] = { std::max(encoded[0] / 32767.0f, -1.0f), std::max(encoded[1] / 32767.0f, -1.0f), 0.0f };
+                d[2] = 1.0f - std::fabs(d[0]) - std::fabs(d[1]);
+                if (d[2] < 0.0f)
+                {
+                    const float x = d[0], y = d[1];
+                    d[0] = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+                    d[1] = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+                }
+                const double length = std::sqrt(double(d[0]) * d[0] + double(d[1]) * d[1] + double(d[2]) * d[2]);
+                const double cosAngle = (n[0] * d[0] + n[1] * d[1] + n[2] * d[2]) / length;
+                maxError = std::max(maxError, std::acos(std::min(1.0, cosAngle)) * 180.0 / 3.14159265358979);
+            }
+            int16_t axis[2];
+            packOctahedralNormal(0.0f, 0.0f, -1.0f, axis);
+            if (maxError > 0.05 || std::abs(axis[0]) != 32767 || std::abs(axis[1]) != 32767)
+            {
+                passed = false;
+                details = "Octahedral normal round trip error " + std::to_string(maxError) + " degrees";
+            }
+        }
+        
+        // Test 4: Indices narrow to 16 bits only while every vertex stays addressable
+        if (passed)
+        {
+            const uint32_t indices[] = { 0, 1, 65535, 2 };
+            std::vector<uint8_t> data;
+            const IndexFormat narrow = packIndices(indices, 4, 65536, data);
+            uint16_t narrowed[4] = {};
+            if (data.size() == sizeof(narrowed))
+            {
+                memcpy(narrowed, data.data(), sizeof(narrowed));
+            }
+            const bool narrowOk = narrow == IndexFormat::UInt16 && data.size() == 4 * sizeof(uint16_t) &&
+                narrowed[0] == 0 && narrowed[1] == 1 && narrowed[2] == 65535 && narrowed[3] == 2;
+            const IndexFormat wide = packIndices(indices, 4, 65537, data);
+            if (!narrowOk || wide != IndexFormat::UInt32 || data.size() != sizeof(indices) ||
+                memcmp(data.data(), indices, sizeof(indices)) != 0)
+            {
+                passed = false;
+                details = "packIndices picked the wrong format or changed the indices";
+            }
+        }
+        
+        if (passed)
+        {
+            details = "Half, 10_10_10_2, octahedral normal and index packing validated successfully";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        passed = false;
+        details = std::string("Exception: ") + e.what();
+    }
+    
+    LogTestResult("Vertex Packing", passed, details);
+}
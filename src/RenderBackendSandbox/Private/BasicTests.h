@@ -37,6 +37,15 @@ public:
     void TestMathOperations();
     void TestPlatformDetection();
     void TestBufferOperations();
+    void TestNameInterning();
+    void TestArrayContainer();
+    void TestMapContainer();
+    void BenchmarkMapContainer();
+    void TestStartupProfiler();
+    void TestTextureCompression();
+    void TestResourceHandles();
+    void TestProgramBinding();
+    void TestVertexPacking();
     
     // Query test status
     bool IsInitialized() const { return bInitialized; }
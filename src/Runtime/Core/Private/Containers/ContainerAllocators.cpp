@@ -0,0 +1,72 @@
+#include "Containers/ContainerAllocators.h"
+
+#include <cstdint>
+#include <algorithm>
+
+static size_t AlignUp(size_t Value, size_t Alignment)
+{
+	return (Value + Alignment - 1) & ~(Alignment - 1);
+}
+
+FMemArena::FMemArena(size_t InBlockSize)
+	: BlockSize(InBlockSize)
+{
+}
+
+FMemArena::~FMemArena()
+{
+	while (Head) {
+		FBlock* Next = Head->Next;
+		::operator delete(Head);
+		Head = Next;
+	}
+}
+
+FMemArena::FBlock* FMemArena::AllocateBlock(size_t MinSize)
+{
+	const size_t Size = std::max(BlockSize, MinSize + sizeof(FBlock) + alignof(std::max_align_t));
+	FBlock* Block = static_cast<FBlock*>(::operator new(Size));
+	Block->Next = Head;
+	Block->Size = Size;
+	Head = Block;
+	Cursor = reinterpret_cast<unsigned char*>(Block) + sizeof(FBlock);
+	End = reinterpret_cast<unsigned char*>(Block) + Size;
+	return Block;
+}
+
+void* FMemArena::Allocate(size_t Size, size_t Alignment)
+{
+	if (Size == 0) Size = 1;
+
+	auto TryBump = [&]() -> void* {
+		if (!Cursor) return nullptr;
+		const uintptr_t Current = reinterpret_cast<uintptr_t>(Cursor);
+		const uintptr_t Aligned = AlignUp(Current, Alignment);
+		if (Aligned + Size > reinterpret_cast<uintptr_t>(End)) return nullptr;
+		BytesUsed += (Aligned - Current) + Size;
+		Cursor = reinterpret_cast<unsigned char*>(Aligned + Size);
+		return reinterpret_cast<void*>(Aligned);
+	};
+
+	if (void* Ptr = TryBump()) {
+		return Ptr;
+	}
+
+	AllocateBlock(Size + Alignment);
+	return TryBump();
+}
+
+void FMemArena::Reset()
+{
+	if (!Head) return;
+
+	// Keep only the oldest block (the last in the list); it is the common working set.
+	while (Head->Next) {
+		FBlock* Next = Head->Next;
+		::operator delete(Head);
+		Head = Next;
+	}
+	Cursor = reinterpret_cast<unsigned char*>(Head) + sizeof(FBlock);
+	End = reinterpret_cast<unsigned char*>(Head) + Head->Size;
+	BytesUsed = 0;
+}
@@ -0,0 +1,237 @@
+#include "Misc/FileWatcher.h"
+
+#include <filesystem>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+FString ToWatchedPath(const fs::path& Path)
+{
+	std::error_code Ec;
+	fs::path Absolute = fs::absolute(Path, Ec);
+	return (Ec ? Path : Absolute).lexically_normal().generic_string();
+}
+
+struct FFileStamp
+{
+	fs::file_time_type WriteTime;
+	uintmax_t Size = 0;
+
+	bool operator==(const FFileStamp& Other) const { return WriteTime == Other.WriteTime && Size == Other.Size; }
+	bool operator!=(const FFileStamp& Other) const { return !(*this == Other); }
+};
+
+TMap<FString, FFileStamp> ScanDirectory(const FString& Directory)
+{
+	TMap<FString, FFileStamp> Files;
+	std::error_code Ec;
+	for (fs::recursive_directory_iterator It(Directory, Ec), End; !Ec && It != End; It.increment(Ec)) {
+		if (!It->is_regular_file(Ec)) continue;
+		FFileStamp Stamp;
+		Stamp.WriteTime = It->last_write_time(Ec);
+		Stamp.Size = It->file_size(Ec);
+		Files.Add(ToWatchedPath(It->path()), Stamp);
+	}
+	return Files;
+}
+
+} // namespace
+
+FFileWatcher::~FFileWatcher()
+{
+	Stop();
+}
+
+bool FFileWatcher::Start(const FString& InDirectory, bool bForcePolling)
+{
+	Stop();
+
+	std::error_code Ec;
+	if (!fs::is_directory(InDirectory, Ec)) {
+		LOG("FFileWatcher: " << InDirectory << " is not a directory");
+		return false;
+	}
+	Directory = ToWatchedPath(InDirectory);
+	bStopRequested = false;
+	bPolling = true;
+
+#if defined(__linux__)
+	if (!bForcePolling) {
+		InotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (InotifyFd >= 0 && AddInotifyWatches(Directory)) {
+			bPolling = false;
+			Thread = std::thread(&FFileWatcher::RunInotify, this);
+		} else {
+			// e.g. the per-user watch limit is exhausted
+			LOG("FFileWatcher: inotify unavailable, polling " << Directory);
+			if (InotifyFd >= 0) {
+				close(InotifyFd);
+				InotifyFd = -1;
+			}
+			WatchedDirs.Empty();
+		}
+	}
+#else
+	(void)bForcePolling;
+#endif
+
+	if (bPolling) {
+		Thread = std::thread(&FFileWatcher::RunPolling, this);
+	}
+	return true;
+}
+
+void FFileWatcher::Stop()
+{
+	if (!Thread.joinable()) return;
+
+	bStopRequested = true;
+	Thread.join();
+
+#if defined(__linux__)
+	if (InotifyFd >= 0) {
+		close(InotifyFd);
+		InotifyFd = -1;
+	}
+	WatchedDirs.Empty();
+#endif
+
+	std::lock_guard<std::mutex> Lock(Mutex);
+	Pending.Empty();
+}
+
+TArray<FString> FFileWatcher::ConsumeChanges()
+{
+	TArray<FString> Changes;
+	const FClock::time_point Now = FClock::now();
+	const auto Debounce = std::chrono::milliseconds(DebounceMs);
+
+	std::lock_guard<std::mutex> Lock(Mutex);
+	for (const auto& Entry : Pending) {
+		if (Now - Entry.second >= Debounce) {
+			Changes.Add(Entry.first);
+		}
+	}
+	for (const FString& Path : Changes) {
+		Pending.Remove(Path);
+	}
+	return Changes;
+}
+
+void FFileWatcher::AddChange(const FString& Path)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+	Pending.Add(Path, FClock::now());
+}
+
+void FFileWatcher::RunPolling()
+{
+	TMap<FString, FFileStamp> Previous = ScanDirectory(Directory);
+	while (!bStopRequested) {
+		// Sleep in short steps so Stop() does not wait a whole interval
+		const FClock::time_point Wake = FClock::now() + std::chrono::milliseconds(PollIntervalMs);
+		while (!bStopRequested && FClock::now() < Wake) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		}
+		if (bStopRequested) break;
+
+		TMap<FString, FFileStamp> Current = ScanDirectory(Directory);
+		for (const auto& Entry : Current) {
+			const FFileStamp* Old = Previous.Find(Entry.first);
+			if (!Old || *Old != Entry.second) {
+				AddChange(Entry.first);
+			}
+		}
+		for (const auto& Entry : Previous) {
+			if (!Current.Contains(Entry.first)) {
+				AddChange(Entry.first);
+			}
+		}
+		Previous = std::move(Current);
+	}
+}
+
+#if defined(__linux__)
+
+bool FFileWatcher::AddInotifyWatches(const FString& Root)
+{
+	constexpr uint32_t Mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+	TArray<FString> Directories;
+	Directories.Add(Root);
+	std::error_code Ec;
+	for (fs::recursive_directory_iterator It(Root, Ec), End; !Ec && It != End; It.increment(Ec)) {
+		if (It->is_directory(Ec)) {
+			Directories.Add(ToWatchedPath(It->path()));
+		}
+	}
+
+	for (const FString& Dir : Directories) {
+		const int Wd = inotify_add_watch(InotifyFd, Dir.c_str(), Mask);
+		if (Wd < 0) {
+			LOG("FFileWatcher: Cannot watch " << Dir);
+			return false;
+		}
+		WatchedDirs.Add(Wd, Dir);
+	}
+	return true;
+}
+
+void FFileWatcher::RunInotify()
+{
+	alignas(inotify_event) char Buffer[16 * 1024];
+	pollfd Fd{InotifyFd, POLLIN, 0};
+
+	while (!bStopRequested) {
+		// The timeout bounds how long Stop() waits for this thread
+		if (poll(&Fd, 1, 100) <= 0) continue;
+
+		const ssize_t Length = read(InotifyFd, Buffer, sizeof(Buffer));
+		for (ssize_t Offset = 0; Length > 0 && Offset < Length;) {
+			const inotify_event* Event = reinterpret_cast<const inotify_event*>(Buffer + Offset);
+			Offset += sizeof(inotify_event) + Event->len;
+
+			if (Event->mask & IN_Q_OVERFLOW) {
+				// Events were dropped; report every file so nothing is missed
+				LOG("FFileWatcher: Event queue overflow, rescanning " << Directory);
+				for (const auto& Entry : ScanDirectory(Directory)) {
+					AddChange(Entry.first);
+				}
+				continue;
+			}
+			if (Event->mask & IN_IGNORED) {
+				WatchedDirs.Remove(Event->wd);
+				continue;
+			}
+
+			const FString* Dir = WatchedDirs.Find(Event->wd);
+			if (!Dir || Event->len == 0) continue;
+			const FString Path = *Dir + "/" + Event->name;
+
+			if (Event->mask & IN_ISDIR) {
+				// Watch new subdirectories, and report files that were moved in with them
+				if (Event->mask & (IN_CREATE | IN_MOVED_TO)) {
+					AddInotifyWatches(Path);
+					for (const auto& Entry : ScanDirectory(Path)) {
+						AddChange(Entry.first);
+					}
+				}
+				continue;
+			}
+			// IN_CREATE alone is followed by IN_CLOSE_WRITE once the file is written
+			if (Event->mask & (IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)) {
+				AddChange(Path);
+			}
+		}
+	}
+}
+
+#endif
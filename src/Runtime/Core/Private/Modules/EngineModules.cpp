@@ -9,6 +9,11 @@ void FCoreEngineModule::StartupModule()
 	// Initialize core systems: memory allocators, file system, logging, etc.
 }
 
+void FCoreEngineModule::GetModuleDescriptor(FModuleDescriptor& OutDescriptor) const
+{
+	OutDescriptor.LoadingPhase = ELoadingPhase::PreInit;
+}
+
 void FCoreEngineModule::ShutdownModule()
 {
 	LOG("CoreEngineModule: Shutdown");
@@ -1,6 +1,9 @@
 #include "Modules/Module.h"
-#include <iostream>
+#include "Misc/StartupProfiler.h"
+#include <algorithm>
 #include <filesystem>
+#include <functional>
+#include <iostream>
 
 #if !defined(_WIN32)
 #include <dlfcn.h>
@@ -12,75 +15,389 @@ FModuleManager& FModuleManager::Get()
     return mgr;
 }
 
+FModuleManager::FModuleManager()
+    // Modules register from static initializers and InitializeModule* calls before PreInit,
+    // so the first thread to touch the manager is the main thread.
+    : mainThreadId(std::this_thread::get_id())
+{
+}
+
 void FModuleManager::RegisterModule(const FName& name, FUniquePtr<IModuleInterface> module, EModuleType type)
 {
     LOG("ModuleManager: Registering module " << name << " of type " << static_cast<int>(type));
     
     FModuleInfo info;
-    info.ModuleInstance = std::move(module);
     info.Descriptor.ModuleName = name;
     info.Descriptor.Type = type;
+    // Application modules host user entry code; keep them on the main thread unless they opt out
+    info.Descriptor.bMainThreadOnly = (type == EModuleType::Application);
+    if (module) {
+        module->GetModuleDescriptor(info.Descriptor);
+    }
+    info.Descriptor.ModuleName = name; // the registry owns the name
+    info.ModuleInstance = std::move(module);
     info.bIsLoaded = false;
     
+    std::lock_guard<std::mutex> lock(modulesMutex);
     modules[name] = std::move(info);
 }
 
 IModuleInterface* FModuleManager::GetModule(const FName& name)
 {
-    auto it = modules.find(name);
-    return it == modules.end() ? nullptr : it->second.ModuleInstance.get();
+    std::lock_guard<std::mutex> lock(modulesMutex);
+    const FModuleInfo* info = modules.Find(name);
+    return info ? info->ModuleInstance.get() : nullptr;
 }
 
 bool FModuleManager::IsModuleLoaded(const FName& name) const
 {
-    auto it = modules.find(name);
-    return it != modules.end() && it->second.bIsLoaded;
+    std::lock_guard<std::mutex> lock(modulesMutex);
+    const FModuleInfo* info = modules.Find(name);
+    return info && info->bIsLoaded;
 }
 
 bool FModuleManager::LoadModule(const FName& name)
 {
-    auto it = modules.find(name);
-    if (it == modules.end()) {
-        // Module not found - this is not necessarily an error
-        // Some applications may not have all modules registered
-        LOG("ModuleManager: Module " << name << " not found in registry");
-        return false;
+    TArray<FName> names;
+    names.Add(name);
+    return StartupModuleGraph(names, false);
+}
+
+bool FModuleManager::LoadModules(const TArray<FName>& names)
+{
+    return StartupModuleGraph(names, bParallelStartup);
+}
+
+bool FModuleManager::LoadModulesForPhase(ELoadingPhase phase)
+{
+    TArray<FName> names;
+    {
+        std::lock_guard<std::mutex> lock(modulesMutex);
+        for (const auto& kv : modules) {
+            if (!kv.second.bIsLoaded && kv.second.Descriptor.LoadingPhase == phase) {
+                names.Add(kv.first);
+            }
+        }
+    }
+    // Registration order depends on static init order; sort so serial startup is reproducible
+    names.Sort(&FName::LexicalLess);
+    
+    LOG("ModuleManager: Loading " << names.Num() << " module(s) for loading phase " << static_cast<int>(phase));
+    return StartupModuleGraph(names, bParallelStartup);
+}
+
+void FModuleManager::SetParallelStartupEnabled(bool bEnabled)
+{
+    bParallelStartup = bEnabled;
+}
+
+bool FModuleManager::IsParallelStartupEnabled() const
+{
+    return bParallelStartup;
+}
+
+namespace {
+
+// One module in a startup batch
+struct FStartupNode
+{
+    FName Name;
+    IModuleInterface* Instance = nullptr;
+    bool bMainThreadOnly = false;
+    bool bFailed = false;
+    int32 PendingDependencies = 0;
+    TInlineArray<int32, 8> Dependents;
+};
+
+int32 PopFront(TInlineArray<int32, 16>& queue)
+{
+    const int32 index = queue[0];
+    queue.RemoveAt(0);
+    return index;
+}
+
+} // namespace
+
+bool FModuleManager::StartupModuleGraph(const TArray<FName>& names, bool bAllowParallel)
+{
+    TArray<FStartupNode> nodes;
+    FMap<FName, int32> nodeIndex;
+    bool bAllSucceeded = true;
+    
+    // 1. Walk Dependencies depth first and build the DAG of modules that still need starting.
+    //    The walk only reads the registry, so it runs under the lock in one go.
+    {
+        std::lock_guard<std::mutex> lock(modulesMutex);
+        
+        FMap<FName, bool> visited; // false while on the DFS stack, true once finished
+        TInlineArray<FName, 16> path;
+        
+        std::function<bool(const FName&)> visit = [&](const FName& name) -> bool {
+            const FModuleInfo* info = modules.Find(name);
+            if (!info) {
+                // Module not found - this is not necessarily an error
+                // Some applications may not have all modules registered
+                LOG("ModuleManager: Module " << name << " not found in registry");
+                return false;
+            }
+            if (info->bIsLoaded) {
+                return true;
+            }
+            if (const bool* bFinished = visited.Find(name)) {
+                if (*bFinished) {
+                    return !nodes[*nodeIndex.Find(name)].bFailed;
+                }
+                FString cycle;
+                bool bInCycle = false;
+                for (const FName& step : path) {
+                    bInCycle = bInCycle || step == name;
+                    if (bInCycle) cycle += step.ToString() + " -> ";
+                }
+                LOG("ModuleManager: Dependency cycle detected: " << cycle << name);
+                return false;
+            }
+            
+            visited.Add(name, false);
+            path.Add(name);
+            
+            const int32 index = static_cast<int32>(nodes.Num());
+            FStartupNode& node = nodes.EmplaceGetRef();
+            node.Name = name;
+            node.Instance = info->ModuleInstance.get();
+            node.bMainThreadOnly = info->Descriptor.bMainThreadOnly;
+            nodeIndex.Add(name, index);
+            
+            for (const FName& dep : info->Descriptor.Dependencies) {
+                if (!visit(dep)) {
+                    LOG("ModuleManager: Failed to load dependency " << dep << " for module " << name);
+                    nodes[index].bFailed = true;
+                } else if (const int32* depIndex = nodeIndex.Find(dep)) {
+                    nodes[*depIndex].Dependents.Add(index);
+                    ++nodes[index].PendingDependencies;
+                }
+            }
+            
+            path.Pop();
+            visited.Add(name, true);
+            return !nodes[index].bFailed;
+        };
+        
+        for (const FName& name : names) {
+            if (!visit(name)) {
+                bAllSucceeded = false;
+            }
+        }
     }
     
-    if (it->second.bIsLoaded) {
-        LOG("ModuleManager: Module " << name << " already loaded");
-        return true;
+    // 2. Run the DAG. Ready modules go to the main-thread queue or the worker queue.
+    std::mutex schedulerMutex;
+    std::condition_variable schedulerCv;
+    TInlineArray<int32, 16> mainReady;
+    TInlineArray<int32, 16> workerReady;
+    size_t remaining = 0;
+    size_t workerCapable = 0;
+    
+    for (size_t i = 0; i < nodes.Num(); ++i) {
+        const FStartupNode& node = nodes[i];
+        if (node.bFailed) continue;
+        ++remaining;
+        workerCapable += node.bMainThreadOnly ? 0 : 1;
+        if (node.PendingDependencies == 0) {
+            (node.bMainThreadOnly ? mainReady : workerReady).Add(static_cast<int32>(i));
+        }
+    }
+    if (remaining == 0) {
+        return bAllSucceeded;
     }
     
-    LOG("ModuleManager: Starting up module " << name);
+    // Called with schedulerMutex held
+    std::function<void(int32)> skipDependents = [&](int32 index) {
+        for (int32 dependent : nodes[index].Dependents) {
+            if (!nodes[dependent].bFailed) {
+                LOG("ModuleManager: Skipping module " << nodes[dependent].Name << ", dependency " << nodes[index].Name << " failed");
+                nodes[dependent].bFailed = true;
+                --remaining;
+                skipDependents(dependent);
+            }
+        }
+    };
+    
+    auto runNode = [&](std::unique_lock<std::mutex>& lock, int32 index) {
+        const FName name = nodes[index].Name;
+        IModuleInterface* instance = nodes[index].Instance;
+        lock.unlock();
+        const bool bSucceeded = StartupSingleModule(name, instance);
+        lock.lock();
+        
+        --remaining;
+        if (!bSucceeded) {
+            nodes[index].bFailed = true;
+            bAllSucceeded = false;
+            skipDependents(index);
+        } else {
+            for (int32 dependent : nodes[index].Dependents) {
+                FStartupNode& node = nodes[dependent];
+                if (!node.bFailed && --node.PendingDependencies == 0) {
+                    (node.bMainThreadOnly ? mainReady : workerReady).Add(dependent);
+                }
+            }
+        }
+        schedulerCv.notify_all();
+    };
+    
+    size_t numWorkers = 0;
+    if (bAllowParallel && remaining > 1) {
+        // Startup work is often I/O bound (file loads, driver init), so don't go below a few threads
+        const size_t hardwareThreads = std::max(4u, std::thread::hardware_concurrency());
+        numWorkers = std::min(hardwareThreads - 1, workerCapable);
+    }
+    
+    TInlineArray<std::thread, 8> workers;
+    for (size_t i = 0; i < numWorkers; ++i) {
+        workers.Emplace([&]() {
+            std::unique_lock<std::mutex> lock(schedulerMutex);
+            for (;;) {
+                schedulerCv.wait(lock, [&] { return remaining == 0 || !workerReady.IsEmpty(); });
+                if (workerReady.IsEmpty()) {
+                    return;
+                }
+                runNode(lock, PopFront(workerReady));
+            }
+        });
+    }
     
-    // Load dependencies first
-    for (const auto& dep : it->second.Descriptor.Dependencies) {
-        if (!IsModuleLoaded(dep)) {
-            if (!LoadModule(dep)) {
-                LOG("ModuleManager: Failed to load dependency " << dep << " for module " << name);
+    // The calling thread runs main-thread-only modules (and everything when there are no workers)
+    {
+        std::unique_lock<std::mutex> lock(schedulerMutex);
+        while (remaining > 0) {
+            schedulerCv.wait(lock, [&] {
+                return remaining == 0 || !mainReady.IsEmpty() || (numWorkers == 0 && !workerReady.IsEmpty());
+            });
+            if (!mainReady.IsEmpty()) {
+                runNode(lock, PopFront(mainReady));
+            } else if (numWorkers == 0 && !workerReady.IsEmpty()) {
+                runNode(lock, PopFront(workerReady));
+            }
+        }
+    }
+    
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return bAllSucceeded;
+}
+
+bool FModuleManager::StartupSingleModule(const FName& name, IModuleInterface* instance)
+{
+    {
+        std::unique_lock<std::mutex> lock(modulesMutex);
+        FModuleInfo* info = modules.Find(name);
+        if (!info) {
+            return false;
+        }
+        if (info->bIsLoaded) {
+            return true;
+        }
+        if (info->bIsStarting) {
+            if (info->StartingThread == std::this_thread::get_id()) {
+                LOG("ModuleManager: Module " << name << " was requested again from its own StartupModule");
                 return false;
             }
+            // Another thread is starting it (e.g. a nested LoadModule from a parallel startup).
+            // If that thread is (transitively) waiting for a module this thread is starting, both
+            // would wait forever, so the request that closes the cycle fails instead.
+            if (WouldDeadlockWaitingFor(name)) {
+                LOG("ModuleManager: Module " << name << " is being started by another thread that waits for a module this thread is starting");
+                return false;
+            }
+            const std::thread::id thisThread = std::this_thread::get_id();
+            startupWaits.Add(thisThread, name);
+            moduleStateChanged.wait(lock, [&] {
+                const FModuleInfo* current = modules.Find(name);
+                return !current || !current->bIsStarting;
+            });
+            startupWaits.Remove(thisThread);
+            const FModuleInfo* current = modules.Find(name);
+            return current && current->bIsLoaded;
+        }
+        if (info->Descriptor.bMainThreadOnly && std::this_thread::get_id() != mainThreadId) {
+            LOG("ModuleManager: Warning - main-thread-only module " << name << " is being started off the main thread");
         }
+        info->bIsStarting = true;
+        info->StartingThread = std::this_thread::get_id();
     }
     
-    // Startup the module
-    it->second.ModuleInstance->StartupModule();
-    it->second.bIsLoaded = true;
+    LOG("ModuleManager: Starting up module " << name);
     
-    LOG("ModuleManager: Module " << name << " loaded successfully");
-    return true;
+    bool bSucceeded = true;
+    try {
+        FStartupScope scope("Module", name.ToString());
+        instance->StartupModule();
+    } catch (const std::exception& e) {
+        LOG("ModuleManager: Module " << name << " failed to start: " << e.what());
+        bSucceeded = false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(modulesMutex);
+        if (FModuleInfo* info = modules.Find(name)) {
+            info->bIsStarting = false;
+            info->bIsLoaded = bSucceeded;
+        }
+        if (bSucceeded) {
+            startupOrder.Add(name);
+        }
+    }
+    moduleStateChanged.notify_all();
+    
+    if (bSucceeded) {
+        LOG("ModuleManager: Module " << name << " loaded successfully");
+    }
+    return bSucceeded;
+}
+
+bool FModuleManager::WouldDeadlockWaitingFor(const FName& name) const
+{
+    const std::thread::id thisThread = std::this_thread::get_id();
+    FName waitedFor = name;
+    // Follow starting thread -> module it waits for until the chain ends or comes back here.
+    // Every thread waits for at most one module, so the chain is at most one link per thread.
+    for (size_t hops = 0; hops <= startupWaits.Num(); ++hops) {
+        const FModuleInfo* info = modules.Find(waitedFor);
+        if (!info || !info->bIsStarting) {
+            return false;
+        }
+        if (info->StartingThread == thisThread) {
+            return true;
+        }
+        const FName* next = startupWaits.Find(info->StartingThread);
+        if (!next) {
+            return false;
+        }
+        waitedFor = *next;
+    }
+    return false;
 }
 
 void FModuleManager::UnloadModule(const FName& name)
 {
-    auto it = modules.find(name);
-    if (it != modules.end()) {
+    IModuleInterface* instance = nullptr;
+    FUniquePtr<IModuleInterface> owned;
+    {
+        std::lock_guard<std::mutex> lock(modulesMutex);
+        auto it = modules.find(name);
+        if (it == modules.end()) {
+            return;
+        }
         if (it->second.bIsLoaded) {
-            it->second.ModuleInstance->ShutdownModule();
-            it->second.bIsLoaded = false;
+            instance = it->second.ModuleInstance.get();
         }
+        owned = std::move(it->second.ModuleInstance);
         modules.erase(it);
+        startupOrder.Remove(name);
+    }
+    if (instance) {
+        instance->ShutdownModule();
     }
 }
 
@@ -89,35 +406,56 @@ void FModuleManager::ShutdownAll()
     LOG("ModuleManager: Shutting down all modules");
     
     // Shutdown in reverse order (game modules first, then engine modules)
-    TArray<FName> engineModules;
-    TArray<FName> gameModules;
-    TArray<FName> pluginModules;
-    TArray<FName> appModules;
+    TInlineArray<FName, 16> engineModules;
+    TInlineArray<FName, 16> gameModules;
+    TInlineArray<FName, 16> pluginModules;
+    TInlineArray<FName, 16> appModules;
+    
+    std::unique_lock<std::mutex> lock(modulesMutex);
+    
+    // Within each group, stop modules in reverse order of startup so dependents go before
+    // their dependencies (the order is not fixed when startup ran in parallel).
+    TArray<FName> order;
+    order.Reserve(modules.Num());
+    for (size_t i = startupOrder.Num(); i-- > 0;) {
+        order.Add(startupOrder[i]);
+    }
+    for (const auto& kv : modules) {
+        if (kv.second.bIsLoaded && !startupOrder.Contains(kv.first)) {
+            order.Add(kv.first);
+        }
+    }
     
-    for (auto& kv : modules) {
-        if (!kv.second.bIsLoaded) continue;
+    for (const FName& name : order) {
+        const FModuleInfo* info = modules.Find(name);
+        if (!info || !info->bIsLoaded) continue;
         
-        switch (kv.second.Descriptor.Type) {
+        switch (info->Descriptor.Type) {
             case EModuleType::Application:
-                appModules.Add(kv.first);
+                appModules.Add(name);
                 break;
             case EModuleType::Game:
-                gameModules.Add(kv.first);
+                gameModules.Add(name);
                 break;
             case EModuleType::Plugin:
-                pluginModules.Add(kv.first);
+                pluginModules.Add(name);
                 break;
             case EModuleType::Engine:
-                engineModules.Add(kv.first);
+                engineModules.Add(name);
                 break;
         }
     }
     
-    // Helper lambda to shutdown a list of modules
-    auto shutdownModules = [this](const TArray<FName>& moduleNames) {
+    // Helper lambda to shutdown a list of modules (the lock is released around each call)
+    auto shutdownModules = [this, &lock](const TInlineArray<FName, 16>& moduleNames) {
         for (const auto& name : moduleNames) {
-            modules[name].ModuleInstance->ShutdownModule();
-            modules[name].bIsLoaded = false;
+            FModuleInfo* info = modules.Find(name);
+            if (!info) continue;
+            IModuleInterface* instance = info->ModuleInstance.get();
+            info->bIsLoaded = false;
+            lock.unlock();
+            instance->ShutdownModule();
+            lock.lock();
         }
     };
     
@@ -128,6 +466,7 @@ void FModuleManager::ShutdownAll()
     shutdownModules(engineModules);
     
     modules.clear();
+    startupOrder.Reset();
 }
 
 void FModuleManager::DiscoverPlugins(const FString& pluginDirectory)
@@ -150,7 +489,7 @@ void FModuleManager::DiscoverPlugins(const FString& pluginDirectory)
                 FName potentialPluginName = entry.path().filename().string();
                 if (availablePlugins.find(potentialPluginName) == availablePlugins.end()) {
                     FPluginDescriptor desc(potentialPluginName);
-                    desc.FriendlyName = potentialPluginName;
+                    desc.FriendlyName = potentialPluginName.ToString();
                     availablePlugins[potentialPluginName] = desc;
                     LOG("ModuleManager: Discovered plugin " << potentialPluginName);
                 }
@@ -173,6 +512,7 @@ bool FModuleManager::LoadPlugin(const FName& pluginName)
     
     // Load all modules in the plugin
     TArray<FName> loadedModules;
+    loadedModules.Reserve(it->second.Modules.Num());
     for (const auto& moduleDesc : it->second.Modules) {
         if (LoadModule(moduleDesc.ModuleName)) {
             loadedModules.Add(moduleDesc.ModuleName);
@@ -212,6 +552,7 @@ void FModuleManager::UnloadPlugin(const FName& pluginName)
 TArray<FPluginDescriptor> FModuleManager::GetAvailablePlugins() const
 {
     TArray<FPluginDescriptor> result;
+    result.Reserve(availablePlugins.size());
     for (const auto& kv : availablePlugins) {
         result.Add(kv.second);
     }
@@ -221,6 +562,7 @@ TArray<FPluginDescriptor> FModuleManager::GetAvailablePlugins() const
 TArray<FName> FModuleManager::GetModulesByType(EModuleType type) const
 {
     TArray<FName> result;
+    std::lock_guard<std::mutex> lock(modulesMutex);
     for (const auto& kv : modules) {
         if (kv.second.Descriptor.Type == type) {
             result.Add(kv.first);
@@ -235,10 +577,11 @@ TArray<FName> FModuleManager::GetModulesByType(EModuleType type) const
 #pragma region Unvalidated
 
 // TODO : Not validated
-bool FModuleManager::LoadModuleDynamic(const FName& name)
+bool FModuleManager::LoadModuleDynamic(const FString& path)
 {
     // FString path = GetModuleDiskPath(name);
-    FString path = name; // For testing, assume name is full path
+    // For testing, assume the module name is the file name without extension
+    FName name = std::filesystem::path(path).stem().string();
 #ifdef _WIN32
     HMODULE lib = LoadLibraryA(path.c_str());
     if (!lib) { std::cerr << "LoadLibrary failed: " << path << "\n"; return false; }
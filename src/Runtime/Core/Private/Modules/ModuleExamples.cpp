@@ -200,6 +200,16 @@ void ExampleModuleUsage()
 class FAdvancedModule : public IModuleInterface
 {
 public:
+    // Declare dependencies so the module manager starts them first. Without bMainThreadOnly
+    // this module may be started on a worker thread, in parallel with unrelated modules.
+    // 声明依赖项，模块管理器会先启动它们。未设置 bMainThreadOnly 时，
+    // 该模块可能在工作线程上与无关模块并行启动。
+    virtual void GetModuleDescriptor(FModuleDescriptor& OutDescriptor) const override
+    {
+        OutDescriptor.Dependencies.Add("CoreEngine");
+        OutDescriptor.Dependencies.Add("RHI");
+    }
+
     virtual void StartupModule() override
     {
         LOG("AdvancedModule: Starting up");
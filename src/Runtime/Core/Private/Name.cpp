@@ -0,0 +1,238 @@
+#include "Misc/Name.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+// -- Name table ------------------------------------------------------------
+//
+// Names are sharded by a case-insensitive hash so both the exact-spelling map and the
+// case-folded map for a given name are guarded by the same shard lock. Entries are stored in
+// fixed-size blocks that never move, which makes index -> string resolution lock-free.
+
+namespace {
+
+constexpr uint32 NameShardBits = 4;
+constexpr uint32 NumNameShards = 1u << NameShardBits;
+constexpr uint32 NameBlockBits = 12;
+constexpr uint32 NameBlockSize = 1u << NameBlockBits;   // entries per block
+constexpr uint32 MaxNameBlocks = 1024;                    // 4M distinct spellings
+
+struct FNameEntry
+{
+	FString Display;
+	uint32 ComparisonIndex;
+};
+
+inline TCHAR FoldChar(TCHAR C)
+{
+	return static_cast<TCHAR>(std::tolower(static_cast<unsigned char>(C)));
+}
+
+// FNV-1a over the case-folded characters; picks the shard.
+inline uint32 HashFolded(const TCHAR* Str, size_t Len)
+{
+	uint32 Hash = 2166136261u;
+	for (size_t i = 0; i < Len; ++i) {
+		Hash ^= static_cast<unsigned char>(FoldChar(Str[i]));
+		Hash *= 16777619u;
+	}
+	return Hash;
+}
+
+class FNamePool
+{
+public:
+	static FNamePool& Get()
+	{
+		// Function-local static: FNames are created by static module registrants before main().
+		static FNamePool Pool;
+		return Pool;
+	}
+
+	FNamePool()
+	{
+		for (auto& Block : Blocks) {
+			Block.store(nullptr, std::memory_order_relaxed);
+		}
+		// Index 0 is NAME_None.
+		FNameEntry* None = AllocateEntry(FString());
+		None->ComparisonIndex = 0;
+	}
+
+	~FNamePool()
+	{
+		for (auto& Block : Blocks) {
+			FNameEntry* Entries = Block.load(std::memory_order_relaxed);
+			delete[] Entries;
+		}
+	}
+
+	void Intern(const TCHAR* Str, size_t Len, uint32& OutComparison, uint32& OutDisplay)
+	{
+		if (Len == 0) {
+			OutComparison = 0;
+			OutDisplay = 0;
+			return;
+		}
+
+		FShard& Shard = Shards[HashFolded(Str, Len) & (NumNameShards - 1)];
+		const std::string_view Exact(Str, Len);
+
+		std::lock_guard<std::mutex> Lock(Shard.Mutex);
+
+		// Fast path: already interned. The lookup hashes the characters in place, no FString is built.
+		if (const uint32* Existing = Shard.ExactToIndex.Find(Exact)) {
+			OutDisplay = *Existing;
+			OutComparison = Resolve(OutDisplay).ComparisonIndex;
+			return;
+		}
+
+		FString Folded(Exact);
+		for (TCHAR& C : Folded) C = FoldChar(C);
+
+		uint32 Index = 0;
+		FNameEntry* Entry = AllocateEntry(FString(Exact), &Index);
+
+		if (const uint32* FoldedIndex = Shard.FoldedToIndex.Find(Folded)) {
+			Entry->ComparisonIndex = *FoldedIndex;
+		} else {
+			Entry->ComparisonIndex = Index;
+			Shard.FoldedToIndex.emplace(std::move(Folded), Index);
+		}
+		// Publish only after the entry is fully written; readers get the index through this map.
+		Shard.ExactToIndex.Add(FString(Exact), Index);
+
+		OutComparison = Entry->ComparisonIndex;
+		OutDisplay = Index;
+	}
+
+	bool Find(const TCHAR* Str, size_t Len, uint32& OutComparison, uint32& OutDisplay)
+	{
+		OutComparison = 0;
+		OutDisplay = 0;
+		if (Len == 0) return true;
+
+		FShard& Shard = Shards[HashFolded(Str, Len) & (NumNameShards - 1)];
+		const std::string_view Exact(Str, Len);
+
+		std::lock_guard<std::mutex> Lock(Shard.Mutex);
+		if (const uint32* Existing = Shard.ExactToIndex.Find(Exact)) {
+			OutDisplay = *Existing;
+			OutComparison = Resolve(OutDisplay).ComparisonIndex;
+			return true;
+		}
+
+		// Fold into a stack buffer so a lookup miss never allocates for typical name lengths
+		TInlineArray<TCHAR, 128> Folded;
+		Folded.SetNum(Len);
+		for (size_t i = 0; i < Len; ++i) Folded[i] = FoldChar(Str[i]);
+		if (const uint32* FoldedIndex = Shard.FoldedToIndex.Find(std::string_view(Folded.GetData(), Len))) {
+			OutComparison = *FoldedIndex;
+			OutDisplay = *FoldedIndex;
+			return true;
+		}
+		return false;
+	}
+
+	const FNameEntry& Resolve(uint32 Index) const
+	{
+		const FNameEntry* Block = Blocks[Index >> NameBlockBits].load(std::memory_order_acquire);
+		return Block[Index & (NameBlockSize - 1)];
+	}
+
+	uint32 Num() const { return NumEntries.load(std::memory_order_acquire); }
+
+private:
+	struct FShard
+	{
+		std::mutex Mutex;
+		FMap<FString, uint32> ExactToIndex;
+		FMap<FString, uint32> FoldedToIndex;
+	};
+
+	FNameEntry* AllocateEntry(const FString& Display, uint32* OutIndex = nullptr)
+	{
+		const uint32 Index = NumEntries.fetch_add(1, std::memory_order_acq_rel);
+		const uint32 BlockIndex = Index >> NameBlockBits;
+		if (BlockIndex >= MaxNameBlocks) {
+			throw std::runtime_error("FName table exhausted");
+		}
+
+		FNameEntry* Block = Blocks[BlockIndex].load(std::memory_order_acquire);
+		if (!Block) {
+			FNameEntry* NewBlock = new FNameEntry[NameBlockSize];
+			if (Blocks[BlockIndex].compare_exchange_strong(Block, NewBlock, std::memory_order_acq_rel)) {
+				Block = NewBlock;
+			} else {
+				delete[] NewBlock; // another shard won the race; Block now holds its pointer
+			}
+		}
+
+		FNameEntry& Entry = Block[Index & (NameBlockSize - 1)];
+		Entry.Display = Display;
+		if (OutIndex) *OutIndex = Index;
+		return &Entry;
+	}
+
+	FShard Shards[NumNameShards];
+	std::atomic<FNameEntry*> Blocks[MaxNameBlocks];
+	std::atomic<uint32> NumEntries{0};
+};
+
+} // namespace
+
+// -- FName -----------------------------------------------------------------
+
+void FName::Init(const TCHAR* InName, size_t InLen)
+{
+	FNamePool::Get().Intern(InName, InLen, ComparisonIndex, DisplayIndex);
+}
+
+const FString& FName::ToString() const
+{
+	return FNamePool::Get().Resolve(DisplayIndex).Display;
+}
+
+bool FName::operator==(const TCHAR* Other) const
+{
+	const FString& Self = ToString();
+	if (!Other) return Self.empty();
+	size_t i = 0;
+	for (; i < Self.size(); ++i) {
+		if (Other[i] == 0 || FoldChar(Self[i]) != FoldChar(Other[i])) return false;
+	}
+	return Other[i] == 0;
+}
+
+bool FName::LexicalLess(const FName& A, const FName& B)
+{
+	const FString& SA = A.ToString();
+	const FString& SB = B.ToString();
+	const size_t N = std::min(SA.size(), SB.size());
+	for (size_t i = 0; i < N; ++i) {
+		const TCHAR CA = FoldChar(SA[i]);
+		const TCHAR CB = FoldChar(SB[i]);
+		if (CA != CB) return CA < CB;
+	}
+	return SA.size() < SB.size();
+}
+
+FName FName::Find(const TCHAR* InName)
+{
+	FName Result;
+	if (!InName) return Result;
+	if (!FNamePool::Get().Find(InName, std::char_traits<TCHAR>::length(InName), Result.ComparisonIndex, Result.DisplayIndex)) {
+		return FName();
+	}
+	return Result;
+}
+
+uint32 FName::GetNumNames()
+{
+	return FNamePool::Get().Num();
+}
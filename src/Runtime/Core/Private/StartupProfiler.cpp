@@ -0,0 +1,231 @@
+#include "Misc/StartupProfiler.h"
+#include "Misc/Path.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+static FStartupProfiler::FClock::time_point GetProcessStartTime()
+{
+	static const FStartupProfiler::FClock::time_point StartTime = FStartupProfiler::FClock::now();
+	return StartTime;
+}
+
+// Capture the origin while the Core module is being loaded, not on the first profiled scope.
+static const FStartupProfiler::FClock::time_point GProcessStartTime = GetProcessStartTime();
+
+FStartupProfiler& FStartupProfiler::Get()
+{
+	static FStartupProfiler Instance(GetProcessStartTime());
+	return Instance;
+}
+
+FStartupProfiler::FStartupProfiler()
+	: FStartupProfiler(FClock::now())
+{
+}
+
+FStartupProfiler::FStartupProfiler(FClock::time_point InOrigin)
+	: Origin(InOrigin)
+{
+	Threads.Add(std::this_thread::get_id());
+}
+
+double FStartupProfiler::ToMs(FClock::time_point Time) const
+{
+	return std::chrono::duration<double, std::milli>(Time - Origin).count();
+}
+
+uint32 FStartupProfiler::GetThreadIndexLocked(std::thread::id Id)
+{
+	auto Index = Threads.Find(Id);
+	if (Index == INDEX_NONE) {
+		Index = Threads.Add(Id);
+	}
+	return static_cast<uint32>(Index);
+}
+
+void FStartupProfiler::AddEvent(const FString& Category, const FString& Name, FClock::time_point Start, FClock::time_point End)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+	if (TimeToFirstFrameMs >= 0.0) {
+		return;
+	}
+
+	FEvent& Event = Events.EmplaceGetRef();
+	Event.Category = Category;
+	Event.Name = Name;
+	Event.StartMs = ToMs(Start);
+	Event.DurationMs = std::chrono::duration<double, std::milli>(End - Start).count();
+	Event.ThreadIndex = GetThreadIndexLocked(std::this_thread::get_id());
+}
+
+void FStartupProfiler::MarkFirstFrame()
+{
+	MarkFirstFrame(FClock::now());
+}
+
+void FStartupProfiler::MarkFirstFrame(FClock::time_point When)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+	if (TimeToFirstFrameMs < 0.0) {
+		TimeToFirstFrameMs = ToMs(When);
+	}
+}
+
+bool FStartupProfiler::HasFirstFrame() const
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+	return TimeToFirstFrameMs >= 0.0;
+}
+
+double FStartupProfiler::GetTimeToFirstFrameMs() const
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+	return TimeToFirstFrameMs;
+}
+
+double FStartupProfiler::GetElapsedMs() const
+{
+	return ToMs(FClock::now());
+}
+
+TArray<FStartupProfiler::FEvent> FStartupProfiler::GetEvents() const
+{
+	TArray<FEvent> Result;
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		Result = Events;
+	}
+	Result.Sort([](const FEvent& A, const FEvent& B) { return A.StartMs < B.StartMs; });
+	return Result;
+}
+
+double FStartupProfiler::GetCategoryTotalMs(const FString& Category) const
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+	double Total = 0.0;
+	for (const FEvent& Event : Events) {
+		if (Event.Category == Category) {
+			Total += Event.DurationMs;
+		}
+	}
+	return Total;
+}
+
+void FStartupProfiler::PrintReport(std::ostream& Out) const
+{
+	const TArray<FEvent> Snapshot = GetEvents();
+	const double FirstFrameMs = GetTimeToFirstFrameMs();
+
+	// Category totals, in order of first appearance
+	TArray<FString> Categories;
+	for (const FEvent& Event : Snapshot) {
+		Categories.AddUnique(Event.Category);
+	}
+
+	const std::ios::fmtflags OldFlags = Out.flags();
+	const std::streamsize OldPrecision = Out.precision();
+	Out << std::fixed << std::setprecision(2);
+
+	Out << "==== Startup Report ====" << std::endl;
+	if (FirstFrameMs >= 0.0) {
+		Out << "Time to first frame: " << FirstFrameMs << " ms" << std::endl;
+	} else {
+		Out << "Time to first frame: (not reached, " << GetElapsedMs() << " ms elapsed)" << std::endl;
+	}
+
+	for (const FString& Category : Categories) {
+		Out << "-- " << Category << " (" << GetCategoryTotalMs(Category) << " ms total)" << std::endl;
+		for (const FEvent& Event : Snapshot) {
+			if (Event.Category != Category) continue;
+			Out << "   " << std::setw(9) << Event.DurationMs << " ms  @" << std::setw(9) << Event.StartMs
+				<< " ms  [T" << Event.ThreadIndex << "] " << Event.Name << std::endl;
+		}
+	}
+	Out << "========================" << std::endl;
+
+	Out.flags(OldFlags);
+	Out.precision(OldPrecision);
+}
+
+static void WriteJsonString(std::ostream& Out, const FString& Value)
+{
+	Out << '"';
+	for (const char C : Value) {
+		switch (C) {
+		case '"':  Out << "\\\""; break;
+		case '\\': Out << "\\\\"; break;
+		case '\n': Out << "\\n"; break;
+		case '\r': Out << "\\r"; break;
+		case '\t': Out << "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(C) < 0x20) {
+				char Buffer[8];
+				std::snprintf(Buffer, sizeof(Buffer), "\\u%04x", static_cast<unsigned>(C));
+				Out << Buffer;
+			} else {
+				Out << C;
+			}
+		}
+	}
+	Out << '"';
+}
+
+bool FStartupProfiler::WriteTrace(const FString& Filename) const
+{
+	std::error_code Ec;
+	const std::filesystem::path TracePath(Filename);
+	if (TracePath.has_parent_path()) {
+		std::filesystem::create_directories(TracePath.parent_path(), Ec);
+	}
+
+	std::ofstream File(Filename, std::ios::out | std::ios::trunc);
+	if (!File) {
+		LOG("FStartupProfiler: Failed to open trace file " << Filename);
+		return false;
+	}
+
+	const TArray<FEvent> Snapshot = GetEvents();
+	const double FirstFrameMs = GetTimeToFirstFrameMs();
+
+	// Trace event timestamps are in microseconds
+	File << std::fixed << std::setprecision(3);
+	File << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	File << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Main\"}}";
+	for (const FEvent& Event : Snapshot) {
+		File << ",\n{\"name\":";
+		WriteJsonString(File, Event.Name);
+		File << ",\"cat\":";
+		WriteJsonString(File, Event.Category);
+		File << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << Event.ThreadIndex
+			<< ",\"ts\":" << Event.StartMs * 1000.0 << ",\"dur\":" << Event.DurationMs * 1000.0 << "}";
+	}
+	if (FirstFrameMs >= 0.0) {
+		File << ",\n{\"name\":\"FirstFrame\",\"cat\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":"
+			<< FirstFrameMs * 1000.0 << "}";
+	}
+	File << "\n]}\n";
+
+	return static_cast<bool>(File);
+}
+
+FString FStartupProfiler::GetDefaultTracePath()
+{
+	return CarrotToy::Path::ProjectDir() + "/Saved/Profiling/StartupTrace.json";
+}
+
+FStartupScope::FStartupScope(const TCHAR* InCategory, FString InName, FStartupProfiler& InProfiler)
+	: Profiler(InProfiler)
+	, Category(InCategory)
+	, Name(std::move(InName))
+	, Start(FStartupProfiler::FClock::now())
+{
+}
+
+FStartupScope::~FStartupScope()
+{
+	Profiler.AddEvent(Category, Name, Start, FStartupProfiler::FClock::now());
+}
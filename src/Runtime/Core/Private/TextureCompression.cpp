@@ -0,0 +1,558 @@
+#include "Image/TextureCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+
+using FBlock = uint8_t[16][4];
+
+void FetchBlock(const uint8_t* Rgba, uint32 Width, uint32 Height, uint32 BlockX, uint32 BlockY, FBlock& Out)
+{
+	for (uint32 Y = 0; Y < 4; ++Y) {
+		const uint32 SrcY = std::min(BlockY * 4 + Y, Height - 1);
+		for (uint32 X = 0; X < 4; ++X) {
+			const uint32 SrcX = std::min(BlockX * 4 + X, Width - 1);
+			memcpy(Out[Y * 4 + X], Rgba + (size_t(SrcY) * Width + SrcX) * 4, 4);
+		}
+	}
+}
+
+void StoreBlock(const FBlock& Block, uint32 Width, uint32 Height, uint32 BlockX, uint32 BlockY, uint8_t* Rgba)
+{
+	for (uint32 Y = 0; Y < 4 && BlockY * 4 + Y < Height; ++Y) {
+		for (uint32 X = 0; X < 4 && BlockX * 4 + X < Width; ++X) {
+			memcpy(Rgba + (size_t(BlockY * 4 + Y) * Width + BlockX * 4 + X) * 4, Block[Y * 4 + X], 4);
+		}
+	}
+}
+
+/** Principal axis of the first Channels channels of the block (power iteration on the covariance) */
+void FitAxis(const FBlock& Block, int32 Channels, float Mean[4], float Axis[4])
+{
+	for (int32 C = 0; C < 4; ++C) {
+		Mean[C] = 0.0f;
+		Axis[C] = 0.0f;
+	}
+	for (int32 I = 0; I < 16; ++I) {
+		for (int32 C = 0; C < Channels; ++C) {
+			Mean[C] += Block[I][C] / 16.0f;
+		}
+	}
+
+	float Cov[4][4] = {};
+	for (int32 I = 0; I < 16; ++I) {
+		for (int32 A = 0; A < Channels; ++A) {
+			for (int32 B = 0; B < Channels; ++B) {
+				Cov[A][B] += (Block[I][A] - Mean[A]) * (Block[I][B] - Mean[B]);
+			}
+		}
+	}
+
+	for (int32 C = 0; C < Channels; ++C) {
+		Axis[C] = 1.0f;
+	}
+	for (int32 Iteration = 0; Iteration < 8; ++Iteration) {
+		float Next[4] = {};
+		float Length = 0.0f;
+		for (int32 A = 0; A < Channels; ++A) {
+			for (int32 B = 0; B < Channels; ++B) {
+				Next[A] += Cov[A][B] * Axis[B];
+			}
+			Length = std::max(Length, std::fabs(Next[A]));
+		}
+		if (Length <= 0.0f) break;
+		for (int32 C = 0; C < Channels; ++C) {
+			Axis[C] = Next[C] / Length;
+		}
+	}
+}
+
+/** Block extremes along the principal axis */
+void FitEndpoints(const FBlock& Block, int32 Channels, float Low[4], float High[4])
+{
+	float Mean[4], Axis[4];
+	FitAxis(Block, Channels, Mean, Axis);
+
+	float MinT = 0.0f, MaxT = 0.0f;
+	float AxisLengthSq = 0.0f;
+	for (int32 C = 0; C < Channels; ++C) {
+		AxisLengthSq += Axis[C] * Axis[C];
+	}
+	if (AxisLengthSq > 0.0f) {
+		MinT = MaxT = 0.0f;
+		for (int32 I = 0; I < 16; ++I) {
+			float T = 0.0f;
+			for (int32 C = 0; C < Channels; ++C) {
+				T += (Block[I][C] - Mean[C]) * Axis[C];
+			}
+			T /= AxisLengthSq;
+			MinT = std::min(MinT, T);
+			MaxT = std::max(MaxT, T);
+		}
+	}
+	for (int32 C = 0; C < 4; ++C) {
+		Low[C] = std::clamp(Mean[C] + Axis[C] * MinT, 0.0f, 255.0f);
+		High[C] = std::clamp(Mean[C] + Axis[C] * MaxT, 0.0f, 255.0f);
+	}
+}
+
+int32 ColorDistanceSq(const uint8_t* A, const int32* B, int32 Channels)
+{
+	int32 Sum = 0;
+	for (int32 C = 0; C < Channels; ++C) {
+		const int32 D = int32(A[C]) - B[C];
+		Sum += D * D;
+	}
+	return Sum;
+}
+
+// -- BC1 -------------------------------------------------------------------
+
+uint16_t PackRgb565(const float Color[3])
+{
+	const uint16_t R = uint16_t(std::lround(Color[0] * 31.0f / 255.0f));
+	const uint16_t G = uint16_t(std::lround(Color[1] * 63.0f / 255.0f));
+	const uint16_t B = uint16_t(std::lround(Color[2] * 31.0f / 255.0f));
+	return uint16_t((R << 11) | (G << 5) | B);
+}
+
+void UnpackRgb565(uint16_t Packed, int32 Out[3])
+{
+	const int32 R = (Packed >> 11) & 31, G = (Packed >> 5) & 63, B = Packed & 31;
+	Out[0] = (R << 3) | (R >> 2);
+	Out[1] = (G << 2) | (G >> 4);
+	Out[2] = (B << 3) | (B >> 2);
+}
+
+void Bc1Palette(uint16_t Color0, uint16_t Color1, bool bFourColor, int32 Palette[4][3])
+{
+	UnpackRgb565(Color0, Palette[0]);
+	UnpackRgb565(Color1, Palette[1]);
+	for (int32 C = 0; C < 3; ++C) {
+		if (bFourColor) {
+			Palette[2][C] = (2 * Palette[0][C] + Palette[1][C]) / 3;
+			Palette[3][C] = (Palette[0][C] + 2 * Palette[1][C]) / 3;
+		} else {
+			Palette[2][C] = (Palette[0][C] + Palette[1][C]) / 2;
+			Palette[3][C] = 0;
+		}
+	}
+}
+
+/** Closest of the four (interpolated) colors per texel; returns the total squared error */
+int32 Bc1SelectIndices(const FBlock& Block, uint16_t Color0, uint16_t Color1, uint8_t Indices[16])
+{
+	int32 Palette[4][3];
+	Bc1Palette(Color0, Color1, true, Palette);
+	int32 Error = 0;
+	for (int32 I = 0; I < 16; ++I) {
+		int32 Best = 0, BestError = INT32_MAX;
+		for (int32 P = 0; P < 4; ++P) {
+			const int32 E = ColorDistanceSq(Block[I], Palette[P], 3);
+			if (E < BestError) {
+				Best = P;
+				BestError = E;
+			}
+		}
+		Indices[I] = uint8_t(Best);
+		Error += BestError;
+	}
+	return Error;
+}
+
+/** Least-squares endpoints for fixed indices; false if the indices do not constrain them */
+bool Bc1RefitEndpoints(const FBlock& Block, const uint8_t Indices[16], float High[3], float Low[3])
+{
+	static const float Weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+	float AA = 0, BB = 0, AB = 0, AX[3] = {}, BX[3] = {};
+	for (int32 I = 0; I < 16; ++I) {
+		const float A = Weights[Indices[I]], B = 1.0f - A;
+		AA += A * A;
+		BB += B * B;
+		AB += A * B;
+		for (int32 C = 0; C < 3; ++C) {
+			AX[C] += A * Block[I][C];
+			BX[C] += B * Block[I][C];
+		}
+	}
+	const float Det = AA * BB - AB * AB;
+	if (std::fabs(Det) < 1e-6f) return false;
+	for (int32 C = 0; C < 3; ++C) {
+		High[C] = std::clamp((AX[C] * BB - BX[C] * AB) / Det, 0.0f, 255.0f);
+		Low[C] = std::clamp((BX[C] * AA - AX[C] * AB) / Det, 0.0f, 255.0f);
+	}
+	return true;
+}
+
+void WriteBc1Indices(uint8_t* Out, uint16_t Color0, uint16_t Color1, const uint8_t Indices[16])
+{
+	uint32 Bits = 0;
+	for (int32 I = 0; I < 16; ++I) {
+		Bits |= uint32(Indices[I]) << (I * 2);
+	}
+	Out[0] = uint8_t(Color0);
+	Out[1] = uint8_t(Color0 >> 8);
+	Out[2] = uint8_t(Color1);
+	Out[3] = uint8_t(Color1 >> 8);
+	memcpy(Out + 4, &Bits, 4);
+}
+
+void EncodeBc1(const FBlock& Block, uint8_t* Out)
+{
+	float Low[4], High[4];
+	FitEndpoints(Block, 3, Low, High);
+
+	uint16_t Color0 = PackRgb565(High), Color1 = PackRgb565(Low);
+	uint8_t Indices[16];
+	int32 Error = Bc1SelectIndices(Block, Color0, Color1, Indices);
+
+	float RefitHigh[3], RefitLow[3];
+	if (Bc1RefitEndpoints(Block, Indices, RefitHigh, RefitLow)) {
+		const uint16_t RefitColor0 = PackRgb565(RefitHigh), RefitColor1 = PackRgb565(RefitLow);
+		uint8_t RefitIndices[16];
+		const int32 RefitError = Bc1SelectIndices(Block, RefitColor0, RefitColor1, RefitIndices);
+		if (RefitError < Error) {
+			Color0 = RefitColor0;
+			Color1 = RefitColor1;
+			memcpy(Indices, RefitIndices, 16);
+		}
+	}
+
+	// Four-color mode needs Color0 > Color1; swapping the endpoints mirrors the indices
+	if (Color0 < Color1) {
+		std::swap(Color0, Color1);
+		for (uint8_t& Index : Indices) {
+			Index ^= 1;
+		}
+	} else if (Color0 == Color1) {
+		memset(Indices, 0, 16);
+	}
+	WriteBc1Indices(Out, Color0, Color1, Indices);
+}
+
+void DecodeBc1(const uint8_t* In, FBlock& Block, bool bAlwaysFourColor)
+{
+	const uint16_t Color0 = uint16_t(In[0] | (In[1] << 8));
+	const uint16_t Color1 = uint16_t(In[2] | (In[3] << 8));
+	uint32 Bits;
+	memcpy(&Bits, In + 4, 4);
+
+	const bool bFourColor = bAlwaysFourColor || Color0 > Color1;
+	int32 Palette[4][3];
+	Bc1Palette(Color0, Color1, bFourColor, Palette);
+	for (int32 I = 0; I < 16; ++I) {
+		const uint32 Index = (Bits >> (I * 2)) & 3;
+		for (int32 C = 0; C < 3; ++C) {
+			Block[I][C] = uint8_t(Palette[Index][C]);
+		}
+		Block[I][3] = (!bFourColor && Index == 3) ? 0 : 255;
+	}
+}
+
+// -- BC4 (one channel; BC3 alpha, BC5 red and green) -----------------------
+
+void Bc4Palette(uint8_t Value0, uint8_t Value1, int32 Palette[8])
+{
+	Palette[0] = Value0;
+	Palette[1] = Value1;
+	if (Value0 > Value1) {
+		for (int32 I = 2; I < 8; ++I) {
+			Palette[I] = ((8 - I) * Value0 + (I - 1) * Value1) / 7;
+		}
+	} else {
+		for (int32 I = 2; I < 6; ++I) {
+			Palette[I] = ((6 - I) * Value0 + (I - 1) * Value1) / 5;
+		}
+		Palette[6] = 0;
+		Palette[7] = 255;
+	}
+}
+
+void EncodeBc4(const FBlock& Block, int32 Channel, uint8_t* Out)
+{
+	uint8_t Low = 255, High = 0;
+	for (int32 I = 0; I < 16; ++I) {
+		Low = std::min(Low, Block[I][Channel]);
+		High = std::max(High, Block[I][Channel]);
+	}
+
+	int32 Palette[8];
+	Bc4Palette(High, Low, Palette);
+	uint64 Bits = 0;
+	for (int32 I = 0; I < 16; ++I) {
+		int32 Best = 0, BestError = INT32_MAX;
+		for (int32 P = 0; P < 8; ++P) {
+			const int32 E = std::abs(int32(Block[I][Channel]) - Palette[P]);
+			if (E < BestError) {
+				Best = P;
+				BestError = E;
+			}
+		}
+		Bits |= uint64(Best) << (I * 3);
+	}
+	Out[0] = High;
+	Out[1] = Low;
+	for (int32 Byte = 0; Byte < 6; ++Byte) {
+		Out[2 + Byte] = uint8_t(Bits >> (Byte * 8));
+	}
+}
+
+void DecodeBc4(const uint8_t* In, int32 Channel, FBlock& Block)
+{
+	int32 Palette[8];
+	Bc4Palette(In[0], In[1], Palette);
+	uint64 Bits = 0;
+	for (int32 Byte = 0; Byte < 6; ++Byte) {
+		Bits |= uint64(In[2 + Byte]) << (Byte * 8);
+	}
+	for (int32 I = 0; I < 16; ++I) {
+		Block[I][Channel] = uint8_t(Palette[(Bits >> (I * 3)) & 7]);
+	}
+}
+
+// -- BC7 mode 6 ------------------------------------------------------------
+
+const int32 Bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+struct FBitWriter
+{
+	uint8_t* Out;
+	uint32 Position = 0;
+
+	void Write(uint32 Value, uint32 Count)
+	{
+		for (uint32 Bit = 0; Bit < Count; ++Bit, ++Position) {
+			if (Value & (1u << Bit)) {
+				Out[Position / 8] |= uint8_t(1u << (Position % 8));
+			}
+		}
+	}
+};
+
+struct FBitReader
+{
+	const uint8_t* In;
+	uint32 Position = 0;
+
+	uint32 Read(uint32 Count)
+	{
+		uint32 Value = 0;
+		for (uint32 Bit = 0; Bit < Count; ++Bit, ++Position) {
+			Value |= uint32((In[Position / 8] >> (Position % 8)) & 1) << Bit;
+		}
+		return Value;
+	}
+};
+
+/** 7-bit endpoint plus a shared p-bit, choosing the p-bit with the smaller error */
+void QuantizeBc7Endpoint(const float Color[4], uint32 Quantized[4], uint32& PBit)
+{
+	float BestError = -1.0f;
+	for (uint32 P = 0; P < 2; ++P) {
+		uint32 Candidate[4];
+		float Error = 0.0f;
+		for (int32 C = 0; C < 4; ++C) {
+			const float Q = std::clamp(std::round((Color[C] - P) / 2.0f), 0.0f, 127.0f);
+			Candidate[C] = uint32(Q);
+			const float D = Color[C] - float(Candidate[C] * 2 + P);
+			Error += D * D;
+		}
+		if (BestError < 0.0f || Error < BestError) {
+			BestError = Error;
+			PBit = P;
+			memcpy(Quantized, Candidate, sizeof(Candidate));
+		}
+	}
+}
+
+void EncodeBc7(const FBlock& Block, uint8_t* Out)
+{
+	float Low[4], High[4];
+	FitEndpoints(Block, 4, Low, High);
+
+	uint32 Endpoint[2][4], PBits[2];
+	QuantizeBc7Endpoint(Low, Endpoint[0], PBits[0]);
+	QuantizeBc7Endpoint(High, Endpoint[1], PBits[1]);
+
+	int32 Colors[2][4], Palette[16][4];
+	for (int32 E = 0; E < 2; ++E) {
+		for (int32 C = 0; C < 4; ++C) {
+			Colors[E][C] = int32(Endpoint[E][C] * 2 + PBits[E]);
+		}
+	}
+	for (int32 P = 0; P < 16; ++P) {
+		for (int32 C = 0; C < 4; ++C) {
+			Palette[P][C] = ((64 - Bc7Weights4[P]) * Colors[0][C] + Bc7Weights4[P] * Colors[1][C] + 32) >> 6;
+		}
+	}
+
+	uint8_t Indices[16];
+	for (int32 I = 0; I < 16; ++I) {
+		int32 Best = 0, BestError = INT32_MAX;
+		for (int32 P = 0; P < 16; ++P) {
+			const int32 E = ColorDistanceSq(Block[I], Palette[P], 4);
+			if (E < BestError) {
+				Best = P;
+				BestError = E;
+			}
+		}
+		Indices[I] = uint8_t(Best);
+	}
+
+	// The first texel's index is stored without its top bit, which must therefore be 0
+	if (Indices[0] & 8) {
+		std::swap(Endpoint[0], Endpoint[1]);
+		std::swap(PBits[0], PBits[1]);
+		for (uint8_t& Index : Indices) {
+			Index = uint8_t(15 - Index);
+		}
+	}
+
+	memset(Out, 0, 16);
+	FBitWriter Writer{ Out };
+	Writer.Write(1u << 6, 7);
+	for (int32 C = 0; C < 4; ++C) {
+		Writer.Write(Endpoint[0][C], 7);
+		Writer.Write(Endpoint[1][C], 7);
+	}
+	Writer.Write(PBits[0], 1);
+	Writer.Write(PBits[1], 1);
+	for (int32 I = 0; I < 16; ++I) {
+		Writer.Write(Indices[I], I == 0 ? 3 : 4);
+	}
+}
+
+void DecodeBc7(const uint8_t* In, FBlock& Block)
+{
+	FBitReader Reader{ In };
+	if (Reader.Read(7) != (1u << 6)) {
+		for (int32 I = 0; I < 16; ++I) {
+			Block[I][0] = 255;
+			Block[I][1] = 0;
+			Block[I][2] = 255;
+			Block[I][3] = 255;
+		}
+		return;
+	}
+
+	uint32 Endpoint[2][4];
+	for (int32 C = 0; C < 4; ++C) {
+		Endpoint[0][C] = Reader.Read(7);
+		Endpoint[1][C] = Reader.Read(7);
+	}
+	const uint32 PBit0 = Reader.Read(1), PBit1 = Reader.Read(1);
+	for (int32 C = 0; C < 4; ++C) {
+		Endpoint[0][C] = Endpoint[0][C] * 2 + PBit0;
+		Endpoint[1][C] = Endpoint[1][C] * 2 + PBit1;
+	}
+	for (int32 I = 0; I < 16; ++I) {
+		const int32 Weight = Bc7Weights4[Reader.Read(I == 0 ? 3 : 4)];
+		for (int32 C = 0; C < 4; ++C) {
+			Block[I][C] = uint8_t(((64 - Weight) * int32(Endpoint[0][C]) + Weight * int32(Endpoint[1][C]) + 32) >> 6);
+		}
+	}
+}
+
+} // namespace
+
+uint32 FTextureCompression::GetBlockBytes(EBlockCompression Format)
+{
+	return Format == EBlockCompression::BC1 ? 8 : 16;
+}
+
+size_t FTextureCompression::GetCompressedSize(EBlockCompression Format, uint32 Width, uint32 Height)
+{
+	return size_t((Width + 3) / 4) * ((Height + 3) / 4) * GetBlockBytes(Format);
+}
+
+TArray<uint8_t> FTextureCompression::Compress(EBlockCompression Format, const uint8_t* Rgba, uint32 Width, uint32 Height)
+{
+	TArray<uint8_t> Blocks;
+	if (!Rgba || Width == 0 || Height == 0) return Blocks;
+	Blocks.SetNum(GetCompressedSize(Format, Width, Height));
+
+	const uint32 BlockBytes = GetBlockBytes(Format);
+	uint8_t* Out = Blocks.GetData();
+	FBlock Block;
+	for (uint32 BlockY = 0; BlockY < (Height + 3) / 4; ++BlockY) {
+		for (uint32 BlockX = 0; BlockX < (Width + 3) / 4; ++BlockX, Out += BlockBytes) {
+			FetchBlock(Rgba, Width, Height, BlockX, BlockY, Block);
+			switch (Format) {
+			case EBlockCompression::BC1:
+				EncodeBc1(Block, Out);
+				break;
+			case EBlockCompression::BC3:
+				EncodeBc4(Block, 3, Out);
+				EncodeBc1(Block, Out + 8);
+				break;
+			case EBlockCompression::BC5:
+				EncodeBc4(Block, 0, Out);
+				EncodeBc4(Block, 1, Out + 8);
+				break;
+			case EBlockCompression::BC7:
+				EncodeBc7(Block, Out);
+				break;
+			}
+		}
+	}
+	return Blocks;
+}
+
+TArray<uint8_t> FTextureCompression::Decompress(EBlockCompression Format, const uint8_t* Blocks, uint32 Width, uint32 Height)
+{
+	TArray<uint8_t> Rgba;
+	if (!Blocks || Width == 0 || Height == 0) return Rgba;
+	Rgba.SetNum(size_t(Width) * Height * 4);
+
+	const uint32 BlockBytes = GetBlockBytes(Format);
+	const uint8_t* In = Blocks;
+	FBlock Block;
+	for (uint32 BlockY = 0; BlockY < (Height + 3) / 4; ++BlockY) {
+		for (uint32 BlockX = 0; BlockX < (Width + 3) / 4; ++BlockX, In += BlockBytes) {
+			switch (Format) {
+			case EBlockCompression::BC1:
+				DecodeBc1(In, Block, false);
+				break;
+			case EBlockCompression::BC3:
+				DecodeBc1(In + 8, Block, true);
+				DecodeBc4(In, 3, Block);
+				break;
+			case EBlockCompression::BC5:
+				for (int32 I = 0; I < 16; ++I) {
+					Block[I][2] = 0;
+					Block[I][3] = 255;
+				}
+				DecodeBc4(In, 0, Block);
+				DecodeBc4(In + 8, 1, Block);
+				break;
+			case EBlockCompression::BC7:
+				DecodeBc7(In, Block);
+				break;
+			}
+			StoreBlock(Block, Width, Height, BlockX, BlockY, Rgba.GetData());
+		}
+	}
+	return Rgba;
+}
+
+TArray<uint8_t> FTextureCompression::DownsampleRGBA8(const uint8_t* Rgba, uint32 Width, uint32 Height)
+{
+	const uint32 OutWidth = std::max(1u, Width / 2), OutHeight = std::max(1u, Height / 2);
+	TArray<uint8_t> Out;
+	Out.SetNum(size_t(OutWidth) * OutHeight * 4);
+	for (uint32 Y = 0; Y < OutHeight; ++Y) {
+		const uint32 Y0 = std::min(Y * 2, Height - 1), Y1 = std::min(Y * 2 + 1, Height - 1);
+		for (uint32 X = 0; X < OutWidth; ++X) {
+			const uint32 X0 = std::min(X * 2, Width - 1), X1 = std::min(X * 2 + 1, Width - 1);
+			for (uint32 C = 0; C < 4; ++C) {
+				const uint32 Sum = Rgba[(size_t(Y0) * Width + X0) * 4 + C] + Rgba[(size_t(Y0) * Width + X1) * 4 + C]
+					+ Rgba[(size_t(Y1) * Width + X0) * 4 + C] + Rgba[(size_t(Y1) * Width + X1) * 4 + C];
+				Out[(size_t(Y) * OutWidth + X) * 4 + C] = uint8_t((Sum + 2) / 4);
+			}
+		}
+	}
+	return Out;
+}
@@ -0,0 +1,522 @@
+#pragma once
+
+#include "CoreUtils.h"
+#include "Containers/ContainerAllocators.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+/** Returned by TArray::Find and friends when no element matches. */
+constexpr size_t INDEX_NONE = static_cast<size_t>(-1);
+
+/**
+ * TArray - contiguous dynamic array
+ *
+ * Differences from std::vector that matter for engine code:
+ *  - AllocatorType controls where memory comes from (heap, arena, ...) and how many
+ *    elements are stored inline: TArray<FName, TInlineAllocator<8>> never touches the heap
+ *    for up to 8 names.
+ *  - RemoveAtSwap/RemoveSwap remove in O(1) when order does not matter.
+ *  - Trivially copyable element types are relocated with memcpy on growth.
+ *
+ * Iterators are raw pointers and are invalidated by any operation that may grow the array.
+ */
+template<typename T, typename AllocatorType = FHeapAllocator>
+class TArray : private AllocatorType
+{
+	template<typename, typename> friend class TArray;
+
+	static constexpr size_t InlineCount = AllocatorType::InlineCount;
+	static constexpr bool bTriviallyRelocatable = std::is_trivially_copyable<T>::value;
+
+public:
+	using ElementType = T;
+	using SizeType = size_t;
+
+	TArray() : Data(GetInlineData()), ArrayNum(0), ArrayMax(InlineCount) {}
+
+	explicit TArray(const AllocatorType& InAllocator)
+		: AllocatorType(InAllocator), Data(GetInlineData()), ArrayNum(0), ArrayMax(InlineCount) {}
+
+	TArray(std::initializer_list<T> InitList) : TArray()
+	{
+		Append(InitList.begin(), InitList.size());
+	}
+
+	TArray(const T* Ptr, SizeType Count) : TArray()
+	{
+		Append(Ptr, Count);
+	}
+
+	TArray(const TArray& Other) : AllocatorType(Other.GetAllocator()), Data(GetInlineData()), ArrayNum(0), ArrayMax(InlineCount)
+	{
+		Append(Other.Data, Other.ArrayNum);
+	}
+
+	TArray(TArray&& Other) noexcept(bTriviallyRelocatable || std::is_nothrow_move_constructible<T>::value)
+		: AllocatorType(std::move(Other.GetAllocator())), Data(GetInlineData()), ArrayNum(0), ArrayMax(InlineCount)
+	{
+		MoveFrom(Other);
+	}
+
+	~TArray()
+	{
+		DestructRange(Data, ArrayNum);
+		FreeStorage();
+	}
+
+	TArray& operator=(const TArray& Other)
+	{
+		if (this != &Other) {
+			Empty(Other.ArrayNum);
+			Append(Other.Data, Other.ArrayNum);
+		}
+		return *this;
+	}
+
+	TArray& operator=(TArray&& Other) noexcept(bTriviallyRelocatable || std::is_nothrow_move_constructible<T>::value)
+	{
+		if (this != &Other) {
+			DestructRange(Data, ArrayNum);
+			FreeStorage();
+			Data = GetInlineData();
+			ArrayNum = 0;
+			ArrayMax = InlineCount;
+			GetAllocator() = std::move(Other.GetAllocator());
+			MoveFrom(Other);
+		}
+		return *this;
+	}
+
+	TArray& operator=(std::initializer_list<T> InitList)
+	{
+		Empty(InitList.size());
+		Append(InitList.begin(), InitList.size());
+		return *this;
+	}
+
+	// -- Size / capacity ---------------------------------------------------
+
+	SizeType Num() const { return ArrayNum; }
+	SizeType Max() const { return ArrayMax; }
+	bool IsEmpty() const { return ArrayNum == 0; }
+	bool IsValidIndex(SizeType Index) const { return Index < ArrayNum; }
+
+	/** True while the elements still live in the inline buffer. */
+	bool IsInline() const { return InlineCount > 0 && Data == GetInlineData(); }
+
+	T* GetData() { return Data; }
+	const T* GetData() const { return Data; }
+
+	const AllocatorType& GetAllocator() const { return *this; }
+	AllocatorType& GetAllocator() { return *this; }
+
+	/** Make room for at least Number elements without changing Num(). */
+	void Reserve(SizeType Number)
+	{
+		if (Number > ArrayMax) {
+			Reallocate(Number);
+		}
+	}
+
+	/** Release unused capacity (moves back into the inline buffer if it fits). */
+	void Shrink()
+	{
+		if (ArrayMax > ArrayNum && ArrayMax > InlineCount) {
+			Reallocate(ArrayNum);
+		}
+	}
+
+	/** Destroy all elements and release memory, keeping room for Slack elements. */
+	void Empty(SizeType Slack = 0)
+	{
+		DestructRange(Data, ArrayNum);
+		ArrayNum = 0;
+		if (ArrayMax != std::max<SizeType>(Slack, InlineCount)) {
+			Reallocate(Slack);
+		}
+	}
+
+	/** Destroy all elements but keep the current allocation. */
+	void Reset()
+	{
+		DestructRange(Data, ArrayNum);
+		ArrayNum = 0;
+	}
+
+	/** Resize, value-initializing new elements (zero for arithmetic types). */
+	void SetNum(SizeType NewNum)
+	{
+		if (NewNum > ArrayNum) {
+			Reserve(NewNum);
+			for (SizeType i = ArrayNum; i < NewNum; ++i) {
+				new (Data + i) T();
+			}
+			ArrayNum = NewNum;
+		} else if (NewNum < ArrayNum) {
+			DestructRange(Data + NewNum, ArrayNum - NewNum);
+			ArrayNum = NewNum;
+		}
+	}
+
+	// -- Element access ----------------------------------------------------
+
+	T& operator[](SizeType Index)
+	{
+		assert(Index < ArrayNum);
+		return Data[Index];
+	}
+
+	const T& operator[](SizeType Index) const
+	{
+		assert(Index < ArrayNum);
+		return Data[Index];
+	}
+
+	T& Last(SizeType IndexFromEnd = 0)
+	{
+		assert(IndexFromEnd < ArrayNum);
+		return Data[ArrayNum - IndexFromEnd - 1];
+	}
+
+	const T& Last(SizeType IndexFromEnd = 0) const
+	{
+		assert(IndexFromEnd < ArrayNum);
+		return Data[ArrayNum - IndexFromEnd - 1];
+	}
+
+	T& Top() { return Last(); }
+	const T& Top() const { return Last(); }
+
+	// -- Adding ------------------------------------------------------------
+
+	SizeType Add(const T& Item) { return Emplace(Item); }
+	SizeType Add(T&& Item) { return Emplace(std::move(Item)); }
+
+	/** Construct a new element in place at the end. Returns its index. */
+	template<typename... ArgsType>
+	SizeType Emplace(ArgsType&&... Args)
+	{
+		EmplaceGetRef(std::forward<ArgsType>(Args)...);
+		return ArrayNum - 1;
+	}
+
+	template<typename... ArgsType>
+	T& EmplaceGetRef(ArgsType&&... Args)
+	{
+		if (ArrayNum == ArrayMax) {
+			// Args may alias an element of this array; construct before relocating.
+			T Temp(std::forward<ArgsType>(Args)...);
+			Reallocate(CalculateGrowth(ArrayNum + 1));
+			new (Data + ArrayNum) T(std::move(Temp));
+		} else {
+			new (Data + ArrayNum) T(std::forward<ArgsType>(Args)...);
+		}
+		return Data[ArrayNum++];
+	}
+
+	/** Add Count value-initialized elements. Returns the index of the first one. */
+	SizeType AddDefaulted(SizeType Count = 1)
+	{
+		const SizeType First = ArrayNum;
+		SetNum(ArrayNum + Count);
+		return First;
+	}
+
+	/** Add Item only if no equal element exists. Returns the index of the (existing) element. */
+	SizeType AddUnique(const T& Item)
+	{
+		const SizeType Existing = Find(Item);
+		return Existing != INDEX_NONE ? Existing : Add(Item);
+	}
+
+	void Push(const T& Item) { Add(Item); }
+	void Push(T&& Item) { Add(std::move(Item)); }
+
+	/** Bulk append; reserves once. */
+	void Append(const T* Ptr, SizeType Count)
+	{
+		if (Count == 0) return;
+		assert(Ptr < Data || Ptr >= Data + ArrayMax); // appending from self is not supported
+		Reserve(ArrayNum + Count);
+		if (bTriviallyRelocatable) {
+			std::memcpy(static_cast<void*>(Data + ArrayNum), Ptr, Count * sizeof(T));
+		} else {
+			for (SizeType i = 0; i < Count; ++i) {
+				new (Data + ArrayNum + i) T(Ptr[i]);
+			}
+		}
+		ArrayNum += Count;
+	}
+
+	template<typename OtherAllocator>
+	void Append(const TArray<T, OtherAllocator>& Other)
+	{
+		Append(Other.GetData(), Other.Num());
+	}
+
+	template<typename OtherAllocator>
+	void Append(TArray<T, OtherAllocator>&& Other)
+	{
+		Reserve(ArrayNum + Other.Num());
+		for (T& Item : Other) {
+			new (Data + ArrayNum) T(std::move(Item));
+			++ArrayNum;
+		}
+		Other.Reset();
+	}
+
+	void Append(std::initializer_list<T> InitList)
+	{
+		Append(InitList.begin(), InitList.size());
+	}
+
+	/** Insert before Index, shifting later elements up. */
+	void Insert(const T& Item, SizeType Index) { EmplaceAt(Index, Item); }
+	void Insert(T&& Item, SizeType Index) { EmplaceAt(Index, std::move(Item)); }
+
+	template<typename... ArgsType>
+	void EmplaceAt(SizeType Index, ArgsType&&... Args)
+	{
+		assert(Index <= ArrayNum);
+		T Temp(std::forward<ArgsType>(Args)...);
+		if (ArrayNum == ArrayMax) {
+			Reallocate(CalculateGrowth(ArrayNum + 1));
+		}
+		if (Index == ArrayNum) {
+			new (Data + ArrayNum) T(std::move(Temp));
+		} else {
+			new (Data + ArrayNum) T(std::move(Data[ArrayNum - 1]));
+			for (SizeType i = ArrayNum - 1; i > Index; --i) {
+				Data[i] = std::move(Data[i - 1]);
+			}
+			Data[Index] = std::move(Temp);
+		}
+		++ArrayNum;
+	}
+
+	// -- Removing ----------------------------------------------------------
+
+	/** Remove Count elements at Index, preserving order. */
+	void RemoveAt(SizeType Index, SizeType Count = 1)
+	{
+		assert(Index + Count <= ArrayNum);
+		if (Count == 0) return;
+		std::move(Data + Index + Count, Data + ArrayNum, Data + Index);
+		DestructRange(Data + ArrayNum - Count, Count);
+		ArrayNum -= Count;
+	}
+
+	/** Remove Count elements at Index by moving the tail into the hole. O(Count), does not preserve order. */
+	void RemoveAtSwap(SizeType Index, SizeType Count = 1)
+	{
+		assert(Index + Count <= ArrayNum);
+		if (Count == 0) return;
+		const SizeType TailStart = std::max(Index + Count, ArrayNum - Count);
+		const SizeType NumToMove = ArrayNum - TailStart;
+		for (SizeType i = 0; i < NumToMove; ++i) {
+			Data[Index + i] = std::move(Data[TailStart + i]);
+		}
+		DestructRange(Data + ArrayNum - Count, Count);
+		ArrayNum -= Count;
+	}
+
+	/** Remove every element equal to Item, preserving order. Returns the number removed. */
+	SizeType Remove(const T& Item)
+	{
+		return RemoveAll([&Item](const T& Element) { return Element == Item; });
+	}
+
+	/** Remove every element equal to Item without preserving order. Returns the number removed. */
+	SizeType RemoveSwap(const T& Item)
+	{
+		const SizeType OriginalNum = ArrayNum;
+		for (SizeType i = 0; i < ArrayNum;) {
+			if (Data[i] == Item) {
+				RemoveAtSwap(i);
+			} else {
+				++i;
+			}
+		}
+		return OriginalNum - ArrayNum;
+	}
+
+	template<typename PredicateType>
+	SizeType RemoveAll(PredicateType Predicate)
+	{
+		T* NewEnd = std::remove_if(Data, Data + ArrayNum, Predicate);
+		const SizeType NumRemoved = static_cast<SizeType>((Data + ArrayNum) - NewEnd);
+		DestructRange(NewEnd, NumRemoved);
+		ArrayNum -= NumRemoved;
+		return NumRemoved;
+	}
+
+	T Pop()
+	{
+		assert(ArrayNum > 0);
+		T Result(std::move(Data[ArrayNum - 1]));
+		DestructRange(Data + ArrayNum - 1, 1);
+		--ArrayNum;
+		return Result;
+	}
+
+	// -- Searching ---------------------------------------------------------
+
+	SizeType Find(const T& Item) const
+	{
+		for (SizeType i = 0; i < ArrayNum; ++i) {
+			if (Data[i] == Item) return i;
+		}
+		return INDEX_NONE;
+	}
+
+	bool Contains(const T& Item) const { return Find(Item) != INDEX_NONE; }
+
+	template<typename PredicateType>
+	SizeType IndexOfByPredicate(PredicateType Predicate) const
+	{
+		for (SizeType i = 0; i < ArrayNum; ++i) {
+			if (Predicate(Data[i])) return i;
+		}
+		return INDEX_NONE;
+	}
+
+	template<typename PredicateType>
+	T* FindByPredicate(PredicateType Predicate)
+	{
+		const SizeType Index = IndexOfByPredicate(Predicate);
+		return Index != INDEX_NONE ? Data + Index : nullptr;
+	}
+
+	template<typename PredicateType>
+	const T* FindByPredicate(PredicateType Predicate) const
+	{
+		const SizeType Index = IndexOfByPredicate(Predicate);
+		return Index != INDEX_NONE ? Data + Index : nullptr;
+	}
+
+	// -- Misc --------------------------------------------------------------
+
+	void Sort() { std::sort(Data, Data + ArrayNum); }
+
+	template<typename PredicateType>
+	void Sort(PredicateType Predicate) { std::sort(Data, Data + ArrayNum, Predicate); }
+
+	bool operator==(const TArray& Other) const
+	{
+		return ArrayNum == Other.ArrayNum && std::equal(Data, Data + ArrayNum, Other.Data);
+	}
+
+	bool operator!=(const TArray& Other) const { return !(*this == Other); }
+
+	// Iterator support for range-based for loops
+	T* begin() { return Data; }
+	T* end() { return Data + ArrayNum; }
+	const T* begin() const { return Data; }
+	const T* end() const { return Data + ArrayNum; }
+
+private:
+	// Inline storage; an empty struct when the allocator has no inline elements.
+	template<size_t Count, typename Dummy = void>
+	struct TInlineStorage
+	{
+		alignas(T) unsigned char Bytes[Count * sizeof(T)];
+		T* Get() { return reinterpret_cast<T*>(Bytes); }
+		const T* Get() const { return reinterpret_cast<const T*>(Bytes); }
+	};
+
+	template<typename Dummy>
+	struct TInlineStorage<0, Dummy>
+	{
+		T* Get() { return nullptr; }
+		const T* Get() const { return nullptr; }
+	};
+
+	T* GetInlineData() { return InlineStorage.Get(); }
+	const T* GetInlineData() const { return InlineStorage.Get(); }
+
+	static void DestructRange(T* First, SizeType Count)
+	{
+		if (!std::is_trivially_destructible<T>::value) {
+			for (SizeType i = 0; i < Count; ++i) {
+				First[i].~T();
+			}
+		}
+	}
+
+	static SizeType CalculateGrowth(SizeType Required)
+	{
+		// 1.5x growth with a small floor so tiny arrays don't reallocate on every add
+		return std::max<SizeType>(Required, std::max<SizeType>(4, Required + Required / 2));
+	}
+
+	static void RelocateRange(T* Dest, T* Source, SizeType Count)
+	{
+		if (bTriviallyRelocatable) {
+			if (Count) std::memcpy(static_cast<void*>(Dest), Source, Count * sizeof(T));
+		} else {
+			for (SizeType i = 0; i < Count; ++i) {
+				new (Dest + i) T(std::move(Source[i]));
+				Source[i].~T();
+			}
+		}
+	}
+
+	void FreeStorage()
+	{
+		if (Data && Data != GetInlineData()) {
+			GetAllocator().Free(Data, ArrayMax * sizeof(T), alignof(T));
+		}
+	}
+
+	/** Move storage to a block of NewMax elements (or the inline buffer if it fits). */
+	void Reallocate(SizeType NewMax)
+	{
+		NewMax = std::max(NewMax, ArrayNum);
+		T* NewData = nullptr;
+		if (NewMax <= InlineCount) {
+			NewData = GetInlineData();
+			NewMax = InlineCount;
+		} else {
+			NewData = static_cast<T*>(GetAllocator().Allocate(NewMax * sizeof(T), alignof(T)));
+		}
+
+		if (NewData != Data) {
+			RelocateRange(NewData, Data, ArrayNum);
+			FreeStorage();
+			Data = NewData;
+		}
+		ArrayMax = NewMax;
+	}
+
+	template<typename OtherAllocator>
+	void MoveFrom(TArray<T, OtherAllocator>& Other)
+	{
+		if (Other.Data == Other.GetInlineData() || Other.ArrayNum == 0) {
+			// Inline elements cannot be stolen, move them one by one
+			Reserve(Other.ArrayNum);
+			RelocateRange(Data, Other.Data, Other.ArrayNum);
+			ArrayNum = Other.ArrayNum;
+			Other.ArrayNum = 0;
+		} else {
+			Data = Other.Data;
+			ArrayNum = Other.ArrayNum;
+			ArrayMax = Other.ArrayMax;
+			Other.Data = Other.GetInlineData();
+			Other.ArrayNum = 0;
+			Other.ArrayMax = Other.InlineCount;
+		}
+	}
+
+	TInlineStorage<InlineCount> InlineStorage;
+	T* Data;
+	SizeType ArrayNum;
+	SizeType ArrayMax;
+};
+
+/** Convenience alias for arrays that keep up to N elements inline. */
+template<typename T, size_t N>
+using TInlineArray = TArray<T, TInlineAllocator<N>>;
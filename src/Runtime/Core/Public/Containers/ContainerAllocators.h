@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+/**
+ * Container allocators
+ *
+ * An allocator policy supplies raw memory to TArray and declares how many elements the
+ * container may keep inline before it has to allocate:
+ *
+ *   struct FMyAllocator {
+ *       static constexpr size_t InlineCount = 0;
+ *       void* Allocate(size_t Size, size_t Alignment);
+ *       void  Free(void* Ptr, size_t Size, size_t Alignment);
+ *   };
+ *
+ * Allocators are stored by value inside the container, so stateful allocators (e.g. one that
+ * points at an arena) are supported. Copying a container copies its allocator.
+ */
+
+/** Default allocator: global aligned new/delete. */
+struct FHeapAllocator
+{
+	static constexpr size_t InlineCount = 0;
+
+	void* Allocate(size_t Size, size_t Alignment)
+	{
+		return ::operator new(Size, std::align_val_t(Alignment));
+	}
+
+	void Free(void* Ptr, size_t /*Size*/, size_t Alignment)
+	{
+		::operator delete(Ptr, std::align_val_t(Alignment));
+	}
+};
+
+/**
+ * Keeps the first N elements inside the container itself and only falls back to
+ * SecondaryAllocator once the array grows past N. Use for short-lived lists whose
+ * typical size is known, e.g. TArray<FName, TInlineAllocator<8>>.
+ */
+template<size_t N, typename SecondaryAllocator = FHeapAllocator>
+struct TInlineAllocator : public SecondaryAllocator
+{
+	static constexpr size_t InlineCount = N;
+
+	TInlineAllocator() = default;
+	TInlineAllocator(const SecondaryAllocator& Secondary) : SecondaryAllocator(Secondary) {}
+};
+
+// CoreUtils.h pulls in Containers/Array.h, which needs the policies above; include it only
+// now so that including this header first does not leave TArray without its default allocator.
+#include "CoreUtils.h"
+
+/**
+ * FMemArena - linear (bump) allocator
+ *
+ * Hands out memory from large blocks and frees everything at once in Reset() or the destructor.
+ * Individual frees are no-ops. Not thread-safe; use one arena per thread or per task.
+ */
+class CORE_API FMemArena
+{
+public:
+	explicit FMemArena(size_t InBlockSize = 64 * 1024);
+	~FMemArena();
+
+	FMemArena(const FMemArena&) = delete;
+	FMemArena& operator=(const FMemArena&) = delete;
+
+	void* Allocate(size_t Size, size_t Alignment);
+
+	/** Release all allocations. Keeps the first block around for reuse. */
+	void Reset();
+
+	/** Bytes handed out since the last Reset() (including alignment padding). */
+	size_t GetBytesUsed() const { return BytesUsed; }
+
+private:
+	struct FBlock
+	{
+		FBlock* Next;
+		size_t Size;
+	};
+
+	FBlock* AllocateBlock(size_t MinSize);
+
+	FBlock* Head = nullptr;
+	unsigned char* Cursor = nullptr;
+	unsigned char* End = nullptr;
+	size_t BlockSize;
+	size_t BytesUsed = 0;
+};
+
+/** Allocator policy that draws from an FMemArena. The arena must outlive every container using it. */
+struct FArenaAllocator
+{
+	static constexpr size_t InlineCount = 0;
+
+	FArenaAllocator() = default;
+	FArenaAllocator(FMemArena& InArena) : Arena(&InArena) {}
+
+	void* Allocate(size_t Size, size_t Alignment)
+	{
+		// A default constructed arena allocator has nowhere to allocate from
+		if (!Arena) throw std::bad_alloc();
+		return Arena->Allocate(Size, Alignment);
+	}
+
+	void Free(void* /*Ptr*/, size_t /*Size*/, size_t /*Alignment*/)
+	{
+		// Arena memory is reclaimed in bulk by FMemArena::Reset()
+	}
+
+	FMemArena* Arena = nullptr;
+};
@@ -0,0 +1,605 @@
+#pragma once
+
+#include "CoreUtils.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <new>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * Hash / equality policies for TMap.
+ *
+ * Specializations that declare `is_transparent` enable heterogeneous lookup: Find("Name")
+ * on a TMap<FString, ...> hashes the characters directly instead of building an FString, and
+ * on a TMap<FName, ...> it resolves the name with FName::Find() (no interning on a miss).
+ * The FName specializations live in Misc/Name.h next to FName itself.
+ */
+template<typename KeyType>
+struct TMapHash
+{
+	size_t operator()(const KeyType& Key) const { return std::hash<KeyType>()(Key); }
+};
+
+template<>
+struct TMapHash<FString>
+{
+	using is_transparent = void;
+	size_t operator()(std::string_view Key) const { return std::hash<std::string_view>()(Key); }
+};
+
+template<typename KeyType>
+struct TMapKeyEqual : std::equal_to<KeyType>
+{
+};
+
+template<>
+struct TMapKeyEqual<FString> : std::equal_to<>
+{
+};
+
+namespace MapPrivate
+{
+	// Control bytes, one per slot. Full slots store the low 7 bits of the hash (H2), so the
+	// high bit tells full (0) from empty/deleted (1).
+	constexpr uint8_t CtrlEmpty = 0x80;
+	constexpr uint8_t CtrlDeleted = 0xFE;
+	constexpr size_t GroupWidth = 8;
+
+	constexpr uint64 LsbMask = 0x0101010101010101ull;
+	constexpr uint64 MsbMask = 0x8080808080808080ull;
+
+	inline bool IsFull(uint8_t Ctrl) { return (Ctrl & 0x80) == 0; }
+
+	inline uint64 LoadGroup(const uint8_t* Ctrl)
+	{
+		uint64 Word;
+		std::memcpy(&Word, Ctrl, sizeof(Word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		Word = __builtin_bswap64(Word);
+#endif
+		return Word;
+	}
+
+	/** Bytes equal to H2 (may report false positives next to a real match; callers compare keys). */
+	inline uint64 MatchH2(uint64 Group, uint8_t H2)
+	{
+		const uint64 X = Group ^ (LsbMask * H2);
+		return (X - LsbMask) & ~X & MsbMask;
+	}
+
+	inline uint64 MatchEmpty(uint64 Group) { return Group & ~(Group << 6) & MsbMask; }
+	inline uint64 MatchEmptyOrDeleted(uint64 Group) { return Group & ~(Group << 7) & MsbMask; }
+
+	/** Index of the lowest matched byte in a Match* mask. */
+	inline size_t LowestMatch(uint64 Mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long Bit;
+		_BitScanForward64(&Bit, Mask);
+		return Bit >> 3;
+#else
+		return static_cast<size_t>(__builtin_ctzll(Mask)) >> 3;
+#endif
+	}
+
+	/** Spread user hashes (std::hash of integers is often the identity). */
+	inline uint64 MixHash(size_t Hash)
+	{
+		const uint64 H = static_cast<uint64>(Hash) * 0x9E3779B97F4A7C15ull;
+		return H ^ (H >> 32);
+	}
+
+	template<typename T, typename = void>
+	struct TIsTransparent : std::false_type {};
+
+	template<typename T>
+	struct TIsTransparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+}
+
+/**
+ * TMap - open-addressing hash map (SwissTable layout)
+ *
+ * Elements live in one flat slot array next to an array of 1-byte control words. Lookups probe
+ * 8 control bytes at a time and only touch a slot when its 7-bit hash tag matches, so most
+ * misses never read a key. Erase leaves a tombstone (or an empty slot when that cannot break a
+ * probe chain); tombstones are reclaimed on the next rehash.
+ *
+ * Unlike std::unordered_map, inserting may move elements: any insertion can invalidate
+ * iterators, pointers and references. Erasing never moves other elements.
+ *
+ * Both a UE-flavoured API (Find/Add/FindOrAdd/Remove/Num) and the std subset the engine
+ * already used (find/end/erase/count/operator[]/emplace/size) are provided.
+ */
+template<typename KeyType, typename ValueType,
+	typename HashType = TMapHash<KeyType>, typename EqualType = TMapKeyEqual<KeyType>>
+class TMap
+{
+	static constexpr bool bHeterogeneous =
+		MapPrivate::TIsTransparent<HashType>::value && MapPrivate::TIsTransparent<EqualType>::value;
+
+	template<typename LookupType>
+	using TEnableIfHeterogeneous = typename std::enable_if<bHeterogeneous && !std::is_same<typename std::decay<LookupType>::type, KeyType>::value, int>::type;
+
+public:
+	using ElementType = std::pair<const KeyType, ValueType>;
+	using key_type = KeyType;
+	using mapped_type = ValueType;
+	using value_type = ElementType;
+	using size_type = size_t;
+
+	template<bool bConst>
+	class TIterator
+	{
+		friend class TMap;
+		using MapType = typename std::conditional<bConst, const TMap, TMap>::type;
+		using RefType = typename std::conditional<bConst, const ElementType&, ElementType&>::type;
+		using PtrType = typename std::conditional<bConst, const ElementType*, ElementType*>::type;
+
+	public:
+		TIterator() = default;
+		TIterator(MapType* InMap, size_t InIndex) : Map(InMap), Index(InIndex) { SkipEmpty(); }
+
+		// Allow iterator -> const_iterator
+		template<bool bOtherConst, typename = typename std::enable_if<bConst && !bOtherConst>::type>
+		TIterator(const TIterator<bOtherConst>& Other) : Map(Other.Map), Index(Other.Index) {}
+
+		RefType operator*() const { return Map->Slots[Index]; }
+		PtrType operator->() const { return &Map->Slots[Index]; }
+
+		TIterator& operator++() { ++Index; SkipEmpty(); return *this; }
+
+		bool operator==(const TIterator& Other) const { return Index == Other.Index; }
+		bool operator!=(const TIterator& Other) const { return Index != Other.Index; }
+
+	private:
+		template<bool> friend class TIterator;
+
+		void SkipEmpty()
+		{
+			while (Map && Index < Map->Capacity && !MapPrivate::IsFull(Map->Ctrl[Index])) {
+				++Index;
+			}
+		}
+
+		MapType* Map = nullptr;
+		size_t Index = 0;
+	};
+
+	using iterator = TIterator<false>;
+	using const_iterator = TIterator<true>;
+
+	TMap() = default;
+
+	TMap(std::initializer_list<ElementType> InitList)
+	{
+		Reserve(InitList.size());
+		for (const ElementType& Element : InitList) {
+			Add(Element.first, Element.second);
+		}
+	}
+
+	TMap(const TMap& Other) : Hasher(Other.Hasher), KeyEqual(Other.KeyEqual)
+	{
+		CopyFrom(Other);
+	}
+
+	TMap(TMap&& Other) noexcept
+		: Hasher(std::move(Other.Hasher)), KeyEqual(std::move(Other.KeyEqual))
+	{
+		StealFrom(Other);
+	}
+
+	~TMap()
+	{
+		DestroyAll();
+		FreeArrays(Ctrl, Slots, Capacity);
+	}
+
+	TMap& operator=(const TMap& Other)
+	{
+		if (this != &Other) {
+			Empty();
+			Hasher = Other.Hasher;
+			KeyEqual = Other.KeyEqual;
+			CopyFrom(Other);
+		}
+		return *this;
+	}
+
+	TMap& operator=(TMap&& Other) noexcept
+	{
+		if (this != &Other) {
+			Empty();
+			Hasher = std::move(Other.Hasher);
+			KeyEqual = std::move(Other.KeyEqual);
+			StealFrom(Other);
+		}
+		return *this;
+	}
+
+	// -- Size / capacity ---------------------------------------------------
+
+	size_t Num() const { return NumElements; }
+	bool IsEmpty() const { return NumElements == 0; }
+
+	/** Number of slots; the map rehashes before more than 7/8 of them are used. */
+	size_t Max() const { return Capacity; }
+
+	/** Make sure Number elements fit without rehashing. */
+	void Reserve(size_t Number)
+	{
+		const size_t Required = CapacityForCount(Number);
+		if (Required > Capacity) {
+			Rehash(Required);
+		}
+	}
+
+	/** Destroy all elements and free the slot arrays. */
+	void Empty()
+	{
+		DestroyAll();
+		FreeArrays(Ctrl, Slots, Capacity);
+		Ctrl = nullptr;
+		Slots = nullptr;
+		Capacity = 0;
+		NumElements = 0;
+		GrowthLeft = 0;
+	}
+
+	/** Destroy all elements but keep the slot arrays for reuse. */
+	void Reset()
+	{
+		DestroyAll();
+		if (Capacity) {
+			std::memset(Ctrl, MapPrivate::CtrlEmpty, Capacity);
+		}
+		NumElements = 0;
+		GrowthLeft = MaxLoad(Capacity);
+	}
+
+	// -- Lookup ------------------------------------------------------------
+
+	/** Returns a pointer to the value for Key, or nullptr. */
+	ValueType* Find(const KeyType& Key)
+	{
+		const size_t Index = FindIndex(Key);
+		return Index != IndexNone ? &Slots[Index].second : nullptr;
+	}
+
+	const ValueType* Find(const KeyType& Key) const
+	{
+		const size_t Index = FindIndex(Key);
+		return Index != IndexNone ? &Slots[Index].second : nullptr;
+	}
+
+	template<typename LookupType, TEnableIfHeterogeneous<LookupType> = 0>
+	ValueType* Find(const LookupType& Key)
+	{
+		const size_t Index = FindIndex(Key);
+		return Index != IndexNone ? &Slots[Index].second : nullptr;
+	}
+
+	template<typename LookupType, TEnableIfHeterogeneous<LookupType> = 0>
+	const ValueType* Find(const LookupType& Key) const
+	{
+		const size_t Index = FindIndex(Key);
+		return Index != IndexNone ? &Slots[Index].second : nullptr;
+	}
+
+	bool Contains(const KeyType& Key) const { return FindIndex(Key) != IndexNone; }
+
+	template<typename LookupType, TEnableIfHeterogeneous<LookupType> = 0>
+	bool Contains(const LookupType& Key) const { return FindIndex(Key) != IndexNone; }
+
+	iterator find(const KeyType& Key) { return MakeIterator(FindIndex(Key)); }
+	const_iterator find(const KeyType& Key) const { return MakeIterator(FindIndex(Key)); }
+
+	template<typename LookupType, TEnableIfHeterogeneous<LookupType> = 0>
+	iterator find(const LookupType& Key) { return MakeIterator(FindIndex(Key)); }
+
+	template<typename LookupType, TEnableIfHeterogeneous<LookupType> = 0>
+	const_iterator find(const LookupType& Key) const { return MakeIterator(FindIndex(Key)); }
+
+	size_t count(const KeyType& Key) const { return Contains(Key) ? 1 : 0; }
+
+	template<typename LookupType, TEnableIfHeterogeneous<LookupType> = 0>
+	size_t count(const LookupType& Key) const { return Contains(Key) ? 1 : 0; }
+
+	// -- Insertion ---------------------------------------------------------
+
+	/** Insert or overwrite the value for Key. */
+	template<typename ValueArg>
+	ValueType& Add(const KeyType& Key, ValueArg&& Value)
+	{
+		auto Result = TryEmplace(Key, std::forward<ValueArg>(Value));
+		if (!Result.second) {
+			Slots[Result.first].second = std::forward<ValueArg>(Value);
+		}
+		return Slots[Result.first].second;
+	}
+
+	template<typename ValueArg>
+	ValueType& Add(KeyType&& Key, ValueArg&& Value)
+	{
+		auto Result = TryEmplace(std::move(Key), std::forward<ValueArg>(Value));
+		if (!Result.second) {
+			Slots[Result.first].second = std::forward<ValueArg>(Value);
+		}
+		return Slots[Result.first].second;
+	}
+
+	/** Returns the value for Key, default constructing it if missing. */
+	ValueType& FindOrAdd(const KeyType& Key)
+	{
+		// Index first: TryEmplace may reallocate Slots
+		const size_t Index = TryEmplace(Key).first;
+		return Slots[Index].second;
+	}
+
+	ValueType& FindOrAdd(KeyType&& Key)
+	{
+		const size_t Index = TryEmplace(std::move(Key)).first;
+		return Slots[Index].second;
+	}
+
+	ValueType& operator[](const KeyType& Key) { return FindOrAdd(Key); }
+	ValueType& operator[](KeyType&& Key) { return FindOrAdd(std::move(Key)); }
+
+	/** Construct the value from Args only if Key is not present (std::map::try_emplace semantics). */
+	template<typename KeyArg, typename... ArgsType>
+	std::pair<iterator, bool> emplace(KeyArg&& Key, ArgsType&&... Args)
+	{
+		auto Result = TryEmplace(KeyType(std::forward<KeyArg>(Key)), std::forward<ArgsType>(Args)...);
+		return { MakeIterator(Result.first), Result.second };
+	}
+
+	std::pair<iterator, bool> insert(const ElementType& Element)
+	{
+		auto Result = TryEmplace(Element.first, Element.second);
+		return { MakeIterator(Result.first), Result.second };
+	}
+
+	// -- Removal -----------------------------------------------------------
+
+	/** Remove Key. Returns true if it was present. */
+	bool Remove(const KeyType& Key)
+	{
+		const size_t Index = FindIndex(Key);
+		if (Index == IndexNone) return false;
+		EraseIndex(Index);
+		return true;
+	}
+
+	template<typename LookupType, TEnableIfHeterogeneous<LookupType> = 0>
+	bool Remove(const LookupType& Key)
+	{
+		const size_t Index = FindIndex(Key);
+		if (Index == IndexNone) return false;
+		EraseIndex(Index);
+		return true;
+	}
+
+	size_t erase(const KeyType& Key) { return Remove(Key) ? 1 : 0; }
+
+	/** Erase the element at It and return an iterator to the next one. */
+	iterator erase(const_iterator It)
+	{
+		EraseIndex(It.Index);
+		return iterator(this, It.Index + 1);
+	}
+
+	iterator erase(iterator It) { return erase(const_iterator(It)); }
+
+	// -- std compatibility -------------------------------------------------
+
+	size_t size() const { return NumElements; }
+	bool empty() const { return NumElements == 0; }
+	void clear() { Reset(); }
+	void reserve(size_t Number) { Reserve(Number); }
+
+	iterator begin() { return iterator(this, 0); }
+	iterator end() { return iterator(this, Capacity); }
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, Capacity); }
+
+private:
+	static constexpr size_t IndexNone = static_cast<size_t>(-1);
+
+	static size_t MaxLoad(size_t InCapacity) { return InCapacity - InCapacity / 8; }
+
+	static size_t CapacityForCount(size_t Count)
+	{
+		if (Count == 0) return 0;
+		size_t Result = MapPrivate::GroupWidth;
+		while (MaxLoad(Result) < Count) {
+			Result *= 2;
+		}
+		return Result;
+	}
+
+	iterator MakeIterator(size_t Index) { return iterator(this, Index == IndexNone ? Capacity : Index); }
+	const_iterator MakeIterator(size_t Index) const { return const_iterator(this, Index == IndexNone ? Capacity : Index); }
+
+	template<typename LookupType>
+	size_t FindIndex(const LookupType& Key) const
+	{
+		if (NumElements == 0) return IndexNone;
+		return FindIndex(Key, MapPrivate::MixHash(Hasher(Key)));
+	}
+
+	template<typename LookupType>
+	size_t FindIndex(const LookupType& Key, uint64 Hash) const
+	{
+		if (NumElements == 0) return IndexNone;
+
+		const uint8_t H2 = static_cast<uint8_t>(Hash & 0x7F);
+		const size_t GroupMask = Capacity / MapPrivate::GroupWidth - 1;
+		size_t Group = static_cast<size_t>(Hash >> 7) & GroupMask;
+
+		// Triangular probing visits every group exactly once when the group count is a power of two
+		for (size_t Step = 1;; ++Step) {
+			const size_t Base = Group * MapPrivate::GroupWidth;
+			const uint64 Word = MapPrivate::LoadGroup(Ctrl + Base);
+			for (uint64 Mask = MapPrivate::MatchH2(Word, H2); Mask; Mask &= Mask - 1) {
+				const size_t Index = Base + MapPrivate::LowestMatch(Mask);
+				if (KeyEqual(Slots[Index].first, Key)) {
+					return Index;
+				}
+			}
+			if (MapPrivate::MatchEmpty(Word)) {
+				return IndexNone;
+			}
+			Group = (Group + Step) & GroupMask;
+		}
+	}
+
+	/** First empty or deleted slot on the probe sequence for Hash. The table must not be full. */
+	size_t FindInsertSlot(uint64 Hash) const
+	{
+		const size_t GroupMask = Capacity / MapPrivate::GroupWidth - 1;
+		size_t Group = static_cast<size_t>(Hash >> 7) & GroupMask;
+		for (size_t Step = 1;; ++Step) {
+			const size_t Base = Group * MapPrivate::GroupWidth;
+			const uint64 Mask = MapPrivate::MatchEmptyOrDeleted(MapPrivate::LoadGroup(Ctrl + Base));
+			if (Mask) {
+				return Base + MapPrivate::LowestMatch(Mask);
+			}
+			Group = (Group + Step) & GroupMask;
+		}
+	}
+
+	/** Returns {slot index, true if inserted}. The value is only constructed when inserting. */
+	template<typename KeyArg, typename... ArgsType>
+	std::pair<size_t, bool> TryEmplace(KeyArg&& Key, ArgsType&&... Args)
+	{
+		const uint64 Hash = MapPrivate::MixHash(Hasher(Key));
+		const size_t Existing = FindIndex(Key, Hash);
+		if (Existing != IndexNone) {
+			return { Existing, false };
+		}
+
+		size_t Index = Capacity ? FindInsertSlot(Hash) : IndexNone;
+		if (Index == IndexNone || (GrowthLeft == 0 && Ctrl[Index] == MapPrivate::CtrlEmpty)) {
+			// Out of fresh slots. If at least half of the load is tombstones, rehash in place.
+			const bool bMostlyTombstones = Capacity && NumElements < MaxLoad(Capacity) / 2;
+			Rehash(bMostlyTombstones ? Capacity : std::max(MapPrivate::GroupWidth, Capacity * 2));
+			Index = FindInsertSlot(Hash);
+		}
+
+		new (&Slots[Index]) ElementType(std::piecewise_construct,
+			std::forward_as_tuple(std::forward<KeyArg>(Key)),
+			std::forward_as_tuple(std::forward<ArgsType>(Args)...));
+		if (Ctrl[Index] == MapPrivate::CtrlEmpty) {
+			--GrowthLeft;
+		}
+		Ctrl[Index] = static_cast<uint8_t>(Hash & 0x7F);
+		++NumElements;
+		return { Index, true };
+	}
+
+	void EraseIndex(size_t Index)
+	{
+		Slots[Index].~ElementType();
+		--NumElements;
+
+		// If this slot's group still has an empty byte, no probe sequence ever continued past it,
+		// so the slot can become empty again instead of a tombstone.
+		const size_t Base = Index & ~(MapPrivate::GroupWidth - 1);
+		if (MapPrivate::MatchEmpty(MapPrivate::LoadGroup(Ctrl + Base))) {
+			Ctrl[Index] = MapPrivate::CtrlEmpty;
+			++GrowthLeft;
+		} else {
+			Ctrl[Index] = MapPrivate::CtrlDeleted;
+		}
+	}
+
+	void Rehash(size_t NewCapacity)
+	{
+		uint8_t* OldCtrl = Ctrl;
+		ElementType* OldSlots = Slots;
+		const size_t OldCapacity = Capacity;
+
+		AllocateArrays(NewCapacity);
+		for (size_t i = 0; i < OldCapacity; ++i) {
+			if (!MapPrivate::IsFull(OldCtrl[i])) continue;
+
+			ElementType& Element = OldSlots[i];
+			const uint64 Hash = MapPrivate::MixHash(Hasher(Element.first));
+			const size_t Index = FindInsertSlot(Hash);
+			// Keys are const inside the pair, so they are copied; values are moved.
+			new (&Slots[Index]) ElementType(Element.first, std::move(Element.second));
+			Ctrl[Index] = static_cast<uint8_t>(Hash & 0x7F);
+			Element.~ElementType();
+		}
+		FreeArrays(OldCtrl, OldSlots, OldCapacity);
+	}
+
+	void AllocateArrays(size_t NewCapacity)
+	{
+		Ctrl = static_cast<uint8_t*>(::operator new(NewCapacity));
+		std::memset(Ctrl, MapPrivate::CtrlEmpty, NewCapacity);
+		Slots = static_cast<ElementType*>(::operator new(NewCapacity * sizeof(ElementType), std::align_val_t(alignof(ElementType))));
+		Capacity = NewCapacity;
+		GrowthLeft = MaxLoad(NewCapacity) - NumElements; // elements about to be reinserted by Rehash
+	}
+
+	static void FreeArrays(uint8_t* InCtrl, ElementType* InSlots, size_t InCapacity)
+	{
+		if (InCapacity == 0) return;
+		::operator delete(InCtrl);
+		::operator delete(InSlots, std::align_val_t(alignof(ElementType)));
+	}
+
+	void DestroyAll()
+	{
+		if (!std::is_trivially_destructible<ElementType>::value) {
+			for (size_t i = 0; i < Capacity; ++i) {
+				if (MapPrivate::IsFull(Ctrl[i])) {
+					Slots[i].~ElementType();
+				}
+			}
+		}
+	}
+
+	void CopyFrom(const TMap& Other)
+	{
+		Reserve(Other.NumElements);
+		for (const ElementType& Element : Other) {
+			TryEmplace(Element.first, Element.second);
+		}
+	}
+
+	void StealFrom(TMap& Other)
+	{
+		Ctrl = Other.Ctrl;
+		Slots = Other.Slots;
+		Capacity = Other.Capacity;
+		NumElements = Other.NumElements;
+		GrowthLeft = Other.GrowthLeft;
+		Other.Ctrl = nullptr;
+		Other.Slots = nullptr;
+		Other.Capacity = 0;
+		Other.NumElements = 0;
+		Other.GrowthLeft = 0;
+	}
+
+	HashType Hasher;
+	EqualType KeyEqual;
+	uint8_t* Ctrl = nullptr;
+	ElementType* Slots = nullptr;
+	size_t Capacity = 0;
+	size_t NumElements = 0;
+	size_t GrowthLeft = 0;
+};
+
+/** Engine-wide hash map alias (formerly std::unordered_map). */
+template<typename K, typename V> using FMap = TMap<K, V>;
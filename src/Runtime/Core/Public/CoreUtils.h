@@ -3,7 +3,6 @@
 #include <vector>
 #include <string>
 #include <memory>
-#include <unordered_map>
 #include <cstdint>
 
 #pragma region FuncDefs
@@ -43,44 +42,14 @@ using int64 = int64_t;
 using FString = std::string;
 using FText = std::string;
 using TCHAR = char;
-using FName = std::string;
+class FName; // interned name, see Misc/Name.h
 template<typename T> using FUniquePtr = std::unique_ptr<T>;
 template<typename T> using FSharedPtr = std::shared_ptr<T>;
 template<typename T> using FWeakPtr = std::weak_ptr<T>;
 template<typename T> using FVector = std::vector<T>;
-template<typename K, typename V> using FMap = std::unordered_map<K, V>;
+// FMap (open-addressing TMap) lives in Containers/Map.h
 
-// Type definitions for TArray
-template<typename T>
-class TArray {
-public:
-    TArray() = default;
-
-    void Add(const T& item) {
-        data.push_back(item);
-    }
-
-    size_t Num() const {
-        return data.size();
-    }
-
-    T& operator[](size_t index) {
-        return data[index];
-    }
-
-    const T& operator[](size_t index) const {
-        return data[index];
-    }
-
-    // Iterator support for range-based for loops
-    typename FVector<T>::iterator begin() { return data.begin(); }
-    typename FVector<T>::iterator end() { return data.end(); }
-    typename FVector<T>::const_iterator begin() const { return data.begin(); }
-    typename FVector<T>::const_iterator end() const { return data.end(); }
-
-private:
-    FVector<T> data;
-};
+// TArray lives in Containers/Array.h (included at the end of this file)
 
 #pragma endregion // TypeDefs
 
@@ -107,4 +76,9 @@ private:
 
 extern TCHAR GInternalProjectName[64];
 
-#pragma endregion
\ No newline at end of file
+#pragma endregion
+
+// FName and the containers need CORE_API and the typedefs above, so they are pulled in last.
+#include "Misc/Name.h"
+#include "Containers/Array.h"
+#include "Containers/Map.h"
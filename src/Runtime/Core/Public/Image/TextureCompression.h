@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreUtils.h"
+
+/** Block-compressed texture formats; every format stores 4x4 texel blocks */
+enum class EBlockCompression : uint32
+{
+	/** RGB, 8 bytes per block. Alpha is dropped. */
+	BC1,
+	/** RGBA, 16 bytes per block: BC1 color plus interpolated alpha */
+	BC3,
+	/** Two channels (R, G), 16 bytes per block, e.g. tangent-space normal maps */
+	BC5,
+	/** RGBA, 16 bytes per block, highest quality */
+	BC7,
+};
+
+/**
+ * FTextureCompression - CPU encoder and decoder for BC1/BC3/BC5/BC7
+ *
+ * Meant for the asset pipeline (e.g. the TextureLoader's worker threads), not per frame. The
+ * encoder fits each block's endpoints along the principal axis of its colors and picks the
+ * closest palette entry per texel; BC1 refines the endpoints with one least-squares pass. BC7
+ * uses mode 6 only (one subset, RGBA endpoints with p-bits, 4-bit indices), which is a good fit
+ * for smooth material textures and cheap to search.
+ *
+ * Images are tightly packed RGBA8, rows top to bottom. Blocks are stored row by row. Sizes that
+ * are not a multiple of 4 are padded by repeating the last row and column.
+ */
+struct CORE_API FTextureCompression
+{
+	static uint32 GetBlockBytes(EBlockCompression Format);
+	static size_t GetCompressedSize(EBlockCompression Format, uint32 Width, uint32 Height);
+
+	static TArray<uint8_t> Compress(EBlockCompression Format, const uint8_t* Rgba, uint32 Width, uint32 Height);
+
+	/** Decodes what Compress() writes. BC7 blocks in modes other than 6 decode to magenta. */
+	static TArray<uint8_t> Decompress(EBlockCompression Format, const uint8_t* Blocks, uint32 Width, uint32 Height);
+
+	/** Next mip level of an RGBA8 image (2x2 box filter); each size halves, down to 1 */
+	static TArray<uint8_t> DownsampleRGBA8(const uint8_t* Rgba, uint32 Width, uint32 Height);
+};
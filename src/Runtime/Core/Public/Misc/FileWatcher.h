@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreUtils.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+/**
+ * FFileWatcher - reports files that changed below a directory
+ *
+ * A background thread collects changes: inotify on Linux, otherwise (or when inotify is
+ * unavailable) a periodic scan comparing modification times and sizes. Created, modified,
+ * renamed and deleted files are reported; directories are not.
+ *
+ * Editors often save in several steps (truncate, write, rename), so a file is only reported once
+ * it has been quiet for the debounce time. ConsumeChanges() is meant to be polled, e.g. once per
+ * frame.
+ */
+class CORE_API FFileWatcher
+{
+public:
+	using FClock = std::chrono::steady_clock;
+
+	FFileWatcher() = default;
+	~FFileWatcher();
+
+	FFileWatcher(const FFileWatcher&) = delete;
+	FFileWatcher& operator=(const FFileWatcher&) = delete;
+
+	/** Watches Directory recursively. Returns false if it does not exist. */
+	bool Start(const FString& InDirectory, bool bForcePolling = false);
+	void Stop();
+
+	bool IsRunning() const { return Thread.joinable(); }
+	bool IsPolling() const { return bPolling; }
+	const FString& GetDirectory() const { return Directory; }
+
+	/** Quiet time before a change is reported. Default 100 ms. */
+	void SetDebounceMs(uint32 Ms) { DebounceMs = Ms; }
+	/** Scan interval of the polling fallback. Default 250 ms. */
+	void SetPollIntervalMs(uint32 Ms) { PollIntervalMs = Ms; }
+
+	/** Absolute paths (forward slashes, no duplicates) of files changed since the last call. */
+	TArray<FString> ConsumeChanges();
+
+private:
+	void RunPolling();
+#if defined(__linux__)
+	void RunInotify();
+	bool AddInotifyWatches(const FString& Root);
+#endif
+	void AddChange(const FString& Path);
+
+	FString Directory;
+	std::thread Thread;
+	std::atomic<bool> bStopRequested{false};
+	bool bPolling = false;
+	uint32 DebounceMs = 100;
+	uint32 PollIntervalMs = 250;
+
+	std::mutex Mutex;
+	/** Path -> time of its latest change */
+	TMap<FString, FClock::time_point> Pending;
+
+#if defined(__linux__)
+	int InotifyFd = -1;
+	/** inotify watch descriptor -> watched directory */
+	TMap<int32, FString> WatchedDirs;
+#endif
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreUtils.h"
+
+/**
+ * FHash - stable, non-cryptographic hashing
+ *
+ * Unlike std::hash, the result only depends on the input bytes, so it can be stored on disk
+ * (cache keys, archive tables of contents) and compared across runs and platforms.
+ */
+struct FHash
+{
+	static constexpr uint64 Fnv1a64Seed = 14695981039346656037ull;
+
+	/** 64-bit FNV-1a. Pass the previous result as Seed to hash several buffers as one stream. */
+	static uint64 Fnv1a64(const void* Data, size_t Size, uint64 Seed = Fnv1a64Seed)
+	{
+		const unsigned char* Bytes = static_cast<const unsigned char*>(Data);
+		uint64 Hash = Seed;
+		for (size_t Index = 0; Index < Size; ++Index) {
+			Hash ^= Bytes[Index];
+			Hash *= 1099511628211ull;
+		}
+		return Hash;
+	}
+
+	static uint64 Fnv1a64(const FString& Value, uint64 Seed = Fnv1a64Seed)
+	{
+		return Fnv1a64(Value.data(), Value.size(), Seed);
+	}
+
+	/** Lower-case, zero-padded hex, e.g. for file names */
+	static FString ToHex(uint64 Value)
+	{
+		static const char Digits[] = "0123456789abcdef";
+		FString Result(16, '0');
+		for (int32 Index = 15; Index >= 0; --Index, Value >>= 4) {
+			Result[Index] = Digits[Value & 0xF];
+		}
+		return Result;
+	}
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "CoreUtils.h"
+#include <functional>
+#include <ostream>
+
+/**
+ * FName - interned, case-insensitive name
+ *
+ * Every distinct spelling of a name is stored exactly once in a global, sharded name
+ * table. An FName only carries two 32-bit indices into that table:
+ *  - ComparisonIndex: shared by all spellings that are equal ignoring case. Equality and
+ *    hashing only look at this index, so comparing two names is a single integer compare.
+ *  - DisplayIndex: the exact spelling this FName was created from. ToString() returns it
+ *    without allocating, which keeps case-sensitive consumers (e.g. GL uniform lookups) happy.
+ *
+ * Index 0 is reserved for NAME_None (the empty name), so a default constructed FName is None.
+ * The table is never shrunk; names live until process exit.
+ *
+ * Note: operator< orders by ComparisonIndex (i.e. roughly creation order), not lexically.
+ * Use LexicalLess() when a human readable ordering is required.
+ */
+class FName
+{
+public:
+	FName() = default;
+
+	// Implicit on purpose: string literals and FStrings are accepted wherever an FName is expected,
+	// mirroring Unreal's FName(const TCHAR*).
+	FName(const TCHAR* InName) { Init(InName, InName ? std::char_traits<TCHAR>::length(InName) : 0); }
+	FName(const FString& InName) { Init(InName.data(), InName.size()); }
+
+	/** Returns the exact spelling this name was created with. Never allocates. */
+	CORE_API const FString& ToString() const;
+
+	const TCHAR* c_str() const { return ToString().c_str(); }
+
+	bool IsNone() const { return ComparisonIndex == 0; }
+
+	uint32 GetComparisonIndex() const { return ComparisonIndex; }
+	uint32 GetDisplayIndex() const { return DisplayIndex; }
+
+	/** Compare the spelling too (e.g. "Albedo" vs "albedo" are equal FNames but not IsEqualCaseSensitive). */
+	bool IsEqualCaseSensitive(const FName& Other) const { return DisplayIndex == Other.DisplayIndex; }
+
+	bool operator==(const FName& Other) const { return ComparisonIndex == Other.ComparisonIndex; }
+	bool operator!=(const FName& Other) const { return ComparisonIndex != Other.ComparisonIndex; }
+	bool operator<(const FName& Other) const { return ComparisonIndex < Other.ComparisonIndex; }
+
+	/** Case-insensitive compare against a raw string. Does not intern Other. */
+	CORE_API bool operator==(const TCHAR* Other) const;
+	bool operator!=(const TCHAR* Other) const { return !(*this == Other); }
+
+	/** Case-insensitive lexical ordering of the display strings. */
+	CORE_API static bool LexicalLess(const FName& A, const FName& B);
+
+	/** Look up a name without adding it. Returns NAME_None if it was never interned. */
+	CORE_API static FName Find(const TCHAR* InName);
+
+	/** Number of distinct spellings currently stored in the name table. */
+	CORE_API static uint32 GetNumNames();
+
+private:
+	CORE_API void Init(const TCHAR* InName, size_t InLen);
+
+	uint32 ComparisonIndex = 0;
+	uint32 DisplayIndex = 0;
+};
+
+#define NAME_None FName()
+
+inline std::ostream& operator<<(std::ostream& Out, const FName& Name)
+{
+	return Out << Name.ToString();
+}
+
+namespace std {
+template<>
+struct hash<FName>
+{
+	size_t operator()(const FName& Name) const noexcept
+	{
+		// Indices are dense; spread them so power-of-two bucket counts behave.
+		return static_cast<size_t>(static_cast<uint64>(Name.GetComparisonIndex()) * 0x9E3779B97F4A7C15ull);
+	}
+};
+} // namespace std
+
+// TMap hash/equality policies (primary templates in Containers/Map.h). Transparent so that
+// Find("Name") resolves through FName::Find() instead of interning a new name.
+template<typename KeyType> struct TMapHash;
+template<typename KeyType> struct TMapKeyEqual;
+
+template<>
+struct TMapHash<FName>
+{
+	using is_transparent = void;
+	size_t operator()(const FName& Key) const { return std::hash<FName>()(Key); }
+	size_t operator()(const TCHAR* Key) const { return std::hash<FName>()(FName::Find(Key)); }
+	size_t operator()(const FString& Key) const { return (*this)(Key.c_str()); }
+};
+
+template<>
+struct TMapKeyEqual<FName>
+{
+	using is_transparent = void;
+	bool operator()(const FName& A, const FName& B) const { return A == B; }
+	bool operator()(const FName& A, const TCHAR* B) const { return A == B; }
+	bool operator()(const FName& A, const FString& B) const { return A == B.c_str(); }
+};
+
+/**
+ * Case-sensitive TMap policies, keyed on the DisplayIndex: for caches of names that are
+ * case-sensitive downstream (e.g. GLSL identifiers), where "Albedo" and "albedo" must not share
+ * an entry. Usage: TMap<FName, V, FNameCaseSensitiveHash, FNameCaseSensitiveKeyEqual>.
+ */
+struct FNameCaseSensitiveHash
+{
+	size_t operator()(const FName& Key) const
+	{
+		return static_cast<size_t>(static_cast<uint64>(Key.GetDisplayIndex()) * 0x9E3779B97F4A7C15ull);
+	}
+};
+
+struct FNameCaseSensitiveKeyEqual
+{
+	bool operator()(const FName& A, const FName& B) const { return A.IsEqualCaseSensitive(B); }
+};
+
+/** Comparator for ordered containers that should iterate alphabetically (see LexicalLess()). */
+struct FNameLexicalLess
+{
+	bool operator()(const FName& A, const FName& B) const { return FName::LexicalLess(A, B); }
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreUtils.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+/**
+ * FStartupProfiler - wall clock timeline of engine startup
+ *
+ * Records named, categorized scopes (module startup, shader compile/link, init phases) relative
+ * to process start, plus the time-to-first-frame milestone. Recording is thread-safe so scopes
+ * from modules starting on worker threads land on their own track.
+ *
+ * Once the first frame is marked, recording stops: later shader hot reloads and runtime module
+ * loads do not pollute the startup report.
+ *
+ * The report is available in two forms:
+ *  - PrintReport(): a human readable summary on the console.
+ *  - WriteTrace(): Chrome trace event JSON, loadable in chrome://tracing or ui.perfetto.dev.
+ */
+class CORE_API FStartupProfiler
+{
+public:
+	using FClock = std::chrono::steady_clock;
+
+	struct FEvent
+	{
+		FString Category;
+		FString Name;
+		double StartMs = 0.0;     // relative to process start
+		double DurationMs = 0.0;
+		uint32 ThreadIndex = 0;   // 0 is the thread that created the profiler (the main thread)
+	};
+
+	/** Process wide profiler. Its origin is the moment the Core module was loaded. */
+	static FStartupProfiler& Get();
+
+	/** Standalone profilers (e.g. in tests) measure from their construction. */
+	FStartupProfiler();
+	explicit FStartupProfiler(FClock::time_point InOrigin);
+
+	/** Record a finished scope. Ignored once the first frame has been marked. */
+	void AddEvent(const FString& Category, const FString& Name, FClock::time_point Start, FClock::time_point End);
+
+	/** Record the first presented frame. Only the first call has an effect. */
+	void MarkFirstFrame();
+	void MarkFirstFrame(FClock::time_point When);
+
+	bool HasFirstFrame() const;
+	/** Milliseconds from process start to the end of the first frame, or -1 if not reached yet. */
+	double GetTimeToFirstFrameMs() const;
+	/** Milliseconds elapsed since process start. */
+	double GetElapsedMs() const;
+
+	/** Snapshot of every recorded event, ordered by start time. */
+	TArray<FEvent> GetEvents() const;
+	/** Sum of all event durations in a category, e.g. total "Shader" time across threads. */
+	double GetCategoryTotalMs(const FString& Category) const;
+
+	void PrintReport(std::ostream& Out) const;
+	/** Writes Chrome trace event JSON to Filename, creating parent directories. */
+	bool WriteTrace(const FString& Filename) const;
+
+	/** Default location of the startup trace: <ProjectDir>/Saved/Profiling/StartupTrace.json */
+	static FString GetDefaultTracePath();
+
+private:
+	double ToMs(FClock::time_point Time) const;
+	uint32 GetThreadIndexLocked(std::thread::id Id);
+
+	FClock::time_point Origin;
+	mutable std::mutex Mutex;
+	TArray<FEvent> Events;
+	TArray<std::thread::id> Threads;
+	double TimeToFirstFrameMs = -1.0;
+};
+
+/** RAII scope that reports its lifetime to a startup profiler. */
+class CORE_API FStartupScope
+{
+public:
+	FStartupScope(const TCHAR* InCategory, FString InName, FStartupProfiler& InProfiler = FStartupProfiler::Get());
+	~FStartupScope();
+
+	FStartupScope(const FStartupScope&) = delete;
+	FStartupScope& operator=(const FStartupScope&) = delete;
+
+private:
+	FStartupProfiler& Profiler;
+	const TCHAR* Category;
+	FString Name;
+	FStartupProfiler::FClock::time_point Start;
+};
+
+#define STARTUP_SCOPE_CONCAT_INNER(A, B) A##B
+#define STARTUP_SCOPE_CONCAT(A, B) STARTUP_SCOPE_CONCAT_INNER(A, B)
+
+/** Times the rest of the enclosing block, e.g. STARTUP_SCOPE("Init", "CreateEditor"); */
+#define STARTUP_SCOPE(Category, Name) FStartupScope STARTUP_SCOPE_CONCAT(StartupScope_, __LINE__)(Category, Name)
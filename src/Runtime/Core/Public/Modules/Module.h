@@ -3,6 +3,9 @@
 
 #include "ModuleInterface.h"
 #include "ModuleDescriptor.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #if defined(_WIN32)
 #include <windows.h>
@@ -21,6 +24,10 @@ struct FModuleInfo
 	FUniquePtr<IModuleInterface> ModuleInstance;
 	FModuleDescriptor Descriptor;
 	bool bIsLoaded = false;
+	
+	/** Set while StartupModule is running, possibly on a worker thread */
+	bool bIsStarting = false;
+	std::thread::id StartingThread;
 };
 
 class FModuleManager {
@@ -33,7 +40,7 @@ public:
         IModuleInterface* module = Get().GetModule(name);
         if (!module) {
             // Handle error: module not found
-            throw std::runtime_error("Module not found: " + std::string(name));
+            throw std::runtime_error("Module not found: " + name.ToString());
         }
         return static_cast<ModuleType&>(*module);
     }
@@ -48,9 +55,22 @@ public:
     // Check if module is loaded
     CORE_API bool IsModuleLoaded(const FName& name) const;
     
-    // Load module by name (searches in known module paths)
+    // Load module by name (searches in known module paths). Dependencies are started first,
+    // serially on the calling thread; safe to call from another module's StartupModule.
     CORE_API bool LoadModule(const FName& name);
     
+    // Load a set of modules and their dependencies. Independent modules are started concurrently
+    // on worker threads (unless parallel startup is disabled); main-thread-only modules run on
+    // the calling thread, which must be the main thread. Fails on missing modules and cycles.
+    CORE_API bool LoadModules(const TArray<FName>& names);
+    
+    // Load every registered module whose descriptor has the given loading phase
+    CORE_API bool LoadModulesForPhase(ELoadingPhase phase);
+    
+    // Parallel startup is on by default; disable for debugging startup order issues
+    CORE_API void SetParallelStartupEnabled(bool bEnabled);
+    CORE_API bool IsParallelStartupEnabled() const;
+    
     // Unload a specific module
     CORE_API void UnloadModule(const FName& name);
     
@@ -71,10 +91,26 @@ public:
     CORE_API TArray<FName> GetModulesByType(EModuleType type) const;
     
 private:
-    FModuleManager() = default;
+    FModuleManager();
+    
+    // Builds the dependency DAG rooted at names and runs StartupModule for every node
+    bool StartupModuleGraph(const TArray<FName>& names, bool bAllowParallel);
+    bool StartupSingleModule(const FName& name, IModuleInterface* instance);
+    // True when waiting for name, which another thread is starting, would close a cycle of
+    // threads waiting on each other's modules. Called with modulesMutex held.
+    bool WouldDeadlockWaitingFor(const FName& name) const;
+    
+    // Guards the maps below and the per-module load state. Never held while calling into modules.
+    mutable std::mutex modulesMutex;
+    std::condition_variable moduleStateChanged;
+    std::thread::id mainThreadId;
+    bool bParallelStartup = true;
+    TArray<FName> startupOrder; // in order of completed StartupModule calls
+    
     FMap<FName, FModuleInfo> modules;
     FMap<FName, FPluginDescriptor> availablePlugins;
     FMap<FName, TArray<FName>> loadedPluginModules; // plugin name -> module names
+    FMap<std::thread::id, FName> startupWaits; // thread -> module it waits for another thread to start
 };
 
 
@@ -54,8 +54,15 @@ struct FModuleDescriptor
 	/** Whether this module can be unloaded at runtime */
 	bool bCanUnload = true;
 	
-	/** List of modules this module depends on */
-	TArray<FName> Dependencies;
+	/** List of modules this module depends on (usually only a handful, kept inline) */
+	TInlineArray<FName, 4> Dependencies;
+	
+	/**
+	 * StartupModule must run on the main thread (e.g. it creates the window or owns the graphics
+	 * context). Other modules may be started concurrently on worker threads once their
+	 * dependencies are up.
+	 */
+	bool bMainThreadOnly = false;
 	
 	FModuleDescriptor() = default;
 	
@@ -98,6 +105,6 @@ struct FPluginDescriptor
 	
 	FPluginDescriptor(const FName& InName) : PluginName(InName)
 	{
-		FriendlyName = InName;
+		FriendlyName = InName.ToString();
 	}
 };
@@ -1,6 +1,8 @@
 // Copied from Unreal: Engine\Source\Runtime\Core\Public\Modules\ModuleInterface.h
 #pragma once
 
+struct FModuleDescriptor;
+
 /**
  * Interface class that all module implementations should derive from.  This is used to initialize
  * a module after it's been loaded, and also to clean it up before the module is unloaded.
@@ -27,6 +29,15 @@ public:
 	{
 	}
 
+	/**
+	 * Called once when the module is registered. Override to declare dependencies, loading phase
+	 * and whether StartupModule has to run on the main thread; FModuleManager uses this to order
+	 * startup and to start independent modules in parallel.
+	 */
+	virtual void GetModuleDescriptor(FModuleDescriptor& OutDescriptor) const
+	{
+	}
+
 	/**
 	 * Called before the module has been unloaded
 	 */
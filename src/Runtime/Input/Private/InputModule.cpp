@@ -24,6 +24,10 @@ public:
     // Module interface implementation
     void StartupModule() { initialize(); }
     void ShutdownModule() { shutdown(); }
+    
+    void GetModuleDescriptor(FModuleDescriptor& OutDescriptor) const override {
+        OutDescriptor.Dependencies.Add("CoreEngine");
+    }
 };
 
 // Module instantiation (Legacy, kept for compatibility if needed)
@@ -1,11 +1,15 @@
 #include "Launch.h"
 #include "Misc/Path.h"
+#include "Misc/StartupProfiler.h"
+#include "ShaderArchive.h"
 #include "Renderer.h"
 
 #include "Material.h"
 #include "EditorModule.h"
 #include "MaterialEditor.h"
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
 #include "Modules/Module.h"
 #include "Modules/EngineModules.h"
 #include "RendererModule.h"
@@ -30,6 +34,8 @@ FMainLoop::~FMainLoop()
 
 bool FMainLoop::PreInit(int argc, char** argv)
 {
+    STARTUP_SCOPE("Init", "PreInit");
+
     // Initialize Path globals from command line / environment once at startup
     Path::InitFromCmdLineAndEnv(argc, const_cast<const char**>(argv));
 
@@ -46,6 +52,25 @@ bool FMainLoop::PreInit(int argc, char** argv)
     TotalTickTime = 0.0;
 
 
+    // -SerialModuleStartup: start modules one at a time on the main thread (for debugging startup order)
+    // -ExitAfterFirstFrame / -MaxTimeToFirstFrameMs=<ms>: launch-time checks for automated runs
+    // -StartupTrace=<file>: where to write the startup trace (Chrome trace event JSON)
+    // -NoShaderHotReload: do not watch the shader sources
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-SerialModuleStartup") {
+            FModuleManager::Get().SetParallelStartupEnabled(false);
+        } else if (arg == "-ExitAfterFirstFrame") {
+            bExitAfterFirstFrame = true;
+        } else if (Path::startsWith(arg, "-MaxTimeToFirstFrameMs=")) {
+            MaxTimeToFirstFrameMs = std::atof(arg.c_str() + std::strlen("-MaxTimeToFirstFrameMs="));
+        } else if (Path::startsWith(arg, "-StartupTrace=")) {
+            StartupTracePath = arg.substr(std::strlen("-StartupTrace="));
+        } else if (arg == "-NoShaderHotReload") {
+            bShaderHotReload = false;
+        }
+    }
+
     LoadPreInitModules();
 
     return true;
@@ -53,6 +78,7 @@ bool FMainLoop::PreInit(int argc, char** argv)
 
 void FMainLoop::LoadPreInitModules()
 {
+    STARTUP_SCOPE("Init", "LoadPreInitModules");
     LOG("FMainLoop: Loading PreInit Modules");
     
     // Initialize dynamic module DLLs by calling their exported init functions
@@ -63,23 +89,18 @@ void FMainLoop::LoadPreInitModules()
     InitializeModuleRHI();
     InitializeModuleRenderer();
     InitializeModuleEditor();
-    // Load application module first (if registered)
-    // Get all registered application modules and load them
-    const auto& appModules = FModuleManager::Get().GetModulesByType(EModuleType::Application);
-    for (const auto& modName : appModules) {
-        LOG("FMainLoop: Loading Application Module: " << modName);
-        FModuleManager::Get().LoadModule(modName);
+
+    // Start every registered module in dependency order. Each module declares its dependencies,
+    // loading phase and main-thread requirement (IModuleInterface::GetModuleDescriptor); independent
+    // modules start concurrently on worker threads.
+    {
+        STARTUP_SCOPE("Init", "LoadModulesForPhase(PreInit)");
+        FModuleManager::Get().LoadModulesForPhase(ELoadingPhase::PreInit);
+    }
+    {
+        STARTUP_SCOPE("Init", "LoadModulesForPhase(Default)");
+        FModuleManager::Get().LoadModulesForPhase(ELoadingPhase::Default);
     }
-    
-    // Load core engine modules in order
-    // Platform must be loaded before RHI and Renderer
-    FModuleManager::Get().LoadModule("CoreEngine");
-    FModuleManager::Get().LoadModule("Launch");
-    FModuleManager::Get().LoadModule("Platform");  // Load Platform before RHI
-    FModuleManager::Get().LoadModule("Input");     // Load Input module
-    FModuleManager::Get().LoadModule("RHI");
-    FModuleManager::Get().LoadModule("Renderer");
-    FModuleManager::Get().LoadModule("Editor");
 
     // Example: Discover and list available plugins
     // In a real project, you would specify your plugins directory
@@ -107,36 +128,68 @@ void FMainLoop::LoadPreInitModules()
 
 bool FMainLoop::Init()
 {
+    STARTUP_SCOPE("Init", "Init");
     try {
+        {
+            STARTUP_SCOPE("Init", "LoadModulesForPhase(PostDefault)");
+            FModuleManager::Get().LoadModulesForPhase(ELoadingPhase::PostDefault);
+        }
+
         // Initialize renderer
-        renderer = std::make_unique<CarrotToy::Renderer>();
-        if (!renderer->initialize(1280, 720, "CarrotToy - Material Editor")) {
-            std::cerr << "Failed to initialize renderer" << std::endl;
-            return false;
+        {
+            STARTUP_SCOPE("Init", "Renderer::initialize");
+            renderer = std::make_unique<CarrotToy::Renderer>();
+            if (!renderer->initialize(1280, 720, "CarrotToy - Material Editor")) {
+                std::cerr << "Failed to initialize renderer" << std::endl;
+                return false;
+            }
         }
 
-        // Create default shader
-        auto defaultShader = std::make_shared<CarrotToy::Shader>(
-            "shaders/default.vs.spv",
-            "shaders/default.ps.spv"
-        );
-        defaultShader->reload();
-        defaultShader->linkProgram();
-        // Create default material
-        defaultMaterial = CarrotToy::MaterialManager::getInstance().createMaterial(
-            "DefaultPBR",
-            defaultShader
-        );
-        defaultMaterial->setVec3("albedo", 0.8f, 0.2f, 0.2f);
-        defaultMaterial->setFloat("metallic", 0.5f);
-        defaultMaterial->setFloat("roughness", 0.5f);
+        {
+            STARTUP_SCOPE("Init", "CreateDefaultMaterial");
+            // Cooked shaders; loose files under shaders/ still take precedence. Optional.
+            FShaderArchive::Mount("shaders/Shaders.pak", "shaders");
+
+            // Create default shader
+            auto defaultShader = std::make_shared<CarrotToy::Shader>(
+                "shaders/default.vs.spv",
+                "shaders/default.ps.spv"
+            );
+            // Keywords of default.ps.hlsl; materials pick variants with Material::setKeyword
+            defaultShader->declareKeyword("ENABLE_SPECULAR", 0, true);
+            defaultShader->declareEnumKeyword("TONEMAP", 1, { "None", "Reinhard", "ACES" }, 1);
+            defaultShader->reload();
+            defaultShader->linkProgram();
+            // Linked synchronously; stands in for materials whose shaders are still compiling
+            CarrotToy::Shader::setPlaceholderShader(defaultShader);
+            // Shader sources are recompiled into the loaded shaders/ folder as they change
+            if (bShaderHotReload) {
+                renderer->enableShaderHotReload(Path::ShaderWorkingDir(), "shaders");
+            }
+            // Create default material
+            defaultMaterial = CarrotToy::MaterialManager::getInstance().createMaterial(
+                "DefaultPBR",
+                defaultShader
+            );
+            defaultMaterial->setVec3("albedo", 0.8f, 0.2f, 0.2f);
+            defaultMaterial->setFloat("metallic", 0.5f);
+            defaultMaterial->setFloat("roughness", 0.5f);
+        }
 
         // Initialize material editor
-        auto& editorMod = FModuleManager::Get().GetModuleChecked<FEditorModule>("Editor");
-        editor = editorMod.CreateEditor(renderer.get());
-        if (!editor) {
-            std::cerr << "Failed to initialize material editor" << std::endl;
-            return false;
+        {
+            STARTUP_SCOPE("Init", "CreateEditor");
+            auto& editorMod = FModuleManager::Get().GetModuleChecked<FEditorModule>("Editor");
+            editor = editorMod.CreateEditor(renderer.get());
+            if (!editor) {
+                std::cerr << "Failed to initialize material editor" << std::endl;
+                return false;
+            }
+        }
+
+        {
+            STARTUP_SCOPE("Init", "LoadModulesForPhase(PostEngineInit)");
+            FModuleManager::Get().LoadModulesForPhase(ELoadingPhase::PostEngineInit);
         }
 
     } catch (const std::exception& e) {
@@ -187,6 +240,12 @@ void FMainLoop::Tick()
 
         renderer->endFrame();
 
+        // The first swap is the end of startup
+        if (FrameCounter == 0) {
+            FStartupProfiler::Get().MarkFirstFrame();
+            ReportStartup();
+        }
+
         // Check for window close
         if (renderer->shouldClose()) {
             ShouldExit = true;
@@ -212,6 +271,26 @@ void FMainLoop::Tick()
     }
 }
 
+void FMainLoop::ReportStartup()
+{
+    FStartupProfiler& profiler = FStartupProfiler::Get();
+    profiler.PrintReport(std::cout);
+
+    const std::string tracePath = StartupTracePath.empty() ? FStartupProfiler::GetDefaultTracePath() : StartupTracePath;
+    if (profiler.WriteTrace(tracePath)) {
+        LOG("FMainLoop: Startup trace written to " << tracePath);
+    }
+
+    const double timeToFirstFrameMs = profiler.GetTimeToFirstFrameMs();
+    if (MaxTimeToFirstFrameMs > 0.0 && timeToFirstFrameMs > MaxTimeToFirstFrameMs) {
+        LOG("FMainLoop: Time to first frame " << timeToFirstFrameMs << " ms exceeds budget of " << MaxTimeToFirstFrameMs << " ms");
+        ExitCode = 1;
+    }
+    if (bExitAfterFirstFrame) {
+        ShouldExit = true;
+    }
+}
+
 void FMainLoop::Exit()
 {
     LOG("FMainLoop: Exiting");
@@ -221,11 +300,13 @@ void FMainLoop::Exit()
         editor->shutdown();
         editor.reset();
     }
+    CarrotToy::Shader::setPlaceholderShader(nullptr);
     if (renderer) {
         renderer->shutdown();
         renderer.reset();
     }
     defaultMaterial.reset();
+    FShaderArchive::UnmountAll();
     
     // Shutdown all modules in proper order
     FModuleManager::Get().ShutdownAll();
@@ -10,6 +10,12 @@ void FLaunchModule::StartupModule()
 	// Main loop setup, engine loop initialization
 }
 
+void FLaunchModule::GetModuleDescriptor(FModuleDescriptor& OutDescriptor) const
+{
+	OutDescriptor.LoadingPhase = ELoadingPhase::PreInit;
+	OutDescriptor.Dependencies.Add("CoreEngine");
+}
+
 void FLaunchModule::ShutdownModule()
 {
 	LOG("LaunchModule: Shutdown - Shutting down launch subsystem");
@@ -33,5 +33,5 @@ Renderer / UI / Input / Editor 等
         GEngineLoop.Tick();
     }
     GEngineLoop.Exit();
-    return 0;
+    return GEngineLoop.GetExitCode();
 }
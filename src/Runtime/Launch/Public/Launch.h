@@ -26,10 +26,15 @@ public:
 private:
 	// Load modules required before Init()
 	void LoadPreInitModules();
+	// Print the startup report, write the trace file and check the time-to-first-frame budget
+	void ReportStartup();
 	
 public:
 	bool ShouldExit = false;
 
+	// Process exit code; non-zero when a startup budget check failed
+	int GetExitCode() const { return ExitCode; }
+
 protected:
 	// Timing / profiling
 	std::chrono::high_resolution_clock::time_point LastTime;
@@ -38,6 +43,14 @@ protected:
 	std::vector<float> FrameTimes; // ms
 	double TotalTickTime = 0.0;
 
+	// Startup profiling (see FStartupProfiler)
+	bool bExitAfterFirstFrame = false;   // -ExitAfterFirstFrame
+	double MaxTimeToFirstFrameMs = 0.0;  // -MaxTimeToFirstFrameMs=<ms>, 0 disables the check
+	std::string StartupTracePath;        // -StartupTrace=<file>, defaults to Saved/Profiling
+	int ExitCode = 0;
+
+	bool bShaderHotReload = true;        // -NoShaderHotReload
+
 	// Fixed timestep target (seconds)
 	double FixedDt = 1.0 / 60.0;
 	// Max accumulated time to avoid spiral of death
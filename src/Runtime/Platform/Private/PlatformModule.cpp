@@ -130,6 +130,12 @@ public:
         CarrotToy::Platform::PlatformSubsystem::Get().Initialize();
     }
     
+    virtual void GetModuleDescriptor(FModuleDescriptor& OutDescriptor) const override {
+        // GLFW must be initialized and pumped from the main thread
+        OutDescriptor.Dependencies.Add("CoreEngine");
+        OutDescriptor.bMainThreadOnly = true;
+    }
+    
     virtual void ShutdownModule() override {
         LOG("PlatformModule: Shutdown - Shutting down Platform subsystem");
         CarrotToy::Platform::PlatformSubsystem::Get().Shutdown();
@@ -0,0 +1,84 @@
+#include "OpenGLDeletionQueue.h"
+#include <algorithm>
+
+namespace CarrotToy {
+namespace RHI {
+
+void OpenGLDeletionQueue::shutdown() {
+    std::vector<PendingObject> remaining;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        remaining.swap(queued);
+    }
+    for (RetiringBatch& batch : retiring) {
+        glDeleteSync(batch.fence);
+        deleteObjects(batch.objects);
+    }
+    retiring.clear();
+    deleteObjects(remaining);
+}
+
+void OpenGLDeletionQueue::enqueue(ObjectType type, GLuint name) {
+    if (name == 0) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!closed) {
+        queued.push_back({ type, name });
+    }
+}
+
+void OpenGLDeletionQueue::endFrame() {
+    RetiringBatch batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch.objects.swap(queued);
+    }
+    if (!batch.objects.empty()) {
+        batch.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        retiring.push_back(std::move(batch));
+    }
+
+    // Never waits: a batch whose frame is still in flight stays for a later endFrame
+    while (!retiring.empty()) {
+        RetiringBatch& oldest = retiring.front();
+        if (oldest.fence && glClientWaitSync(oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED) {
+            break;
+        }
+        glDeleteSync(oldest.fence);
+        deleteObjects(oldest.objects);
+        retiring.pop_front();
+    }
+}
+
+void OpenGLDeletionQueue::deleteObjects(std::vector<PendingObject>& objects) {
+    std::sort(objects.begin(), objects.end(), [](const PendingObject& a, const PendingObject& b) {
+        return a.type < b.type;
+    });
+
+    std::vector<GLuint> names;
+    for (size_t first = 0; first < objects.size();) {
+        const ObjectType type = objects[first].type;
+        size_t last = first;
+        names.clear();
+        while (last < objects.size() && objects[last].type == type) {
+            names.push_back(objects[last++].name);
+        }
+        const GLsizei count = static_cast<GLsizei>(names.size());
+        switch (type) {
+            case ObjectType::Buffer:      glDeleteBuffers(count, names.data()); break;
+            case ObjectType::Texture:     glDeleteTextures(count, names.data()); break;
+            case ObjectType::Framebuffer: glDeleteFramebuffers(count, names.data()); break;
+            case ObjectType::VertexArray: glDeleteVertexArrays(count, names.data()); break;
+            case ObjectType::Shader:
+                for (GLuint name : names) glDeleteShader(name);
+                break;
+            case ObjectType::Program:
+                for (GLuint name : names) glDeleteProgram(name);
+                break;
+        }
+        first = last;
+    }
+}
+
+} // namespace RHI
+} // namespace CarrotToy
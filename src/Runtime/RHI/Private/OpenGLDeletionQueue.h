@@ -0,0 +1,64 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace CarrotToy {
+namespace RHI {
+
+// Deferred deletion of GL object names, owned by an OpenGLRHIDevice.
+//
+// Resources hand their names over here from release() instead of calling glDelete* themselves,
+// on whichever thread dropped the last reference, which may be a loader or worker thread without
+// the GL context. Names are only ever deleted on the context's thread: endFrame() puts a fence
+// behind the frame's commands and deletes the names queued during a frame once that fence has
+// signalled, so neither the frame nor a worker thread ever waits for the driver to tear down
+// objects the GPU may still be using. Deleting a large material set costs a few glDelete* calls
+// per type, a frame or two later.
+//
+// enqueue() is safe on any thread; the other methods must be called on the GL context's thread.
+// After shutdown() the context is going away and takes its objects with it, so names released
+// later are dropped.
+class OpenGLDeletionQueue {
+public:
+    enum class ObjectType : uint8_t {
+        Buffer,
+        Texture,
+        Framebuffer,
+        VertexArray,
+        Shader,
+        Program
+    };
+
+    // Deletes everything still queued, without waiting for the GPU
+    void shutdown();
+
+    void enqueue(ObjectType type, GLuint name);
+    void endFrame();
+
+private:
+    struct PendingObject {
+        ObjectType type;
+        GLuint name;
+    };
+    struct RetiringBatch {
+        std::vector<PendingObject> objects;
+        GLsync fence = nullptr;
+    };
+
+    // Sorts objects by type so each type goes out in a single call where GL allows it
+    static void deleteObjects(std::vector<PendingObject>& objects);
+
+    std::mutex mutex;
+    // Queued since the last endFrame; guarded by mutex, as is closed
+    std::vector<PendingObject> queued;
+    bool closed = false;
+    // Oldest first, each waiting for its frame's fence
+    std::deque<RetiringBatch> retiring;
+};
+
+} // namespace RHI
+} // namespace CarrotToy
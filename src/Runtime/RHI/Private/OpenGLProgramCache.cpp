@@ -0,0 +1,232 @@
+#include "OpenGLProgramCache.h"
+#include "Misc/Path.h"
+#include <glad/glad.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace CarrotToy {
+namespace RHI {
+
+namespace {
+
+// Bump when the file layout changes; it is part of the driver hash, so old files are pruned.
+constexpr uint32_t kCacheVersion = 1;
+constexpr uint32_t kCacheMagic = 0x42505443; // 'CTPB'
+
+struct ProgramCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t driverHash;
+    uint32_t binaryFormat;
+    uint32_t binaryLength;
+    uint32_t stageCount;
+    uint32_t reserved;
+};
+
+std::string getGLString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+} // namespace
+
+OpenGLProgramCache& OpenGLProgramCache::get() {
+    static OpenGLProgramCache instance;
+    return instance;
+}
+
+void OpenGLProgramCache::initialize() {
+    enabled = false;
+    knownStages.Empty();
+    entries.Empty();
+
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount <= 0) {
+        LOG("OpenGLProgramCache: Driver exposes no program binary formats, cache disabled");
+        return;
+    }
+
+    const std::string driver = getGLString(GL_VENDOR) + "|" + getGLString(GL_RENDERER) + "|" +
+        getGLString(GL_VERSION) + "|" + getGLString(GL_SHADING_LANGUAGE_VERSION);
+    driverHash = FHash::Fnv1a64(driver.data(), driver.size());
+    driverHash = FHash::Fnv1a64(&kCacheVersion, sizeof(kCacheVersion), driverHash);
+
+    const std::filesystem::path root = Path::ProjectDir() + "/Saved/ShaderCache/OpenGL";
+    directory = (root / FHash::ToHex(driverHash)).generic_string();
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        LOG("OpenGLProgramCache: Cannot create " << directory << ": " << ec.message() << ", cache disabled");
+        return;
+    }
+
+    // Binaries from other drivers (or older cache versions) can never be loaded again
+    for (const auto& entry : std::filesystem::directory_iterator(root, ec)) {
+        if (entry.is_directory() && entry.path().filename() != FHash::ToHex(driverHash)) {
+            std::filesystem::remove_all(entry.path(), ec);
+        }
+    }
+
+    enabled = true;
+    scanDirectory();
+    LOG("OpenGLProgramCache: " << entries.Num() << " cached program(s) in " << directory);
+}
+
+void OpenGLProgramCache::shutdown() {
+    enabled = false;
+    knownStages.Empty();
+    entries.Empty();
+}
+
+uint64_t OpenGLProgramCache::computeProgramKey(const uint64_t* stageHashes, size_t stageCount) const {
+    uint64_t key = FHash::Fnv1a64(&driverHash, sizeof(driverHash));
+    return FHash::Fnv1a64(stageHashes, stageCount * sizeof(uint64_t), key);
+}
+
+std::string OpenGLProgramCache::getEntryPath(uint64_t key) const {
+    return directory + "/" + FHash::ToHex(key) + ".bin";
+}
+
+void OpenGLProgramCache::scanDirectory() {
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".bin") {
+            continue;
+        }
+
+        // Only the header and stage list are read here; the binary itself is read on demand
+        std::ifstream file(entry.path(), std::ios::binary);
+        ProgramCacheHeader header{};
+        bool valid = file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+            header.magic == kCacheMagic && header.version == kCacheVersion &&
+            header.driverHash == driverHash && header.stageCount > 0 && header.stageCount <= 8;
+
+        TInlineArray<uint64_t, 4> stages;
+        if (valid) {
+            stages.SetNum(header.stageCount);
+            valid = static_cast<bool>(file.read(reinterpret_cast<char*>(stages.GetData()), header.stageCount * sizeof(uint64_t)));
+        }
+        if (!valid) {
+            file.close();
+            std::filesystem::remove(entry.path(), ec);
+            continue;
+        }
+
+        for (uint64_t stage : stages) {
+            ++knownStages.FindOrAdd(stage);
+        }
+        entries.Add(header.key, std::move(stages));
+    }
+}
+
+void OpenGLProgramCache::forgetEntry(uint64_t key) {
+    if (const auto* stages = entries.Find(key)) {
+        for (uint64_t stage : *stages) {
+            uint32_t* count = knownStages.Find(stage);
+            if (count && --(*count) == 0) {
+                knownStages.Remove(stage);
+            }
+        }
+        entries.Remove(key);
+    }
+    std::error_code ec;
+    std::filesystem::remove(getEntryPath(key), ec);
+}
+
+bool OpenGLProgramCache::load(uint64_t key, unsigned int program) {
+    if (!enabled || !entries.Contains(key)) {
+        return false;
+    }
+
+    std::ifstream file(getEntryPath(key), std::ios::binary);
+    ProgramCacheHeader header{};
+    bool valid = file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+        header.magic == kCacheMagic && header.key == key && header.driverHash == driverHash;
+
+    std::vector<char> binary;
+    if (valid) {
+        file.seekg(sizeof(header) + header.stageCount * sizeof(uint64_t), std::ios::beg);
+        binary.resize(header.binaryLength);
+        valid = static_cast<bool>(file.read(binary.data(), binary.size()));
+    }
+    file.close();
+
+    if (valid) {
+        glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        valid = success != 0;
+    }
+
+    if (!valid) {
+        // The driver may reject binaries after an update that kept the version string
+        LOG("OpenGLProgramCache: Discarding unusable entry " << FHash::ToHex(key));
+        forgetEntry(key);
+        return false;
+    }
+    return true;
+}
+
+void OpenGLProgramCache::store(uint64_t key, unsigned int program, const uint64_t* stageHashes, size_t stageCount) {
+    if (!enabled || entries.Contains(key)) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum binaryFormat = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &binaryFormat, binary.data());
+    if (written <= 0) {
+        return;
+    }
+
+    ProgramCacheHeader header{};
+    header.magic = kCacheMagic;
+    header.version = kCacheVersion;
+    header.key = key;
+    header.driverHash = driverHash;
+    header.binaryFormat = binaryFormat;
+    header.binaryLength = static_cast<uint32_t>(written);
+    header.stageCount = static_cast<uint32_t>(stageCount);
+
+    // Write to a temporary file and rename, so a crash never leaves a truncated entry behind
+    const std::string path = getEntryPath(key);
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(stageHashes), stageCount * sizeof(uint64_t));
+        file.write(binary.data(), written);
+        if (!file) {
+            LOG("OpenGLProgramCache: Failed to write " << tempPath);
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return;
+    }
+
+    TInlineArray<uint64_t, 4> stages;
+    stages.Append(stageHashes, stageCount);
+    for (uint64_t stage : stages) {
+        ++knownStages.FindOrAdd(stage);
+    }
+    entries.Add(key, std::move(stages));
+}
+
+} // namespace RHI
+} // namespace CarrotToy
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreUtils.h"
+#include "Misc/Hash.h"
+#include <string>
+
+namespace CarrotToy {
+namespace RHI {
+
+// On-disk cache of linked OpenGL program binaries (glGetProgramBinary / glProgramBinary).
+//
+// A program is keyed by the hash of its stage binaries (stage type, source format, entry point
+// and the SPIR-V/GLSL bytes, in attach order) mixed with a hash of the driver string
+// (vendor, renderer, GL and GLSL version). Changing any input yields a different key, so stale
+// entries are never loaded. Entries written by another driver live in their own subdirectory and
+// are removed on startup.
+//
+// Layout: <ProjectDir>/Saved/ShaderCache/OpenGL/<driver hash>/<program key>.bin
+//
+// Stages that appear in a cached program are known to compile on this driver. OpenGLShader uses
+// that to defer its GL compile until a program actually misses the cache.
+//
+// All methods must be called on the thread that owns the GL context.
+class OpenGLProgramCache {
+public:
+    static OpenGLProgramCache& get();
+
+    // Called once the GL context is current. Disables the cache if the driver exposes no
+    // program binary formats.
+    void initialize();
+    void shutdown();
+
+    bool isEnabled() const { return enabled; }
+
+    uint64_t computeProgramKey(const uint64_t* stageHashes, size_t stageCount) const;
+
+    // True if stageHash is part of a cached program for the current driver
+    bool isKnownStage(uint64_t stageHash) const { return knownStages.Contains(stageHash); }
+
+    // Loads the cached binary into program. On failure the (stale or corrupt) entry is deleted
+    // and the caller should link from source.
+    bool load(uint64_t key, unsigned int program);
+
+    // Stores the binary of a successfully linked program.
+    void store(uint64_t key, unsigned int program, const uint64_t* stageHashes, size_t stageCount);
+
+private:
+    std::string getEntryPath(uint64_t key) const;
+    void scanDirectory();
+    void forgetEntry(uint64_t key);
+
+    bool enabled = false;
+    uint64_t driverHash = 0;
+    std::string directory;
+    // Stage hash -> number of cached programs that contain it
+    TMap<uint64_t, uint32_t> knownStages;
+    // Program key -> its stage hashes, so removing an entry can update knownStages
+    TMap<uint64_t, TInlineArray<uint64_t, 4>> entries;
+};
+
+} // namespace RHI
+} // namespace CarrotToy
@@ -1,4 +1,9 @@
 #include "RHI/OpenGLRHI.h"
+#include "OpenGLDeletionQueue.h"
+#include "OpenGLProgramCache.h"
+#include "OpenGLStreamBuffer.h"
+#include "OpenGLTextureUploader.h"
+#include "RHICommandList.h"
 #include <glad/glad.h>
 #include <iostream>
 #include <cstring>
@@ -9,12 +14,51 @@
 namespace CarrotToy {
 namespace RHI {
 
+// Set at device initialization when GL_KHR/ARB_parallel_shader_compile is available
+static bool GParallelShaderCompile = false;
+// Set at device initialization when GL 4.5 / ARB_direct_state_access is available. Resources then
+// use glCreate* names and are edited directly instead of being bound to a target first.
+static bool GDirectStateAccess = false;
+// Set at device initialization when GL 4.4 / ARB_buffer_storage is available. Stream buffers then
+// get immutable storage that stays mapped.
+static bool GBufferStorage = false;
+// Set at device initialization when GL 4.2 / ARB_texture_storage is available. Textures then get
+// immutable storage and are only ever updated with glTexSubImage2D.
+static bool GTextureStorage = false;
+// Set at device initialization: EXT_texture_compression_s3tc (BC1/BC3) and GL 4.2 /
+// ARB_texture_compression_bptc (BC7). BC5 (RGTC) is core since GL 3.0.
+static bool GTextureCompressionS3TC = false;
+static bool GTextureCompressionBPTC = false;
+// Set at device initialization: GL 4.0 draws indexed geometry with arguments from a buffer, GL 4.3 /
+// ARB_multi_draw_indirect issues a whole array of those in one call
+static bool GDrawIndirect = false;
+static bool GMultiDrawIndirect = false;
+// Set at device initialization when GL 4.3 (or ARB_compute_shader with
+// ARB_shader_storage_buffer_object) provides compute shaders and shader storage buffers
+static bool GCompute = false;
+// Set at device initialization when ARB_bindless_texture lets shaders sample through 64-bit texture
+// handles, e.g. read from a uniform block, instead of texture units
+static bool GBindlessTexture = false;
+// Vertex array bound through OpenGLVertexArray::bind() (0 after unbind()) and its index format;
+// glDrawElements* need the format and GL cannot be asked for it
+static GLuint GBoundVertexArray = 0;
+// See OpenGLProgramBinding
+static GLuint GBoundProgram = 0;
+static IndexFormat GBoundIndexFormat = IndexFormat::UInt32;
+
+// Per frame; the ring behind allocateTransient holds OpenGLStreamBuffer::kFrameCount of these
+static constexpr size_t kTransientFrameSize = 2 * 1024 * 1024;
+// Staging ring for uploadTextureAsync; fits a 2048x2048 RGBA8 image twice
+static constexpr size_t kTextureStagingSize = 32 * 1024 * 1024;
+
 // Helper function to convert RHI types to OpenGL types
 static unsigned int toGLBufferType(BufferType type) {
     switch (type) {
         case BufferType::Vertex:  return GL_ARRAY_BUFFER;
         case BufferType::Index:   return GL_ELEMENT_ARRAY_BUFFER;
         case BufferType::Uniform: return GL_UNIFORM_BUFFER;
+        case BufferType::Indirect: return GL_DRAW_INDIRECT_BUFFER;
+        case BufferType::Storage: return GL_SHADER_STORAGE_BUFFER;
         default: return GL_ARRAY_BUFFER;
     }
 }
@@ -38,6 +82,38 @@ static unsigned int toGLShaderType(ShaderType type) {
     }
 }
 
+// SpecId decorations (OpDecorate <id> SpecId <constant id>) of a SPIR-V module
+static std::vector<uint32_t> getSpirvSpecConstantIDs(const std::string& spirv) {
+    constexpr uint32_t kSpirvMagic = 0x07230203;
+    constexpr uint32_t kOpDecorate = 71;
+    constexpr uint32_t kDecorationSpecId = 1;
+    constexpr size_t kHeaderWords = 5;
+
+    std::vector<uint32_t> ids;
+    const size_t wordCount = spirv.size() / sizeof(uint32_t);
+    if (wordCount < kHeaderWords) {
+        return ids;
+    }
+    std::vector<uint32_t> words(wordCount);
+    std::memcpy(words.data(), spirv.data(), wordCount * sizeof(uint32_t));
+    if (words[0] != kSpirvMagic) {
+        return ids;
+    }
+
+    for (size_t i = kHeaderWords; i < wordCount;) {
+        const uint32_t opWordCount = words[i] >> 16;
+        const uint32_t opcode = words[i] & 0xFFFF;
+        if (opWordCount == 0 || i + opWordCount > wordCount) {
+            break;
+        }
+        if (opcode == kOpDecorate && opWordCount >= 4 && words[i + 2] == kDecorationSpecId) {
+            ids.push_back(words[i + 3]);
+        }
+        i += opWordCount;
+    }
+    return ids;
+}
+
 static unsigned int toGLTextureInternalFormat(TextureFormat format) {
     switch (format) {
         case TextureFormat::RGB8:            return GL_RGB8;
@@ -46,6 +122,10 @@ static unsigned int toGLTextureInternalFormat(TextureFormat format) {
         case TextureFormat::RGBA32F:         return GL_RGBA32F;
         case TextureFormat::Depth24Stencil8: return GL_DEPTH24_STENCIL8;
         case TextureFormat::Depth32F:        return GL_DEPTH_COMPONENT32F;
+        case TextureFormat::BC1:             return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case TextureFormat::BC3:             return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case TextureFormat::BC5:             return GL_COMPRESSED_RG_RGTC2;
+        case TextureFormat::BC7:             return GL_COMPRESSED_RGBA_BPTC_UNORM;
         default: return GL_RGBA8;
     }
 }
@@ -145,9 +225,46 @@ static unsigned int toGLPrimitiveTopology(PrimitiveTopology topology) {
     }
 }
 
+static unsigned int toGLVertexType(VertexFormat format) {
+    switch (format) {
+        case VertexFormat::Float:           return GL_FLOAT;
+        case VertexFormat::Half:            return GL_HALF_FLOAT;
+        case VertexFormat::Snorm16:         return GL_SHORT;
+        case VertexFormat::Unorm8:          return GL_UNSIGNED_BYTE;
+        case VertexFormat::Snorm10_10_10_2: return GL_INT_2_10_10_10_REV;
+        default: return GL_FLOAT;
+    }
+}
+
+static unsigned int toGLIndexType(IndexFormat format) {
+    return format == IndexFormat::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
 // OpenGLBuffer implementation
-OpenGLBuffer::OpenGLBuffer(const BufferDesc& desc)
-    : bufferID(0), type(desc.type), usage(desc.usage), size(desc.size) {
+OpenGLBuffer::OpenGLBuffer(const BufferDesc& desc, std::shared_ptr<OpenGLDeletionQueue> inDeletionQueue)
+    : bufferID(0), deletionQueue(std::move(inDeletionQueue)), type(desc.type), usage(desc.usage), size(desc.size) {
+    if (usage == BufferUsage::Stream && GBufferStorage) {
+        // Mapped once for the buffer's lifetime. Coherent, so writes need no explicit flush;
+        // dynamic storage keeps updateData() working.
+        const GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        if (GDirectStateAccess) {
+            glCreateBuffers(1, &bufferID);
+            glNamedBufferStorage(bufferID, desc.size, desc.initialData, mapFlags | GL_DYNAMIC_STORAGE_BIT);
+            persistentData = glMapNamedBufferRange(bufferID, 0, desc.size, mapFlags);
+        } else {
+            glGenBuffers(1, &bufferID);
+            glBindBuffer(toGLBufferType(type), bufferID);
+            glBufferStorage(toGLBufferType(type), desc.size, desc.initialData, mapFlags | GL_DYNAMIC_STORAGE_BIT);
+            persistentData = glMapBufferRange(toGLBufferType(type), 0, desc.size, mapFlags);
+            glBindBuffer(toGLBufferType(type), 0);
+        }
+        return;
+    }
+    if (GDirectStateAccess) {
+        glCreateBuffers(1, &bufferID);
+        glNamedBufferData(bufferID, desc.size, desc.initialData, toGLBufferUsage(usage));
+        return;
+    }
     glGenBuffers(1, &bufferID);
     glBindBuffer(toGLBufferType(type), bufferID);
     glBufferData(toGLBufferType(type), desc.size, desc.initialData, toGLBufferUsage(usage));
@@ -159,32 +276,60 @@ OpenGLBuffer::~OpenGLBuffer() {
 }
 
 void OpenGLBuffer::updateData(const void* data, size_t updateSize, size_t offset) {
+    if (GDirectStateAccess) {
+        glNamedBufferSubData(bufferID, offset, updateSize, data);
+        return;
+    }
     glBindBuffer(toGLBufferType(type), bufferID);
     glBufferSubData(toGLBufferType(type), offset, updateSize, data);
     glBindBuffer(toGLBufferType(type), 0);
 }
 
 void* OpenGLBuffer::map() {
+    if (persistentData) {
+        return persistentData;
+    }
+    // Stream contents are rewritten whole; invalidating lets the driver hand out fresh memory
+    // instead of waiting for draws still reading the old contents
+    const bool invalidate = usage == BufferUsage::Stream;
+    if (GDirectStateAccess) {
+        if (invalidate) {
+            return glMapNamedBufferRange(bufferID, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        }
+        return glMapNamedBuffer(bufferID, GL_READ_WRITE);
+    }
     glBindBuffer(toGLBufferType(type), bufferID);
+    if (invalidate) {
+        return glMapBufferRange(toGLBufferType(type), 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    }
     void* ptr = glMapBuffer(toGLBufferType(type), GL_READ_WRITE);
     return ptr;
 }
 
 void OpenGLBuffer::unmap() {
+    if (persistentData) {
+        return;
+    }
+    if (GDirectStateAccess) {
+        glUnmapNamedBuffer(bufferID);
+        return;
+    }
     glUnmapBuffer(toGLBufferType(type));
     glBindBuffer(toGLBufferType(type), 0);
 }
 
 void OpenGLBuffer::release() {
     if (bufferID != 0) {
-        glDeleteBuffers(1, &bufferID);
+        // Deleting a mapped buffer unmaps it
+        deletionQueue->enqueue(OpenGLDeletionQueue::ObjectType::Buffer, bufferID);
         bufferID = 0;
+        persistentData = nullptr;
     }
 }
 
 // OpenGLShader implementation
-OpenGLShader::OpenGLShader(const ShaderDesc& desc)
-    : shaderID(0), type(desc.type), format(desc.format), source(desc.source, desc.sourceSize) {
+OpenGLShader::OpenGLShader(const ShaderDesc& desc, std::shared_ptr<OpenGLDeletionQueue> inDeletionQueue)
+    : shaderID(0), deletionQueue(std::move(inDeletionQueue)), type(desc.type), format(desc.format), source(desc.source, desc.sourceSize) {
     shaderID = glCreateShader(toGLShaderType(type));
     if (desc.entryPoint) {
         entryPoint = desc.entryPoint;
@@ -192,6 +337,28 @@ OpenGLShader::OpenGLShader(const ShaderDesc& desc)
         // Default entry points
         entryPoint = (type == ShaderType::Vertex) ? "VSMain" : "PSMain";
     }
+    
+    // Keep only the constants this module declares. A stage that uses none of them stays
+    // bit-identical (same hash) across variants.
+    if (format == ShaderSourceFormat::SPIRV && desc.numSpecializationConstants > 0) {
+        const std::vector<uint32_t> declared = getSpirvSpecConstantIDs(source);
+        for (uint32_t i = 0; i < desc.numSpecializationConstants; ++i) {
+            const ShaderSpecializationConstant& constant = desc.specializationConstants[i];
+            if (std::find(declared.begin(), declared.end(), constant.constantID) != declared.end()) {
+                specConstantIDs.push_back(constant.constantID);
+                specConstantValues.push_back(constant.value);
+            }
+        }
+    }
+    
+    const uint32_t stageInfo[2] = { static_cast<uint32_t>(type), static_cast<uint32_t>(format) };
+    sourceHash = FHash::Fnv1a64(stageInfo, sizeof(stageInfo));
+    sourceHash = FHash::Fnv1a64(entryPoint.data(), entryPoint.size(), sourceHash);
+    sourceHash = FHash::Fnv1a64(source.data(), source.size(), sourceHash);
+    if (!specConstantIDs.empty()) {
+        sourceHash = FHash::Fnv1a64(specConstantIDs.data(), specConstantIDs.size() * sizeof(uint32_t), sourceHash);
+        sourceHash = FHash::Fnv1a64(specConstantValues.data(), specConstantValues.size() * sizeof(uint32_t), sourceHash);
+    }
 }
 
 OpenGLShader::~OpenGLShader() {
@@ -199,6 +366,43 @@ OpenGLShader::~OpenGLShader() {
 }
 
 bool OpenGLShader::compile() {
+    // This exact stage is part of a cached program binary for the current driver, so it is known
+    // to compile. Skip glShaderBinary/glSpecializeShader; link() compiles it if the cache misses.
+    if (OpenGLProgramCache::get().isKnownStage(sourceHash)) {
+        errors.clear();
+        return true;
+    }
+    return submitCompile() && checkCompileStatus();
+}
+
+bool OpenGLShader::compileAsync() {
+    if (OpenGLProgramCache::get().isKnownStage(sourceHash)) {
+        errors.clear();
+        return true;
+    }
+    return submitCompile();
+}
+
+bool OpenGLShader::ensureSubmitted() {
+    return submitted || submitCompile();
+}
+
+bool OpenGLShader::checkCompileStatus() {
+    // With GL_KHR_parallel_shader_compile this is the point where we wait for the driver thread
+    int success;
+    glGetShaderiv(shaderID, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        char infoLog[512];
+        glGetShaderInfoLog(shaderID, 512, nullptr, infoLog);
+        errors = infoLog;
+        return false;
+    }
+    errors.clear();
+    return true;
+}
+
+bool OpenGLShader::submitCompile() {
+    submitted = false;
     if (format == ShaderSourceFormat::SPIRV) {
         // SPIR-V compilation path
         // Check for GL_ARB_gl_spirv extension or OpenGL 4.6+
@@ -222,51 +426,36 @@ bool OpenGLShader::compile() {
 
         glShaderBinary(1, &shaderID, binaryFormat, source.data(), (GLsizei)source.size());
 
-        // Specialize the shader with the entry point
+        // Specialize the shader with the entry point and the variant's constants
+        const GLuint numConstants = static_cast<GLuint>(specConstantIDs.size());
 #ifdef GL_ARB_gl_spirv
-        glSpecializeShaderARB(shaderID, entryPoint.c_str(), 0, nullptr, nullptr);
+        glSpecializeShaderARB(shaderID, entryPoint.c_str(), numConstants, specConstantIDs.data(), specConstantValues.data());
 #else
-        glSpecializeShader(shaderID, entryPoint.c_str(), 0, nullptr, nullptr);
+        glSpecializeShader(shaderID, entryPoint.c_str(), numConstants, specConstantIDs.data(), specConstantValues.data());
 #endif
-
-        int success;
-        glGetShaderiv(shaderID, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            char infoLog[512];
-            glGetShaderInfoLog(shaderID, 512, nullptr, infoLog);
-            errors = infoLog;
-            return false;
-        }
     } else {
         // GLSL compilation path
         const char* src = source.c_str();
         glShaderSource(shaderID, 1, &src, nullptr);
         glCompileShader(shaderID);
-        
-        int success;
-        glGetShaderiv(shaderID, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            char infoLog[512];
-            glGetShaderInfoLog(shaderID, 512, nullptr, infoLog);
-            errors = infoLog;
-            return false;
-        }
     }
     
+    // The status is not queried here: doing so would make the driver finish the compile now
     errors.clear();
+    submitted = true;
     return true;
 }
 
 void OpenGLShader::release() {
     if (shaderID != 0) {
-        glDeleteShader(shaderID);
+        deletionQueue->enqueue(OpenGLDeletionQueue::ObjectType::Shader, shaderID);
         shaderID = 0;
     }
 }
 
 // OpenGLShaderProgram implementation
-OpenGLShaderProgram::OpenGLShaderProgram()
-    : programID(0) {
+OpenGLShaderProgram::OpenGLShaderProgram(std::shared_ptr<OpenGLDeletionQueue> inDeletionQueue)
+    : programID(0), deletionQueue(std::move(inDeletionQueue)) {
     programID = glCreateProgram();
 }
 
@@ -283,16 +472,13 @@ void OpenGLShaderProgram::attachShader(IRHIShader* shader) {
     // Cast to OpenGL shader to get backend-specific handle
     // This is acceptable as this is backend implementation code
     if (auto* glShader = dynamic_cast<OpenGLShader*>(shader)) {
-        unsigned int shaderID = glShader->getShaderID();
-        
         // Check if already attached to avoid duplicates
-        if (std::find(attachedShaders.begin(), attachedShaders.end(), shaderID) != attachedShaders.end()) {
+        if (std::find(attachedShaders.begin(), attachedShaders.end(), glShader) != attachedShaders.end()) {
             std::cerr << "Shader already attached to program" << std::endl;
             return;
         }
         
-        glAttachShader(programID, shaderID);
-        attachedShaders.push_back(shaderID);
+        attachedShaders.push_back(glShader);
     } else {
         std::cerr << "Shader is not an OpenGL shader - cannot attach to OpenGL program" << std::endl;
     }
@@ -305,11 +491,8 @@ void OpenGLShaderProgram::detachShader(IRHIShader* shader) {
     
     // Cast to OpenGL shader to get backend-specific handle
     if (auto* glShader = dynamic_cast<OpenGLShader*>(shader)) {
-        unsigned int shaderID = glShader->getShaderID();
-        glDetachShader(programID, shaderID);
-        
         // Remove from tracking vector
-        auto it = std::find(attachedShaders.begin(), attachedShaders.end(), shaderID);
+        auto it = std::find(attachedShaders.begin(), attachedShaders.end(), glShader);
         if (it != attachedShaders.end()) {
             attachedShaders.erase(it);
         }
@@ -317,77 +500,170 @@ void OpenGLShaderProgram::detachShader(IRHIShader* shader) {
 }
 
 bool OpenGLShaderProgram::link() {
+    if (linkState != LinkState::Pending && !submitLink()) {
+        return false;
+    }
+    return finishLink();
+}
+
+bool OpenGLShaderProgram::linkAsync() {
+    if (linkState == LinkState::Pending) {
+        return true;
+    }
+    return submitLink();
+}
+
+bool OpenGLShaderProgram::isReady() const {
+    if (linkState != LinkState::Pending || !GParallelShaderCompile) {
+        // Without the extension a status query would block anyway; report ready and let link() wait
+        return true;
+    }
+    GLint completed = 0;
+    glGetProgramiv(programID, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed != 0;
+}
+
+bool OpenGLShaderProgram::submitLink() {
+    linkState = LinkState::Unlinked;
+    loadedFromCache = false;
+    uniformLocationCache.Reset();
+    
+    OpenGLProgramCache& cache = OpenGLProgramCache::get();
+    stageHashes.Reset();
+    cacheKey = 0;
+    if (cache.isEnabled()) {
+        for (OpenGLShader* shader : attachedShaders) {
+            stageHashes.Add(shader->getSourceHash());
+        }
+        cacheKey = cache.computeProgramKey(stageHashes.GetData(), stageHashes.Num());
+        if (cache.load(cacheKey, programID)) {
+            loadedFromCache = true;
+            linkState = LinkState::Pending;
+            return true;
+        }
+    }
+    
+    // Cache miss: submit any deferred stages and link from source
+    for (OpenGLShader* shader : attachedShaders) {
+        if (!shader->ensureSubmitted()) {
+            errors = shader->getCompileErrors();
+            linkState = LinkState::Failed;
+            return false;
+        }
+        glAttachShader(programID, shader->getShaderID());
+    }
+    if (cache.isEnabled()) {
+        glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    
     glLinkProgram(programID);
     
+    // The link captured the attached stages, so they can be detached right away
+    for (OpenGLShader* shader : attachedShaders) {
+        glDetachShader(programID, shader->getShaderID());
+    }
+    
+    linkState = LinkState::Pending;
+    return true;
+}
+
+bool OpenGLShaderProgram::finishLink() {
     int success;
     glGetProgramiv(programID, GL_LINK_STATUS, &success);
     if (!success) {
-        char infoLog[512];
-        glGetProgramInfoLog(programID, 512, nullptr, infoLog);
-        errors = infoLog;
+        // A stage that failed to compile explains the failure better than the link log
+        errors.clear();
+        for (OpenGLShader* shader : attachedShaders) {
+            if (!shader->checkCompileStatus()) {
+                errors += shader->getCompileErrors();
+            }
+        }
+        if (errors.empty()) {
+            char infoLog[512];
+            glGetProgramInfoLog(programID, 512, nullptr, infoLog);
+            errors = infoLog;
+        }
+        linkState = LinkState::Failed;
         return false;
     }
+    attachedShaders.clear();
     
-    // Detach shaders after linking
-    for (unsigned int shaderID : attachedShaders) {
-        glDetachShader(programID, shaderID);
+    OpenGLProgramCache& cache = OpenGLProgramCache::get();
+    if (!loadedFromCache && cache.isEnabled()) {
+        cache.store(cacheKey, programID, stageHashes.GetData(), stageHashes.Num());
     }
-    attachedShaders.clear();
     
     errors.clear();
+    linkState = LinkState::Linked;
     return true;
 }
 
+void OpenGLProgramBinding::onBind(uint32_t programID) {
+    GBoundProgram = programID;
+}
+
+void OpenGLProgramBinding::onRelease(uint32_t programID) {
+    if (GBoundProgram == programID) {
+        GBoundProgram = 0;
+    }
+}
+
+bool OpenGLProgramBinding::isBound(uint32_t programID) {
+    return programID != 0 && GBoundProgram == programID;
+}
+
 void OpenGLShaderProgram::bind() {
     glUseProgram(programID);
+    OpenGLProgramBinding::onBind(programID);
 }
 
 void OpenGLShaderProgram::unbind() {
     glUseProgram(0);
+    OpenGLProgramBinding::onBind(0);
 }
 
-int OpenGLShaderProgram::getUniformLocation(const std::string& name) {
-    auto it = uniformLocationCache.find(name);
-    if (it != uniformLocationCache.end()) {
-        return it->second;
+int OpenGLShaderProgram::getUniformLocation(const FName& name) {
+    if (const int* cached = uniformLocationCache.Find(name)) {
+        return *cached;
     }
     
     int location = glGetUniformLocation(programID, name.c_str());
-    uniformLocationCache[name] = location;
+    uniformLocationCache.Add(name, location);
     return location;
 }
 
-void OpenGLShaderProgram::setUniformFloat(const std::string& name, float value) {
+void OpenGLShaderProgram::setUniformFloat(const FName& name, float value) {
     glUniform1f(getUniformLocation(name), value);
 }
 
-void OpenGLShaderProgram::setUniformVec2(const std::string& name, float x, float y) {
+void OpenGLShaderProgram::setUniformVec2(const FName& name, float x, float y) {
     glUniform2f(getUniformLocation(name), x, y);
 }
 
-void OpenGLShaderProgram::setUniformVec3(const std::string& name, float x, float y, float z) {
+void OpenGLShaderProgram::setUniformVec3(const FName& name, float x, float y, float z) {
     glUniform3f(getUniformLocation(name), x, y, z);
 }
 
-void OpenGLShaderProgram::setUniformVec4(const std::string& name, float x, float y, float z, float w) {
+void OpenGLShaderProgram::setUniformVec4(const FName& name, float x, float y, float z, float w) {
     glUniform4f(getUniformLocation(name), x, y, z, w);
 }
 
-void OpenGLShaderProgram::setUniformInt(const std::string& name, int value) {
+void OpenGLShaderProgram::setUniformInt(const FName& name, int value) {
     glUniform1i(getUniformLocation(name), value);
 }
 
-void OpenGLShaderProgram::setUniformBool(const std::string& name, bool value) {
+void OpenGLShaderProgram::setUniformBool(const FName& name, bool value) {
     glUniform1i(getUniformLocation(name), value ? 1 : 0);
 }
 
-void OpenGLShaderProgram::setUniformMatrix4(const std::string& name, const float* value) {
+void OpenGLShaderProgram::setUniformMatrix4(const FName& name, const float* value) {
     glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, value);
 }
 
 void OpenGLShaderProgram::release() {
     if (programID != 0) {
-        glDeleteProgram(programID);
+        OpenGLProgramBinding::onRelease(programID);
+        deletionQueue->enqueue(OpenGLDeletionQueue::ObjectType::Program, programID);
         programID = 0;
     }
 }
@@ -470,28 +746,40 @@ std::vector<UniformVariableInfo> OpenGLShaderProgram::getUniformVariables() cons
 }
 
 // OpenGLTexture implementation
-OpenGLTexture::OpenGLTexture(const TextureDesc& desc)
-    : textureID(0), width(desc.width), height(desc.height), format(desc.format),
-      minFilter(desc.minFilter), magFilter(desc.magFilter), wrapS(desc.wrapS), wrapT(desc.wrapT) {
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    
-    unsigned int internalFormat = toGLTextureInternalFormat(format);
-    unsigned int glFormat = toGLTextureFormat(format);
-    unsigned int dataType = toGLTextureDataType(format);
-    
-    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, glFormat, dataType, desc.initialData);
-    
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, toGLTextureFilter(minFilter));
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, toGLTextureFilter(magFilter));
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, toGLTextureWrap(wrapS));
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, toGLTextureWrap(wrapT));
-    
-    if (desc.generateMipmaps) {
-        glGenerateMipmap(GL_TEXTURE_2D);
+OpenGLTexture::OpenGLTexture(const TextureDesc& desc, std::shared_ptr<OpenGLDeletionQueue> inDeletionQueue)
+    : textureID(0), deletionQueue(std::move(inDeletionQueue)), type(desc.type),
+      target(desc.type == TextureType::Texture2DArray ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D),
+      width(desc.width), height(desc.height), format(desc.format),
+      minFilter(desc.minFilter), magFilter(desc.magFilter), wrapS(desc.wrapS), wrapT(desc.wrapT),
+      mipLevels(desc.mipLevels),
+      arrayLayers(desc.type == TextureType::Texture2DArray ? std::max(1u, desc.arrayLayers) : 1),
+      generatedMips(false) {
+    const bool hasMipData = desc.mipData && desc.mipDataCount > 0;
+    if (desc.generateMipmaps && !hasMipData) {
+        if (isCompressedFormat(format)) {
+            LOG("OpenGLTexture: Mipmaps of compressed textures cannot be generated, pass them as mipData");
+        } else {
+            generatedMips = true;
+        }
+    }
+    if (mipLevels == 0) {
+        if (generatedMips) {
+            mipLevels = getFullMipCount(width, height);
+        } else if (hasMipData) {
+            mipLevels = std::max(1u, desc.mipDataCount / arrayLayers);
+        } else {
+            mipLevels = 1;
+        }
+    }
+    mipLevels = std::min(mipLevels, getFullMipCount(width, height));
+
+    createName();
+    if (hasMipData) {
+        allocateStorage(desc.mipData, std::min(desc.mipDataCount, mipLevels * arrayLayers));
+    } else {
+        const TextureMipData level0{ desc.initialData, getTextureDataSize(format, width, height) };
+        allocateStorage(&level0, desc.initialData ? 1 : 0);
     }
-    
-    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 OpenGLTexture::~OpenGLTexture() {
@@ -499,50 +787,266 @@ OpenGLTexture::~OpenGLTexture() {
 }
 
 void OpenGLTexture::updateData(const void* data, uint32_t newWidth, uint32_t newHeight) {
+    if (newWidth == width && newHeight == height) {
+        if (data) {
+            updateRegion({ 0, 0, width, height }, data);
+        }
+        return;
+    }
+
+    // Levels are kept, as far as the new size has them
     width = newWidth;
     height = newHeight;
-    
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    
-    unsigned int internalFormat = toGLTextureInternalFormat(format);
-    unsigned int glFormat = toGLTextureFormat(format);
-    unsigned int dataType = toGLTextureDataType(format);
-    
-    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, glFormat, dataType, data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    mipLevels = generatedMips ? getFullMipCount(width, height) : std::min(mipLevels, getFullMipCount(width, height));
+    const TextureMipData level0{ data, getTextureDataSize(format, width, height) };
+
+    if (GDirectStateAccess || GTextureStorage || bindlessHandle != 0) {
+        // Immutable storage cannot be resized, nor can a texture that has a handle, so a new
+        // texture replaces it. Framebuffers the old one was attached to have to attach it again;
+        // its handle dies with it and getBindlessHandle() returns a new one.
+        deletionQueue->enqueue(OpenGLDeletionQueue::ObjectType::Texture, textureID);
+        createName();
+        bindlessHandle = 0;
+    }
+    allocateStorage(&level0, data ? 1 : 0);
+}
+
+void OpenGLTexture::updateRegion(const TextureRegion& region, const void* data) {
+    // data is an offset rather than a pointer while a GL_PIXEL_UNPACK_BUFFER is bound, so even
+    // null is uploaded
+    if (region.mipLevel >= mipLevels || region.arrayLayer >= arrayLayers) {
+        LOG("OpenGLTexture: Level " << region.mipLevel << " of layer " << region.arrayLayer << " does not exist ("
+            << mipLevels << " levels, " << arrayLayers << " layers)");
+        return;
+    }
+    const uint32_t levelWidth = getMipSize(width, region.mipLevel);
+    const uint32_t levelHeight = getMipSize(height, region.mipLevel);
+    if (region.x + region.width > levelWidth || region.y + region.height > levelHeight) {
+        LOG("OpenGLTexture: Region " << region.width << "x" << region.height << " at " << region.x << "," << region.y
+            << " is outside the " << levelWidth << "x" << levelHeight << " level " << region.mipLevel);
+        return;
+    }
+    if (isCompressedFormat(format) &&
+        (region.x % 4 != 0 || region.y % 4 != 0 ||
+         (region.width % 4 != 0 && region.x + region.width != levelWidth) ||
+         (region.height % 4 != 0 && region.y + region.height != levelHeight))) {
+        LOG("OpenGLTexture: Region " << region.width << "x" << region.height << " at " << region.x << "," << region.y
+            << " is not aligned to 4x4 blocks");
+        return;
+    }
+
+    uploadSubImage(region, data, getTextureDataSize(format, region.width, region.height));
+    if (generatedMips && region.mipLevel == 0) {
+        regenerateMips();
+    }
 }
 
 void OpenGLTexture::bind(uint32_t slot) {
+    if (GDirectStateAccess) {
+        glBindTextureUnit(slot, textureID);
+        return;
+    }
     glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    glBindTexture(target, textureID);
 }
 
 void OpenGLTexture::unbind() {
-    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindTexture(target, 0);
+}
+
+void OpenGLTexture::createName() {
+    if (GDirectStateAccess) {
+        glCreateTextures(target, 1, &textureID);
+    } else {
+        glGenTextures(1, &textureID);
+    }
+}
+
+void OpenGLTexture::allocateStorage(const TextureMipData* data, uint32_t count) {
+    const unsigned int internalFormat = toGLTextureInternalFormat(format);
+    const bool compressed = isCompressedFormat(format);
+    const bool isArray = type == TextureType::Texture2DArray;
+    
+    if (GDirectStateAccess) {
+        if (isArray) {
+            glTextureStorage3D(textureID, mipLevels, internalFormat, width, height, arrayLayers);
+        } else {
+            glTextureStorage2D(textureID, mipLevels, internalFormat, width, height);
+        }
+        glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, toGLTextureFilter(minFilter));
+        glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, toGLTextureFilter(magFilter));
+        glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, toGLTextureWrap(wrapS));
+        glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, toGLTextureWrap(wrapT));
+        glTextureParameteri(textureID, GL_TEXTURE_MAX_LEVEL, mipLevels - 1);
+    } else {
+        glBindTexture(target, textureID);
+        if (GTextureStorage) {
+            if (isArray) {
+                glTexStorage3D(target, mipLevels, internalFormat, width, height, arrayLayers);
+            } else {
+                glTexStorage2D(target, mipLevels, internalFormat, width, height);
+            }
+        } else {
+            // Mutable storage is defined level by level; the data is uploaded below like for
+            // immutable storage
+            for (uint32_t level = 0; level < mipLevels; ++level) {
+                const uint32_t levelWidth = getMipSize(width, level);
+                const uint32_t levelHeight = getMipSize(height, level);
+                const GLsizei layerSize = (GLsizei)getTextureDataSize(format, levelWidth, levelHeight);
+                if (isArray && compressed) {
+                    glCompressedTexImage3D(target, level, internalFormat, levelWidth, levelHeight, arrayLayers, 0,
+                                           layerSize * arrayLayers, nullptr);
+                } else if (isArray) {
+                    glTexImage3D(target, level, internalFormat, levelWidth, levelHeight, arrayLayers, 0,
+                                 toGLTextureFormat(format), toGLTextureDataType(format), nullptr);
+                } else if (compressed) {
+                    glCompressedTexImage2D(target, level, internalFormat, levelWidth, levelHeight, 0, layerSize, nullptr);
+                } else {
+                    glTexImage2D(target, level, internalFormat, levelWidth, levelHeight, 0,
+                                 toGLTextureFormat(format), toGLTextureDataType(format), nullptr);
+                }
+            }
+        }
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, toGLTextureFilter(minFilter));
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, toGLTextureFilter(magFilter));
+        glTexParameteri(target, GL_TEXTURE_WRAP_S, toGLTextureWrap(wrapS));
+        glTexParameteri(target, GL_TEXTURE_WRAP_T, toGLTextureWrap(wrapT));
+        glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, mipLevels - 1);
+        glBindTexture(target, 0);
+    }
+
+    bool hasBaseLevel = false;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!data[i].data) continue;
+        TextureRegion region;
+        region.mipLevel = i % mipLevels;
+        region.arrayLayer = i / mipLevels;
+        region.width = getMipSize(width, region.mipLevel);
+        region.height = getMipSize(height, region.mipLevel);
+        uploadSubImage(region, data[i].data, data[i].size);
+        hasBaseLevel |= region.mipLevel == 0;
+    }
+    if (generatedMips && hasBaseLevel) {
+        regenerateMips();
+    }
+}
+
+void OpenGLTexture::uploadSubImage(const TextureRegion& region, const void* data, size_t size) {
+    const bool compressed = isCompressedFormat(format);
+    const unsigned int internalFormat = toGLTextureInternalFormat(format);
+    const unsigned int glFormat = toGLTextureFormat(format);
+    const unsigned int dataType = toGLTextureDataType(format);
+
+    if (GDirectStateAccess) {
+        if (type == TextureType::Texture2DArray && compressed) {
+            glCompressedTextureSubImage3D(textureID, region.mipLevel, region.x, region.y, region.arrayLayer,
+                                          region.width, region.height, 1, internalFormat, (GLsizei)size, data);
+        } else if (type == TextureType::Texture2DArray) {
+            glTextureSubImage3D(textureID, region.mipLevel, region.x, region.y, region.arrayLayer,
+                                region.width, region.height, 1, glFormat, dataType, data);
+        } else if (compressed) {
+            glCompressedTextureSubImage2D(textureID, region.mipLevel, region.x, region.y, region.width, region.height,
+                                          internalFormat, (GLsizei)size, data);
+        } else {
+            glTextureSubImage2D(textureID, region.mipLevel, region.x, region.y, region.width, region.height,
+                                glFormat, dataType, data);
+        }
+        return;
+    }
+
+    glBindTexture(target, textureID);
+    if (type == TextureType::Texture2DArray && compressed) {
+        glCompressedTexSubImage3D(target, region.mipLevel, region.x, region.y, region.arrayLayer,
+                                  region.width, region.height, 1, internalFormat, (GLsizei)size, data);
+    } else if (type == TextureType::Texture2DArray) {
+        glTexSubImage3D(target, region.mipLevel, region.x, region.y, region.arrayLayer,
+                        region.width, region.height, 1, glFormat, dataType, data);
+    } else if (compressed) {
+        glCompressedTexSubImage2D(target, region.mipLevel, region.x, region.y, region.width, region.height,
+                                  internalFormat, (GLsizei)size, data);
+    } else {
+        glTexSubImage2D(target, region.mipLevel, region.x, region.y, region.width, region.height,
+                        glFormat, dataType, data);
+    }
+    glBindTexture(target, 0);
+}
+
+void OpenGLTexture::regenerateMips() {
+    if (GDirectStateAccess) {
+        glGenerateTextureMipmap(textureID);
+        return;
+    }
+    glBindTexture(target, textureID);
+    glGenerateMipmap(target);
+    glBindTexture(target, 0);
+}
+
+uint64_t OpenGLTexture::getBindlessHandle() {
+    if (bindlessHandle == 0 && textureID != 0 && GBindlessTexture) {
+        bindlessHandle = glGetTextureHandleARB(textureID);
+        if (bindlessHandle != 0) {
+            glMakeTextureHandleResidentARB(bindlessHandle);
+        }
+    }
+    return bindlessHandle;
 }
 
 void OpenGLTexture::release() {
+    // Deleting the texture also makes its handle non-resident. Doing it here instead would pull
+    // the texture from under draws still in flight.
+    bindlessHandle = 0;
     if (textureID != 0) {
-        glDeleteTextures(1, &textureID);
+        deletionQueue->enqueue(OpenGLDeletionQueue::ObjectType::Texture, textureID);
         textureID = 0;
     }
 }
 
+// OpenGLPipelineState implementation
+OpenGLPipelineState::OpenGLPipelineState(const PipelineStateDesc& inDesc)
+    : desc(inDesc), hash(inDesc.hash()) {
+}
+
+// OpenGLComputePipelineState implementation
+void OpenGLComputePipelineState::getWorkGroupSize(uint32_t& x, uint32_t& y, uint32_t& z) const {
+    GLint size[3] = { 1, 1, 1 };
+    if (desc.program && desc.program->getNativeHandle() != 0) {
+        glGetProgramiv(static_cast<GLuint>(desc.program->getNativeHandle()), GL_COMPUTE_WORK_GROUP_SIZE, size);
+    }
+    x = static_cast<uint32_t>(size[0]);
+    y = static_cast<uint32_t>(size[1]);
+    z = static_cast<uint32_t>(size[2]);
+}
+
 // OpenGLFramebuffer implementation
-OpenGLFramebuffer::OpenGLFramebuffer(const FramebufferDesc& desc)
-    : framebufferID(0), depthTexture(nullptr), width(desc.width), height(desc.height) {
-    glGenFramebuffers(1, &framebufferID);
-    glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
+OpenGLFramebuffer::OpenGLFramebuffer(const FramebufferDesc& desc, std::shared_ptr<OpenGLDeletionQueue> inDeletionQueue)
+    : framebufferID(0), deletionQueue(std::move(inDeletionQueue)), depthTexture(nullptr), width(desc.width), height(desc.height) {
+    if (GDirectStateAccess) {
+        glCreateFramebuffers(1, &framebufferID);
+    } else {
+        glGenFramebuffers(1, &framebufferID);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
+    }
+    if (!desc.createAttachments) {
+        if (!GDirectStateAccess) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+        return;
+    }
     
     // Create default color texture
     TextureDesc colorDesc;
     colorDesc.width = width;
     colorDesc.height = height;
     colorDesc.format = TextureFormat::RGBA8;
-    auto colorTex = std::make_shared<OpenGLTexture>(colorDesc);
+    auto colorTex = std::make_shared<OpenGLTexture>(colorDesc, deletionQueue);
     
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTex->getTextureID(), 0);
+    if (GDirectStateAccess) {
+        glNamedFramebufferTexture(framebufferID, GL_COLOR_ATTACHMENT0, colorTex->getTextureID(), 0);
+    } else {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTex->getTextureID(), 0);
+    }
     colorTextures.push_back(colorTex);
+    colorAttachments.push_back(colorTex.get());
     
     // Create depth texture if requested
     if (desc.hasDepthStencil) {
@@ -550,13 +1054,20 @@ OpenGLFramebuffer::OpenGLFramebuffer(const FramebufferDesc& desc)
         depthDesc.width = width;
         depthDesc.height = height;
         depthDesc.format = TextureFormat::Depth24Stencil8;
-        auto depthTex = std::make_shared<OpenGLTexture>(depthDesc);
+        auto depthTex = std::make_shared<OpenGLTexture>(depthDesc, deletionQueue);
         
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthTex->getTextureID(), 0);
+        if (GDirectStateAccess) {
+            glNamedFramebufferTexture(framebufferID, GL_DEPTH_STENCIL_ATTACHMENT, depthTex->getTextureID(), 0);
+        } else {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthTex->getTextureID(), 0);
+        }
         depthTexture = depthTex;
+        depthAttachment = depthTex.get();
     }
     
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!GDirectStateAccess) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
 }
 
 OpenGLFramebuffer::~OpenGLFramebuffer() {
@@ -573,25 +1084,39 @@ void OpenGLFramebuffer::unbind() {
 
 void OpenGLFramebuffer::attachColorTexture(IRHITexture* texture, uint32_t attachment) {
     if (auto* glTexture = dynamic_cast<OpenGLTexture*>(texture)) {
+        if (colorAttachments.size() <= attachment) {
+            colorAttachments.resize(attachment + 1, nullptr);
+        }
+        colorAttachments[attachment] = texture;
+        if (GDirectStateAccess) {
+            glNamedFramebufferTexture(framebufferID, GL_COLOR_ATTACHMENT0 + attachment, glTexture->getTextureID(), 0);
+            return;
+        }
         glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + attachment, GL_TEXTURE_2D, glTexture->getTextureID(), 0);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        
-        // Note: Caller must keep texture alive - we only store for default textures created in constructor
     }
 }
 
 void OpenGLFramebuffer::attachDepthTexture(IRHITexture* texture) {
     if (auto* glTexture = dynamic_cast<OpenGLTexture*>(texture)) {
+        depthAttachment = texture;
+        const GLenum attachment = glTexture->getFormat() == TextureFormat::Depth24Stencil8
+            ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        if (GDirectStateAccess) {
+            glNamedFramebufferTexture(framebufferID, attachment, glTexture->getTextureID(), 0);
+            return;
+        }
         glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, glTexture->getTextureID(), 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, glTexture->getTextureID(), 0);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        
-        // Note: Caller must keep texture alive - we only store for default textures created in constructor
     }
 }
 
 bool OpenGLFramebuffer::isComplete() {
+    if (GDirectStateAccess) {
+        return glCheckNamedFramebufferStatus(framebufferID, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
     glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
     bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -599,27 +1124,31 @@ bool OpenGLFramebuffer::isComplete() {
 }
 
 IRHITexture* OpenGLFramebuffer::getColorTexture(uint32_t attachment) {
-    if (attachment < colorTextures.size()) {
-        return colorTextures[attachment].get();
+    if (attachment < colorAttachments.size()) {
+        return colorAttachments[attachment];
     }
     return nullptr;
 }
 
 IRHITexture* OpenGLFramebuffer::getDepthTexture() {
-    return depthTexture.get();
+    return depthAttachment;
 }
 
 void OpenGLFramebuffer::release() {
     if (framebufferID != 0) {
-        glDeleteFramebuffers(1, &framebufferID);
+        deletionQueue->enqueue(OpenGLDeletionQueue::ObjectType::Framebuffer, framebufferID);
         framebufferID = 0;
     }
 }
 
 // OpenGLVertexArray implementation
-OpenGLVertexArray::OpenGLVertexArray()
-    : vaoID(0), indexBuffer(nullptr) {
-    glGenVertexArrays(1, &vaoID);
+OpenGLVertexArray::OpenGLVertexArray(std::shared_ptr<OpenGLDeletionQueue> inDeletionQueue)
+    : vaoID(0), deletionQueue(std::move(inDeletionQueue)), indexBuffer(nullptr) {
+    if (GDirectStateAccess) {
+        glCreateVertexArrays(1, &vaoID);
+    } else {
+        glGenVertexArrays(1, &vaoID);
+    }
 }
 
 OpenGLVertexArray::~OpenGLVertexArray() {
@@ -628,51 +1157,102 @@ OpenGLVertexArray::~OpenGLVertexArray() {
 
 void OpenGLVertexArray::bind() {
     glBindVertexArray(vaoID);
+    GBoundVertexArray = vaoID;
+    GBoundIndexFormat = indexFormat;
 }
 
 void OpenGLVertexArray::unbind() {
     glBindVertexArray(0);
+    GBoundVertexArray = 0;
 }
 
-void OpenGLVertexArray::setVertexBuffer(IRHIBuffer* buffer, uint32_t binding) {
+void OpenGLVertexArray::setVertexBuffer(IRHIBuffer* buffer, uint32_t binding, size_t offset) {
     if (auto* glBuffer = dynamic_cast<OpenGLBuffer*>(buffer)) {
-        glBindVertexArray(vaoID);
-        glBindBuffer(GL_ARRAY_BUFFER, glBuffer->getBufferID());
-        glBindVertexArray(0);
+        if (binding >= vertexBindings.size()) {
+            vertexBindings.resize(binding + 1);
+        }
+        VertexBinding& vertexBinding = vertexBindings[binding];
+        vertexBinding.buffer = buffer;
+        vertexBinding.offset = offset;
         
-        if (binding >= vertexBuffers.size()) {
-            vertexBuffers.resize(binding + 1, nullptr);
+        if (GDirectStateAccess) {
+            // The binding's stride comes from setVertexAttribute(); until then the buffer is
+            // attached there
+            if (vertexBinding.stride != 0) {
+                glVertexArrayVertexBuffer(vaoID, binding, glBuffer->getBufferID(), offset, vertexBinding.stride);
+            }
+        } else {
+            glBindVertexArray(vaoID);
+            glBindBuffer(GL_ARRAY_BUFFER, glBuffer->getBufferID());
+            glBindVertexArray(GBoundVertexArray);
         }
-        vertexBuffers[binding] = buffer;
     }
 }
 
-void OpenGLVertexArray::setIndexBuffer(IRHIBuffer* buffer) {
+void OpenGLVertexArray::setIndexBuffer(IRHIBuffer* buffer, IndexFormat format) {
     if (auto* glBuffer = dynamic_cast<OpenGLBuffer*>(buffer)) {
+        indexFormat = format;
+        // Draws read the format of the bound vertex array, which may be this one
+        if (GBoundVertexArray == vaoID) {
+            GBoundIndexFormat = format;
+        }
+        if (GDirectStateAccess) {
+            glVertexArrayElementBuffer(vaoID, glBuffer->getBufferID());
+            indexBuffer = buffer;
+            return;
+        }
         glBindVertexArray(vaoID);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glBuffer->getBufferID());
-        glBindVertexArray(0);
+        glBindVertexArray(GBoundVertexArray);
         indexBuffer = buffer;
     }
 }
 
 void OpenGLVertexArray::setVertexAttribute(const VertexAttribute& attribute) {
+    // The packed integer formats always read as normalized floats; 10_10_10_2 takes all four
+    // components of its 32 bits
+    const GLenum type = toGLVertexType(attribute.format);
+    const bool packed = attribute.format == VertexFormat::Snorm10_10_10_2;
+    const GLint componentCount = packed ? 4 : static_cast<GLint>(attribute.componentCount);
+    const GLboolean normalized = attribute.format == VertexFormat::Float || attribute.format == VertexFormat::Half
+        ? (attribute.normalized ? GL_TRUE : GL_FALSE) : GL_TRUE;
+    if (GDirectStateAccess) {
+        VertexBinding* vertexBinding = attribute.binding < vertexBindings.size() ? &vertexBindings[attribute.binding] : nullptr;
+        auto* glBuffer = vertexBinding ? dynamic_cast<OpenGLBuffer*>(vertexBinding->buffer) : nullptr;
+        if (!glBuffer) {
+            LOG("OpenGLVertexArray: No vertex buffer set for binding " << attribute.binding);
+            return;
+        }
+        // Unlike glVertexAttribPointer, a binding stride of 0 does not mean tightly packed
+        const uint32_t stride = attribute.stride ? attribute.stride : getVertexFormatSize(attribute.format, componentCount);
+        vertexBinding->stride = stride;
+        glEnableVertexArrayAttrib(vaoID, attribute.location);
+        glVertexArrayAttribFormat(vaoID, attribute.location, componentCount, type, normalized, attribute.offset);
+        glVertexArrayAttribBinding(vaoID, attribute.location, attribute.binding);
+        glVertexArrayVertexBuffer(vaoID, attribute.binding, glBuffer->getBufferID(), vertexBinding->offset, stride);
+        return;
+    }
+    const size_t bindingOffset = attribute.binding < vertexBindings.size() ? vertexBindings[attribute.binding].offset : 0;
     glBindVertexArray(vaoID);
     glEnableVertexAttribArray(attribute.location);
     glVertexAttribPointer(
         attribute.location,
-        attribute.componentCount,
-        GL_FLOAT,
-        attribute.normalized ? GL_TRUE : GL_FALSE,
+        componentCount,
+        type,
+        normalized,
         attribute.stride,  // Use stride from attribute
-        (void*)(uintptr_t)attribute.offset
+        (void*)(uintptr_t)(attribute.offset + bindingOffset)
     );
-    glBindVertexArray(0);
+    glBindVertexArray(GBoundVertexArray);
 }
 
 void OpenGLVertexArray::release() {
     if (vaoID != 0) {
-        glDeleteVertexArrays(1, &vaoID);
+        // Deleting the bound vertex array binds 0
+        if (GBoundVertexArray == vaoID) {
+            GBoundVertexArray = 0;
+        }
+        deletionQueue->enqueue(OpenGLDeletionQueue::ObjectType::VertexArray, vaoID);
         vaoID = 0;
     }
 }
@@ -714,34 +1294,125 @@ bool OpenGLRHIDevice::initialize(ProcAddressLoader loader) {
     
     LOG("OpenGLRHI: Initialized. Version: " << (const char*)version);
 
+    // Let the driver compile and link on its own threads; completion is polled via GL_COMPLETION_STATUS_KHR
+    GParallelShaderCompile = false;
+    if (GLAD_GL_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        GParallelShaderCompile = true;
+    } else if (GLAD_GL_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+        GParallelShaderCompile = true;
+    }
+    LOG("OpenGLRHI: Parallel shader compile " << (GParallelShaderCompile ? "enabled" : "not available"));
+
+    GDirectStateAccess = GLAD_GL_VERSION_4_5 || GLAD_GL_ARB_direct_state_access;
+    LOG("OpenGLRHI: Using " << (GDirectStateAccess ? "direct state access" : "bind-to-edit") << " for resource updates");
+
+    // Before any resource is created: they all release through it
+    deletionQueue = std::make_shared<OpenGLDeletionQueue>();
+
+    GBufferStorage = GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage;
+    if (GBufferStorage) {
+        streamBuffer = std::make_unique<OpenGLStreamBuffer>();
+        if (!streamBuffer->initialize(kTransientFrameSize, deletionQueue)) {
+            streamBuffer.reset();
+        }
+    }
+    LOG("OpenGLRHI: Transient allocations " << (streamBuffer ? "use a persistently mapped ring" : "not available"));
+
+    GTextureStorage = GLAD_GL_VERSION_4_2 || GLAD_GL_ARB_texture_storage;
+    GTextureCompressionS3TC = GLAD_GL_EXT_texture_compression_s3tc;
+    GTextureCompressionBPTC = GLAD_GL_VERSION_4_2 || GLAD_GL_ARB_texture_compression_bptc;
+    LOG("OpenGLRHI: Compressed textures: BC5" << (GTextureCompressionS3TC ? ", BC1, BC3" : "")
+        << (GTextureCompressionBPTC ? ", BC7" : ""));
+    GDrawIndirect = GLAD_GL_VERSION_4_0;
+    GMultiDrawIndirect = GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_multi_draw_indirect;
+    LOG("OpenGLRHI: Indirect draws " << (GMultiDrawIndirect ? "batched with glMultiDrawElementsIndirect"
+        : GDrawIndirect ? "issued one by one" : "not available"));
+    GCompute = GLAD_GL_VERSION_4_3 || (GLAD_GL_ARB_compute_shader && GLAD_GL_ARB_shader_storage_buffer_object);
+    LOG("OpenGLRHI: Compute shaders " << (GCompute ? "available" : "not available"));
+    GBindlessTexture = GLAD_GL_ARB_bindless_texture;
+    LOG("OpenGLRHI: Bindless textures " << (GBindlessTexture ? "available" : "not available"));
+    // RHI texel data is tightly packed; the GL default pads rows to 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    textureUploader = std::make_unique<OpenGLTextureUploader>();
+    if (GBufferStorage && !textureUploader->initialize(kTextureStagingSize)) {
+        LOG("OpenGLRHI: Texture staging unavailable, uploading textures synchronously");
+    }
+
+    OpenGLProgramCache::get().initialize();
+
+    contextThread = std::this_thread::get_id();
     initialized = true;
     return true;
 }
 
+bool OpenGLRHIDevice::supportsParallelShaderCompile() const {
+    return initialized && GParallelShaderCompile;
+}
+
+bool OpenGLRHIDevice::supportsCompute() const {
+    return initialized && GCompute;
+}
+
+bool OpenGLRHIDevice::supportsBindlessTextures() const {
+    return initialized && GBindlessTexture;
+}
+
+bool OpenGLRHIDevice::supportsTextureFormat(TextureFormat format) const {
+    switch (format) {
+        case TextureFormat::BC1:
+        case TextureFormat::BC3: return GTextureCompressionS3TC;
+        case TextureFormat::BC7: return GTextureCompressionBPTC;
+        default: return true;
+    }
+}
+
 void OpenGLRHIDevice::shutdown() {
+    if (initialized) {
+        // Release the registered resources while the context still exists
+        resourcePools.clear();
+        textureUploader.reset();
+        streamBuffer.reset();
+        OpenGLProgramCache::get().shutdown();
+        deletionQueue->shutdown();
+        deletionQueue.reset();
+    }
+    {
+        std::lock_guard<std::mutex> lock(pipelineCacheMutex);
+        pipelineCache.clear();
+    }
+    OpenGLProgramBinding::onBind(0);
+    pipelineStateApplied = false;
     initialized = false;
 }
 
 std::shared_ptr<IRHIBuffer> OpenGLRHIDevice::createBuffer(const BufferDesc& desc) {
-    return std::make_shared<OpenGLBuffer>(desc);
+    return std::make_shared<OpenGLBuffer>(desc, deletionQueue);
 }
 
 // OpenGLUniformBuffer - implements IRHIUniformBuffer
 class OpenGLUniformBuffer : public IRHIUniformBuffer {
 public:
-    OpenGLUniformBuffer() : ubo(0), sizeBytes(0), binding(0) {}
-    OpenGLUniformBuffer(size_t size, uint32_t bind) : ubo(0), sizeBytes(0), binding(bind) { create(size, bind); }
+    explicit OpenGLUniformBuffer(std::shared_ptr<OpenGLDeletionQueue> inDeletionQueue)
+        : ubo(0), sizeBytes(0), binding(0), deletionQueue(std::move(inDeletionQueue)) {}
     ~OpenGLUniformBuffer() { release(); }
 
     bool create(size_t size, uint32_t bind) {
         release();
         sizeBytes = size;
         binding = bind;
-        glGenBuffers(1, &ubo);
-        if (!ubo) return false;
-        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-        glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)sizeBytes, nullptr, GL_DYNAMIC_DRAW);
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        if (GDirectStateAccess) {
+            glCreateBuffers(1, &ubo);
+            if (!ubo) return false;
+            glNamedBufferData(ubo, (GLsizeiptr)sizeBytes, nullptr, GL_DYNAMIC_DRAW);
+        } else {
+            glGenBuffers(1, &ubo);
+            if (!ubo) return false;
+            glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+            glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)sizeBytes, nullptr, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        }
         // bind to binding point
         glBindBufferBase(GL_UNIFORM_BUFFER, binding, ubo);
         return true;
@@ -753,6 +1424,10 @@ public:
             std::cerr << "UniformBuffer::update out of range" << std::endl;
             return;
         }
+        if (GDirectStateAccess) {
+            glNamedBufferSubData(ubo, (GLintptr)offset, (GLsizeiptr)size, data);
+            return;
+        }
         glBindBuffer(GL_UNIFORM_BUFFER, ubo);
         glBufferSubData(GL_UNIFORM_BUFFER, (GLintptr)offset, (GLsizeiptr)size, data);
         glBindBuffer(GL_UNIFORM_BUFFER, 0);
@@ -764,12 +1439,14 @@ public:
         glBindBufferBase(GL_UNIFORM_BUFFER, binding, ubo);
     }
 
+    uint32_t getBinding() const override { return binding; }
+
     size_t getSize() const override { return sizeBytes; }
 
     bool isValid() const override { return ubo != 0; }
     void release() override {
         if (ubo) {
-            glDeleteBuffers(1, &ubo);
+            deletionQueue->enqueue(OpenGLDeletionQueue::ObjectType::Buffer, ubo);
             ubo = 0;
         }
         sizeBytes = 0;
@@ -781,32 +1458,114 @@ private:
     GLuint ubo;
     size_t sizeBytes;
     uint32_t binding;
+    std::shared_ptr<OpenGLDeletionQueue> deletionQueue;
 };
 
 std::shared_ptr<IRHIUniformBuffer> OpenGLRHIDevice::createUniformBuffer(size_t size, uint32_t binding) {
-    auto ub = std::make_shared<OpenGLUniformBuffer>();
+    auto ub = std::make_shared<OpenGLUniformBuffer>(deletionQueue);
     if (!ub->create(size, binding)) return nullptr;
     return ub;
 }
 
+std::shared_ptr<IRHIPipelineState> OpenGLRHIDevice::createPipelineState(const PipelineStateDesc& desc) {
+    if (!desc.program) {
+        LOG("OpenGLRHI: Pipeline state without a program");
+        return nullptr;
+    }
+
+    const uint64_t hash = desc.hash();
+    std::lock_guard<std::mutex> lock(pipelineCacheMutex);
+    auto& candidates = pipelineCache[hash];
+    for (auto it = candidates.begin(); it != candidates.end();) {
+        std::shared_ptr<OpenGLPipelineState> existing = it->lock();
+        if (!existing) {
+            it = candidates.erase(it);
+            continue;
+        }
+        if (existing->getDesc() == desc) {
+            return existing;
+        }
+        ++it;
+    }
+
+    auto pipeline = std::make_shared<OpenGLPipelineState>(desc);
+    candidates.push_back(pipeline);
+    return pipeline;
+}
+
+std::shared_ptr<IRHIComputePipelineState> OpenGLRHIDevice::createComputePipelineState(const ComputePipelineDesc& desc) {
+    if (!desc.program) {
+        LOG("OpenGLRHI: Compute pipeline without a program");
+        return nullptr;
+    }
+    return std::make_shared<OpenGLComputePipelineState>(desc);
+}
+
+TransientAllocation OpenGLRHIDevice::allocateTransient(size_t size, size_t alignment) {
+    return streamBuffer ? streamBuffer->allocate(size, alignment) : TransientAllocation{};
+}
+
+void OpenGLRHIDevice::bindUniformBufferRange(uint32_t binding, IRHIBuffer* buffer, size_t offset, size_t size) {
+    if (auto* glBuffer = dynamic_cast<OpenGLBuffer*>(buffer)) {
+        glBindBufferRange(GL_UNIFORM_BUFFER, binding, glBuffer->getBufferID(), (GLintptr)offset, (GLsizeiptr)size);
+    }
+}
+
+void OpenGLRHIDevice::endFrame() {
+    if (deletionQueue) {
+        deletionQueue->endFrame();
+    }
+    if (streamBuffer) {
+        streamBuffer->endFrame();
+    }
+    if (textureUploader) {
+        textureUploader->poll();
+    }
+}
+
+bool OpenGLRHIDevice::uploadTextureAsync(IRHITexture* texture, const TextureRegion& region, const void* data,
+                                         std::function<void()> onComplete) {
+    if (!texture) return false;
+    if (!textureUploader) {
+        return IRHIDevice::uploadTextureAsync(texture, region, data, std::move(onComplete));
+    }
+    return textureUploader->upload(*texture, region, data, std::move(onComplete));
+}
+
+std::unique_ptr<IRHICommandList> OpenGLRHIDevice::createCommandList() {
+    return std::make_unique<RHICommandList>();
+}
+
+void OpenGLRHIDevice::submitCommandLists(IRHICommandList* const* lists, uint32_t count) {
+    if (std::this_thread::get_id() != contextThread) {
+        LOG("OpenGLRHI: Command lists submitted off the context thread, dropping " << count << " lists");
+        return;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        if (lists[i]) {
+            lists[i]->execute(*this);
+        }
+    }
+}
+
 std::shared_ptr<IRHIShader> OpenGLRHIDevice::createShader(const ShaderDesc& desc) {
-    return std::make_shared<OpenGLShader>(desc);
+    return std::make_shared<OpenGLShader>(desc, deletionQueue);
 }
 
 std::shared_ptr<IRHIShaderProgram> OpenGLRHIDevice::createShaderProgram() {
-    return std::make_shared<OpenGLShaderProgram>();
+    return std::make_shared<OpenGLShaderProgram>(deletionQueue);
 }
 
 std::shared_ptr<IRHITexture> OpenGLRHIDevice::createTexture(const TextureDesc& desc) {
-    return std::make_shared<OpenGLTexture>(desc);
+    return std::make_shared<OpenGLTexture>(desc, deletionQueue);
 }
 
 std::shared_ptr<IRHIFramebuffer> OpenGLRHIDevice::createFramebuffer(const FramebufferDesc& desc) {
-    return std::make_shared<OpenGLFramebuffer>(desc);
+    return std::make_shared<OpenGLFramebuffer>(desc, deletionQueue);
 }
 
 std::shared_ptr<IRHIVertexArray> OpenGLRHIDevice::createVertexArray() {
-    return std::make_shared<OpenGLVertexArray>();
+    return std::make_shared<OpenGLVertexArray>(deletionQueue);
 }
 
 void OpenGLRHIDevice::setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
@@ -817,45 +1576,78 @@ void OpenGLRHIDevice::setScissor(uint32_t x, uint32_t y, uint32_t width, uint32_
     glScissor(x, y, width, height);
 }
 
-void OpenGLRHIDevice::setDepthTest(bool enabled) {
-    if (enabled) {
-        glEnable(GL_DEPTH_TEST);
-    } else {
-        glDisable(GL_DEPTH_TEST);
-    }
-}
-
-void OpenGLRHIDevice::setDepthWrite(bool enabled) {
-    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
-}
+void OpenGLRHIDevice::setPipelineState(IRHIPipelineState* pipeline) {
+    if (!pipeline) return;
+    const PipelineStateDesc& desc = pipeline->getDesc();
+    const bool applyAll = !pipelineStateApplied;
 
-void OpenGLRHIDevice::setDepthFunc(CompareFunc func) {
-    glDepthFunc(toGLCompareFunc(func));
-}
+    // Checked against what is really current: programs are also bound outside the device
+    const uint32_t programID = desc.program ? static_cast<uint32_t>(desc.program->getNativeHandle()) : 0;
+    if (desc.program && (applyAll || !OpenGLProgramBinding::isBound(programID))) {
+        desc.program->bind();
+    }
 
-void OpenGLRHIDevice::setBlend(bool enabled) {
-    if (enabled) {
-        glEnable(GL_BLEND);
-    } else {
-        glDisable(GL_BLEND);
+    const RasterState& raster = desc.raster;
+    if (applyAll || raster.cullMode != appliedRaster.cullMode) {
+        if (raster.cullMode == CullMode::None) {
+            glDisable(GL_CULL_FACE);
+        } else {
+            glEnable(GL_CULL_FACE);
+            glCullFace(raster.cullMode == CullMode::Front ? GL_FRONT : GL_BACK);
+        }
+    }
+    if (applyAll || raster.scissorTest != appliedRaster.scissorTest) {
+        if (raster.scissorTest) {
+            glEnable(GL_SCISSOR_TEST);
+        } else {
+            glDisable(GL_SCISSOR_TEST);
+        }
     }
-}
 
-void OpenGLRHIDevice::setBlendFunc(BlendFactor srcFactor, BlendFactor dstFactor) {
-    glBlendFunc(toGLBlendFactor(srcFactor), toGLBlendFactor(dstFactor));
-}
+    const DepthState& depth = desc.depth;
+    if (applyAll || depth.testEnable != appliedDepth.testEnable) {
+        if (depth.testEnable) {
+            glEnable(GL_DEPTH_TEST);
+        } else {
+            glDisable(GL_DEPTH_TEST);
+        }
+    }
+    if (applyAll || depth.writeEnable != appliedDepth.writeEnable) {
+        glDepthMask(depth.writeEnable ? GL_TRUE : GL_FALSE);
+    }
+    if (applyAll || depth.compareFunc != appliedDepth.compareFunc) {
+        glDepthFunc(toGLCompareFunc(depth.compareFunc));
+    }
 
-void OpenGLRHIDevice::setBlendOp(BlendOp op) {
-    glBlendEquation(toGLBlendOp(op));
-}
+    const BlendState& blend = desc.blend;
+    if (applyAll || blend.enable != appliedBlend.enable) {
+        if (blend.enable) {
+            glEnable(GL_BLEND);
+        } else {
+            glDisable(GL_BLEND);
+        }
+    }
+    // Factors and op only matter while blending; they are applied once it is enabled
+    if (blend.enable && (applyAll || !appliedBlend.enable || blend.srcFactor != appliedBlend.srcFactor ||
+                         blend.dstFactor != appliedBlend.dstFactor)) {
+        glBlendFunc(toGLBlendFactor(blend.srcFactor), toGLBlendFactor(blend.dstFactor));
+    }
+    if (blend.enable && (applyAll || !appliedBlend.enable || blend.op != appliedBlend.op)) {
+        glBlendEquation(toGLBlendOp(blend.op));
+    }
 
-void OpenGLRHIDevice::setCullMode(CullMode mode) {
-    if (mode == CullMode::None) {
-        glDisable(GL_CULL_FACE);
+    appliedRaster = raster;
+    appliedDepth = depth;
+    if (blend.enable) {
+        appliedBlend = blend;
     } else {
-        glEnable(GL_CULL_FACE);
-        glCullFace(mode == CullMode::Front ? GL_FRONT : GL_BACK);
+        appliedBlend.enable = false;
     }
+    pipelineStateApplied = true;
+}
+
+void OpenGLRHIDevice::bindDefaultFramebuffer() {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void OpenGLRHIDevice::clearColor(float r, float g, float b, float a) {
@@ -879,7 +1671,106 @@ void OpenGLRHIDevice::draw(PrimitiveTopology topology, uint32_t vertexCount, uin
 }
 
 void OpenGLRHIDevice::drawIndexed(PrimitiveTopology topology, uint32_t indexCount, uint32_t startIndex) {
-    glDrawElements(toGLPrimitiveTopology(topology), indexCount, GL_UNSIGNED_INT, (void*)(uintptr_t)(startIndex * sizeof(uint32_t)));
+    glDrawElements(toGLPrimitiveTopology(topology), indexCount, toGLIndexType(GBoundIndexFormat),
+                   (void*)(uintptr_t)(startIndex * getIndexSize(GBoundIndexFormat)));
+}
+
+void OpenGLRHIDevice::drawIndexedIndirect(PrimitiveTopology topology, IRHIBuffer* buffer, size_t offset) {
+    multiDrawIndexedIndirect(topology, buffer, offset, 1, 0);
+}
+
+void OpenGLRHIDevice::multiDrawIndexedIndirect(PrimitiveTopology topology, IRHIBuffer* buffer, size_t offset,
+                                               uint32_t drawCount, uint32_t stride) {
+    auto* glBuffer = dynamic_cast<OpenGLBuffer*>(buffer);
+    if (!glBuffer || drawCount == 0) return;
+    if (!GDrawIndirect) {
+        static bool reported = false;
+        if (!reported) {
+            LOG("OpenGLRHI: Indirect draws need GL 4.0, skipping them");
+            reported = true;
+        }
+        return;
+    }
+
+    const GLenum mode = toGLPrimitiveTopology(topology);
+    const GLenum indexType = toGLIndexType(GBoundIndexFormat);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, glBuffer->getBufferID());
+    if (GMultiDrawIndirect) {
+        glMultiDrawElementsIndirect(mode, indexType, (const void*)(uintptr_t)offset, drawCount, stride);
+    } else {
+        const size_t step = stride != 0 ? stride : sizeof(DrawIndexedIndirectCommand);
+        for (uint32_t i = 0; i < drawCount; ++i) {
+            glDrawElementsIndirect(mode, indexType, (const void*)(uintptr_t)(offset + i * step));
+        }
+    }
+    // Buffers edited by binding go through their own target, which may be this one
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void OpenGLRHIDevice::setComputePipelineState(IRHIComputePipelineState* pipeline) {
+    if (!pipeline || !pipeline->getDesc().program) return;
+    pipeline->getDesc().program->bind();
+}
+
+void OpenGLRHIDevice::bindStorageBuffer(uint32_t binding, IRHIBuffer* buffer, size_t offset, size_t size) {
+    auto* glBuffer = dynamic_cast<OpenGLBuffer*>(buffer);
+    if (!glBuffer || !GCompute) return;
+    if (offset == 0 && size == 0) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, glBuffer->getBufferID());
+    } else {
+        const size_t boundSize = size != 0 ? size : glBuffer->getSize() - offset;
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, glBuffer->getBufferID(), (GLintptr)offset, (GLsizeiptr)boundSize);
+    }
+}
+
+void OpenGLRHIDevice::bindStorageImage(uint32_t binding, IRHITexture* texture, uint32_t mipLevel, ImageAccess access) {
+    auto* glTexture = dynamic_cast<OpenGLTexture*>(texture);
+    if (!glTexture || !GCompute) return;
+
+    const TextureFormat format = glTexture->getFormat();
+    if (format != TextureFormat::RGBA8 && format != TextureFormat::RGBA16F && format != TextureFormat::RGBA32F) {
+        LOG("OpenGLRHI: Texture format " << static_cast<int>(format) << " cannot be bound as a storage image");
+        return;
+    }
+    GLenum glAccess = GL_READ_WRITE;
+    if (access == ImageAccess::ReadOnly) glAccess = GL_READ_ONLY;
+    if (access == ImageAccess::WriteOnly) glAccess = GL_WRITE_ONLY;
+    const GLboolean layered = glTexture->getType() == TextureType::Texture2DArray ? GL_TRUE : GL_FALSE;
+    glBindImageTexture(binding, glTexture->getTextureID(), static_cast<GLint>(mipLevel), layered, 0, glAccess,
+                       toGLTextureInternalFormat(format));
+}
+
+void OpenGLRHIDevice::dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+    if (!GCompute) return;
+    glDispatchCompute(groupCountX, groupCountY, groupCountZ);
+}
+
+void OpenGLRHIDevice::dispatchIndirect(IRHIBuffer* buffer, size_t offset) {
+    auto* glBuffer = dynamic_cast<OpenGLBuffer*>(buffer);
+    if (!glBuffer || !GCompute) return;
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, glBuffer->getBufferID());
+    glDispatchComputeIndirect((GLintptr)offset);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+}
+
+void OpenGLRHIDevice::memoryBarrier(BarrierFlags consumers) {
+    if (!GCompute || consumers == BarrierFlags::None) return;
+    if (consumers == BarrierFlags::All) {
+        glMemoryBarrier(GL_ALL_BARRIER_BITS);
+        return;
+    }
+    GLbitfield bits = 0;
+    if (hasAnyFlag(consumers, BarrierFlags::VertexBuffer))   bits |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+    if (hasAnyFlag(consumers, BarrierFlags::IndexBuffer))    bits |= GL_ELEMENT_ARRAY_BARRIER_BIT;
+    if (hasAnyFlag(consumers, BarrierFlags::UniformBuffer))  bits |= GL_UNIFORM_BARRIER_BIT;
+    if (hasAnyFlag(consumers, BarrierFlags::IndirectBuffer)) bits |= GL_COMMAND_BARRIER_BIT;
+    if (hasAnyFlag(consumers, BarrierFlags::StorageBuffer))  bits |= GL_SHADER_STORAGE_BARRIER_BIT;
+    if (hasAnyFlag(consumers, BarrierFlags::TextureSample))  bits |= GL_TEXTURE_FETCH_BARRIER_BIT;
+    if (hasAnyFlag(consumers, BarrierFlags::StorageImage))   bits |= GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+    if (hasAnyFlag(consumers, BarrierFlags::BufferUpdate))   bits |= GL_BUFFER_UPDATE_BARRIER_BIT | GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT;
+    if (hasAnyFlag(consumers, BarrierFlags::TextureUpdate))  bits |= GL_TEXTURE_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT;
+    if (hasAnyFlag(consumers, BarrierFlags::Framebuffer))    bits |= GL_FRAMEBUFFER_BARRIER_BIT;
+    glMemoryBarrier(bits);
 }
 
 // Factory function implementation
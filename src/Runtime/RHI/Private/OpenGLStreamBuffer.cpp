@@ -0,0 +1,96 @@
+#include "OpenGLStreamBuffer.h"
+#include "CoreUtils.h"
+
+namespace CarrotToy {
+namespace RHI {
+
+OpenGLStreamBuffer::~OpenGLStreamBuffer() {
+    shutdown();
+}
+
+bool OpenGLStreamBuffer::initialize(size_t inFrameSize, std::shared_ptr<OpenGLDeletionQueue> deletionQueue) {
+    shutdown();
+
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment > 0) {
+        uniformAlignment = static_cast<size_t>(alignment);
+    }
+    frameSize = (inFrameSize + uniformAlignment - 1) / uniformAlignment * uniformAlignment;
+
+    BufferDesc desc;
+    desc.type = BufferType::Uniform;
+    desc.usage = BufferUsage::Stream;
+    desc.size = frameSize * kFrameCount;
+    buffer = std::make_unique<OpenGLBuffer>(desc, std::move(deletionQueue));
+    data = static_cast<uint8_t*>(buffer->getPersistentData());
+    if (!data) {
+        LOG("OpenGLStreamBuffer: Could not map " << desc.size << " bytes persistently");
+        buffer.reset();
+        return false;
+    }
+
+    frameIndex = 0;
+    head = 0;
+    return true;
+}
+
+void OpenGLStreamBuffer::shutdown() {
+    for (GLsync& fence : fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    buffer.reset();
+    data = nullptr;
+}
+
+TransientAllocation OpenGLStreamBuffer::allocate(size_t size, size_t alignment) {
+    TransientAllocation allocation;
+    if (!data || size == 0) {
+        return allocation;
+    }
+
+    if (alignment == 0) {
+        alignment = uniformAlignment;
+    }
+    const size_t start = (head + alignment - 1) / alignment * alignment;
+    if (start + size > frameSize) {
+        if (!overflowReported) {
+            LOG("OpenGLStreamBuffer: Frame budget of " << frameSize << " bytes exceeded, falling back to buffer updates");
+            overflowReported = true;
+        }
+        return allocation;
+    }
+    head = start + size;
+
+    const size_t offset = frameIndex * frameSize + start;
+    allocation.buffer = buffer.get();
+    allocation.data = data + offset;
+    allocation.offset = offset;
+    allocation.size = size;
+    return allocation;
+}
+
+void OpenGLStreamBuffer::endFrame() {
+    if (!data) return;
+
+    fences[frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frameIndex = (frameIndex + 1) % kFrameCount;
+    head = 0;
+
+    // The next region was last used kFrameCount frames ago; its fence has normally signalled
+    GLsync& fence = fences[frameIndex];
+    if (fence) {
+        GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while (result == GL_TIMEOUT_EXPIRED) {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
+} // namespace RHI
+} // namespace CarrotToy
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "RHI/OpenGLRHI.h"
+#include <glad/glad.h>
+
+namespace CarrotToy {
+namespace RHI {
+
+// Streaming memory behind OpenGLRHIDevice::allocateTransient.
+//
+// One Stream buffer (immutable storage, mapped persistent and coherent once at creation) is split
+// into kFrameCount regions. Each frame bump-allocates from its region. endFrame() puts a fence
+// behind the frame's draws and moves on to the next region. Before a region is reused, its fence
+// is waited on, which only blocks when the CPU is kFrameCount frames ahead of the GPU. Writes go
+// directly into driver-visible memory: no glBufferSubData copy, no orphaning, no map/unmap.
+//
+// Requires GL 4.4 or ARB_buffer_storage. All methods must be called on the GL context's thread.
+class OpenGLStreamBuffer {
+public:
+    static constexpr uint32_t kFrameCount = 3;
+
+    ~OpenGLStreamBuffer();
+
+    bool initialize(size_t frameSize, std::shared_ptr<OpenGLDeletionQueue> deletionQueue);
+    void shutdown();
+
+    TransientAllocation allocate(size_t size, size_t alignment);
+    void endFrame();
+
+private:
+    std::unique_ptr<OpenGLBuffer> buffer;
+    uint8_t* data = nullptr;
+    size_t frameSize = 0;
+    size_t uniformAlignment = 256;
+
+    uint32_t frameIndex = 0;
+    size_t head = 0;
+    GLsync fences[kFrameCount] = {};
+    bool overflowReported = false;
+};
+
+} // namespace RHI
+} // namespace CarrotToy
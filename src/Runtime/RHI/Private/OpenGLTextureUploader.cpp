@@ -0,0 +1,133 @@
+#include "OpenGLTextureUploader.h"
+#include "CoreUtils.h"
+#include <cstring>
+#include <vector>
+
+namespace CarrotToy {
+namespace RHI {
+
+// Row starts of every texture format stay aligned to their texel size
+static constexpr size_t kStagingAlignment = 16;
+
+OpenGLTextureUploader::~OpenGLTextureUploader() {
+    shutdown();
+}
+
+bool OpenGLTextureUploader::initialize(size_t inCapacity) {
+    shutdown();
+
+    const GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, inCapacity, nullptr, mapFlags);
+    data = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, inCapacity, mapFlags));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!data) {
+        LOG("OpenGLTextureUploader: Could not map " << inCapacity << " bytes of staging memory");
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+        return false;
+    }
+    capacity = inCapacity;
+    head = 0;
+    return true;
+}
+
+void OpenGLTextureUploader::shutdown() {
+    // Callbacks of unfinished uploads are dropped; their textures are going away with the device
+    for (PendingUpload& upload : pending) {
+        glDeleteSync(upload.fence);
+    }
+    pending.clear();
+
+    if (buffer) {
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+    data = nullptr;
+    capacity = 0;
+}
+
+bool OpenGLTextureUploader::allocate(size_t size, size_t& offset) {
+    // Oldest range still read by the GPU; uploads finish in order, so free space is
+    // [head, tail) once the ring has wrapped, and [head, capacity) + [0, tail) before
+    size_t tail = head;
+    bool empty = true;
+    for (const PendingUpload& upload : pending) {
+        if (upload.size > 0) {
+            tail = upload.offset;
+            empty = false;
+            break;
+        }
+    }
+    if (empty) {
+        head = 0;
+        tail = 0;
+    }
+
+    const size_t start = (head + kStagingAlignment - 1) / kStagingAlignment * kStagingAlignment;
+    if (empty || start > tail) {
+        if (start + size <= capacity) {
+            offset = start;
+        } else if (size < tail) {
+            offset = 0;
+        } else {
+            return false;
+        }
+    } else if (start + size < tail) {
+        offset = start;
+    } else {
+        return false;
+    }
+    head = offset + size;
+    return true;
+}
+
+bool OpenGLTextureUploader::upload(IRHITexture& texture, const TextureRegion& region, const void* texels, std::function<void()> onComplete) {
+    const size_t size = getTextureDataSize(texture.getFormat(), region.width, region.height);
+    PendingUpload upload;
+    upload.onComplete = std::move(onComplete);
+
+    if (!data || size > capacity) {
+        texture.updateRegion(region, texels);
+    } else {
+        if (!allocate(size, upload.offset)) {
+            return false;
+        }
+        upload.size = size;
+        memcpy(data + upload.offset, texels, size);
+
+        // With an unpack buffer bound the data pointer is an offset into it
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        texture.updateRegion(region, reinterpret_cast<const void*>(upload.offset));
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    upload.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pending.push_back(std::move(upload));
+    return true;
+}
+
+void OpenGLTextureUploader::poll() {
+    std::vector<std::function<void()>> completed;
+    while (!pending.empty()) {
+        PendingUpload& upload = pending.front();
+        const GLenum status = glClientWaitSync(upload.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            break;
+        }
+        glDeleteSync(upload.fence);
+        if (upload.onComplete) {
+            completed.push_back(std::move(upload.onComplete));
+        }
+        pending.pop_front();
+    }
+    // Callbacks may start new uploads
+    for (auto& onComplete : completed) {
+        onComplete();
+    }
+}
+
+} // namespace RHI
+} // namespace CarrotToy
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "RHI/OpenGLRHI.h"
+#include <glad/glad.h>
+#include <deque>
+#include <functional>
+
+namespace CarrotToy {
+namespace RHI {
+
+// Staging for OpenGLRHIDevice::uploadTextureAsync.
+//
+// Texels are copied into a persistently mapped GL_PIXEL_UNPACK_BUFFER and the texture update is
+// issued from there, so glTexSubImage2D returns without copying client memory and the transfer
+// overlaps rendering. The buffer is used as a ring: each upload takes a contiguous range that is
+// released, and its completion callback run, once the fence behind the upload has signalled.
+// When the ring is full the upload is refused instead of waiting for the GPU.
+//
+// Without GL 4.4 / ARB_buffer_storage (initialize() fails) uploads are synchronous, but the
+// completion callbacks are still fenced. All methods must be called on the GL context's thread.
+class OpenGLTextureUploader {
+public:
+    ~OpenGLTextureUploader();
+
+    bool initialize(size_t capacity);
+    void shutdown();
+
+    bool upload(IRHITexture& texture, const TextureRegion& region, const void* data, std::function<void()> onComplete);
+    // Releases staging memory of finished uploads and runs their callbacks
+    void poll();
+
+private:
+    bool allocate(size_t size, size_t& offset);
+
+    struct PendingUpload {
+        GLsync fence = nullptr;
+        size_t offset = 0;
+        size_t size = 0;  // 0 for synchronous uploads, which hold no staging memory
+        std::function<void()> onComplete;
+    };
+
+    GLuint buffer = 0;
+    uint8_t* data = nullptr;
+    size_t capacity = 0;
+    size_t head = 0;
+    std::deque<PendingUpload> pending;
+};
+
+} // namespace RHI
+} // namespace CarrotToy
@@ -0,0 +1,400 @@
+#include "RHICommandList.h"
+#include "CoreUtils.h"
+#include <cstring>
+#include <type_traits>
+
+namespace CarrotToy {
+namespace RHI {
+
+namespace {
+
+struct RectArgs { uint32_t x, y, width, height; };
+struct ColorArgs { float r, g, b, a; };
+struct ClearArgs { bool color, depth, stencil; };
+struct PointerArgs { void* resource; };
+struct BindTextureArgs { IRHITexture* texture; uint32_t slot; };
+struct BufferRangeArgs { uint32_t binding; IRHIBuffer* buffer; size_t offset, size; };
+struct HandleArgs { uint32_t handle, slot; };
+struct UniformArgs { FName name; float values[16]; };
+struct UpdateArgs { void* resource; size_t payloadOffset, size, offset; };
+struct UpdateTextureArgs { IRHITexture* texture; TextureRegion region; size_t payloadOffset; };
+struct DrawArgs { PrimitiveTopology topology; uint32_t count, start; };
+struct StorageImageArgs { uint32_t binding; IRHITexture* texture; uint32_t mipLevel; ImageAccess access; };
+struct DispatchArgs { uint32_t x, y, z; };
+struct IndirectArgs { IRHIBuffer* buffer; size_t offset; };
+struct IndirectDrawArgs { PrimitiveTopology topology; IRHIBuffer* buffer; size_t offset; uint32_t drawCount, stride; };
+
+template <typename T>
+T readArgs(const uint8_t*& cursor) {
+    T arguments;
+    memcpy(&arguments, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return arguments;
+}
+
+} // namespace
+
+template <typename T>
+void RHICommandList::record(CommandType type, const T& arguments) {
+    static_assert(std::is_trivially_copyable<T>::value, "Command arguments are copied as bytes");
+    const size_t offset = commands.size();
+    commands.resize(offset + sizeof(CommandType) + sizeof(T));
+    memcpy(commands.data() + offset, &type, sizeof(CommandType));
+    memcpy(commands.data() + offset + sizeof(CommandType), &arguments, sizeof(T));
+}
+
+size_t RHICommandList::storePayload(const void* data, size_t size) {
+    const size_t offset = payload.size();
+    payload.resize(offset + size);
+    if (data && size > 0) {
+        memcpy(payload.data() + offset, data, size);
+    }
+    return offset;
+}
+
+void RHICommandList::reset() {
+    commands.clear();
+    payload.clear();
+}
+
+void RHICommandList::setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    record(CommandType::SetViewport, RectArgs{ x, y, width, height });
+}
+
+void RHICommandList::setScissor(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    record(CommandType::SetScissor, RectArgs{ x, y, width, height });
+}
+
+void RHICommandList::setPipelineState(IRHIPipelineState* pipeline) {
+    record(CommandType::SetPipelineState, PointerArgs{ pipeline });
+}
+
+void RHICommandList::clearColor(float r, float g, float b, float a) {
+    record(CommandType::ClearColor, ColorArgs{ r, g, b, a });
+}
+
+void RHICommandList::clearDepth(float depth) {
+    record(CommandType::ClearDepth, depth);
+}
+
+void RHICommandList::clear(bool color, bool depth, bool stencil) {
+    record(CommandType::Clear, ClearArgs{ color, depth, stencil });
+}
+
+void RHICommandList::bindFramebuffer(IRHIFramebuffer* framebuffer) {
+    record(CommandType::BindFramebuffer, PointerArgs{ framebuffer });
+}
+
+void RHICommandList::bindShaderProgram(IRHIShaderProgram* program) {
+    record(CommandType::BindShaderProgram, PointerArgs{ program });
+}
+
+void RHICommandList::bindVertexArray(IRHIVertexArray* vertexArray) {
+    record(CommandType::BindVertexArray, PointerArgs{ vertexArray });
+}
+
+void RHICommandList::bindTexture(IRHITexture* texture, uint32_t slot) {
+    record(CommandType::BindTexture, BindTextureArgs{ texture, slot });
+}
+
+void RHICommandList::bindUniformBuffer(IRHIUniformBuffer* buffer) {
+    record(CommandType::BindUniformBuffer, PointerArgs{ buffer });
+}
+
+void RHICommandList::bindUniformBufferRange(uint32_t binding, IRHIBuffer* buffer, size_t offset, size_t size) {
+    record(CommandType::BindUniformBufferRange, BufferRangeArgs{ binding, buffer, offset, size });
+}
+
+void RHICommandList::setPipelineState(PipelineStateHandle pipeline) {
+    record(CommandType::SetPipelineStateHandle, HandleArgs{ pipeline.value, 0 });
+}
+
+void RHICommandList::bindFramebuffer(FramebufferHandle framebuffer) {
+    record(CommandType::BindFramebufferHandle, HandleArgs{ framebuffer.value, 0 });
+}
+
+void RHICommandList::bindVertexArray(VertexArrayHandle vertexArray) {
+    record(CommandType::BindVertexArrayHandle, HandleArgs{ vertexArray.value, 0 });
+}
+
+void RHICommandList::bindTexture(TextureHandle texture, uint32_t slot) {
+    record(CommandType::BindTextureHandle, HandleArgs{ texture.value, slot });
+}
+
+void RHICommandList::bindUniformBuffer(UniformBufferHandle buffer) {
+    record(CommandType::BindUniformBufferHandle, HandleArgs{ buffer.value, 0 });
+}
+
+void RHICommandList::setUniformFloat(const FName& name, float value) {
+    UniformArgs arguments{ name, {} };
+    arguments.values[0] = value;
+    record(CommandType::SetUniformFloat, arguments);
+}
+
+void RHICommandList::setUniformVec4(const FName& name, float x, float y, float z, float w) {
+    UniformArgs arguments{ name, { x, y, z, w } };
+    record(CommandType::SetUniformVec4, arguments);
+}
+
+void RHICommandList::setUniformInt(const FName& name, int value) {
+    UniformArgs arguments{ name, {} };
+    memcpy(arguments.values, &value, sizeof(int));
+    record(CommandType::SetUniformInt, arguments);
+}
+
+void RHICommandList::setUniformMatrix4(const FName& name, const float* value) {
+    UniformArgs arguments{ name, {} };
+    memcpy(arguments.values, value, sizeof(arguments.values));
+    record(CommandType::SetUniformMatrix4, arguments);
+}
+
+void RHICommandList::updateBuffer(IRHIBuffer* buffer, const void* data, size_t size, size_t offset) {
+    record(CommandType::UpdateBuffer, UpdateArgs{ buffer, storePayload(data, size), size, offset });
+}
+
+void RHICommandList::updateUniformBuffer(IRHIUniformBuffer* buffer, const void* data, size_t size, size_t offset) {
+    record(CommandType::UpdateUniformBuffer, UpdateArgs{ buffer, storePayload(data, size), size, offset });
+}
+
+void RHICommandList::updateTexture(IRHITexture* texture, const TextureRegion& region, const void* data) {
+    const size_t size = texture ? getTextureDataSize(texture->getFormat(), region.width, region.height) : 0;
+    record(CommandType::UpdateTexture, UpdateTextureArgs{ texture, region, storePayload(data, size) });
+}
+
+void RHICommandList::draw(PrimitiveTopology topology, uint32_t vertexCount, uint32_t startVertex) {
+    record(CommandType::Draw, DrawArgs{ topology, vertexCount, startVertex });
+}
+
+void RHICommandList::drawIndexed(PrimitiveTopology topology, uint32_t indexCount, uint32_t startIndex) {
+    record(CommandType::DrawIndexed, DrawArgs{ topology, indexCount, startIndex });
+}
+
+void RHICommandList::drawIndexedIndirect(PrimitiveTopology topology, IRHIBuffer* buffer, size_t offset) {
+    record(CommandType::MultiDrawIndexedIndirect, IndirectDrawArgs{ topology, buffer, offset, 1, 0 });
+}
+
+void RHICommandList::multiDrawIndexedIndirect(PrimitiveTopology topology, IRHIBuffer* buffer, size_t offset,
+                                              uint32_t drawCount, uint32_t stride) {
+    record(CommandType::MultiDrawIndexedIndirect, IndirectDrawArgs{ topology, buffer, offset, drawCount, stride });
+}
+
+void RHICommandList::setComputePipelineState(IRHIComputePipelineState* pipeline) {
+    record(CommandType::SetComputePipelineState, PointerArgs{ pipeline });
+}
+
+void RHICommandList::bindStorageBuffer(uint32_t binding, IRHIBuffer* buffer, size_t offset, size_t size) {
+    record(CommandType::BindStorageBuffer, BufferRangeArgs{ binding, buffer, offset, size });
+}
+
+void RHICommandList::bindStorageImage(uint32_t binding, IRHITexture* texture, uint32_t mipLevel, ImageAccess access) {
+    record(CommandType::BindStorageImage, StorageImageArgs{ binding, texture, mipLevel, access });
+}
+
+void RHICommandList::dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+    record(CommandType::Dispatch, DispatchArgs{ groupCountX, groupCountY, groupCountZ });
+}
+
+void RHICommandList::dispatchIndirect(IRHIBuffer* buffer, size_t offset) {
+    record(CommandType::DispatchIndirect, IndirectArgs{ buffer, offset });
+}
+
+void RHICommandList::memoryBarrier(BarrierFlags consumers) {
+    record(CommandType::MemoryBarrier, consumers);
+}
+
+void RHICommandList::execute(IRHIDevice& device) {
+    // Uniforms go to the program bound last
+    IRHIShaderProgram* program = nullptr;
+    const RHIResourcePools& pools = device.getResourcePools();
+    
+    const uint8_t* cursor = commands.data();
+    const uint8_t* end = cursor + commands.size();
+    while (cursor < end) {
+        const CommandType type = readArgs<CommandType>(cursor);
+        switch (type) {
+            case CommandType::SetViewport: {
+                const auto args = readArgs<RectArgs>(cursor);
+                device.setViewport(args.x, args.y, args.width, args.height);
+                break;
+            }
+            case CommandType::SetScissor: {
+                const auto args = readArgs<RectArgs>(cursor);
+                device.setScissor(args.x, args.y, args.width, args.height);
+                break;
+            }
+            case CommandType::SetPipelineState: {
+                auto* pipeline = static_cast<IRHIPipelineState*>(readArgs<PointerArgs>(cursor).resource);
+                device.setPipelineState(pipeline);
+                if (pipeline) program = pipeline->getDesc().program.get();
+                break;
+            }
+            case CommandType::ClearColor: {
+                const auto args = readArgs<ColorArgs>(cursor);
+                device.clearColor(args.r, args.g, args.b, args.a);
+                break;
+            }
+            case CommandType::ClearDepth:
+                device.clearDepth(readArgs<float>(cursor));
+                break;
+            case CommandType::Clear: {
+                const auto args = readArgs<ClearArgs>(cursor);
+                device.clear(args.color, args.depth, args.stencil);
+                break;
+            }
+            case CommandType::BindFramebuffer: {
+                auto* framebuffer = static_cast<IRHIFramebuffer*>(readArgs<PointerArgs>(cursor).resource);
+                if (framebuffer) {
+                    framebuffer->bind();
+                } else {
+                    device.bindDefaultFramebuffer();
+                }
+                break;
+            }
+            case CommandType::BindShaderProgram:
+                program = static_cast<IRHIShaderProgram*>(readArgs<PointerArgs>(cursor).resource);
+                if (program) program->bind();
+                break;
+            case CommandType::BindVertexArray: {
+                auto* vertexArray = static_cast<IRHIVertexArray*>(readArgs<PointerArgs>(cursor).resource);
+                if (vertexArray) vertexArray->bind();
+                break;
+            }
+            case CommandType::BindTexture: {
+                const auto args = readArgs<BindTextureArgs>(cursor);
+                if (args.texture) args.texture->bind(args.slot);
+                break;
+            }
+            case CommandType::BindUniformBuffer: {
+                auto* buffer = static_cast<IRHIUniformBuffer*>(readArgs<PointerArgs>(cursor).resource);
+                if (buffer) buffer->bind(buffer->getBinding());
+                break;
+            }
+            case CommandType::BindUniformBufferRange: {
+                const auto args = readArgs<BufferRangeArgs>(cursor);
+                device.bindUniformBufferRange(args.binding, args.buffer, args.offset, args.size);
+                break;
+            }
+            case CommandType::SetPipelineStateHandle: {
+                IRHIPipelineState* pipeline = pools.tryGet(PipelineStateHandle{ readArgs<HandleArgs>(cursor).handle });
+                if (pipeline) {
+                    device.setPipelineState(pipeline);
+                    program = pipeline->getDesc().program.get();
+                }
+                break;
+            }
+            case CommandType::BindFramebufferHandle: {
+                const FramebufferHandle handle{ readArgs<HandleArgs>(cursor).handle };
+                if (!handle.isValid()) {
+                    device.bindDefaultFramebuffer();
+                } else if (IRHIFramebuffer* framebuffer = pools.tryGet(handle)) {
+                    framebuffer->bind();
+                }
+                break;
+            }
+            case CommandType::BindVertexArrayHandle: {
+                IRHIVertexArray* vertexArray = pools.tryGet(VertexArrayHandle{ readArgs<HandleArgs>(cursor).handle });
+                if (vertexArray) vertexArray->bind();
+                break;
+            }
+            case CommandType::BindTextureHandle: {
+                const auto args = readArgs<HandleArgs>(cursor);
+                IRHITexture* texture = pools.tryGet(TextureHandle{ args.handle });
+                if (texture) texture->bind(args.slot);
+                break;
+            }
+            case CommandType::BindUniformBufferHandle: {
+                IRHIUniformBuffer* buffer = pools.tryGet(UniformBufferHandle{ readArgs<HandleArgs>(cursor).handle });
+                if (buffer) buffer->bind(buffer->getBinding());
+                break;
+            }
+            case CommandType::SetUniformFloat: {
+                const auto args = readArgs<UniformArgs>(cursor);
+                if (program) program->setUniformFloat(args.name, args.values[0]);
+                break;
+            }
+            case CommandType::SetUniformVec4: {
+                const auto args = readArgs<UniformArgs>(cursor);
+                if (program) program->setUniformVec4(args.name, args.values[0], args.values[1], args.values[2], args.values[3]);
+                break;
+            }
+            case CommandType::SetUniformInt: {
+                const auto args = readArgs<UniformArgs>(cursor);
+                int value;
+                memcpy(&value, args.values, sizeof(int));
+                if (program) program->setUniformInt(args.name, value);
+                break;
+            }
+            case CommandType::SetUniformMatrix4: {
+                const auto args = readArgs<UniformArgs>(cursor);
+                if (program) program->setUniformMatrix4(args.name, args.values);
+                break;
+            }
+            case CommandType::UpdateBuffer: {
+                const auto args = readArgs<UpdateArgs>(cursor);
+                if (args.resource) {
+                    static_cast<IRHIBuffer*>(args.resource)->updateData(payload.data() + args.payloadOffset, args.size, args.offset);
+                }
+                break;
+            }
+            case CommandType::UpdateUniformBuffer: {
+                const auto args = readArgs<UpdateArgs>(cursor);
+                if (args.resource) {
+                    static_cast<IRHIUniformBuffer*>(args.resource)->update(payload.data() + args.payloadOffset, args.size, args.offset);
+                }
+                break;
+            }
+            case CommandType::UpdateTexture: {
+                const auto args = readArgs<UpdateTextureArgs>(cursor);
+                if (args.texture) args.texture->updateRegion(args.region, payload.data() + args.payloadOffset);
+                break;
+            }
+            case CommandType::Draw: {
+                const auto args = readArgs<DrawArgs>(cursor);
+                device.draw(args.topology, args.count, args.start);
+                break;
+            }
+            case CommandType::DrawIndexed: {
+                const auto args = readArgs<DrawArgs>(cursor);
+                device.drawIndexed(args.topology, args.count, args.start);
+                break;
+            }
+            case CommandType::MultiDrawIndexedIndirect: {
+                const auto args = readArgs<IndirectDrawArgs>(cursor);
+                device.multiDrawIndexedIndirect(args.topology, args.buffer, args.offset, args.drawCount, args.stride);
+                break;
+            }
+            case CommandType::SetComputePipelineState: {
+                auto* pipeline = static_cast<IRHIComputePipelineState*>(readArgs<PointerArgs>(cursor).resource);
+                device.setComputePipelineState(pipeline);
+                if (pipeline) program = pipeline->getDesc().program.get();
+                break;
+            }
+            case CommandType::BindStorageBuffer: {
+                const auto args = readArgs<BufferRangeArgs>(cursor);
+                device.bindStorageBuffer(args.binding, args.buffer, args.offset, args.size);
+                break;
+            }
+            case CommandType::BindStorageImage: {
+                const auto args = readArgs<StorageImageArgs>(cursor);
+                device.bindStorageImage(args.binding, args.texture, args.mipLevel, args.access);
+                break;
+            }
+            case CommandType::Dispatch: {
+                const auto args = readArgs<DispatchArgs>(cursor);
+                device.dispatch(args.x, args.y, args.z);
+                break;
+            }
+            case CommandType::DispatchIndirect: {
+                const auto args = readArgs<IndirectArgs>(cursor);
+                device.dispatchIndirect(args.buffer, args.offset);
+                break;
+            }
+            case CommandType::MemoryBarrier:
+                device.memoryBarrier(readArgs<BarrierFlags>(cursor));
+                break;
+        }
+    }
+}
+
+} // namespace RHI
+} // namespace CarrotToy
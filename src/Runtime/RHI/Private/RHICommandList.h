@@ -0,0 +1,114 @@
+#pragma once
+
+#include "RHI/RHI.h"
+#include "RHI/RHICommandList.h"
+#include <vector>
+
+namespace CarrotToy {
+namespace RHI {
+
+// IRHICommandList that records into a flat byte stream and replays it through the IRHIDevice and
+// resource interfaces, so it works with any backend.
+//
+// Each command is a CommandType followed by its trivially copyable arguments. Data of the update
+// commands goes to a separate payload stream and is referenced by offset. Both streams keep their
+// capacity across reset(), so a list recorded every frame stops allocating after the first one.
+class RHICommandList : public IRHICommandList {
+public:
+    void reset() override;
+    bool isEmpty() const override { return commands.empty(); }
+    
+    void setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+    void setScissor(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+    void setPipelineState(IRHIPipelineState* pipeline) override;
+    
+    void clearColor(float r, float g, float b, float a) override;
+    void clearDepth(float depth) override;
+    void clear(bool color, bool depth, bool stencil) override;
+    
+    void bindFramebuffer(IRHIFramebuffer* framebuffer) override;
+    void bindShaderProgram(IRHIShaderProgram* program) override;
+    void bindVertexArray(IRHIVertexArray* vertexArray) override;
+    void bindTexture(IRHITexture* texture, uint32_t slot) override;
+    void bindUniformBuffer(IRHIUniformBuffer* buffer) override;
+    void bindUniformBufferRange(uint32_t binding, IRHIBuffer* buffer, size_t offset, size_t size) override;
+    
+    void setPipelineState(PipelineStateHandle pipeline) override;
+    void bindFramebuffer(FramebufferHandle framebuffer) override;
+    void bindVertexArray(VertexArrayHandle vertexArray) override;
+    void bindTexture(TextureHandle texture, uint32_t slot) override;
+    void bindUniformBuffer(UniformBufferHandle buffer) override;
+    
+    void setUniformFloat(const FName& name, float value) override;
+    void setUniformVec4(const FName& name, float x, float y, float z, float w) override;
+    void setUniformInt(const FName& name, int value) override;
+    void setUniformMatrix4(const FName& name, const float* value) override;
+    
+    void updateBuffer(IRHIBuffer* buffer, const void* data, size_t size, size_t offset = 0) override;
+    void updateUniformBuffer(IRHIUniformBuffer* buffer, const void* data, size_t size, size_t offset = 0) override;
+    void updateTexture(IRHITexture* texture, const TextureRegion& region, const void* data) override;
+    
+    void draw(PrimitiveTopology topology, uint32_t vertexCount, uint32_t startVertex = 0) override;
+    void drawIndexed(PrimitiveTopology topology, uint32_t indexCount, uint32_t startIndex = 0) override;
+    void drawIndexedIndirect(PrimitiveTopology topology, IRHIBuffer* buffer, size_t offset = 0) override;
+    void multiDrawIndexedIndirect(PrimitiveTopology topology, IRHIBuffer* buffer, size_t offset,
+                                  uint32_t drawCount, uint32_t stride = 0) override;
+    
+    void setComputePipelineState(IRHIComputePipelineState* pipeline) override;
+    void bindStorageBuffer(uint32_t binding, IRHIBuffer* buffer, size_t offset = 0, size_t size = 0) override;
+    void bindStorageImage(uint32_t binding, IRHITexture* texture, uint32_t mipLevel = 0,
+                          ImageAccess access = ImageAccess::ReadWrite) override;
+    void dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) override;
+    void dispatchIndirect(IRHIBuffer* buffer, size_t offset = 0) override;
+    void memoryBarrier(BarrierFlags consumers) override;
+    
+    void execute(IRHIDevice& device) override;
+
+private:
+    enum class CommandType : uint8_t {
+        SetViewport,
+        SetScissor,
+        SetPipelineState,
+        ClearColor,
+        ClearDepth,
+        Clear,
+        BindFramebuffer,
+        BindShaderProgram,
+        BindVertexArray,
+        BindTexture,
+        BindUniformBuffer,
+        BindUniformBufferRange,
+        SetPipelineStateHandle,
+        BindFramebufferHandle,
+        BindVertexArrayHandle,
+        BindTextureHandle,
+        BindUniformBufferHandle,
+        SetUniformFloat,
+        SetUniformVec4,
+        SetUniformInt,
+        SetUniformMatrix4,
+        UpdateBuffer,
+        UpdateUniformBuffer,
+        UpdateTexture,
+        Draw,
+        DrawIndexed,
+        MultiDrawIndexedIndirect,
+        SetComputePipelineState,
+        BindStorageBuffer,
+        BindStorageImage,
+        Dispatch,
+        DispatchIndirect,
+        MemoryBarrier
+    };
+    
+    template <typename T>
+    void record(CommandType type, const T& arguments);
+    // Copies data into the payload stream and returns its offset there
+    size_t storePayload(const void* data, size_t size);
+    
+    std::vector<uint8_t> commands;
+    std::vector<uint8_t> payload;
+};
+
+} // namespace RHI
+} // namespace CarrotToy
@@ -4,6 +4,7 @@
 #include <cstring>
 #include <thread>
 #include <chrono>
+#include <vector>
 
 // Example demonstrating how to use the RHI (Render Hardware Interface)
 // This file is for demonstration purposes and shows the API usage patterns
@@ -172,6 +173,27 @@ void demonstrateRHIUsage() {
     auto texture = rhiDevice->createTexture(textureDesc);
     std::cout << "Texture created" << std::endl;
     
+    // Same-sized material textures can share one array texture, bound to a single slot; shaders
+    // pick the layer. Each layer and level is filled separately.
+    TextureDesc arrayDesc;
+    arrayDesc.type = TextureType::Texture2DArray;
+    arrayDesc.width = 256;
+    arrayDesc.height = 256;
+    arrayDesc.arrayLayers = 4;
+    arrayDesc.mipLevels = 1;
+    arrayDesc.format = TextureFormat::RGBA8;
+    
+    auto textureArray = rhiDevice->createTexture(arrayDesc);
+    std::vector<uint8_t> layerTexels(getTextureDataSize(arrayDesc.format, arrayDesc.width, arrayDesc.height), 255);
+    for (uint32_t layer = 0; layer < arrayDesc.arrayLayers; ++layer) {
+        TextureRegion region;
+        region.width = arrayDesc.width;
+        region.height = arrayDesc.height;
+        region.arrayLayer = layer;
+        textureArray->updateRegion(region, layerTexels.data());
+    }
+    std::cout << "Texture array created with " << textureArray->getArrayLayers() << " layers" << std::endl;
+    
     // 9. Create a framebuffer
     FramebufferDesc framebufferDesc;
     framebufferDesc.width = 1280;
@@ -183,12 +205,17 @@ void demonstrateRHIUsage() {
         std::cout << "Framebuffer created and complete" << std::endl;
     }
     
-    // 10. Demonstrate rendering state setup
+    // 10. Demonstrate rendering state setup: everything but the viewport lives in a pipeline
+    // state, created once (equal descs share one) and bound with a single call
     rhiDevice->setViewport(0, 0, 1280, 720);
-    rhiDevice->setDepthTest(true);
-    rhiDevice->setDepthFunc(CompareFunc::Less);
-    rhiDevice->setCullMode(CullMode::Back);
-    rhiDevice->setBlend(false);
+    
+    PipelineStateDesc pipelineDesc;
+    pipelineDesc.program = shaderProgram;
+    pipelineDesc.vertexLayout = { positionAttr, colorAttr };
+    pipelineDesc.depth.compareFunc = CompareFunc::Less;
+    pipelineDesc.raster.cullMode = CullMode::Back;
+    pipelineDesc.blend.enable = false;
+    auto pipeline = rhiDevice->createPipelineState(pipelineDesc);
     
     std::cout << "Rendering state configured" << std::endl;
     
@@ -196,17 +223,108 @@ void demonstrateRHIUsage() {
     rhiDevice->clearColor(0.2f, 0.2f, 0.2f, 1.0f);
     rhiDevice->clear(true, true, false);
     
-    shaderProgram->bind();
+    rhiDevice->setPipelineState(pipeline.get());
     shaderProgram->setUniformFloat("time", 0.0f);
     shaderProgram->setUniformVec3("lightPos", 0.0f, 10.0f, 0.0f);
     
     vertexArray->bind();
     rhiDevice->drawIndexed(PrimitiveTopology::TriangleList, 3, 0);
+    
+    // The same triangle twice more, with the draw arguments in a buffer: one call for both
+    // baseInstance stays 0: indirect draws work from GL 4.0, a nonzero one needs 4.2
+    const DrawIndexedIndirectCommand indirectCommands[2] = {
+        { 3, 1, 0, 0, 0 },
+        { 3, 1, 0, 0, 0 },
+    };
+    BufferDesc indirectDesc;
+    indirectDesc.type = BufferType::Indirect;
+    indirectDesc.size = sizeof(indirectCommands);
+    indirectDesc.initialData = indirectCommands;
+    auto indirectBuffer = rhiDevice->createBuffer(indirectDesc);
+    rhiDevice->multiDrawIndexedIndirect(PrimitiveTopology::TriangleList, indirectBuffer.get(), 0, 2);
+    
+    // A compute pass can write the same records, e.g. keeping only the objects that pass culling.
+    // The barrier makes its writes visible to the draw call reading them.
+    if (rhiDevice->supportsCompute()) {
+        const char* cullShaderSource = R"(
+            #version 430 core
+            layout (local_size_x = 64) in;
+            struct DrawCommand { uint indexCount, instanceCount, firstIndex; int baseVertex; uint baseInstance; };
+            layout (std430, binding = 0) writeonly buffer DrawCommands { DrawCommand commands[]; };
+            uniform uint drawCount;
+            
+            void main() {
+                uint i = gl_GlobalInvocationID.x;
+                if (i < drawCount) {
+                    commands[i] = DrawCommand(3u, 1u, 0u, 0, 0u);
+                }
+            }
+        )";
+        ShaderDesc cullShaderDesc;
+        cullShaderDesc.type = ShaderType::Compute;
+        cullShaderDesc.source = cullShaderSource;
+        cullShaderDesc.sourceSize = strlen(cullShaderSource);
+        auto cullShader = rhiDevice->createShader(cullShaderDesc);
+        auto cullProgram = rhiDevice->createShaderProgram();
+        if (cullShader->compile()) {
+            cullProgram->attachShader(cullShader.get());
+        }
+        ComputePipelineDesc cullPipelineDesc;
+        cullPipelineDesc.program = cullProgram;
+        auto cullPipeline = cullProgram->link() ? rhiDevice->createComputePipelineState(cullPipelineDesc) : nullptr;
+        
+        BufferDesc drawListDesc;
+        drawListDesc.type = BufferType::Storage;
+        drawListDesc.size = sizeof(DrawIndexedIndirectCommand) * 2;
+        auto drawList = rhiDevice->createBuffer(drawListDesc);
+        if (cullPipeline) {
+            uint32_t groupSizeX, groupSizeY, groupSizeZ;
+            cullPipeline->getWorkGroupSize(groupSizeX, groupSizeY, groupSizeZ);
+            rhiDevice->setComputePipelineState(cullPipeline.get());
+            cullProgram->setUniformInt("drawCount", 2);
+            rhiDevice->bindStorageBuffer(0, drawList.get());
+            rhiDevice->dispatch((2 + groupSizeX - 1) / groupSizeX);
+            rhiDevice->memoryBarrier(BarrierFlags::IndirectBuffer);
+            
+            rhiDevice->setPipelineState(pipeline.get());
+            rhiDevice->multiDrawIndexedIndirect(PrimitiveTopology::TriangleList, drawList.get(), 0, 2);
+        }
+    }
     vertexArray->unbind();
     
     shaderProgram->unbind();
     
     std::cout << "Render pass demonstrated" << std::endl;
+    
+    // The same pass recorded on worker threads, one command list each, and replayed in order on
+    // this thread (the one that owns the context). The lists refer to the pipeline and vertex array
+    // by handle; the pools keep them alive until they are removed.
+    RHIResourcePools& pools = rhiDevice->getResourcePools();
+    const PipelineStateHandle pipelineHandle = pools.add(pipeline);
+    const VertexArrayHandle vertexArrayHandle = pools.add(vertexArray);
+    std::unique_ptr<IRHICommandList> commandLists[2] = { rhiDevice->createCommandList(), rhiDevice->createCommandList() };
+    std::thread recorders[2];
+    for (int i = 0; i < 2; ++i) {
+        recorders[i] = std::thread([&, i]() {
+            IRHICommandList& commands = *commandLists[i];
+            if (i == 0) {
+                commands.setViewport(0, 0, 1280, 720);
+                commands.clear(true, true, false);
+            }
+            commands.setPipelineState(pipelineHandle);
+            commands.setUniformFloat("time", static_cast<float>(i));
+            commands.bindVertexArray(vertexArrayHandle);
+            commands.drawIndexed(PrimitiveTopology::TriangleList, 3, 0);
+        });
+    }
+    for (std::thread& recorder : recorders) {
+        recorder.join();
+    }
+    IRHICommandList* lists[2] = { commandLists[0].get(), commandLists[1].get() };
+    rhiDevice->submitCommandLists(lists, 2);
+    pools.remove(vertexArrayHandle);
+    pools.remove(pipelineHandle);
+    std::cout << "Command lists recorded on 2 threads and submitted" << std::endl;
     std::cout << "Note: This is a demonstration of RHI API usage patterns." << std::endl;
     std::cout << "In a real application, integrate with the Platform layer for window management." << std::endl;
     
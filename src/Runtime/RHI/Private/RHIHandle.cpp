@@ -0,0 +1,17 @@
+#include "RHI/RHIHandle.h"
+#include "CoreUtils.h"
+
+namespace CarrotToy {
+namespace RHI {
+
+void reportStaleHandle(const char* poolName, uint32_t value) {
+    LOG("RHI: Stale " << poolName << " handle " << (value & RHIHandle<void>::kIndexMask)
+        << " (generation " << (value >> RHIHandle<void>::kIndexBits) << "), its resource was removed");
+}
+
+void reportPoolFull(const char* poolName) {
+    LOG("RHI: " << poolName << " pool is full, no handle created");
+}
+
+} // namespace RHI
+} // namespace CarrotToy
@@ -86,6 +86,13 @@ public:
 		// because it requires a proc address loader from the Platform module.
 	}
 
+	virtual void GetModuleDescriptor(FModuleDescriptor& OutDescriptor) const override
+	{
+		// The device is created on (and bound to) the main thread's GL context
+		OutDescriptor.Dependencies.Add("Platform");
+		OutDescriptor.bMainThreadOnly = true;
+	}
+
 	virtual void ShutdownModule() override
 	{
 		LOG("RHIModule: Shutdown - Shutting down RHI subsystem");
@@ -0,0 +1,62 @@
+#include "RHI/RHIResources.h"
+#include "Misc/Hash.h"
+
+namespace CarrotToy {
+namespace RHI {
+
+namespace {
+
+template <typename T>
+uint64_t hashValue(const T& value, uint64_t seed) {
+    return FHash::Fnv1a64(&value, sizeof(T), seed);
+}
+
+} // namespace
+
+uint64_t PipelineStateDesc::hash() const {
+    // Field by field, so padding bytes never reach the hash
+    uint64_t result = FHash::Fnv1a64Seed;
+    result = hashValue(reinterpret_cast<uintptr_t>(program.get()), result);
+    for (const VertexAttribute& attribute : vertexLayout) {
+        result = hashValue(attribute.location, result);
+        result = hashValue(attribute.binding, result);
+        result = hashValue(attribute.offset, result);
+        result = hashValue(attribute.componentCount, result);
+        result = hashValue(attribute.stride, result);
+        result = hashValue(attribute.normalized, result);
+        result = hashValue(attribute.format, result);
+    }
+    result = hashValue(raster.cullMode, result);
+    result = hashValue(raster.scissorTest, result);
+    result = hashValue(depth.testEnable, result);
+    result = hashValue(depth.writeEnable, result);
+    result = hashValue(depth.compareFunc, result);
+    result = hashValue(blend.enable, result);
+    result = hashValue(blend.srcFactor, result);
+    result = hashValue(blend.dstFactor, result);
+    result = hashValue(blend.op, result);
+    return result;
+}
+
+bool PipelineStateDesc::operator==(const PipelineStateDesc& other) const {
+    if (program != other.program || vertexLayout.size() != other.vertexLayout.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < vertexLayout.size(); ++i) {
+        const VertexAttribute& a = vertexLayout[i];
+        const VertexAttribute& b = other.vertexLayout[i];
+        if (a.location != b.location || a.binding != b.binding || a.offset != b.offset ||
+            a.componentCount != b.componentCount || a.stride != b.stride || a.normalized != b.normalized ||
+            a.format != b.format) {
+            return false;
+        }
+    }
+    return raster.cullMode == other.raster.cullMode && raster.scissorTest == other.raster.scissorTest &&
+           depth.testEnable == other.depth.testEnable && depth.writeEnable == other.depth.writeEnable &&
+           depth.compareFunc == other.depth.compareFunc &&
+           blend.enable == other.blend.enable && blend.srcFactor == other.blend.srcFactor &&
+           blend.dstFactor == other.blend.dstFactor && blend.op == other.blend.op;
+}
+
+} // namespace RHI
+} // namespace CarrotToy
@@ -0,0 +1,102 @@
+#include "RHI/RHIVertexPacking.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace CarrotToy {
+namespace RHI {
+
+namespace {
+
+int32_t toSnorm(float value, int32_t maxValue) {
+    const float clamped = std::min(std::max(value, -1.0f), 1.0f);
+    return static_cast<int32_t>(std::lround(clamped * static_cast<float>(maxValue)));
+}
+
+} // namespace
+
+uint16_t packHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t exponent = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent == 0xFFu) {
+        // Infinity stays infinity, NaN stays a (quiet) NaN
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+    }
+    const int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+    if (halfExponent >= 0x1F) {
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+
+    uint32_t half;
+    uint32_t remainder;
+    uint32_t halfway;
+    if (halfExponent <= 0) {
+        // Denormal: the implicit leading 1 becomes explicit and shifts into the 10 mantissa bits
+        if (halfExponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000u;
+        const uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+        half = mantissa >> shift;
+        remainder = mantissa & ((1u << shift) - 1);
+        halfway = 1u << (shift - 1);
+    } else {
+        half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+        remainder = mantissa & 0x1FFFu;
+        halfway = 0x1000u;
+    }
+    // Round to nearest even; a carry out of the mantissa correctly bumps the exponent
+    if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+        ++half;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+void packOctahedralNormal(float x, float y, float z, int16_t out[2]) {
+    const float length = std::fabs(x) + std::fabs(y) + std::fabs(z);
+    float u = 0.0f;
+    float v = 0.0f;
+    if (length > 0.0f) {
+        u = x / length;
+        v = y / length;
+        if (z < 0.0f) {
+            // Lower half folds over the diagonals
+            const float foldedU = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+            const float foldedV = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+            u = foldedU;
+            v = foldedV;
+        }
+    }
+    out[0] = static_cast<int16_t>(toSnorm(u, 32767));
+    out[1] = static_cast<int16_t>(toSnorm(v, 32767));
+}
+
+uint32_t packSnorm10_10_10_2(float x, float y, float z, float w) {
+    const uint32_t packedX = static_cast<uint32_t>(toSnorm(x, 511)) & 0x3FFu;
+    const uint32_t packedY = static_cast<uint32_t>(toSnorm(y, 511)) & 0x3FFu;
+    const uint32_t packedZ = static_cast<uint32_t>(toSnorm(z, 511)) & 0x3FFu;
+    const uint32_t packedW = static_cast<uint32_t>(toSnorm(w, 1)) & 0x3u;
+    return packedX | (packedY << 10) | (packedZ << 20) | (packedW << 30);
+}
+
+IndexFormat packIndices(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                        std::vector<uint8_t>& outData) {
+    const IndexFormat format = getIndexFormatForVertexCount(vertexCount);
+    outData.resize(indexCount * getIndexSize(format));
+    if (format == IndexFormat::UInt32) {
+        memcpy(outData.data(), indices, outData.size());
+        return format;
+    }
+    for (size_t i = 0; i < indexCount; ++i) {
+        const uint16_t index = static_cast<uint16_t>(indices[i]);
+        memcpy(outData.data() + i * sizeof(uint16_t), &index, sizeof(uint16_t));
+    }
+    return format;
+}
+
+} // namespace RHI
+} // namespace CarrotToy
@@ -2,8 +2,11 @@
 
 #include "RHI.h"
 #include "RHIResources.h"
-#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace CarrotToy {
 namespace RHI {
@@ -15,11 +18,15 @@ class OpenGLShaderProgram;
 class OpenGLTexture;
 class OpenGLFramebuffer;
 class OpenGLVertexArray;
+class OpenGLPipelineState;
+class OpenGLStreamBuffer;
+class OpenGLTextureUploader;
+class OpenGLDeletionQueue;
 
 // OpenGL Buffer implementation
 class OpenGLBuffer : public IRHIBuffer {
 public:
-    OpenGLBuffer(const BufferDesc& desc);
+    OpenGLBuffer(const BufferDesc& desc, std::shared_ptr<OpenGLDeletionQueue> deletionQueue);
     ~OpenGLBuffer() override;
     
     void updateData(const void* data, size_t size, size_t offset = 0) override;
@@ -33,21 +40,28 @@ public:
     BufferType getType() const override { return type; }
     
     unsigned int getBufferID() const { return bufferID; }
+    // Non-null for Stream buffers with persistent storage; map() returns it without a GL call.
+    // Writes through it are not synchronized with the GPU.
+    void* getPersistentData() const { return persistentData; }
     
 private:
     unsigned int bufferID;
+    // The device's; release() hands the GL name to it
+    std::shared_ptr<OpenGLDeletionQueue> deletionQueue;
     BufferType type;
     BufferUsage usage;
     size_t size;
+    void* persistentData = nullptr;
 };
 
 // OpenGL Shader implementation
 class OpenGLShader : public IRHIShader {
 public:
-    OpenGLShader(const ShaderDesc& desc);
+    OpenGLShader(const ShaderDesc& desc, std::shared_ptr<OpenGLDeletionQueue> deletionQueue);
     ~OpenGLShader() override;
     
     bool compile() override;
+    bool compileAsync() override;
     std::string getCompileErrors() const override { return errors; }
     
     bool isValid() const override { return shaderID != 0; }
@@ -56,35 +70,66 @@ public:
     ShaderType getType() const override { return type; }
     unsigned int getShaderID() const { return shaderID; }
     
+    // Hash of stage type, format, entry point, source and specialization; program binary cache key input
+    uint64_t getSourceHash() const { return sourceHash; }
+    // Submits the GL compile if compile() deferred it because the program cache knows this stage
+    bool ensureSubmitted();
+    // Queries GL_COMPILE_STATUS (blocks until the compile finished) and fills the compile errors
+    bool checkCompileStatus();
+    
 private:
+    bool submitCompile();
+    
     unsigned int shaderID;
+    std::shared_ptr<OpenGLDeletionQueue> deletionQueue;
     ShaderType type;
     ShaderSourceFormat format;
     std::string source;
     std::string entryPoint;
     std::string errors;
+    // Specialization constants declared by the SPIR-V module, as passed to glSpecializeShader
+    std::vector<uint32_t> specConstantIDs;
+    std::vector<uint32_t> specConstantValues;
+    uint64_t sourceHash = 0;
+    bool submitted = false;
 };
 
 // OpenGL Shader Program implementation
+// The program the GL context is using, as far as the RHI knows. OpenGLShaderProgram::bind(),
+// unbind() and release() report every change here, so binding or unbinding a program outside the
+// device (command list replay, Material, IRHIShaderProgram::unbind) cannot leave setPipelineState
+// skipping a program it thinks is still current. Context thread only.
+class RHI_API OpenGLProgramBinding {
+public:
+    // 0 for none
+    static void onBind(uint32_t programID);
+    // The program is being deleted; GL names are reused, so a later program with the same name
+    // must still be bound
+    static void onRelease(uint32_t programID);
+    static bool isBound(uint32_t programID);
+};
+
 class OpenGLShaderProgram : public IRHIShaderProgram {
 public:
-    OpenGLShaderProgram();
+    explicit OpenGLShaderProgram(std::shared_ptr<OpenGLDeletionQueue> deletionQueue);
     ~OpenGLShaderProgram() override;
     
     void attachShader(IRHIShader* shader) override;
     void detachShader(IRHIShader* shader) override;
     
     bool link() override;
+    bool linkAsync() override;
+    bool isReady() const override;
     void bind() override;
     void unbind() override;
     
-    void setUniformFloat(const std::string& name, float value) override;
-    void setUniformVec2(const std::string& name, float x, float y) override;
-    void setUniformVec3(const std::string& name, float x, float y, float z) override;
-    void setUniformVec4(const std::string& name, float x, float y, float z, float w) override;
-    void setUniformInt(const std::string& name, int value) override;
-    void setUniformBool(const std::string& name, bool value) override;
-    void setUniformMatrix4(const std::string& name, const float* value) override;
+    void setUniformFloat(const FName& name, float value) override;
+    void setUniformVec2(const FName& name, float x, float y) override;
+    void setUniformVec3(const FName& name, float x, float y, float z) override;
+    void setUniformVec4(const FName& name, float x, float y, float z, float w) override;
+    void setUniformInt(const FName& name, int value) override;
+    void setUniformBool(const FName& name, bool value) override;
+    void setUniformMatrix4(const FName& name, const float* value) override;
     
     std::string getLinkErrors() const override { return errors; }
     
@@ -98,21 +143,35 @@ public:
     void release() override;
     
 private:
+    enum class LinkState { Unlinked, Pending, Linked, Failed };
+    
+    bool submitLink();
+    bool finishLink();
+    
     unsigned int programID;
+    std::shared_ptr<OpenGLDeletionQueue> deletionQueue;
     std::string errors;
-    std::vector<unsigned int> attachedShaders;
+    // Stages are only attached to the GL program in link(), after the binary cache missed
+    std::vector<OpenGLShader*> attachedShaders;
     
-    int getUniformLocation(const std::string& name);
-    std::unordered_map<std::string, int> uniformLocationCache;
+    LinkState linkState = LinkState::Unlinked;
+    bool loadedFromCache = false;
+    uint64_t cacheKey = 0;
+    TInlineArray<uint64_t, 4> stageHashes;
+    
+    int getUniformLocation(const FName& name);
+    // GLSL names are case-sensitive, so "Albedo" and "albedo" get their own entries
+    TMap<FName, int, FNameCaseSensitiveHash, FNameCaseSensitiveKeyEqual> uniformLocationCache;
 };
 
 // OpenGL Texture implementation
 class OpenGLTexture : public IRHITexture {
 public:
-    OpenGLTexture(const TextureDesc& desc);
+    OpenGLTexture(const TextureDesc& desc, std::shared_ptr<OpenGLDeletionQueue> deletionQueue);
     ~OpenGLTexture() override;
     
     void updateData(const void* data, uint32_t width, uint32_t height) override;
+    void updateRegion(const TextureRegion& region, const void* data) override;
     void bind(uint32_t slot = 0) override;
     void unbind() override;
     
@@ -122,11 +181,29 @@ public:
     uint32_t getWidth() const override { return width; }
     uint32_t getHeight() const override { return height; }
     TextureFormat getFormat() const override { return format; }
+    TextureType getType() const override { return type; }
+    uint32_t getMipLevels() const override { return mipLevels; }
+    uint32_t getArrayLayers() const override { return arrayLayers; }
     
     unsigned int getTextureID() const { return textureID; }
+    // GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY
+    unsigned int getTarget() const { return target; }
+    uintptr_t getNativeHandle() const override { return (uintptr_t)textureID; }
+    uint64_t getBindlessHandle() override;
     
 private:
+    void createName();
+    // Creates the GL texture: storage (immutable where supported), parameters and the first
+    // count entries of data, ordered as TextureDesc::mipData
+    void allocateStorage(const TextureMipData* data, uint32_t count);
+    // Uploads texels into part of an allocated subresource; size is only used by compressed formats
+    void uploadSubImage(const TextureRegion& region, const void* data, size_t size);
+    void regenerateMips();
+    
     unsigned int textureID;
+    std::shared_ptr<OpenGLDeletionQueue> deletionQueue;
+    TextureType type;
+    unsigned int target;
     uint32_t width;
     uint32_t height;
     TextureFormat format;
@@ -134,12 +211,51 @@ private:
     TextureFilter magFilter;
     TextureWrap wrapS;
     TextureWrap wrapT;
+    uint32_t mipLevels;
+    uint32_t arrayLayers;
+    // Levels past 0 are generated on the GPU from level 0 instead of uploaded
+    bool generatedMips;
+    // Resident ARB_bindless_texture handle, 0 until getBindlessHandle() is called
+    uint64_t bindlessHandle = 0;
+};
+
+// OpenGL pipeline state: a validated, hashed desc. GL has no pipeline objects, so binding it sets
+// the state that differs from the previous pipeline (see OpenGLRHIDevice::setPipelineState).
+class OpenGLPipelineState : public IRHIPipelineState {
+public:
+    explicit OpenGLPipelineState(const PipelineStateDesc& desc);
+    
+    bool isValid() const override { return desc.program && desc.program->isValid(); }
+    void release() override { desc.program.reset(); }
+    
+    const PipelineStateDesc& getDesc() const override { return desc; }
+    uint64_t getHash() const override { return hash; }
+    
+private:
+    PipelineStateDesc desc;
+    uint64_t hash;
+};
+
+// OpenGL compute pipeline: just the program, which glUseProgram binds like a graphics one
+class OpenGLComputePipelineState : public IRHIComputePipelineState {
+public:
+    explicit OpenGLComputePipelineState(const ComputePipelineDesc& inDesc) : desc(inDesc) {}
+    
+    bool isValid() const override { return desc.program && desc.program->isValid(); }
+    void release() override { desc.program.reset(); }
+    
+    const ComputePipelineDesc& getDesc() const override { return desc; }
+    // Queries the linked program; waits for a link still in flight
+    void getWorkGroupSize(uint32_t& x, uint32_t& y, uint32_t& z) const override;
+    
+private:
+    ComputePipelineDesc desc;
 };
 
 // OpenGL Framebuffer implementation
 class OpenGLFramebuffer : public IRHIFramebuffer {
 public:
-    OpenGLFramebuffer(const FramebufferDesc& desc);
+    OpenGLFramebuffer(const FramebufferDesc& desc, std::shared_ptr<OpenGLDeletionQueue> deletionQueue);
     ~OpenGLFramebuffer() override;
     
     void bind() override;
@@ -158,8 +274,13 @@ public:
     
 private:
     unsigned int framebufferID;
+    std::shared_ptr<OpenGLDeletionQueue> deletionQueue;
+    // Textures created with the framebuffer
     std::vector<std::shared_ptr<IRHITexture>> colorTextures;
     std::shared_ptr<IRHITexture> depthTexture;
+    // What is attached now, owned or not
+    std::vector<IRHITexture*> colorAttachments;
+    IRHITexture* depthAttachment = nullptr;
     uint32_t width;
     uint32_t height;
 };
@@ -167,13 +288,13 @@ private:
 // OpenGL Vertex Array implementation
 class OpenGLVertexArray : public IRHIVertexArray {
 public:
-    OpenGLVertexArray();
+    explicit OpenGLVertexArray(std::shared_ptr<OpenGLDeletionQueue> deletionQueue);
     ~OpenGLVertexArray() override;
     
     void bind() override;
     void unbind() override;
-    void setVertexBuffer(IRHIBuffer* buffer, uint32_t binding = 0) override;
-    void setIndexBuffer(IRHIBuffer* buffer) override;
+    void setVertexBuffer(IRHIBuffer* buffer, uint32_t binding = 0, size_t offset = 0) override;
+    void setIndexBuffer(IRHIBuffer* buffer, IndexFormat format = IndexFormat::UInt32) override;
     void setVertexAttribute(const VertexAttribute& attribute) override;
     
     bool isValid() const override { return vaoID != 0; }
@@ -183,8 +304,16 @@ public:
     
 private:
     unsigned int vaoID;
-    std::vector<IRHIBuffer*> vertexBuffers;
+    std::shared_ptr<OpenGLDeletionQueue> deletionQueue;
+    struct VertexBinding {
+        IRHIBuffer* buffer = nullptr;
+        size_t offset = 0;
+        // Set by setVertexAttribute(), for the direct state access path
+        uint32_t stride = 0;
+    };
+    std::vector<VertexBinding> vertexBindings;
     IRHIBuffer* indexBuffer;
+    IndexFormat indexFormat = IndexFormat::UInt32;
 };
 
 // OpenGL RHI Device implementation
@@ -197,6 +326,10 @@ public:
     void shutdown() override;
     
     GraphicsAPI getGraphicsAPI() const override { return GraphicsAPI::OpenGL; }
+    bool supportsParallelShaderCompile() const override;
+    bool supportsTextureFormat(TextureFormat format) const override;
+    bool supportsCompute() const override;
+    bool supportsBindlessTextures() const override;
     
     // Resource creation
     std::shared_ptr<IRHIBuffer> createBuffer(const BufferDesc& desc) override;
@@ -206,20 +339,33 @@ public:
     std::shared_ptr<IRHIFramebuffer> createFramebuffer(const FramebufferDesc& desc) override;
     std::shared_ptr<IRHIVertexArray> createVertexArray() override;
     std::shared_ptr<IRHIUniformBuffer> createUniformBuffer(size_t size, uint32_t binding) override;
+    std::shared_ptr<IRHIPipelineState> createPipelineState(const PipelineStateDesc& desc) override;
+    std::shared_ptr<IRHIComputePipelineState> createComputePipelineState(const ComputePipelineDesc& desc) override;
+    RHIResourcePools& getResourcePools() override { return resourcePools; }
+    
+    TransientAllocation allocateTransient(size_t size, size_t alignment = 0) override;
+    void bindUniformBufferRange(uint32_t binding, IRHIBuffer* buffer, size_t offset, size_t size) override;
+    void endFrame() override;
+    bool uploadTextureAsync(IRHITexture* texture, const TextureRegion& region, const void* data,
+                            std::function<void()> onComplete = nullptr) override;
+    
+    std::unique_ptr<IRHICommandList> createCommandList() override;
+    void submitCommandLists(IRHICommandList* const* lists, uint32_t count) override;
     
     // Rendering state
     void setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
     void setScissor(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+    void setPipelineState(IRHIPipelineState* pipeline) override;
     
-    void setDepthTest(bool enabled) override;
-    void setDepthWrite(bool enabled) override;
-    void setDepthFunc(CompareFunc func) override;
-    
-    void setBlend(bool enabled) override;
-    void setBlendFunc(BlendFactor srcFactor, BlendFactor dstFactor) override;
-    void setBlendOp(BlendOp op) override;
+    void setComputePipelineState(IRHIComputePipelineState* pipeline) override;
+    void bindStorageBuffer(uint32_t binding, IRHIBuffer* buffer, size_t offset = 0, size_t size = 0) override;
+    void bindStorageImage(uint32_t binding, IRHITexture* texture, uint32_t mipLevel = 0,
+                          ImageAccess access = ImageAccess::ReadWrite) override;
+    void dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) override;
+    void dispatchIndirect(IRHIBuffer* buffer, size_t offset = 0) override;
+    void memoryBarrier(BarrierFlags consumers) override;
     
-    void setCullMode(CullMode mode) override;
+    void bindDefaultFramebuffer() override;
     
     // Clearing
     void clearColor(float r, float g, float b, float a) override;
@@ -229,9 +375,31 @@ public:
     // Drawing
     void draw(PrimitiveTopology topology, uint32_t vertexCount, uint32_t startVertex = 0) override;
     void drawIndexed(PrimitiveTopology topology, uint32_t indexCount, uint32_t startIndex = 0) override;
+    void drawIndexedIndirect(PrimitiveTopology topology, IRHIBuffer* buffer, size_t offset = 0) override;
+    void multiDrawIndexedIndirect(PrimitiveTopology topology, IRHIBuffer* buffer, size_t offset,
+                                  uint32_t drawCount, uint32_t stride = 0) override;
     
 private:
     bool initialized;
+    // Thread the GL context is current on
+    std::thread::id contextThread;
+    
+    RHIResourcePools resourcePools;
+    // Pipelines by desc hash; entries expire with the last user of the pipeline
+    std::mutex pipelineCacheMutex;
+    std::unordered_map<uint64_t, std::vector<std::weak_ptr<OpenGLPipelineState>>> pipelineCache;
+    // State applied by the last setPipelineState, for diffing; invalid until the first one. The
+    // program is diffed against OpenGLProgramBinding instead, since it changes outside the device.
+    RasterState appliedRaster;
+    DepthState appliedDepth;
+    BlendState appliedBlend;
+    bool pipelineStateApplied = false;
+    // Ring behind allocateTransient; null without GL 4.4 / ARB_buffer_storage
+    std::unique_ptr<OpenGLStreamBuffer> streamBuffer;
+    std::unique_ptr<OpenGLTextureUploader> textureUploader;
+    // Created by initialize(), drained by endFrame() and shutdown(). Resources share it, so it
+    // outlives the device when they do.
+    std::shared_ptr<OpenGLDeletionQueue> deletionQueue;
 };
 
 } // namespace RHI
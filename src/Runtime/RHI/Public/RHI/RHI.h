@@ -2,6 +2,9 @@
 
 #include "RHITypes.h"
 #include "RHIResources.h"
+#include "RHICommandList.h"
+#include "RHIHandle.h"
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -25,6 +28,18 @@ public:
     // Get graphics API type
     virtual GraphicsAPI getGraphicsAPI() const = 0;
     
+    // True if shader compiles and program links run on driver threads and can be polled
+    // (IRHIShaderProgram::isReady) without stalling
+    virtual bool supportsParallelShaderCompile() const { return false; }
+    
+    // True if the compute entry points below (dispatch, storage buffers and images, barriers) work
+    virtual bool supportsCompute() const { return false; }
+    // Textures can be sampled through IRHITexture::getBindlessHandle, e.g. stored in a uniform block
+    virtual bool supportsBindlessTextures() const { return false; }
+    
+    // False for formats the driver cannot sample, e.g. BC7 before GL 4.2
+    virtual bool supportsTextureFormat(TextureFormat format) const { return !isCompressedFormat(format); }
+    
     // Resource creation
     virtual std::shared_ptr<IRHIBuffer> createBuffer(const BufferDesc& desc) = 0;
     virtual std::shared_ptr<IRHIShader> createShader(const ShaderDesc& desc) = 0;
@@ -34,20 +49,68 @@ public:
     virtual std::shared_ptr<IRHIVertexArray> createVertexArray() = 0;
     // Create a uniform buffer object (size in bytes) and bind it to a binding index
     virtual std::shared_ptr<class IRHIUniformBuffer> createUniformBuffer(size_t size, uint32_t binding) = 0;
+    // Returns the existing pipeline for an equal desc while one is alive. Safe on any thread.
+    virtual std::shared_ptr<IRHIPipelineState> createPipelineState(const PipelineStateDesc& desc) = 0;
+    virtual std::shared_ptr<IRHIComputePipelineState> createComputePipelineState(const ComputePipelineDesc& desc) = 0;
+    
+    // Handles for the resources created above: add() a resource to get a 32-bit handle that
+    // draw packets and command lists can store, get() resolves it, remove() hands ownership back.
+    // Handles of removed resources resolve to null (and assert in debug builds).
+    virtual RHIResourcePools& getResourcePools() = 0;
+    
+    // Per-frame streaming memory for data rewritten every frame (dynamic vertices, per-draw
+    // uniforms). Writing it needs no driver copy and never waits for the GPU. alignment 0 means
+    // suitable for bindUniformBufferRange. Returns an invalid allocation when the backend has no
+    // streaming memory or this frame's share is used up; fall back to updating a buffer.
+    virtual TransientAllocation allocateTransient(size_t size, size_t alignment = 0) { return {}; }
+    // Binds size bytes of buffer at offset as the uniform block at binding
+    virtual void bindUniformBufferRange(uint32_t binding, IRHIBuffer* buffer, size_t offset, size_t size) = 0;
+    // Called once per frame after its last draw; recycles transient memory the GPU is done with,
+    // reports finished texture uploads and deletes released resources the GPU no longer uses.
+    // Backends deferring deletion to here let resources be dropped on any thread.
+    virtual void endFrame() {}
+    
+    // Copies tightly packed texels into staging memory and queues their upload to region of
+    // texture, without waiting for the GPU. The texture may be released right after the call.
+    // onComplete runs in a later endFrame() once the GPU has finished the copy. Returns false,
+    // without uploading, when the staging memory is full; retry next frame. Backends without
+    // staging memory upload synchronously.
+    virtual bool uploadTextureAsync(IRHITexture* texture, const TextureRegion& region, const void* data,
+                                    std::function<void()> onComplete = nullptr) {
+        texture->updateRegion(region, data);
+        if (onComplete) onComplete();
+        return true;
+    }
+    
+    // Command lists can be recorded on any thread; see RHICommandList.h
+    virtual std::unique_ptr<IRHICommandList> createCommandList() = 0;
+    // Replays the lists in order. Only on the thread that initialized the device; this is where
+    // the recorded work reaches the driver.
+    virtual void submitCommandLists(IRHICommandList* const* lists, uint32_t count) = 0;
     
     // Rendering state
     virtual void setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
     virtual void setScissor(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
     
-    virtual void setDepthTest(bool enabled) = 0;
-    virtual void setDepthWrite(bool enabled) = 0;
-    virtual void setDepthFunc(CompareFunc func) = 0;
+    // Binds the program and applies the fixed-function state, changing only what differs from
+    // the pipeline bound before. The device assumes nothing else changes that state.
+    virtual void setPipelineState(IRHIPipelineState* pipeline) = 0;
     
-    virtual void setBlend(bool enabled) = 0;
-    virtual void setBlendFunc(BlendFactor srcFactor, BlendFactor dstFactor) = 0;
-    virtual void setBlendOp(BlendOp op) = 0;
+    // Compute. Storage buffers and images bound here are visible to compute and graphics shaders
+    // alike. A size of 0 binds the buffer from offset to its end. Images bind one mip level (all
+    // layers of an array); compressed, depth and RGB8 textures cannot be bound as images.
+    // Shader writes reach other consumers only after a memoryBarrier naming them.
+    virtual void setComputePipelineState(IRHIComputePipelineState* pipeline) = 0;
+    virtual void bindStorageBuffer(uint32_t binding, IRHIBuffer* buffer, size_t offset = 0, size_t size = 0) = 0;
+    virtual void bindStorageImage(uint32_t binding, IRHITexture* texture, uint32_t mipLevel = 0,
+                                  ImageAccess access = ImageAccess::ReadWrite) = 0;
+    virtual void dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) = 0;
+    // Group counts from a DispatchIndirectCommand in buffer at offset, e.g. written by an earlier dispatch
+    virtual void dispatchIndirect(IRHIBuffer* buffer, size_t offset = 0) = 0;
+    virtual void memoryBarrier(BarrierFlags consumers) = 0;
     
-    virtual void setCullMode(CullMode mode) = 0;
+    // Framebuffers bind themselves; this goes back to the window's
+    virtual void bindDefaultFramebuffer() = 0;
     
     // Clearing
     virtual void clearColor(float r, float g, float b, float a) = 0;
@@ -56,7 +119,15 @@ public:
     
     // Drawing
     virtual void draw(PrimitiveTopology topology, uint32_t vertexCount, uint32_t startVertex = 0) = 0;
+    // Indices are read in the IndexFormat the bound vertex array's index buffer was set with
     virtual void drawIndexed(PrimitiveTopology topology, uint32_t indexCount, uint32_t startIndex = 0) = 0;
+    // Indexed draws whose arguments the GPU reads from DrawIndexedIndirectCommand records in
+    // buffer, starting at offset. The multi version issues drawCount records, stride bytes apart
+    // (0 = tightly packed), in a single call: objects sharing a vertex array and pipeline go out
+    // together however many there are.
+    virtual void drawIndexedIndirect(PrimitiveTopology topology, IRHIBuffer* buffer, size_t offset = 0) = 0;
+    virtual void multiDrawIndexedIndirect(PrimitiveTopology topology, IRHIBuffer* buffer, size_t offset,
+                                          uint32_t drawCount, uint32_t stride = 0) = 0;
 };
 
 // Factory function to create RHI device based on API type
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "RHITypes.h"
+#include "RHIResources.h"
+#include "RHIHandle.h"
+
+namespace CarrotToy {
+namespace RHI {
+
+class IRHIDevice;
+
+// Recorded rendering work, replayed later by IRHIDevice::submitCommandLists.
+//
+// Recording does not touch the graphics context or any device state, so each thread can record
+// its own list at the same time as the others (one thread per list at a time). Resources are
+// referenced, not owned: everything a list uses has to stay alive until its submission returned.
+// Data passed to the update commands is copied into the list, so the caller's memory can be
+// reused right away. Uniform setters apply to the program of the last bindShaderProgram() or
+// setPipelineState().
+class IRHICommandList {
+public:
+    virtual ~IRHICommandList() = default;
+    
+    // Drops all recorded commands so the list can be recorded again
+    virtual void reset() = 0;
+    virtual bool isEmpty() const = 0;
+    
+    // Rendering state
+    virtual void setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
+    virtual void setScissor(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
+    // Also binds the pipeline's program for the uniform setters below
+    virtual void setPipelineState(IRHIPipelineState* pipeline) = 0;
+    
+    // Clearing
+    virtual void clearColor(float r, float g, float b, float a) = 0;
+    virtual void clearDepth(float depth) = 0;
+    virtual void clear(bool color, bool depth, bool stencil) = 0;
+    
+    // Resource binding; a null framebuffer goes back to the default one
+    virtual void bindFramebuffer(IRHIFramebuffer* framebuffer) = 0;
+    virtual void bindShaderProgram(IRHIShaderProgram* program) = 0;
+    virtual void bindVertexArray(IRHIVertexArray* vertexArray) = 0;
+    virtual void bindTexture(IRHITexture* texture, uint32_t slot) = 0;
+    virtual void bindUniformBuffer(IRHIUniformBuffer* buffer) = 0;
+    virtual void bindUniformBufferRange(uint32_t binding, IRHIBuffer* buffer, size_t offset, size_t size) = 0;
+    
+    // Same as above for resources registered in the device's RHIResourcePools. The handles are
+    // resolved when the list executes; one whose resource was removed by then skips its command.
+    // An invalid framebuffer handle goes back to the default framebuffer.
+    virtual void setPipelineState(PipelineStateHandle pipeline) = 0;
+    virtual void bindFramebuffer(FramebufferHandle framebuffer) = 0;
+    virtual void bindVertexArray(VertexArrayHandle vertexArray) = 0;
+    virtual void bindTexture(TextureHandle texture, uint32_t slot) = 0;
+    virtual void bindUniformBuffer(UniformBufferHandle buffer) = 0;
+    
+    // Uniforms of the bound program
+    virtual void setUniformFloat(const FName& name, float value) = 0;
+    virtual void setUniformVec4(const FName& name, float x, float y, float z, float w) = 0;
+    virtual void setUniformInt(const FName& name, int value) = 0;
+    virtual void setUniformMatrix4(const FName& name, const float* value) = 0;
+    
+    // Resource updates, executed in order with the draws around them
+    virtual void updateBuffer(IRHIBuffer* buffer, const void* data, size_t size, size_t offset = 0) = 0;
+    virtual void updateUniformBuffer(IRHIUniformBuffer* buffer, const void* data, size_t size, size_t offset = 0) = 0;
+    virtual void updateTexture(IRHITexture* texture, const TextureRegion& region, const void* data) = 0;
+    
+    // Drawing
+    virtual void draw(PrimitiveTopology topology, uint32_t vertexCount, uint32_t startVertex = 0) = 0;
+    virtual void drawIndexed(PrimitiveTopology topology, uint32_t indexCount, uint32_t startIndex = 0) = 0;
+    // The arguments are read from buffer when the GPU executes the draw, not when recording
+    virtual void drawIndexedIndirect(PrimitiveTopology topology, IRHIBuffer* buffer, size_t offset = 0) = 0;
+    virtual void multiDrawIndexedIndirect(PrimitiveTopology topology, IRHIBuffer* buffer, size_t offset,
+                                          uint32_t drawCount, uint32_t stride = 0) = 0;
+    
+    // Compute; see the IRHIDevice methods of the same names. Uniform setters after
+    // setComputePipelineState() apply to its program.
+    virtual void setComputePipelineState(IRHIComputePipelineState* pipeline) = 0;
+    virtual void bindStorageBuffer(uint32_t binding, IRHIBuffer* buffer, size_t offset = 0, size_t size = 0) = 0;
+    virtual void bindStorageImage(uint32_t binding, IRHITexture* texture, uint32_t mipLevel = 0,
+                                  ImageAccess access = ImageAccess::ReadWrite) = 0;
+    virtual void dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) = 0;
+    virtual void dispatchIndirect(IRHIBuffer* buffer, size_t offset = 0) = 0;
+    virtual void memoryBarrier(BarrierFlags consumers) = 0;
+    
+    // Replays the commands against device; only IRHIDevice::submitCommandLists calls this
+    virtual void execute(IRHIDevice& device) = 0;
+};
+
+} // namespace RHI
+} // namespace CarrotToy
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "RHIResources.h"
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace CarrotToy {
+namespace RHI {
+
+// 32-bit reference to a resource registered in the device's RHIResourcePools: the low bits index
+// a pool slot, the high bits hold the slot's generation. A slot's generation changes whenever its
+// resource is removed, so a handle kept past that no longer resolves instead of reaching whatever
+// took the slot over. Handles are plain integers: draw packets and command lists can store and
+// copy them without touching reference counts. 0 is never a valid handle.
+template <typename T>
+struct RHIHandle {
+    static constexpr uint32_t kIndexBits = 20;
+    static constexpr uint32_t kGenerationBits = 32 - kIndexBits;
+    static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+    static constexpr uint32_t kGenerationMask = (1u << kGenerationBits) - 1;
+
+    uint32_t value = 0;
+
+    static RHIHandle make(uint32_t index, uint32_t generation) {
+        return RHIHandle{ (generation << kIndexBits) | (index & kIndexMask) };
+    }
+
+    uint32_t getIndex() const { return value & kIndexMask; }
+    uint32_t getGeneration() const { return value >> kIndexBits; }
+    bool isValid() const { return value != 0; }
+
+    bool operator==(const RHIHandle& other) const { return value == other.value; }
+    bool operator!=(const RHIHandle& other) const { return value != other.value; }
+};
+
+using BufferHandle = RHIHandle<IRHIBuffer>;
+using UniformBufferHandle = RHIHandle<IRHIUniformBuffer>;
+using ShaderProgramHandle = RHIHandle<IRHIShaderProgram>;
+using TextureHandle = RHIHandle<IRHITexture>;
+using PipelineStateHandle = RHIHandle<IRHIPipelineState>;
+using FramebufferHandle = RHIHandle<IRHIFramebuffer>;
+using VertexArrayHandle = RHIHandle<IRHIVertexArray>;
+
+// Logs a handle whose slot was reused or emptied since it was handed out
+RHI_API void reportStaleHandle(const char* poolName, uint32_t value);
+RHI_API void reportPoolFull(const char* poolName);
+
+// Slots of one resource type. Slots live in fixed-size chunks that never move, and a removed
+// slot is reused by the next add(), so the table stays dense however often resources come and
+// go. add() and remove() lock; get() does not and is safe on any thread, next to both.
+template <typename T>
+class RHIResourcePool {
+public:
+    static constexpr uint32_t kSlotsPerChunk = 1024;
+    static constexpr uint32_t kMaxChunks = (RHIHandle<T>::kIndexMask + 1) / kSlotsPerChunk;
+
+    explicit RHIResourcePool(const char* inName) : name(inName) {}
+    RHIResourcePool(const RHIResourcePool&) = delete;
+    RHIResourcePool& operator=(const RHIResourcePool&) = delete;
+    ~RHIResourcePool() {
+        for (auto& chunk : chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Returns an invalid handle for a null resource or when all slots are taken
+    RHIHandle<T> add(std::shared_ptr<T> resource) {
+        if (!resource) return {};
+        std::lock_guard<std::mutex> lock(mutex);
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            // Slot 0 stays unused so that no handle is 0
+            index = slotCount == 0 ? 1 : slotCount;
+            const uint32_t chunkIndex = index / kSlotsPerChunk;
+            if (chunkIndex >= kMaxChunks) {
+                reportPoolFull(name);
+                return {};
+            }
+            if (!chunks[chunkIndex].load(std::memory_order_relaxed)) {
+                chunks[chunkIndex].store(new Slot[kSlotsPerChunk], std::memory_order_release);
+            }
+            slotCount = index + 1;
+        }
+        Slot& slot = *findSlot(index);
+        slot.resource.store(resource.get(), std::memory_order_relaxed);
+        slot.owner = std::move(resource);
+        ++liveCount;
+        return RHIHandle<T>::make(index, slot.generation.load(std::memory_order_relaxed));
+    }
+
+    // For handles the caller owns, where a stale one is a bug: null for an invalid handle and for
+    // a stale one, which debug builds also report and assert on
+    T* get(RHIHandle<T> handle) const {
+        if (!handle.isValid()) return nullptr;
+        T* resource = nullptr;
+        if (resolve(handle, resource)) return resource;
+#ifndef NDEBUG
+        reportStaleHandle(name, handle.value);
+        assert(!"Use of a removed RHI resource handle");
+#endif
+        return nullptr;
+    }
+
+    // For callers that tolerate stale handles, e.g. command list replay, which skips their
+    // commands: null for an invalid or stale handle. The first stale handle is reported, in every
+    // build, and never asserts.
+    T* tryGet(RHIHandle<T> handle) const {
+        if (!handle.isValid()) return nullptr;
+        T* resource = nullptr;
+        if (resolve(handle, resource)) return resource;
+        if (!staleReported.exchange(true, std::memory_order_relaxed)) {
+            reportStaleHandle(name, handle.value);
+        }
+        return nullptr;
+    }
+
+    // Empties the slot and hands back ownership, so the caller decides when the resource dies.
+    // Every handle to the slot goes stale. Removing a stale handle returns null.
+    std::shared_ptr<T> remove(RHIHandle<T> handle) {
+        if (!handle.isValid()) return nullptr;
+        std::lock_guard<std::mutex> lock(mutex);
+        Slot* slot = findSlot(handle.getIndex());
+        if (!slot || slot->generation.load(std::memory_order_relaxed) != handle.getGeneration()) {
+            return nullptr;
+        }
+        slot->generation.store(nextGeneration(handle.getGeneration()), std::memory_order_release);
+        slot->resource.store(nullptr, std::memory_order_relaxed);
+        freeSlots.push_back(handle.getIndex());
+        --liveCount;
+        return std::move(slot->owner);
+    }
+
+    uint32_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return liveCount;
+    }
+
+    // Removes every resource; all handles go stale
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (uint32_t index = 1; index < slotCount; ++index) {
+            Slot& slot = *findSlot(index);
+            if (!slot.owner) continue;
+            slot.generation.store(nextGeneration(slot.generation.load(std::memory_order_relaxed)), std::memory_order_release);
+            slot.resource.store(nullptr, std::memory_order_relaxed);
+            slot.owner.reset();
+            freeSlots.push_back(index);
+        }
+        liveCount = 0;
+    }
+
+private:
+    struct Slot {
+        std::atomic<T*> resource{ nullptr };
+        std::atomic<uint32_t> generation{ 0 };
+        std::shared_ptr<T> owner;
+    };
+
+    // Wraps around; a handle only collides with one removed 4096 reuses of its slot earlier
+    static uint32_t nextGeneration(uint32_t generation) {
+        return (generation + 1) & RHIHandle<T>::kGenerationMask;
+    }
+
+    // False for a stale handle
+    bool resolve(RHIHandle<T> handle, T*& outResource) const {
+        const Slot* slot = findSlot(handle.getIndex());
+        if (!slot || slot->generation.load(std::memory_order_acquire) != handle.getGeneration()) {
+            return false;
+        }
+        outResource = slot->resource.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    Slot* findSlot(uint32_t index) const {
+        const uint32_t chunkIndex = index / kSlotsPerChunk;
+        if (chunkIndex >= kMaxChunks) return nullptr;
+        Slot* chunk = chunks[chunkIndex].load(std::memory_order_acquire);
+        return chunk ? chunk + index % kSlotsPerChunk : nullptr;
+    }
+
+    const char* name;
+    mutable std::mutex mutex;
+    std::atomic<Slot*> chunks[kMaxChunks] = {};
+    std::vector<uint32_t> freeSlots;
+    uint32_t slotCount = 0;
+    uint32_t liveCount = 0;
+    mutable std::atomic<bool> staleReported{ false };
+};
+
+// One pool per resource type; owned by the device (IRHIDevice::getResourcePools)
+class RHIResourcePools {
+public:
+    template <typename T>
+    RHIHandle<T> add(std::shared_ptr<T> resource) { return pool<T>().add(std::move(resource)); }
+    template <typename T>
+    T* get(RHIHandle<T> handle) const { return const_cast<RHIResourcePools*>(this)->pool<T>().get(handle); }
+    template <typename T>
+    T* tryGet(RHIHandle<T> handle) const { return const_cast<RHIResourcePools*>(this)->pool<T>().tryGet(handle); }
+    template <typename T>
+    std::shared_ptr<T> remove(RHIHandle<T> handle) { return pool<T>().remove(handle); }
+
+    void clear() {
+        pipelineStates.clear();
+        framebuffers.clear();
+        vertexArrays.clear();
+        textures.clear();
+        shaderPrograms.clear();
+        uniformBuffers.clear();
+        buffers.clear();
+    }
+
+    template <typename T>
+    RHIResourcePool<T>& pool();
+
+private:
+    RHIResourcePool<IRHIBuffer> buffers{ "Buffer" };
+    RHIResourcePool<IRHIUniformBuffer> uniformBuffers{ "UniformBuffer" };
+    RHIResourcePool<IRHIShaderProgram> shaderPrograms{ "ShaderProgram" };
+    RHIResourcePool<IRHITexture> textures{ "Texture" };
+    RHIResourcePool<IRHIPipelineState> pipelineStates{ "PipelineState" };
+    RHIResourcePool<IRHIFramebuffer> framebuffers{ "Framebuffer" };
+    RHIResourcePool<IRHIVertexArray> vertexArrays{ "VertexArray" };
+};
+
+template <> inline RHIResourcePool<IRHIBuffer>& RHIResourcePools::pool<IRHIBuffer>() { return buffers; }
+template <> inline RHIResourcePool<IRHIUniformBuffer>& RHIResourcePools::pool<IRHIUniformBuffer>() { return uniformBuffers; }
+template <> inline RHIResourcePool<IRHIShaderProgram>& RHIResourcePools::pool<IRHIShaderProgram>() { return shaderPrograms; }
+template <> inline RHIResourcePool<IRHITexture>& RHIResourcePools::pool<IRHITexture>() { return textures; }
+template <> inline RHIResourcePool<IRHIPipelineState>& RHIResourcePools::pool<IRHIPipelineState>() { return pipelineStates; }
+template <> inline RHIResourcePool<IRHIFramebuffer>& RHIResourcePools::pool<IRHIFramebuffer>() { return framebuffers; }
+template <> inline RHIResourcePool<IRHIVertexArray>& RHIResourcePools::pool<IRHIVertexArray>() { return vertexArrays; }
+
+} // namespace RHI
+} // namespace CarrotToy
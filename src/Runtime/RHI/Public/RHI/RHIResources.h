@@ -1,6 +1,7 @@
 #pragma once
 
 #include "RHITypes.h"
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -41,6 +42,7 @@ public:
 
     // Bind the buffer to the given binding point (makes sure binding point is occupied)
     virtual void bind(uint32_t binding) = 0;
+    virtual uint32_t getBinding() const = 0;
 
     virtual size_t getSize() const = 0;
     // Optional native handle accessor (returns 0 if not available)
@@ -56,6 +58,10 @@ public:
     virtual bool compile() = 0;
     virtual std::string getCompileErrors() const = 0;
     
+    // Submit the compile without waiting for its status. Errors are reported when a program
+    // using this shader is linked. Backends without asynchronous compilation compile here.
+    virtual bool compileAsync() { return compile(); }
+    
     virtual ShaderType getType() const = 0;
 };
 
@@ -69,18 +75,24 @@ public:
     virtual void detachShader(IRHIShader* shader) = 0;
     
     // Program operations
+    // link() is synchronous. If an asynchronous link is pending it waits for it and returns its result.
     virtual bool link() = 0;
+    // Submit the link and return immediately; returns false only if submission failed.
+    // Attached shaders must stay alive until the link has been completed with link().
+    virtual bool linkAsync() { return link(); }
+    // Non-blocking: true once no link is in flight, i.e. link() will not stall.
+    virtual bool isReady() const { return true; }
     virtual void bind() = 0;
     virtual void unbind() = 0;
     
     // Uniform setters
-    virtual void setUniformFloat(const std::string& name, float value) = 0;
-    virtual void setUniformVec2(const std::string& name, float x, float y) = 0;
-    virtual void setUniformVec3(const std::string& name, float x, float y, float z) = 0;
-    virtual void setUniformVec4(const std::string& name, float x, float y, float z, float w) = 0;
-    virtual void setUniformInt(const std::string& name, int value) = 0;
-    virtual void setUniformBool(const std::string& name, bool value) = 0;
-    virtual void setUniformMatrix4(const std::string& name, const float* value) = 0;
+    virtual void setUniformFloat(const FName& name, float value) = 0;
+    virtual void setUniformVec2(const FName& name, float x, float y) = 0;
+    virtual void setUniformVec3(const FName& name, float x, float y, float z) = 0;
+    virtual void setUniformVec4(const FName& name, float x, float y, float z, float w) = 0;
+    virtual void setUniformInt(const FName& name, int value) = 0;
+    virtual void setUniformBool(const FName& name, bool value) = 0;
+    virtual void setUniformMatrix4(const FName& name, const float* value) = 0;
     
     virtual std::string getLinkErrors() const = 0;
     
@@ -98,13 +110,71 @@ public:
     virtual ~IRHITexture() = default;
     
     // Texture operations
+    // Replaces level 0 of layer 0; a different size reallocates the texture
     virtual void updateData(const void* data, uint32_t width, uint32_t height) = 0;
+    // Replaces a rectangle of one mip level of one layer with tightly packed texels. Writing level
+    // 0 regenerates generated mipmaps. For compressed formats the rectangle is block aligned (or
+    // ends at the edge of the level).
+    virtual void updateRegion(const TextureRegion& region, const void* data) = 0;
     virtual void bind(uint32_t slot = 0) = 0;
     virtual void unbind() = 0;
     
     virtual uint32_t getWidth() const = 0;
     virtual uint32_t getHeight() const = 0;
     virtual TextureFormat getFormat() const = 0;
+    virtual TextureType getType() const = 0;
+    virtual uint32_t getMipLevels() const = 0;
+    virtual uint32_t getArrayLayers() const = 0;
+    
+    // Optional native handle accessor (returns 0 if not available)
+    virtual uintptr_t getNativeHandle() const { return 0; }
+    // 64-bit handle shaders sample the texture through without binding it to a slot (see
+    // IRHIDevice::supportsBindlessTextures); 0 when the backend has none. Created and made
+    // resident on the first call, on the device's thread, and valid until the texture is released
+    // or reallocated by updateData. The sampling state is fixed from then on.
+    virtual uint64_t getBindlessHandle() { return 0; }
+};
+
+// Everything a draw needs besides its resources: program, vertex input and fixed-function state
+struct RHI_API PipelineStateDesc {
+    std::shared_ptr<IRHIShaderProgram> program;
+    // Vertex input the program reads. OpenGL keeps the vertex format in the vertex array, so it
+    // only tells pipelines apart there; backends with explicit pipelines build their input state
+    // from it.
+    std::vector<VertexAttribute> vertexLayout;
+    RasterState raster;
+    DepthState depth;
+    BlendState blend;
+    
+    // Stable over the lifetime of the program; equal descs hash equally
+    uint64_t hash() const;
+    bool operator==(const PipelineStateDesc& other) const;
+    bool operator!=(const PipelineStateDesc& other) const { return !(*this == other); }
+};
+
+// Immutable pipeline state, created (and deduplicated) by IRHIDevice::createPipelineState and
+// bound with IRHIDevice::setPipelineState
+class IRHIPipelineState : public IRHIResource {
+public:
+    virtual ~IRHIPipelineState() = default;
+    
+    virtual const PipelineStateDesc& getDesc() const = 0;
+    virtual uint64_t getHash() const = 0;
+};
+
+// A compute shader program; GL links compute programs like any other
+struct ComputePipelineDesc {
+    std::shared_ptr<IRHIShaderProgram> program;
+};
+
+// Created by IRHIDevice::createComputePipelineState and bound with setComputePipelineState
+class IRHIComputePipelineState : public IRHIResource {
+public:
+    virtual ~IRHIComputePipelineState() = default;
+    
+    virtual const ComputePipelineDesc& getDesc() const = 0;
+    // The program's local_size; dispatch counts are in groups of this many invocations
+    virtual void getWorkGroupSize(uint32_t& x, uint32_t& y, uint32_t& z) const = 0;
 };
 
 // Framebuffer interface
@@ -115,6 +185,8 @@ public:
     // Framebuffer operations
     virtual void bind() = 0;
     virtual void unbind() = 0;
+    // Attached textures are not owned; they have to outlive the framebuffer or be detached.
+    // A Depth24Stencil8 texture is attached as depth and stencil.
     virtual void attachColorTexture(IRHITexture* texture, uint32_t attachment = 0) = 0;
     virtual void attachDepthTexture(IRHITexture* texture) = 0;
     virtual bool isComplete() = 0;
@@ -131,8 +203,11 @@ public:
     // Vertex array operations
     virtual void bind() = 0;
     virtual void unbind() = 0;
-    virtual void setVertexBuffer(IRHIBuffer* buffer, uint32_t binding = 0) = 0;
-    virtual void setIndexBuffer(IRHIBuffer* buffer) = 0;
+    // offset: byte offset of the first vertex in buffer, e.g. a TransientAllocation's offset.
+    // Set it before the attributes that read the binding.
+    virtual void setVertexBuffer(IRHIBuffer* buffer, uint32_t binding = 0, size_t offset = 0) = 0;
+    // drawIndexed and the indirect draws read indices of format while this vertex array is bound
+    virtual void setIndexBuffer(IRHIBuffer* buffer, IndexFormat format = IndexFormat::UInt32) = 0;
     virtual void setVertexAttribute(const VertexAttribute& attribute) = 0;
 };
 
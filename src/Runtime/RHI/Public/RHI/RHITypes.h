@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <string>
+#include "CoreUtils.h"
 
 // RHI API export/import macro
 #ifndef RHI_API
@@ -32,14 +33,16 @@ class IRHIFramebuffer;
 enum class BufferType {
     Vertex,
     Index,
-    Uniform
+    Uniform,
+    Indirect,   // DrawIndexedIndirectCommand / DispatchIndirectCommand records for the indirect calls
+    Storage     // Shader storage buffer, read and written by shaders (see IRHIDevice::bindStorageBuffer)
 };
 
 // Buffer usage hints
 enum class BufferUsage {
     Static,    // Data rarely changes
     Dynamic,   // Data changes occasionally
-    Stream     // Data changes every frame
+    Stream     // Data changes every frame (persistently mapped where supported)
 };
 
 // Shader types
@@ -57,7 +60,23 @@ enum class TextureFormat {
     RGBA16F,
     RGBA32F,
     Depth24Stencil8,
-    Depth32F
+    Depth32F,
+    // Block-compressed, 4x4 texels per block (see FTextureCompression for a CPU encoder)
+    BC1,    // RGB, 8 bytes per block
+    BC3,    // RGBA, 16 bytes per block
+    BC5,    // RG, 16 bytes per block
+    BC7     // RGBA, 16 bytes per block
+};
+
+inline bool isCompressedFormat(TextureFormat format) {
+    return format == TextureFormat::BC1 || format == TextureFormat::BC3 ||
+           format == TextureFormat::BC5 || format == TextureFormat::BC7;
+}
+
+// Texture dimensionality
+enum class TextureType {
+    Texture2D,
+    Texture2DArray  // arrayLayers images of the same size and format, bound to one slot
 };
 
 // Texture filtering
@@ -126,6 +145,25 @@ enum class CullMode {
     Back
 };
 
+// Fixed-function state of a pipeline (see PipelineStateDesc)
+struct RasterState {
+    CullMode cullMode = CullMode::Back;
+    bool scissorTest = false;
+};
+
+struct DepthState {
+    bool testEnable = true;
+    bool writeEnable = true;
+    CompareFunc compareFunc = CompareFunc::Less;
+};
+
+struct BlendState {
+    bool enable = false;
+    BlendFactor srcFactor = BlendFactor::SrcAlpha;
+    BlendFactor dstFactor = BlendFactor::OneMinusSrcAlpha;
+    BlendOp op = BlendOp::Add;
+};
+
 // Graphics API types
 enum class GraphicsAPI {
     OpenGL,
@@ -135,16 +173,53 @@ enum class GraphicsAPI {
     Metal
 };
 
+// Storage of a vertex attribute in its buffer. Shaders read every format as floats; the packed
+// ones cut the bytes fetched per vertex.
+enum class VertexFormat : uint8_t {
+    Float,              // 32-bit floats
+    Half,               // 16-bit floats, e.g. positions of small meshes
+    Snorm16,            // 16-bit signed normalized to [-1, 1]; 2 components = RG16_SNORM, e.g. octahedral normals
+    Unorm8,             // 8-bit unsigned normalized to [0, 1], e.g. colors
+    Snorm10_10_10_2     // x, y, z in 10 bits and w in 2 bits, signed normalized; always 4 components
+};
+
+// Bytes of one attribute of componentCount components
+inline uint32_t getVertexFormatSize(VertexFormat format, uint32_t componentCount) {
+    switch (format) {
+        case VertexFormat::Half:            return componentCount * 2;
+        case VertexFormat::Snorm16:         return componentCount * 2;
+        case VertexFormat::Unorm8:          return componentCount;
+        case VertexFormat::Snorm10_10_10_2: return 4;
+        default:                            return componentCount * 4;
+    }
+}
+
 // Vertex attribute data
 struct VertexAttribute {
     uint32_t location;
     uint32_t binding;
     uint32_t offset;
-    uint32_t componentCount;  // 1, 2, 3, or 4
+    uint32_t componentCount;  // 1, 2, 3, or 4 (4 for Snorm10_10_10_2)
     uint32_t stride;          // Byte offset between consecutive vertices (0 = automatically calculated by OpenGL)
-    bool normalized;
+    bool normalized;          // Float and Half ignore it; the normalized formats always are
+    VertexFormat format = VertexFormat::Float;
+};
+
+// Width of the indices in an index buffer
+enum class IndexFormat : uint8_t {
+    UInt16,
+    UInt32
 };
 
+inline uint32_t getIndexSize(IndexFormat format) {
+    return format == IndexFormat::UInt16 ? 2 : 4;
+}
+
+// Narrowest format able to address vertexCount vertices
+inline IndexFormat getIndexFormatForVertexCount(size_t vertexCount) {
+    return vertexCount <= 0x10000 ? IndexFormat::UInt16 : IndexFormat::UInt32;
+}
+
 // Buffer descriptor
 struct BufferDesc {
     BufferType type;
@@ -159,30 +234,159 @@ struct BufferDesc {
         , initialData(nullptr) {}
 };
 
+// Arguments of one indirect indexed draw, in the layout the GPU reads from the buffer. Records
+// can be written by the CPU or by a compute pass.
+struct DrawIndexedIndirectCommand {
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    // Must be 0 below GL 4.2 (ARB_base_instance), where the draw is undefined otherwise
+    uint32_t baseInstance;
+};
+
+// Work group counts of one indirect dispatch, in the layout the GPU reads from the buffer
+struct DispatchIndirectCommand {
+    uint32_t groupCountX;
+    uint32_t groupCountY;
+    uint32_t groupCountZ;
+};
+
+// How a shader accesses a storage image
+enum class ImageAccess {
+    ReadOnly,
+    WriteOnly,
+    ReadWrite
+};
+
+// Consumers of memory written by shaders (storage buffers and images). IRHIDevice::memoryBarrier
+// makes the writes of earlier dispatches and draws visible to the consumers named.
+enum class BarrierFlags : uint32_t {
+    None = 0,
+    VertexBuffer = 1 << 0,
+    IndexBuffer = 1 << 1,
+    UniformBuffer = 1 << 2,
+    IndirectBuffer = 1 << 3,    // Draw and dispatch arguments
+    StorageBuffer = 1 << 4,
+    TextureSample = 1 << 5,
+    StorageImage = 1 << 6,
+    BufferUpdate = 1 << 7,      // CPU access: updateData, map
+    TextureUpdate = 1 << 8,     // CPU access: updateRegion, uploads
+    Framebuffer = 1 << 9,
+    All = 0xFFFFFFFFu
+};
+
+inline BarrierFlags operator|(BarrierFlags a, BarrierFlags b) {
+    return static_cast<BarrierFlags>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+inline bool hasAnyFlag(BarrierFlags flags, BarrierFlags test) {
+    return (static_cast<uint32_t>(flags) & static_cast<uint32_t>(test)) != 0;
+}
+
+// Per-frame memory returned by IRHIDevice::allocateTransient. data stays writable until the
+// device's endFrame(); the GPU may read it for the rest of that frame.
+struct TransientAllocation {
+    IRHIBuffer* buffer = nullptr;  // Buffer the memory lives in, for binding
+    void* data = nullptr;          // Write-only CPU pointer
+    size_t offset = 0;             // Byte offset of data in buffer
+    size_t size = 0;
+    
+    bool isValid() const { return data != nullptr; }
+};
+
+// Texel data of one mip level of one array layer; compressed formats hold whole blocks
+struct TextureMipData {
+    const void* data = nullptr;
+    size_t size = 0;
+};
+
 // Texture descriptor
 struct TextureDesc {
+    TextureType type;
     uint32_t width;
     uint32_t height;
+    // Levels allocated. 0 picks a full chain with generateMipmaps, otherwise the levels in
+    // mipData (or 1). Storage is immutable where the driver supports it, so this cannot grow later.
+    uint32_t mipLevels;
+    uint32_t arrayLayers;    // Texture2DArray only
     TextureFormat format;
     TextureFilter minFilter;
     TextureFilter magFilter;
     TextureWrap wrapS;
     TextureWrap wrapT;
-    bool generateMipmaps;
-    const void* initialData;
+    bool generateMipmaps;    // uncompressed formats only, from level 0 of each layer
+    const void* initialData; // mip level 0 of layer 0
+    // Optional initial data, layer by layer with level 0 first in each; replaces initialData.
+    // Entries past mipDataCount are left undefined. Compressed formats cannot generate mipmaps,
+    // so their levels come from here (or from IRHITexture::updateRegion).
+    const TextureMipData* mipData;
+    uint32_t mipDataCount;
     
     TextureDesc()
-        : width(0)
+        : type(TextureType::Texture2D)
+        , width(0)
         , height(0)
+        , mipLevels(0)
+        , arrayLayers(1)
         , format(TextureFormat::RGBA8)
         , minFilter(TextureFilter::Linear)
         , magFilter(TextureFilter::Linear)
         , wrapS(TextureWrap::Repeat)
         , wrapT(TextureWrap::Repeat)
         , generateMipmaps(false)
-        , initialData(nullptr) {}
+        , initialData(nullptr)
+        , mipData(nullptr)
+        , mipDataCount(0) {}
 };
 
+// Rectangle of texels in one mip level of one array layer; x, y, width and height are in texels
+// of that level
+struct TextureRegion {
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevel = 0;
+    uint32_t arrayLayer = 0;
+};
+
+// Width or height of a mip level
+inline uint32_t getMipSize(uint32_t size, uint32_t mipLevel) {
+    const uint32_t mipSize = mipLevel < 32 ? size >> mipLevel : 0;
+    return mipSize > 0 ? mipSize : 1;
+}
+
+// Levels of a full mip chain, down to 1x1
+inline uint32_t getFullMipCount(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    for (uint32_t size = width > height ? width : height; size > 1; size >>= 1) {
+        ++levels;
+    }
+    return levels;
+}
+
+// Bytes of tightly packed texel data for width x height texels of format. Compressed formats
+// count whole 4x4 blocks.
+inline size_t getTextureDataSize(TextureFormat format, uint32_t width, uint32_t height) {
+    if (isCompressedFormat(format)) {
+        const size_t blockBytes = format == TextureFormat::BC1 ? 8 : 16;
+        return blockBytes * ((width + 3) / 4) * ((height + 3) / 4);
+    }
+
+    size_t bytesPerTexel = 4;
+    switch (format) {
+        case TextureFormat::RGB8:            bytesPerTexel = 3; break;
+        case TextureFormat::RGBA8:           bytesPerTexel = 4; break;
+        case TextureFormat::RGBA16F:         bytesPerTexel = 8; break;
+        case TextureFormat::RGBA32F:         bytesPerTexel = 16; break;
+        case TextureFormat::Depth24Stencil8: bytesPerTexel = 4; break;
+        case TextureFormat::Depth32F:        bytesPerTexel = 4; break;
+        default: break;
+    }
+    return bytesPerTexel * width * height;
+}
+
 // Shader source format
 enum class ShaderSourceFormat {
     GLSL,       // GLSL source code
@@ -190,6 +394,12 @@ enum class ShaderSourceFormat {
     HLSL        // HLSL source code (for future support)
 };
 
+// Value of a SPIR-V specialization constant ([[vk::constant_id(N)]] in HLSL)
+struct ShaderSpecializationConstant {
+    uint32_t constantID;
+    uint32_t value;  // bool: 0 or 1; int/uint/float: the 32-bit pattern
+};
+
 // Shader descriptor
 struct ShaderDesc {
     ShaderType type;
@@ -197,13 +407,19 @@ struct ShaderDesc {
     size_t sourceSize;
     ShaderSourceFormat format;
     const char* entryPoint;  // Entry point for SPIR-V/HLSL (e.g., "VSMain", "PSMain")
+    // SPIR-V only: applied when the stage is specialized. Constants the module does not declare
+    // are skipped, so one list can be passed to every stage of a program.
+    const ShaderSpecializationConstant* specializationConstants;
+    uint32_t numSpecializationConstants;
     
     ShaderDesc()
         : type(ShaderType::Vertex)
         , source(nullptr)
         , sourceSize(0)
         , format(ShaderSourceFormat::GLSL)
-        , entryPoint(nullptr) {}
+        , entryPoint(nullptr)
+        , specializationConstants(nullptr)
+        , numSpecializationConstants(0) {}
 };
 
 // Framebuffer descriptor
@@ -211,23 +427,28 @@ struct FramebufferDesc {
     uint32_t width;
     uint32_t height;
     bool hasDepthStencil;
+    // False creates the framebuffer without textures of its own, for attaching existing ones
+    // (e.g. from a render target pool); width, height and hasDepthStencil are ignored then
+    bool createAttachments;
     
     FramebufferDesc()
         : width(0)
         , height(0)
-        , hasDepthStencil(true) {}
+        , hasDepthStencil(true)
+        , createAttachments(true) {}
 };
 
 // Shader reflection data structures
+// Names are interned FNames so per-frame lookups compare indices instead of strings.
 struct UniformBlockInfo {
-    std::string name;
+    FName name;
     uint32_t binding;
     uint32_t size;
     uint32_t blockIndex;
 };
 
 struct UniformVariableInfo {
-    std::string name;
+    FName name;
     uint32_t blockIndex;
     int32_t offset;
     uint32_t size;
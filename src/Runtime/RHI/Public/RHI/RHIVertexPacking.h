@@ -0,0 +1,32 @@
+#pragma once
+
+#include "RHITypes.h"
+#include <vector>
+
+namespace CarrotToy {
+namespace RHI {
+
+// CPU side of the packed VertexFormats: converts mesh data before it is uploaded
+
+// IEEE half, rounded to nearest even; out of range values become infinity. VertexFormat::Half.
+RHI_API uint16_t packHalf(float value);
+
+// Unit vector as two signed normalized 16-bit values (VertexFormat::Snorm16, 2 components) on an
+// octahedron unfolded onto a square; the direction is off by at most about 0.04 degrees. The
+// shader decodes with
+//     n = float3(e.x, e.y, 1 - abs(e.x) - abs(e.y));
+//     if (n.z < 0) n.xy = (1 - abs(n.yx)) * select(n.xy >= 0, 1, -1);
+//     n = normalize(n);
+RHI_API void packOctahedralNormal(float x, float y, float z, int16_t out[2]);
+
+// x, y, z and w in [-1, 1] for VertexFormat::Snorm10_10_10_2; w keeps only -1, 0 or 1, e.g. the
+// handedness of a tangent frame
+RHI_API uint32_t packSnorm10_10_10_2(float x, float y, float z, float w = 0.0f);
+
+// Index data for a mesh of vertexCount vertices, in the narrowest format that addresses them all
+// (see getIndexFormatForVertexCount). Returns the format to pass to setIndexBuffer.
+RHI_API IndexFormat packIndices(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                std::vector<uint8_t>& outData);
+
+} // namespace RHI
+} // namespace CarrotToy
@@ -1,7 +1,9 @@
 #include "Material.h"
+#include "TextureLoader.h"
 #include <glad/glad.h>
 #include <fstream>
 #include <sstream>
+#include <cstring>
 #include <iostream>
 #include "CoreUtils.h"
 
@@ -9,8 +11,20 @@ namespace CarrotToy {
 
 
 // Material implementation
-Material::Material(const std::string& name, std::shared_ptr<Shader> shader)
-    : name(name), shader(shader) {
+Material::Material(const FName& name, std::shared_ptr<Shader> shader)
+    : name(name), baseShader(shader), shader(shader) {
+}
+
+void Material::setKeyword(const FName& keyword, uint32_t value) {
+    if (!baseShader) return;
+    const ShaderKeywordMask mask = baseShader->getKeywordLayout().setValue(getKeywordMask(), keyword, value);
+    if (mask != getKeywordMask()) {
+        shader = baseShader->getVariant(mask);
+    }
+}
+
+uint32_t Material::getKeyword(const FName& keyword) const {
+    return baseShader ? baseShader->getKeywordLayout().getValue(getKeywordMask(), keyword) : 0;
 }
 
 Material::~Material() {
@@ -39,47 +53,87 @@ Material::~Material() {
     }
 }
 
-void Material::bind() {
+bool Material::bind() {
     if (shader) {
         shader->use();
 
-        // If the shader exposes a Material UBO, pack all parameters into the UBO block and upload in one call
+        // Textures in the Material block are packed with the other parameters below as their
+        // handle. The rest go to consecutive units in parameter order; samplers without a uniform
+        // location keep their layout(binding) instead.
         size_t mSize = shader->getMaterialUBOSize();
+        auto rhiDevice = RHI::getGlobalDevice();
+        const bool bindless = mSize > 0 && rhiDevice && rhiDevice->supportsBindlessTextures();
+        int textureUnit = 0;
+        for (auto& [pname, param] : parameters) {
+            if (param.type != ShaderParamType::Texture2D) continue;
+            if (mSize > 0 && shader->getUBOOffset(pname) >= 0) {
+                // A block member has no uniform location to point at a unit, so without a handle
+                // the shader would sample through handle 0
+                if (!bindless || getTextureHandle(pname) == 0) {
+                    if (!warnedMissingHandle) {
+                        LOG("Material " << name << ": texture " << pname << " is declared in the Material block but "
+                            << (bindless ? "is not an RHI texture" : "bindless textures are not supported")
+                            << "; not drawing with it");
+                        warnedMissingHandle = true;
+                    }
+                    return false;
+                }
+                continue;
+            }
+            // RHI textures are resolved now: resizing one (updateData) gives it a new GL name
+            auto texture = textures.find(pname);
+            const unsigned int textureID = texture != textures.end()
+                ? static_cast<unsigned int>(texture->second->getNativeHandle())
+                : *(unsigned int*)param.data;
+            glActiveTexture(GL_TEXTURE0 + textureUnit);
+            glBindTexture(GL_TEXTURE_2D, textureID);
+            shader->setInt(pname, textureUnit);
+            ++textureUnit;
+        }
+
+        // If the shader exposes a Material UBO, pack all parameters into the UBO block and upload in one call
         if (mSize > 0) {
-            std::vector<unsigned char> block(mSize);
+            TInlineArray<unsigned char, 256> block;
+            block.SetNum(mSize);
             for (auto& kv : parameters) {
-                const std::string& pname = kv.first;
+                const FName& pname = kv.first;
                 auto& param = kv.second;
                 GLint off = shader->getUBOOffset(pname);
                 if (off < 0) continue; // not part of material block
 
                 switch (param.type) {
                     case ShaderParamType::Float:
-                        memcpy(block.data() + off, param.data, sizeof(float));
+                        memcpy(block.GetData() + off, param.data, sizeof(float));
                         break;
                     case ShaderParamType::Vec3:
-                        memcpy(block.data() + off, param.data, sizeof(float) * 3);
+                        memcpy(block.GetData() + off, param.data, sizeof(float) * 3);
                         break;
                     case ShaderParamType::Vec4:
-                        memcpy(block.data() + off, param.data, sizeof(float) * 4);
+                        memcpy(block.GetData() + off, param.data, sizeof(float) * 4);
                         break;
                     case ShaderParamType::Int:
-                        memcpy(block.data() + off, param.data, sizeof(int));
+                        memcpy(block.GetData() + off, param.data, sizeof(int));
                         break;
                     case ShaderParamType::Bool: {
                         int iv = (*(bool*)param.data) ? 1 : 0;
-                        memcpy(block.data() + off, &iv, sizeof(int));
+                        memcpy(block.GetData() + off, &iv, sizeof(int));
                         break;
                     }
                     case ShaderParamType::Matrix4:
-                        memcpy(block.data() + off, param.data, sizeof(float) * 16);
+                        memcpy(block.GetData() + off, param.data, sizeof(float) * 16);
+                        break;
+                    case ShaderParamType::Texture2D: {
+                        // A sampler in a block is its 64-bit handle, checked to be nonzero above
+                        const uint64_t handle = getTextureHandle(pname);
+                        memcpy(block.GetData() + off, &handle, sizeof(uint64_t));
                         break;
+                    }
                     default:
-                        // textures and unsupported types are ignored for UBO packing
+                        // unsupported types are ignored for UBO packing
                         break;
                 }
             }
-            shader->updateMaterialBlock(block.data(), block.size());
+            shader->updateMaterialBlock(block.GetData(), block.Num());
         } else {
             // No material UBO: fall back to setting uniforms directly (uniforms only, no UBO-by-name writes)
             for (auto& [name, param] : parameters) {
@@ -108,14 +162,18 @@ void Material::bind() {
                 }
             }
         }
+        return true;
     }
+    return false;
 }
 
 void Material::unbind() {
-    glUseProgram(0);
+    if (shader) {
+        shader->unuse();
+    }
 }
 
-void Material::setFloat(const std::string& name, float value) {
+void Material::setFloat(const FName& name, float value) {
     auto it = parameters.find(name);
     if (it != parameters.end()) {
         *(float*)it->second.data = value;
@@ -125,7 +183,7 @@ void Material::setFloat(const std::string& name, float value) {
     }
 }
 
-void Material::setVec3(const std::string& name, float x, float y, float z) {
+void Material::setVec3(const FName& name, float x, float y, float z) {
     auto it = parameters.find(name);
     if (it != parameters.end()) {
         float* vec = (float*)it->second.data;
@@ -136,7 +194,7 @@ void Material::setVec3(const std::string& name, float x, float y, float z) {
     }
 }
 
-void Material::setVec4(const std::string& name, float x, float y, float z, float w) {
+void Material::setVec4(const FName& name, float x, float y, float z, float w) {
     auto it = parameters.find(name);
     if (it != parameters.end()) {
         float* vec = (float*)it->second.data;
@@ -147,7 +205,27 @@ void Material::setVec4(const std::string& name, float x, float y, float z, float
     }
 }
 
-void Material::setTexture(const std::string& name, unsigned int textureID) {
+void Material::setTexture(const FName& name, unsigned int textureID) {
+    textures.erase(name);
+    setTextureParameter(name, textureID);
+}
+
+void Material::setTexture(const FName& name, std::shared_ptr<RHI::IRHITexture> texture) {
+    if (!texture) {
+        setTexture(name, 0u);
+        return;
+    }
+    // The GL name is looked up at bind time, it changes when the texture is resized
+    textures[name] = std::move(texture);
+    setTextureParameter(name, 0u);
+}
+
+uint64_t Material::getTextureHandle(const FName& name) const {
+    auto it = textures.find(name);
+    return it != textures.end() ? it->second->getBindlessHandle() : 0;
+}
+
+void Material::setTextureParameter(const FName& name, unsigned int textureID) {
     auto it = parameters.find(name);
     if (it != parameters.end()) {
         *(unsigned int*)it->second.data = textureID;
@@ -157,19 +235,28 @@ void Material::setTexture(const std::string& name, unsigned int textureID) {
     }
 }
 
+void Material::loadTexture(const FName& name, const std::string& path, RHI::TextureFormat format) {
+    std::weak_ptr<Material> weakThis = weak_from_this();
+    TextureLoader::getInstance().load(path, [weakThis, name](std::shared_ptr<RHI::IRHITexture> texture) {
+        auto material = weakThis.lock();
+        if (!material || !texture) return;
+        material->setTexture(name, std::move(texture));
+    }, true, format);
+}
+
 // MaterialManager implementation
 MaterialManager& MaterialManager::getInstance() {
     static MaterialManager instance;
     return instance;
 }
 
-std::shared_ptr<Material> MaterialManager::createMaterial(const std::string& name, std::shared_ptr<Shader> shader) {
+std::shared_ptr<Material> MaterialManager::createMaterial(const FName& name, std::shared_ptr<Shader> shader) {
     auto material = std::make_shared<Material>(name, shader);
     materials[name] = material;
     return material;
 }
 
-std::shared_ptr<Material> MaterialManager::getMaterial(const std::string& name) {
+std::shared_ptr<Material> MaterialManager::getMaterial(const FName& name) {
     auto it = materials.find(name);
     if (it != materials.end()) {
         return it->second;
@@ -177,7 +264,7 @@ std::shared_ptr<Material> MaterialManager::getMaterial(const std::string& name)
     return nullptr;
 }
 
-void MaterialManager::removeMaterial(const std::string& name) {
+void MaterialManager::removeMaterial(const FName& name) {
     materials.erase(name);
 }
 
@@ -0,0 +1,419 @@
+#include "RenderGraph.h"
+#include "CoreUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace CarrotToy {
+
+namespace {
+
+constexpr uint32_t kInvalidIndex = RenderGraphTexture::kInvalidIndex;
+
+} // namespace
+
+// Builder
+
+RenderGraphTexture RenderGraph::Builder::createTexture(const FName& name, const RenderTargetDesc& desc) {
+    return graph.createTexture(name, desc);
+}
+
+void RenderGraph::Builder::read(RenderGraphTexture texture) {
+    graph.addAccess(passIndex, texture, Access::Sample);
+}
+
+void RenderGraph::Builder::readStorage(RenderGraphTexture texture) {
+    graph.addAccess(passIndex, texture, Access::StorageRead);
+}
+
+void RenderGraph::Builder::writeStorage(RenderGraphTexture texture) {
+    graph.addAccess(passIndex, texture, Access::StorageWrite);
+}
+
+void RenderGraph::Builder::setColorTarget(RenderGraphTexture texture, RenderGraphLoadOp loadOp,
+                                          float r, float g, float b, float a) {
+    PassNode& pass = graph.passes[passIndex];
+    if (pass.colorTarget != kInvalidIndex) {
+        LOG("RenderGraph: Pass " << pass.name << " already has a color target");
+        return;
+    }
+    graph.addAccess(passIndex, texture, Access::ColorTarget);
+    if (pass.accesses.empty() || pass.accesses.back().access != Access::ColorTarget) return;
+    pass.colorTarget = texture.index;
+    pass.colorLoadOp = loadOp;
+    pass.clearColor[0] = r;
+    pass.clearColor[1] = g;
+    pass.clearColor[2] = b;
+    pass.clearColor[3] = a;
+}
+
+void RenderGraph::Builder::setDepthTarget(RenderGraphTexture texture, RenderGraphLoadOp loadOp, float depth) {
+    PassNode& pass = graph.passes[passIndex];
+    if (pass.depthTarget != kInvalidIndex) {
+        LOG("RenderGraph: Pass " << pass.name << " already has a depth target");
+        return;
+    }
+    graph.addAccess(passIndex, texture, Access::DepthTarget);
+    if (pass.accesses.empty() || pass.accesses.back().access != Access::DepthTarget) return;
+    pass.depthTarget = texture.index;
+    pass.depthLoadOp = loadOp;
+    pass.clearDepth = depth;
+}
+
+void RenderGraph::Builder::setSideEffect() {
+    graph.passes[passIndex].sideEffect = true;
+}
+
+// RenderGraph
+
+RenderGraph::RenderGraph(RenderTargetPool& inPool)
+    : pool(inPool) {
+}
+
+RenderGraph::~RenderGraph() {
+    reset();
+}
+
+RenderGraphTexture RenderGraph::createTexture(const FName& name, const RenderTargetDesc& desc) {
+    ResourceNode resource;
+    resource.name = name;
+    resource.desc = desc;
+    resources.push_back(resource);
+    compiled = false;
+    return { static_cast<uint32_t>(resources.size() - 1) };
+}
+
+RenderGraphTexture RenderGraph::importTexture(const FName& name, RHI::IRHITexture* texture) {
+    if (!texture) {
+        LOG("RenderGraph: Cannot import a null texture as " << name);
+        return {};
+    }
+    ResourceNode resource;
+    resource.name = name;
+    resource.desc = { texture->getWidth(), texture->getHeight(), texture->getFormat() };
+    resource.texture = texture;
+    resource.imported = true;
+    resources.push_back(resource);
+    compiled = false;
+    return { static_cast<uint32_t>(resources.size() - 1) };
+}
+
+RenderGraphTexture RenderGraph::importBackbuffer(uint32_t width, uint32_t height) {
+    ResourceNode resource;
+    resource.name = FName("Backbuffer");
+    resource.desc.width = width;
+    resource.desc.height = height;
+    resource.imported = true;
+    resource.backbuffer = true;
+    resources.push_back(resource);
+    compiled = false;
+    return { static_cast<uint32_t>(resources.size() - 1) };
+}
+
+void RenderGraph::extractTexture(RenderGraphTexture texture) {
+    if (!texture.isValid() || texture.index >= resources.size()) return;
+    ResourceNode& resource = resources[texture.index];
+    if (resource.imported) return;
+    resource.extracted = true;
+    compiled = false;
+}
+
+void RenderGraph::addPass(const FName& name, const SetupFunc& setup, RecordFunc record) {
+    addPassNode(name, setup, std::move(record), nullptr);
+}
+
+void RenderGraph::addImmediatePass(const FName& name, const SetupFunc& setup, ExecuteFunc execute) {
+    addPassNode(name, setup, nullptr, std::move(execute));
+}
+
+uint32_t RenderGraph::addPassNode(const FName& name, const SetupFunc& setup, RecordFunc record, ExecuteFunc execute) {
+    PassNode pass;
+    pass.name = name;
+    pass.record = std::move(record);
+    pass.execute = std::move(execute);
+    passes.push_back(std::move(pass));
+    compiled = false;
+
+    const uint32_t passIndex = static_cast<uint32_t>(passes.size() - 1);
+    if (setup) {
+        Builder builder(*this, passIndex);
+        setup(builder);
+    }
+    return passIndex;
+}
+
+void RenderGraph::addAccess(uint32_t passIndex, RenderGraphTexture texture, Access access) {
+    PassNode& pass = passes[passIndex];
+    if (!texture.isValid() || texture.index >= resources.size()) {
+        LOG("RenderGraph: Pass " << pass.name << " uses an invalid texture");
+        return;
+    }
+    const ResourceNode& resource = resources[texture.index];
+    if (resource.backbuffer && access != Access::ColorTarget && access != Access::DepthTarget) {
+        LOG("RenderGraph: Pass " << pass.name << " can only render to the backbuffer");
+        return;
+    }
+    if (access == Access::ColorTarget || access == Access::DepthTarget) {
+        // The backbuffer is the default framebuffer: nothing else can be attached next to it
+        const uint32_t other = access == Access::ColorTarget ? pass.depthTarget : pass.colorTarget;
+        if (other != kInvalidIndex && resources[other].backbuffer != resource.backbuffer) {
+            LOG("RenderGraph: Pass " << pass.name << " mixes the backbuffer with " << resource.name);
+            return;
+        }
+    }
+    pass.accesses.push_back({ texture.index, access });
+}
+
+bool RenderGraph::isWrite(Access access) {
+    return access == Access::StorageWrite || access == Access::ColorTarget || access == Access::DepthTarget;
+}
+
+void RenderGraph::compile() {
+    for (ResourceNode& resource : resources) {
+        resource.firstPass = kInvalidIndex;
+        resource.lastPass = kInvalidIndex;
+    }
+
+    // Culling, walking back from the end: a resource is needed while a later surviving pass reads
+    // what is in it, or when it outlives the graph. A pass clearing a target overwrites all of it,
+    // so the writers before it are needed only if something in between reads the target.
+    std::vector<bool> needed(resources.size());
+    for (size_t i = 0; i < resources.size(); ++i) {
+        needed[i] = resources[i].imported || resources[i].extracted;
+    }
+    for (size_t p = passes.size(); p-- > 0;) {
+        PassNode& pass = passes[p];
+        bool keep = pass.sideEffect;
+        for (const ResourceAccess& access : pass.accesses) {
+            keep = keep || (isWrite(access.access) && needed[access.resource]);
+        }
+        pass.culled = !keep;
+        if (!keep) continue;
+
+        auto isCleared = [&pass](const ResourceAccess& access) {
+            return (access.access == Access::ColorTarget && pass.colorLoadOp == RenderGraphLoadOp::Clear) ||
+                   (access.access == Access::DepthTarget && pass.depthLoadOp == RenderGraphLoadOp::Clear);
+        };
+        for (const ResourceAccess& access : pass.accesses) {
+            if (isCleared(access)) {
+                needed[access.resource] = false;
+            }
+        }
+        // Reads, and writes keeping what was there (blending, storage writes), need the contents
+        for (const ResourceAccess& access : pass.accesses) {
+            if (!isCleared(access)) {
+                needed[access.resource] = true;
+            }
+        }
+    }
+
+    // Lifetimes and barriers, in execution order. pending holds, per resource, the consumers that
+    // have not seen its last storage write yet; a barrier reaches every resource, not just one.
+    std::vector<uint32_t> pending(resources.size(), 0);
+    const uint32_t afterStorageWrite = static_cast<uint32_t>(
+        RHI::BarrierFlags::TextureSample | RHI::BarrierFlags::StorageImage | RHI::BarrierFlags::Framebuffer);
+    for (uint32_t p = 0; p < passes.size(); ++p) {
+        PassNode& pass = passes[p];
+        pass.barriers = RHI::BarrierFlags::None;
+        pass.framebuffer = nullptr;
+        if (pass.culled) continue;
+
+        uint32_t barriers = 0;
+        for (const ResourceAccess& access : pass.accesses) {
+            ResourceNode& resource = resources[access.resource];
+            if (resource.firstPass == kInvalidIndex) {
+                resource.firstPass = p;
+            }
+            resource.lastPass = p;
+
+            RHI::BarrierFlags consumer = RHI::BarrierFlags::Framebuffer;
+            if (access.access == Access::Sample) {
+                consumer = RHI::BarrierFlags::TextureSample;
+            } else if (access.access == Access::StorageRead || access.access == Access::StorageWrite) {
+                consumer = RHI::BarrierFlags::StorageImage;
+            }
+            barriers |= pending[access.resource] & static_cast<uint32_t>(consumer);
+        }
+        if (barriers != 0) {
+            for (uint32_t& flags : pending) {
+                flags &= ~barriers;
+            }
+        }
+        for (const ResourceAccess& access : pass.accesses) {
+            if (access.access == Access::StorageWrite) {
+                pending[access.resource] = afterStorageWrite;
+            }
+        }
+        pass.barriers = static_cast<RHI::BarrierFlags>(barriers);
+    }
+
+    compiled = true;
+}
+
+void RenderGraph::execute(RHI::IRHIDevice& device, uint32_t recordThreads) {
+    if (!compiled) {
+        compile();
+    }
+
+    // Created textures are taken from the pool at their first pass and handed back after their
+    // last, so a later texture of the same desc gets the same one. The GPU runs the passes in
+    // order, so sharing is safe even though the lists are recorded together.
+    std::vector<uint32_t> recorded;
+    for (uint32_t p = 0; p < passes.size(); ++p) {
+        PassNode& pass = passes[p];
+        if (pass.culled) continue;
+
+        for (const ResourceAccess& access : pass.accesses) {
+            ResourceNode& resource = resources[access.resource];
+            if (!resource.imported && resource.firstPass == p && !resource.texture) {
+                resource.texture = pool.acquire(resource.desc);
+                if (!resource.texture) {
+                    LOG("RenderGraph: Could not create " << resource.name << " (" << resource.desc.width << "x" << resource.desc.height << ")");
+                }
+            }
+        }
+
+        const bool toBackbuffer = (pass.colorTarget != kInvalidIndex && resources[pass.colorTarget].backbuffer) ||
+                                  (pass.depthTarget != kInvalidIndex && resources[pass.depthTarget].backbuffer);
+        if (!toBackbuffer && (pass.colorTarget != kInvalidIndex || pass.depthTarget != kInvalidIndex)) {
+            RHI::IRHITexture* color = pass.colorTarget != kInvalidIndex ? resources[pass.colorTarget].texture : nullptr;
+            RHI::IRHITexture* depth = pass.depthTarget != kInvalidIndex ? resources[pass.depthTarget].texture : nullptr;
+            pass.framebuffer = color || depth ? pool.getFramebuffer(color, depth) : nullptr;
+        }
+
+        pass.commandList = kInvalidIndex;
+        if (pass.record) {
+            pass.commandList = static_cast<uint32_t>(recorded.size());
+            recorded.push_back(p);
+        }
+
+        for (const ResourceAccess& access : pass.accesses) {
+            ResourceNode& resource = resources[access.resource];
+            if (!resource.imported && !resource.extracted && resource.lastPass == p && resource.texture) {
+                pool.release(resource.texture);
+            }
+        }
+    }
+
+    while (commandLists.size() < recorded.size()) {
+        commandLists.push_back(device.createCommandList());
+    }
+
+    // Recording only touches the pass's own list and the texture pointers resolved above
+    const Context context(*this, device);
+    auto recordPass = [&](uint32_t listIndex) {
+        const PassNode& pass = passes[recorded[listIndex]];
+        RHI::IRHICommandList& commands = *commandLists[listIndex];
+        commands.reset();
+        beginPass(pass, device, &commands);
+        pass.record(context, commands);
+    };
+    const uint32_t threadCount = std::min<uint32_t>(std::max<uint32_t>(recordThreads, 1u),
+                                                    static_cast<uint32_t>(recorded.size()));
+    if (threadCount > 1) {
+        std::atomic<uint32_t> next{ 0 };
+        auto worker = [&]() {
+            for (uint32_t i = next.fetch_add(1); i < recorded.size(); i = next.fetch_add(1)) {
+                recordPass(i);
+            }
+        };
+        std::vector<std::thread> workers;
+        for (uint32_t i = 1; i < threadCount; ++i) {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& thread : workers) {
+            thread.join();
+        }
+    } else {
+        for (uint32_t i = 0; i < recorded.size(); ++i) {
+            recordPass(i);
+        }
+    }
+
+    // Submission in pass order; consecutive recorded passes go out in one call
+    std::vector<RHI::IRHICommandList*> batch;
+    auto flush = [&]() {
+        if (!batch.empty()) {
+            device.submitCommandLists(batch.data(), static_cast<uint32_t>(batch.size()));
+            batch.clear();
+        }
+    };
+    for (const PassNode& pass : passes) {
+        if (pass.culled) continue;
+        if (pass.commandList != kInvalidIndex) {
+            batch.push_back(commandLists[pass.commandList].get());
+            continue;
+        }
+        flush();
+        beginPass(pass, device, nullptr);
+        if (pass.execute) {
+            pass.execute(context);
+        }
+    }
+    flush();
+    device.bindDefaultFramebuffer();
+
+    // Only extracted textures stay valid past execute()
+    for (ResourceNode& resource : resources) {
+        if (!resource.imported && !resource.extracted) {
+            resource.texture = nullptr;
+        }
+    }
+}
+
+void RenderGraph::beginPass(const PassNode& pass, RHI::IRHIDevice& device, RHI::IRHICommandList* commands) const {
+    if (pass.barriers != RHI::BarrierFlags::None) {
+        if (commands) {
+            commands->memoryBarrier(pass.barriers);
+        } else {
+            device.memoryBarrier(pass.barriers);
+        }
+    }
+    if (pass.colorTarget == kInvalidIndex && pass.depthTarget == kInvalidIndex) return;
+
+    const uint32_t width = getTargetWidth(pass);
+    const uint32_t height = getTargetHeight(pass);
+    const bool clearColor = pass.colorTarget != kInvalidIndex && pass.colorLoadOp == RenderGraphLoadOp::Clear;
+    const bool clearDepth = pass.depthTarget != kInvalidIndex && pass.depthLoadOp == RenderGraphLoadOp::Clear;
+    if (commands) {
+        commands->bindFramebuffer(pass.framebuffer);
+        commands->setViewport(0, 0, width, height);
+        if (clearColor) commands->clearColor(pass.clearColor[0], pass.clearColor[1], pass.clearColor[2], pass.clearColor[3]);
+        if (clearDepth) commands->clearDepth(pass.clearDepth);
+        if (clearColor || clearDepth) commands->clear(clearColor, clearDepth, false);
+        return;
+    }
+    if (pass.framebuffer) {
+        pass.framebuffer->bind();
+    } else {
+        device.bindDefaultFramebuffer();
+    }
+    device.setViewport(0, 0, width, height);
+    if (clearColor) device.clearColor(pass.clearColor[0], pass.clearColor[1], pass.clearColor[2], pass.clearColor[3]);
+    if (clearDepth) device.clearDepth(pass.clearDepth);
+    if (clearColor || clearDepth) device.clear(clearColor, clearDepth, false);
+}
+
+uint32_t RenderGraph::getTargetWidth(const PassNode& pass) const {
+    const uint32_t target = pass.colorTarget != kInvalidIndex ? pass.colorTarget : pass.depthTarget;
+    return resources[target].desc.width;
+}
+
+uint32_t RenderGraph::getTargetHeight(const PassNode& pass) const {
+    const uint32_t target = pass.colorTarget != kInvalidIndex ? pass.colorTarget : pass.depthTarget;
+    return resources[target].desc.height;
+}
+
+void RenderGraph::reset() {
+    resources.clear();
+    passes.clear();
+    compiled = false;
+}
+
+RHI::IRHITexture* RenderGraph::getTexture(RenderGraphTexture texture) const {
+    if (!texture.isValid() || texture.index >= resources.size()) return nullptr;
+    return resources[texture.index].texture;
+}
+
+} // namespace CarrotToy
@@ -0,0 +1,118 @@
+#include "RenderTargetPool.h"
+#include "CoreUtils.h"
+#include <algorithm>
+
+namespace CarrotToy {
+
+RenderTargetPool::~RenderTargetPool() {
+    shutdown();
+}
+
+RHI::IRHITexture* RenderTargetPool::acquire(const RenderTargetDesc& desc) {
+    for (Target& target : targets) {
+        if (!target.acquired && target.desc == desc) {
+            target.acquired = true;
+            target.lastUsedFrame = frame;
+            return target.texture.get();
+        }
+    }
+
+    auto device = RHI::getGlobalDevice();
+    if (!device || desc.width == 0 || desc.height == 0) return nullptr;
+
+    RHI::TextureDesc textureDesc;
+    textureDesc.width = desc.width;
+    textureDesc.height = desc.height;
+    textureDesc.format = desc.format;
+    textureDesc.mipLevels = 1;
+    textureDesc.minFilter = RHI::TextureFilter::Linear;
+    textureDesc.magFilter = RHI::TextureFilter::Linear;
+    textureDesc.wrapS = RHI::TextureWrap::ClampToEdge;
+    textureDesc.wrapT = RHI::TextureWrap::ClampToEdge;
+    auto texture = device->createTexture(textureDesc);
+    if (!texture) return nullptr;
+
+    Target target;
+    target.desc = desc;
+    target.texture = std::move(texture);
+    target.acquired = true;
+    target.lastUsedFrame = frame;
+    targets.push_back(std::move(target));
+    return targets.back().texture.get();
+}
+
+void RenderTargetPool::release(RHI::IRHITexture* texture) {
+    for (Target& target : targets) {
+        if (target.texture.get() == texture) {
+            target.acquired = false;
+            target.lastUsedFrame = frame;
+            return;
+        }
+    }
+}
+
+RHI::IRHIFramebuffer* RenderTargetPool::getFramebuffer(RHI::IRHITexture* color, RHI::IRHITexture* depth) {
+    for (const CachedFramebuffer& cached : framebuffers) {
+        if (cached.color == color && cached.depth == depth) {
+            return cached.framebuffer.get();
+        }
+    }
+
+    auto device = RHI::getGlobalDevice();
+    if (!device || (!color && !depth)) return nullptr;
+
+    RHI::FramebufferDesc desc;
+    desc.createAttachments = false;
+    auto framebuffer = device->createFramebuffer(desc);
+    if (!framebuffer) return nullptr;
+    if (color) {
+        framebuffer->attachColorTexture(color, 0);
+    }
+    if (depth) {
+        framebuffer->attachDepthTexture(depth);
+    }
+    if (!framebuffer->isComplete()) {
+        RHI::IRHITexture* target = color ? color : depth;
+        LOG("RenderTargetPool: Incomplete framebuffer for a " << target->getWidth() << "x" << target->getHeight() << " target");
+    }
+    framebuffers.push_back({ color, depth, framebuffer });
+    return framebuffer.get();
+}
+
+void RenderTargetPool::endFrame() {
+    ++frame;
+
+    std::vector<RHI::IRHITexture*> expired;
+    for (const Target& target : targets) {
+        if (!target.acquired && frame - target.lastUsedFrame > kMaxIdleFrames) {
+            expired.push_back(target.texture.get());
+        }
+    }
+    if (expired.empty()) return;
+
+    auto isExpired = [&expired](RHI::IRHITexture* texture) {
+        return texture && std::find(expired.begin(), expired.end(), texture) != expired.end();
+    };
+    // Framebuffers go first; they refer to the textures without owning them
+    framebuffers.erase(std::remove_if(framebuffers.begin(), framebuffers.end(), [&](const CachedFramebuffer& cached) {
+        return isExpired(cached.color) || isExpired(cached.depth);
+    }), framebuffers.end());
+    targets.erase(std::remove_if(targets.begin(), targets.end(), [&](const Target& target) {
+        return isExpired(target.texture.get());
+    }), targets.end());
+}
+
+void RenderTargetPool::shutdown() {
+    framebuffers.clear();
+    targets.clear();
+}
+
+size_t RenderTargetPool::getAllocatedBytes() const {
+    size_t bytes = 0;
+    for (const Target& target : targets) {
+        bytes += RHI::getTextureDataSize(target.desc.format, target.desc.width, target.desc.height);
+    }
+    return bytes;
+}
+
+} // namespace CarrotToy
@@ -1,13 +1,19 @@
 #include "Renderer.h"
 #include "Material.h"
+#include "RenderGraph.h"
+#include "RenderTargetPool.h"
+#include "ShaderHotReload.h"
+#include "TextureLoader.h"
 #include "Platform/PlatformModule.h"
 #include "RHI/RHIModuleInit.h"
+#include "RHI/RHIVertexPacking.h"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 #include <cmath>
+#include <cstddef>
 #include "CoreUtils.h"
 #include "Input/InputDevice.h"
 
@@ -15,9 +21,7 @@ namespace CarrotToy {
 
 Renderer::Renderer() 
     : window(nullptr), cachedPlatform(nullptr), inputDevice(nullptr), 
-      width(800), height(600), renderMode(RenderMode::Rasterization),
-      sphereVAO(0), sphereVBO(0), sphereEBO(0),
-      previewFBO(0), previewTexture(0) {
+      width(800), height(600), renderMode(RenderMode::Rasterization) {
 }
 
 Renderer::~Renderer() {
@@ -97,7 +101,8 @@ bool Renderer::initialize(int w, int h, const std::string& title) {
     glEnable(GL_DEPTH_TEST);
     
     setupPreviewGeometry();
-    setupFramebuffer();
+    renderTargetPool = std::make_unique<RenderTargetPool>();
+    renderGraph = std::make_unique<RenderGraph>(*renderTargetPool);
     
     LOG("Renderer: Initialized successfully");
     return true;
@@ -106,11 +111,15 @@ bool Renderer::initialize(int w, int h, const std::string& title) {
 void Renderer::shutdown() {
     LOG("Renderer: Shutting down...");
     
-    if (sphereVAO) glDeleteVertexArrays(1, &sphereVAO);
-    if (sphereVBO) glDeleteBuffers(1, &sphereVBO);
-    if (sphereEBO) glDeleteBuffers(1, &sphereEBO);
-    if (previewFBO) glDeleteFramebuffers(1, &previewFBO);
-    if (previewTexture) glDeleteTextures(1, &previewTexture);
+    shaderHotReloader.reset();
+    TextureLoader::getInstance().shutdown();
+    
+    sphereVertexArray.reset();
+    sphereVertexBuffer.reset();
+    sphereIndexBuffer.reset();
+    frameTargets.clear();
+    renderGraph.reset();
+    renderTargetPool.reset();
     
     // Shutdown window and input
     inputDevice.reset();
@@ -124,11 +133,51 @@ void Renderer::shutdown() {
 }
 
 void Renderer::beginFrame() {
-    glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // Frame boundary: pick up changed shaders and swap in programs whose link finished, so every
+    // draw of a frame uses the same program
+    if (shaderHotReloader) {
+        shaderHotReloader->tick();
+    }
+    Shader::updatePendingLinks();
+    TextureLoader::getInstance().tick();
+    
+    // The editor draws into the backbuffer between the passes, so the clear cannot wait for the
+    // first pass of the frame and runs on its own
+    auto rhiDevice = RHI::getGlobalDevice();
+    if (!rhiDevice || !renderGraph) return;
+    uint32_t backbufferWidth, backbufferHeight;
+    getBackbufferSize(backbufferWidth, backbufferHeight);
+    const RenderGraphTexture backbuffer = renderGraph->importBackbuffer(backbufferWidth, backbufferHeight);
+    renderGraph->addImmediatePass(FName("ClearBackbuffer"), [&](RenderGraph::Builder& builder) {
+        builder.setColorTarget(backbuffer, RenderGraphLoadOp::Clear, 0.2f, 0.2f, 0.2f, 1.0f);
+        builder.setDepthTarget(backbuffer, RenderGraphLoadOp::Clear);
+    }, nullptr);
+    renderGraph->execute(*rhiDevice);
+    renderGraph->reset();
+}
+
+bool Renderer::enableShaderHotReload(const std::string& sourceDir, const std::string& outputDir) {
+    auto reloader = std::make_unique<ShaderHotReloader>();
+    if (!reloader->start(sourceDir, outputDir)) {
+        return false;
+    }
+    shaderHotReloader = std::move(reloader);
+    return true;
 }
 
 void Renderer::endFrame() {
+    if (renderTargetPool) {
+        for (RHI::IRHITexture* target : frameTargets) {
+            renderTargetPool->release(target);
+        }
+        renderTargetPool->endFrame();
+    }
+    frameTargets.clear();
+    
+    // Recycles the frame's transient uniform memory once the GPU is done with it
+    if (auto rhiDevice = RHI::getGlobalDevice()) {
+        rhiDevice->endFrame();
+    }
     if (window) {
         window->swapBuffers();
         Platform::PlatformSubsystem::Get().PollEvents();
@@ -137,17 +186,73 @@ void Renderer::endFrame() {
 
 void Renderer::renderMaterialPreview(std::shared_ptr<Material> material) {
     setPreviewMaterial(material);
-    if (!material) return;
-    
-    material->bind();
+    auto rhiDevice = RHI::getGlobalDevice();
+    if (!material || !rhiDevice || !renderGraph) return;
+    
+    uint32_t backbufferWidth, backbufferHeight;
+    getBackbufferSize(backbufferWidth, backbufferHeight);
+    if (backbufferWidth == 0 || backbufferHeight == 0) return;  // Minimized
+    const RenderGraphTexture backbuffer = renderGraph->importBackbuffer(backbufferWidth, backbufferHeight);
+    const float aspect = (float)backbufferWidth / (float)backbufferHeight;
+    // Immediate: Material and the sphere still bind and draw with raw GL
+    renderGraph->addImmediatePass(FName("MaterialPreview"), [&](RenderGraph::Builder& builder) {
+        builder.setColorTarget(backbuffer, RenderGraphLoadOp::Load);
+        builder.setDepthTarget(backbuffer, RenderGraphLoadOp::Load);
+    }, [this, &material, aspect](const RenderGraph::Context&) {
+        drawPreview(*material, aspect);
+    });
+    renderGraph->execute(*rhiDevice);
+    renderGraph->reset();
+}
+
+RHI::IRHITexture* Renderer::renderMaterialPreviewToTexture(std::shared_ptr<Material> material, uint32_t size) {
+    auto rhiDevice = RHI::getGlobalDevice();
+    if (!material || !rhiDevice || !renderGraph || size == 0) return nullptr;
+    
+    // Depth is only needed while drawing, so the graph hands it back to the pool right after the
+    // pass. The color target is extracted and held until endFrame() for the caller to sample.
+    RenderGraphTexture color;
+    renderGraph->addImmediatePass(FName("MaterialPreviewToTexture"), [&](RenderGraph::Builder& builder) {
+        color = builder.createTexture(FName("PreviewColor"), { size, size, RHI::TextureFormat::RGBA8 });
+        const RenderGraphTexture depth = builder.createTexture(FName("PreviewDepth"), { size, size, RHI::TextureFormat::Depth24Stencil8 });
+        builder.setColorTarget(color, RenderGraphLoadOp::Clear, 0.2f, 0.2f, 0.2f, 1.0f);
+        builder.setDepthTarget(depth, RenderGraphLoadOp::Clear);
+    }, [this, &material](const RenderGraph::Context&) {
+        drawPreview(*material, 1.0f);
+    });
+    renderGraph->extractTexture(color);
+    renderGraph->execute(*rhiDevice);
+    RHI::IRHITexture* texture = renderGraph->getTexture(color);
+    renderGraph->reset();
+    
+    uint32_t backbufferWidth, backbufferHeight;
+    getBackbufferSize(backbufferWidth, backbufferHeight);
+    rhiDevice->setViewport(0, 0, backbufferWidth, backbufferHeight);
+    if (texture) {
+        frameTargets.push_back(texture);
+    }
+    return texture;
+}
+
+void Renderer::getBackbufferSize(uint32_t& outWidth, uint32_t& outHeight) const {
+    outWidth = static_cast<uint32_t>(width);
+    outHeight = static_cast<uint32_t>(height);
+    if (window) {
+        window->getFramebufferSize(outWidth, outHeight);
+    }
+}
+
+void Renderer::drawPreview(Material& material, float aspect) {
+    if (!material.bind()) {
+        material.unbind();
+        return;
+    }
     
     // Set up view and projection matrices
     glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 3.0f), 
                                  glm::vec3(0.0f, 0.0f, 0.0f), 
                                  glm::vec3(0.0f, 1.0f, 0.0f));
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 
-                                           (float)width / (float)height, 
-                                           0.1f, 100.0f);
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspect, 0.1f, 100.0f);
     glm::mat4 model = glm::mat4(1.0f);
     
     // Use cached platform pointer for efficient per-frame time access
@@ -162,7 +267,7 @@ void Renderer::renderMaterialPreview(std::shared_ptr<Material> material) {
         }
     }
     
-    auto shader = material->getShader();
+    auto shader = material.getShader();
     // Use typed helpers to upload per-frame matrices and light/camera data
     shader->setPerFrameMatrices(glm::value_ptr(model), glm::value_ptr(view), glm::value_ptr(projection));
     float lightPos[3] = {10.0f, 10.0f, 0.0f};
@@ -171,14 +276,14 @@ void Renderer::renderMaterialPreview(std::shared_ptr<Material> material) {
     shader->setLightData(lightPos, lightColor, viewPos);
     
     // Render sphere
-    if (sphereVAO) {
-        glBindVertexArray(sphereVAO);
-        // Calculate actual element count: latitudes * longitudes * 6 (2 triangles per quad)
-        glDrawElements(GL_TRIANGLES, 50 * 50 * 6, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+    auto rhiDevice = RHI::getGlobalDevice();
+    if (sphereVertexArray && rhiDevice) {
+        sphereVertexArray->bind();
+        rhiDevice->drawIndexed(RHI::PrimitiveTopology::TriangleList, sphereIndexCount);
+        sphereVertexArray->unbind();
     }
     
-    material->unbind();
+    material.unbind();
 }
 
 void Renderer::renderScene() {
@@ -228,12 +333,21 @@ std::shared_ptr<Material> Renderer::getPreviewMaterial() const {
     return previewMaterial;
 }
 void Renderer::setupPreviewGeometry() {
+    auto rhiDevice = RHI::getGlobalDevice();
+    if (!rhiDevice) return;
+    
     // Create a simple sphere for material preview
     const int latitudes = 50;
     const int longitudes = 50;
     const float PI = 3.14159265358979323846f;
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
+    // Half float positions (w = 1) and 10_10_10_2 normals: half the 24 bytes of six floats. The
+    // shaders read them as float3 like before.
+    struct PreviewVertex {
+        uint16_t position[4];
+        uint32_t normal;
+    };
+    std::vector<PreviewVertex> vertices;
+    std::vector<uint32_t> indices;
     
     for (int lat = 0; lat <= latitudes; ++lat) {
         float theta = lat * PI / latitudes;
@@ -249,12 +363,13 @@ void Renderer::setupPreviewGeometry() {
             float y = cosTheta;
             float z = sinPhi * sinTheta;
             
-            vertices.push_back(x);
-            vertices.push_back(y);
-            vertices.push_back(z);
-            vertices.push_back(x); // normal
-            vertices.push_back(y);
-            vertices.push_back(z);
+            PreviewVertex vertex;
+            vertex.position[0] = RHI::packHalf(x);
+            vertex.position[1] = RHI::packHalf(y);
+            vertex.position[2] = RHI::packHalf(z);
+            vertex.position[3] = RHI::packHalf(1.0f);
+            vertex.normal = RHI::packSnorm10_10_10_2(x, y, z); // normal
+            vertices.push_back(vertex);
         }
     }
     
@@ -273,43 +388,48 @@ void Renderer::setupPreviewGeometry() {
         }
     }
     
-    glGenVertexArrays(1, &sphereVAO);
-    glGenBuffers(1, &sphereVBO);
-    glGenBuffers(1, &sphereEBO);
+    // 2601 vertices fit 16-bit indices
+    std::vector<uint8_t> indexData;
+    const RHI::IndexFormat indexFormat = RHI::packIndices(indices.data(), indices.size(), vertices.size(), indexData);
+    sphereIndexCount = static_cast<uint32_t>(indices.size());
     
-    glBindVertexArray(sphereVAO);
+    RHI::BufferDesc vertexDesc;
+    vertexDesc.type = RHI::BufferType::Vertex;
+    vertexDesc.size = vertices.size() * sizeof(PreviewVertex);
+    vertexDesc.initialData = vertices.data();
+    sphereVertexBuffer = rhiDevice->createBuffer(vertexDesc);
     
-    glBindBuffer(GL_ARRAY_BUFFER, sphereVBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    RHI::BufferDesc indexDesc;
+    indexDesc.type = RHI::BufferType::Index;
+    indexDesc.size = indexData.size();
+    indexDesc.initialData = indexData.data();
+    sphereIndexBuffer = rhiDevice->createBuffer(indexDesc);
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    sphereVertexArray = rhiDevice->createVertexArray();
+    sphereVertexArray->setVertexBuffer(sphereVertexBuffer.get(), 0);
+    sphereVertexArray->setIndexBuffer(sphereIndexBuffer.get(), indexFormat);
     
     // Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    RHI::VertexAttribute position;
+    position.location = 0;
+    position.binding = 0;
+    position.offset = offsetof(PreviewVertex, position);
+    position.componentCount = 4;
+    position.stride = sizeof(PreviewVertex);
+    position.normalized = false;
+    position.format = RHI::VertexFormat::Half;
+    sphereVertexArray->setVertexAttribute(position);
     
     // Normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    glBindVertexArray(0);
-}
-
-void Renderer::setupFramebuffer() {
-    // Setup framebuffer for preview rendering
-    glGenFramebuffers(1, &previewFBO);
-    glGenTextures(1, &previewTexture);
-    
-    glBindTexture(GL_TEXTURE_2D, previewTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 512, 512, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    
-    glBindFramebuffer(GL_FRAMEBUFFER, previewFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, previewTexture, 0);
-    
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    RHI::VertexAttribute normal;
+    normal.location = 1;
+    normal.binding = 0;
+    normal.offset = offsetof(PreviewVertex, normal);
+    normal.componentCount = 4;
+    normal.stride = sizeof(PreviewVertex);
+    normal.normalized = true;
+    normal.format = RHI::VertexFormat::Snorm10_10_10_2;
+    sphereVertexArray->setVertexAttribute(normal);
 }
 
 void Renderer::exportSceneForRayTracing(const std::string& outputPath) {
@@ -11,6 +11,12 @@ void FRendererModule::StartupModule()
 	// Material system, shader management, etc.
 }
 
+void FRendererModule::GetModuleDescriptor(FModuleDescriptor& OutDescriptor) const
+{
+	// Startup only sets up CPU-side state; GL work happens later in Renderer::initialize
+	OutDescriptor.Dependencies.Add("RHI");
+}
+
 void FRendererModule::ShutdownModule()
 {
 	LOG("RendererModule: Shutdown - Shutting down renderer subsystem");
@@ -1,5 +1,7 @@
 #include "Shader.h"
 #include "CoreUtils.h"
+#include "Misc/StartupProfiler.h"
+#include "ShaderArchive.h"
 #include <fstream>
 #include <algorithm>
 #include <vector>
@@ -18,9 +20,12 @@ static bool hasExtension(const std::string& path, const std::string& ext) {
 // Shader implementation
 Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
     : vertexPath(vertexPath), fragmentPath(fragmentPath) {
+    liveShaders.push_back(this);
 }
 
 Shader::~Shader() {
+    liveShaders.erase(std::remove(liveShaders.begin(), liveShaders.end(), this), liveShaders.end());
+
     if (shaderProgram && shaderProgram->isValid()) {
         // Remove program cache entry
         uintptr_t programID = shaderProgram->getNativeHandle();
@@ -30,18 +35,64 @@ Shader::~Shader() {
     }
 }
 
+std::shared_ptr<Shader> Shader::placeholderShader;
+std::vector<Shader*> Shader::liveShaders;
+
+void Shader::updatePendingLinks() {
+    for (Shader* shader : liveShaders) {
+        shader->updatePendingLink();
+    }
+}
+
+void Shader::forEachShader(const std::function<void(Shader&)>& callback) {
+    // Copy: the callback may create or destroy shaders
+    const std::vector<Shader*> shaders = liveShaders;
+    for (Shader* shader : shaders) {
+        callback(*shader);
+    }
+}
+
 void Shader::use() {
+    if (Shader* placeholder = getPlaceholder()) {
+        placeholder->use();
+        return;
+    }
     if (shaderProgram && shaderProgram->isValid()) {
         shaderProgram->bind();
     }
 }
 
+void Shader::unuse() {
+    if (Shader* placeholder = getPlaceholder()) {
+        placeholder->unuse();
+        return;
+    }
+    if (shaderProgram) {
+        shaderProgram->unbind();
+    }
+}
+
 void Shader::reload() {
-    // Read shader files
+    reloadFromFiles(false);
+}
+
+void Shader::reloadAsync() {
+    reloadFromFiles(true);
+}
+
+void Shader::reloadFromFiles(bool async) {
+    STARTUP_SCOPE("Shader", "Reload " + vertexPath + " | " + fragmentPath);
+
+    // Read shader files. Loose files win, so edited shaders take effect without re-cooking;
+    // otherwise fall back to the mounted shader archive.
     auto readFile = [](const std::string& path) -> std::string {
         bool isBinary = hasExtension(path, ".spv");
         std::ifstream file(path, isBinary ? (std::ios::binary | std::ios::ate) : std::ios::ate);
-        if (!file.is_open()) return "";
+        if (!file.is_open()) {
+            std::string archived;
+            FShaderArchive::ReadMounted(path, archived);
+            return archived;
+        }
         std::streamsize size = file.tellg();
         file.seekg(0, std::ios::beg);
         std::string buffer(size, '\0');
@@ -57,10 +108,118 @@ void Shader::reload() {
         return;
     }
     
-    compile(vCode, fCode);
+    if (isVariant()) {
+        // A variant reloads only itself, specialized with its keywords
+        if (compileStages(vCode, fCode, async)) {
+            async ? linkProgramAsync() : linkProgram();
+        }
+    } else if (async) {
+        compileAsync(vCode, fCode);
+    } else {
+        compile(vCode, fCode);
+    }
 }
 
 bool Shader::compile(const std::string& vertexSource, const std::string& fragmentSource) {
+    // Variants always follow their base shader's sources
+    if (auto base = variantBase.lock()) {
+        return base->compile(vertexSource, fragmentSource);
+    }
+    if (!compileStages(vertexSource, fragmentSource, false)) {
+        return false;
+    }
+    // The caller links this shader; variants are relinked right away
+    for (auto& kv : variants) {
+        Shader& variant = *kv.second;
+        if (!variant.compileStages(vertexSource, fragmentSource, false) || !variant.linkProgram()) {
+            std::cerr << "Shader variant failed: " << keywordLayout.describe(kv.first) << std::endl;
+        }
+    }
+    return true;
+}
+
+bool Shader::compileAsync(const std::string& vertexSource, const std::string& fragmentSource) {
+    if (auto base = variantBase.lock()) {
+        return base->compileAsync(vertexSource, fragmentSource);
+    }
+    if (!compileStages(vertexSource, fragmentSource, true) || !linkProgramAsync()) {
+        return false;
+    }
+    for (auto& kv : variants) {
+        Shader& variant = *kv.second;
+        if (!variant.compileStages(vertexSource, fragmentSource, true) || !variant.linkProgramAsync()) {
+            std::cerr << "Shader variant failed: " << keywordLayout.describe(kv.first) << std::endl;
+        }
+    }
+    return true;
+}
+
+bool Shader::declareKeyword(const FName& name, uint32_t constantID, bool defaultValue) {
+    if (isVariant() || variants.Num() > 0) {
+        std::cerr << "Keywords must be declared on the base shader before variants exist" << std::endl;
+        return false;
+    }
+    const bool declared = keywordLayout.declareBool(name, constantID, defaultValue);
+    keywordMask = keywordLayout.getDefaultMask();
+    return declared;
+}
+
+bool Shader::declareEnumKeyword(const FName& name, uint32_t constantID, std::vector<std::string> valueNames, uint32_t defaultValue) {
+    if (isVariant() || variants.Num() > 0) {
+        std::cerr << "Keywords must be declared on the base shader before variants exist" << std::endl;
+        return false;
+    }
+    const bool declared = keywordLayout.declareEnum(name, constantID, std::move(valueNames), defaultValue);
+    keywordMask = keywordLayout.getDefaultMask();
+    return declared;
+}
+
+const ShaderKeywordLayout& Shader::getKeywordLayout() const {
+    if (auto base = variantBase.lock()) {
+        return base->keywordLayout;
+    }
+    return keywordLayout;
+}
+
+std::shared_ptr<Shader> Shader::getVariant(ShaderKeywordMask mask) {
+    if (auto base = variantBase.lock()) {
+        return base->getVariant(mask);
+    }
+    if (mask == keywordLayout.getDefaultMask()) {
+        return shared_from_this();
+    }
+    if (std::shared_ptr<Shader>* existing = variants.Find(mask)) {
+        return *existing;
+    }
+    
+    auto variant = std::make_shared<Shader>(vertexPath, fragmentPath);
+    variant->variantBase = weak_from_this();
+    variant->keywordMask = mask;
+    variant->specialization = keywordLayout.getSpecializationConstants(mask);
+    variants.Add(mask, variant);
+    
+    LOG("Shader: Compiling variant [" << keywordLayout.describe(mask) << "] of " << fragmentPath);
+    if (lastVertexSource.empty() || lastFragmentSource.empty()) {
+        // The base shader was never compiled; start from the files
+        variant->reloadFromFiles(true);
+    } else if (!variant->compileStages(lastVertexSource, lastFragmentSource, true) || !variant->linkProgramAsync()) {
+        std::cerr << "Shader variant failed: " << keywordLayout.describe(mask) << std::endl;
+    }
+    return variant;
+}
+
+void Shader::precompileVariants(const std::vector<ShaderKeywordMask>& masks) {
+    for (ShaderKeywordMask mask : masks) {
+        getVariant(mask);
+    }
+}
+
+bool Shader::compileStages(const std::string& vertexSource, const std::string& fragmentSource, bool async) {
+    if (!isVariant()) {
+        lastVertexSource = vertexSource;
+        lastFragmentSource = fragmentSource;
+    }
+    
     // Determine shader format based on file extension
     RHI::ShaderSourceFormat vFormat = hasExtension(vertexPath, ".spv") 
         ? RHI::ShaderSourceFormat::SPIRV 
@@ -70,12 +229,12 @@ bool Shader::compile(const std::string& vertexSource, const std::string& fragmen
         : RHI::ShaderSourceFormat::GLSL;
     
     // Compile vertex shader
-    if (!compileShader(vertexShader, RHI::ShaderType::Vertex, vertexSource, vFormat)) {
+    if (!compileShader(vertexShader, RHI::ShaderType::Vertex, vertexSource, vFormat, async)) {
         return false;
     }
     
     // Compile fragment shader
-    if (!compileShader(fragmentShader, RHI::ShaderType::Fragment, fragmentSource, fFormat)) {
+    if (!compileShader(fragmentShader, RHI::ShaderType::Fragment, fragmentSource, fFormat, async)) {
         return false;
     }
     
@@ -85,7 +244,8 @@ bool Shader::compile(const std::string& vertexSource, const std::string& fragmen
 bool Shader::compileShader(std::shared_ptr<RHI::IRHIShader>& shader, 
                            RHI::ShaderType type, 
                            const std::string& source,
-                           RHI::ShaderSourceFormat format) {
+                           RHI::ShaderSourceFormat format,
+                           bool async) {
     auto rhiDev = RHI::getGlobalDevice();
     if (!rhiDev) {
         std::cerr << "No global RHI device available!" << std::endl;
@@ -103,6 +263,9 @@ bool Shader::compileShader(std::shared_ptr<RHI::IRHIShader>& shader,
     if (format == RHI::ShaderSourceFormat::SPIRV) {
         desc.entryPoint = (type == RHI::ShaderType::Vertex) ? "VSMain" : "PSMain";
     }
+    // Keyword values of a variant; GLSL sources have no specialization constants and ignore them
+    desc.specializationConstants = specialization.data();
+    desc.numSpecializationConstants = static_cast<uint32_t>(specialization.size());
     
     // Create and compile shader
     shader = rhiDev->createShader(desc);
@@ -111,7 +274,8 @@ bool Shader::compileShader(std::shared_ptr<RHI::IRHIShader>& shader,
         return false;
     }
     
-    if (!shader->compile()) {
+    // An asynchronous compile only reports submission errors; the rest surface at link time
+    if (!(async ? shader->compileAsync() : shader->compile())) {
         std::cerr << "Shader compilation failed: " << shader->getCompileErrors() << std::endl;
         return false;
     }
@@ -119,28 +283,42 @@ bool Shader::compileShader(std::shared_ptr<RHI::IRHIShader>& shader,
     return true;
 }
 
-bool Shader::linkProgram() {
+std::shared_ptr<RHI::IRHIShaderProgram> Shader::createProgram() {
     auto rhiDev = RHI::getGlobalDevice();
     if (!rhiDev) {
         std::cerr << "No global RHI device available!" << std::endl;
-        return false;
+        return nullptr;
     }
     
     if (!vertexShader || !fragmentShader) {
         std::cerr << "Shaders not compiled!" << std::endl;
-        return false;
+        return nullptr;
     }
     
     // Create shader program
     auto newProgram = rhiDev->createShaderProgram();
     if (!newProgram || !newProgram->isValid()) {
         std::cerr << "Failed to create shader program!" << std::endl;
-        return false;
+        return nullptr;
     }
     
     // Attach shaders
     newProgram->attachShader(vertexShader.get());
     newProgram->attachShader(fragmentShader.get());
+    return newProgram;
+}
+
+bool Shader::linkProgram() {
+    STARTUP_SCOPE("Shader", "Link " + vertexPath + " | " + fragmentPath);
+
+    // A synchronous link supersedes any link still in flight
+    pendingProgram.reset();
+    pendingStages.clear();
+    
+    auto newProgram = createProgram();
+    if (!newProgram) {
+        return false;
+    }
     
     // Link program
     if (!newProgram->link()) {
@@ -148,6 +326,70 @@ bool Shader::linkProgram() {
         return false;
     }
     
+    return activateProgram(newProgram);
+}
+
+bool Shader::linkProgramAsync() {
+    auto newProgram = createProgram();
+    if (!newProgram) {
+        return false;
+    }
+    
+    if (!newProgram->linkAsync()) {
+        std::cerr << "Shader linking failed: " << newProgram->getLinkErrors() << std::endl;
+        return false;
+    }
+    
+    // The stages have to outlive the link; a newer compile replaces vertexShader/fragmentShader
+    pendingProgram = newProgram;
+    pendingStages = { vertexShader, fragmentShader };
+    return true;
+}
+
+bool Shader::updatePendingLink() {
+    if (!pendingProgram || !pendingProgram->isReady()) {
+        return false;
+    }
+    
+    auto newProgram = std::move(pendingProgram);
+    pendingProgram.reset();
+    pendingStages.clear();
+    
+    // Ready, so this does not stall
+    if (!newProgram->link()) {
+        std::cerr << "Shader linking failed: " << newProgram->getLinkErrors() << std::endl;
+        return false;
+    }
+    return activateProgram(newProgram);
+}
+
+void Shader::setPlaceholderShader(std::shared_ptr<Shader> shader) {
+    placeholderShader = std::move(shader);
+}
+
+Shader* Shader::getPlaceholder() const {
+    if (hasProgram()) {
+        return nullptr;
+    }
+    // A variant renders with its base shader until its own program is ready
+    if (auto base = variantBase.lock()) {
+        if (base->hasProgram()) {
+            return base.get();
+        }
+    }
+    if (!placeholderShader || placeholderShader.get() == this || !placeholderShader->hasProgram()) {
+        return nullptr;
+    }
+    return placeholderShader.get();
+}
+
+bool Shader::activateProgram(const std::shared_ptr<RHI::IRHIShaderProgram>& newProgram) {
+    auto rhiDev = RHI::getGlobalDevice();
+    if (!rhiDev) {
+        std::cerr << "No global RHI device available!" << std::endl;
+        return false;
+    }
+    
     // --- UBO automatic setup using RHI reflection ---
     ProgramUBOCache cache;
     auto uniformBlocks = newProgram->getUniformBlocks();
@@ -167,6 +409,7 @@ bool Shader::linkProgram() {
         usedBindings.insert(bindingPoint);
         
         // Create UBO via RHI
+        const std::string& blockName = block.name.ToString();
         if (block.size > 0) {
             auto rhiUB = rhiDev->createUniformBuffer(block.size, bindingPoint);
             if (!rhiUB) {
@@ -174,13 +417,13 @@ bool Shader::linkProgram() {
                           << "' (binding " << bindingPoint << ")" << std::endl;
             } else {
                 // Categorize UBOs based on name
-                if (block.name.find("PerFrame") != std::string::npos) {
+                if (blockName.find("PerFrame") != std::string::npos) {
                     perFrameUBO = rhiUB;
                     perFrameUBOSize = block.size;
-                } else if (block.name.find("Light") != std::string::npos) {
+                } else if (blockName.find("Light") != std::string::npos) {
                     lightUBO = rhiUB;
                     lightUBOSize = block.size;
-                } else if (block.name.find("Material") != std::string::npos) {
+                } else if (blockName.find("Material") != std::string::npos) {
                     materialUBO = rhiUB;
                     materialUBOSize = block.size;
                 }
@@ -220,21 +463,22 @@ bool Shader::linkProgram() {
             continue;
         }
         
-        auto store = [&](const std::string& key) {
+        auto store = [&](const FName& key) {
             cache.vars[key] = {uboID, var.offset};
         };
         
         store(var.name);
         
         // Store short name variants (for compatibility)
-        size_t arr = var.name.find('[');
+        const std::string& varName = var.name.ToString();
+        size_t arr = varName.find('[');
         if (arr != std::string::npos) {
-            store(var.name.substr(0, arr));
+            store(varName.substr(0, arr));
         }
         
-        size_t lastDot = var.name.find_last_of('.');
+        size_t lastDot = varName.find_last_of('.');
         if (lastDot != std::string::npos) {
-            std::string shortName = var.name.substr(lastDot + 1);
+            std::string shortName = varName.substr(lastDot + 1);
             size_t sArr = shortName.find('[');
             if (sArr != std::string::npos) {
                 shortName = shortName.substr(0, sArr);
@@ -276,188 +520,226 @@ uintptr_t Shader::getID() const {
 }
 
 // Uniform setters using RHI
-void Shader::setFloat(const std::string& name, float value) {
+void Shader::setFloat(const FName& name, float value) {
+    if (Shader* placeholder = getPlaceholder()) {
+        placeholder->setFloat(name, value);
+        return;
+    }
     if (shaderProgram && shaderProgram->isValid()) {
         shaderProgram->setUniformFloat(name, value);
     }
 }
 
-void Shader::setVec2(const std::string& name, float x, float y) {
+void Shader::setVec2(const FName& name, float x, float y) {
+    if (Shader* placeholder = getPlaceholder()) {
+        placeholder->setVec2(name, x, y);
+        return;
+    }
     if (shaderProgram && shaderProgram->isValid()) {
         shaderProgram->setUniformVec2(name, x, y);
     }
 }
 
-void Shader::setVec3(const std::string& name, float x, float y, float z) {
+void Shader::setVec3(const FName& name, float x, float y, float z) {
+    if (Shader* placeholder = getPlaceholder()) {
+        placeholder->setVec3(name, x, y, z);
+        return;
+    }
     if (shaderProgram && shaderProgram->isValid()) {
         shaderProgram->setUniformVec3(name, x, y, z);
     }
 }
 
-void Shader::setVec4(const std::string& name, float x, float y, float z, float w) {
+void Shader::setVec4(const FName& name, float x, float y, float z, float w) {
+    if (Shader* placeholder = getPlaceholder()) {
+        placeholder->setVec4(name, x, y, z, w);
+        return;
+    }
     if (shaderProgram && shaderProgram->isValid()) {
         shaderProgram->setUniformVec4(name, x, y, z, w);
     }
 }
 
-void Shader::setInt(const std::string& name, int value) {
+void Shader::setInt(const FName& name, int value) {
+    if (Shader* placeholder = getPlaceholder()) {
+        placeholder->setInt(name, value);
+        return;
+    }
     if (shaderProgram && shaderProgram->isValid()) {
         shaderProgram->setUniformInt(name, value);
     }
 }
 
-void Shader::setBool(const std::string& name, bool value) {
+void Shader::setBool(const FName& name, bool value) {
+    if (Shader* placeholder = getPlaceholder()) {
+        placeholder->setBool(name, value);
+        return;
+    }
     if (shaderProgram && shaderProgram->isValid()) {
         shaderProgram->setUniformBool(name, value);
     }
 }
 
-void Shader::setMatrix4(const std::string& name, const float* value) {
+void Shader::setMatrix4(const FName& name, const float* value) {
+    if (Shader* placeholder = getPlaceholder()) {
+        placeholder->setMatrix4(name, value);
+        return;
+    }
     if (shaderProgram && shaderProgram->isValid()) {
         shaderProgram->setUniformMatrix4(name, value);
     }
 }
 
+// Uniform names used by the per-frame helpers; interned once instead of every frame.
+static const FName NAME_Model("model");
+static const FName NAME_View("view");
+static const FName NAME_Projection("projection");
+static const FName NAME_LightPos("lightPos");
+static const FName NAME_LightColor("lightColor");
+static const FName NAME_ViewPos("viewPos");
+
+// Block contents are rewritten for every draw. They go to the device's per-frame streaming memory
+// when it has room, so no draw waits for the previous one to finish reading the block's UBO.
+// Otherwise the UBO is updated (and rebound, in case a streamed range took its binding point).
+static void uploadUniformBlock(RHI::IRHIUniformBuffer& ubo, const void* data, size_t size, size_t blockSize = 0) {
+    blockSize = std::max(size, blockSize);
+    if (auto rhiDev = RHI::getGlobalDevice()) {
+        RHI::TransientAllocation allocation = rhiDev->allocateTransient(blockSize);
+        if (allocation.isValid()) {
+            memcpy(allocation.data, data, size);
+            memset(static_cast<unsigned char*>(allocation.data) + size, 0, blockSize - size);
+            rhiDev->bindUniformBufferRange(ubo.getBinding(), allocation.buffer, allocation.offset, blockSize);
+            return;
+        }
+    }
+    ubo.update(data, size, 0);
+    ubo.bind(ubo.getBinding());
+}
+
 void Shader::setPerFrameMatrices(const float* model, const float* view, const float* projection) {
+    if (Shader* placeholder = getPlaceholder()) {
+        placeholder->setPerFrameMatrices(model, view, projection);
+        return;
+    }
     // If we have a typed RHI-backed PerFrame UBO, assemble and update it
     if (perFrameUBO && perFrameUBO->isValid() && perFrameUBOSize > 0) {
-        std::vector<unsigned char> block(perFrameUBOSize);
+        // Per-frame scratch; the usual block sizes fit inline so this never hits the heap
+        TInlineArray<unsigned char, 256> block;
+        block.SetNum(perFrameUBOSize);
         uintptr_t programID = getID();
         
         if (g_ProgramUBOs.count(programID)) {
-            auto& cache = g_ProgramUBOs[programID];
-            auto findOffset = [&](const std::string& field) -> int32_t {
-                // exact match
-                auto it = cache.vars.find(field);
-                if (it != cache.vars.end()) return it->second.offset;
-                
-                // .suffix match
-                std::string dot = std::string(".") + field;
-                for (const auto& kv : cache.vars) {
-                    if (kv.first.size() > dot.size() && 
-                        kv.first.compare(kv.first.size() - dot.size(), dot.size(), dot) == 0) {
-                        return kv.second.offset;
-                    }
-                }
-                
-                // ends with field
-                for (const auto& kv : cache.vars) {
-                    if (kv.first.size() >= field.size() && 
-                        kv.first.compare(kv.first.size() - field.size(), field.size(), field) == 0) {
-                        return kv.second.offset;
-                    }
-                }
-                return -1;
-            };
-
-            int32_t offModel = findOffset("model");
-            if (offModel >= 0) memcpy(block.data() + offModel, model, sizeof(float) * 16);
+            int32_t offModel = getUBOOffset(NAME_Model);
+            if (offModel >= 0) memcpy(block.GetData() + offModel, model, sizeof(float) * 16);
             
-            int32_t offView = findOffset("view");
-            if (offView >= 0) memcpy(block.data() + offView, view, sizeof(float) * 16);
+            int32_t offView = getUBOOffset(NAME_View);
+            if (offView >= 0) memcpy(block.GetData() + offView, view, sizeof(float) * 16);
             
-            int32_t offProj = findOffset("projection");
-            if (offProj >= 0) memcpy(block.data() + offProj, projection, sizeof(float) * 16);
+            int32_t offProj = getUBOOffset(NAME_Projection);
+            if (offProj >= 0) memcpy(block.GetData() + offProj, projection, sizeof(float) * 16);
         } else {
             // Best-effort contiguous layout
-            memcpy(block.data(), model, sizeof(float) * 16);
-            memcpy(block.data() + sizeof(float) * 16, view, sizeof(float) * 16);
-            memcpy(block.data() + sizeof(float) * 32, projection, sizeof(float) * 16);
+            memcpy(block.GetData(), model, sizeof(float) * 16);
+            memcpy(block.GetData() + sizeof(float) * 16, view, sizeof(float) * 16);
+            memcpy(block.GetData() + sizeof(float) * 32, projection, sizeof(float) * 16);
         }
 
-        perFrameUBO->update(block.data(), block.size(), 0);
+        uploadUniformBlock(*perFrameUBO, block.GetData(), block.Num());
         return;
     }
 
     // Fallback to direct uniforms
-    setMatrix4("model", model);
-    setMatrix4("view", view);
-    setMatrix4("projection", projection);
+    setMatrix4(NAME_Model, model);
+    setMatrix4(NAME_View, view);
+    setMatrix4(NAME_Projection, projection);
 }
 
 void Shader::setLightData(const float* lightPos, const float* lightColor, const float* viewPos) {
+    if (Shader* placeholder = getPlaceholder()) {
+        placeholder->setLightData(lightPos, lightColor, viewPos);
+        return;
+    }
     if (lightUBO && lightUBO->isValid() && lightUBOSize > 0) {
-        std::vector<unsigned char> block(lightUBOSize);
+        // Per-frame scratch; the usual block sizes fit inline so this never hits the heap
+        TInlineArray<unsigned char, 256> block;
+        block.SetNum(lightUBOSize);
         uintptr_t programID = getID();
         
         if (g_ProgramUBOs.count(programID)) {
-            auto& cache = g_ProgramUBOs[programID];
-            auto findOffset = [&](const std::string& field) -> int32_t {
-                auto it = cache.vars.find(field);
-                if (it != cache.vars.end()) return it->second.offset;
-                
-                std::string dot = std::string(".") + field;
-                for (const auto& kv : cache.vars) {
-                    if (kv.first.size() > dot.size() && 
-                        kv.first.compare(kv.first.size() - dot.size(), dot.size(), dot) == 0) {
-                        return kv.second.offset;
-                    }
-                }
-                
-                for (const auto& kv : cache.vars) {
-                    if (kv.first.size() >= field.size() && 
-                        kv.first.compare(kv.first.size() - field.size(), field.size(), field) == 0) {
-                        return kv.second.offset;
-                    }
-                }
-                return -1;
-            };
-
-            int32_t offLP = findOffset("lightPos");
-            if (offLP >= 0) memcpy(block.data() + offLP, lightPos, sizeof(float) * 3);
+            int32_t offLP = getUBOOffset(NAME_LightPos);
+            if (offLP >= 0) memcpy(block.GetData() + offLP, lightPos, sizeof(float) * 3);
             
-            int32_t offLC = findOffset("lightColor");
-            if (offLC >= 0) memcpy(block.data() + offLC, lightColor, sizeof(float) * 3);
+            int32_t offLC = getUBOOffset(NAME_LightColor);
+            if (offLC >= 0) memcpy(block.GetData() + offLC, lightColor, sizeof(float) * 3);
             
-            int32_t offVP = findOffset("viewPos");
-            if (offVP >= 0) memcpy(block.data() + offVP, viewPos, sizeof(float) * 3);
+            int32_t offVP = getUBOOffset(NAME_ViewPos);
+            if (offVP >= 0) memcpy(block.GetData() + offVP, viewPos, sizeof(float) * 3);
         } else {
-            memcpy(block.data(), lightPos, sizeof(float) * 3);
-            memcpy(block.data() + sizeof(float) * 4, lightColor, sizeof(float) * 3);
-            memcpy(block.data() + sizeof(float) * 8, viewPos, sizeof(float) * 3);
+            memcpy(block.GetData(), lightPos, sizeof(float) * 3);
+            memcpy(block.GetData() + sizeof(float) * 4, lightColor, sizeof(float) * 3);
+            memcpy(block.GetData() + sizeof(float) * 8, viewPos, sizeof(float) * 3);
         }
 
-        lightUBO->update(block.data(), block.size(), 0);
+        uploadUniformBlock(*lightUBO, block.GetData(), block.Num());
         return;
     }
 
     // Fallback to direct uniforms
-    setVec3("lightPos", lightPos[0], lightPos[1], lightPos[2]);
-    setVec3("lightColor", lightColor[0], lightColor[1], lightColor[2]);
-    setVec3("viewPos", viewPos[0], viewPos[1], viewPos[2]);
+    setVec3(NAME_LightPos, lightPos[0], lightPos[1], lightPos[2]);
+    setVec3(NAME_LightColor, lightColor[0], lightColor[1], lightColor[2]);
+    setVec3(NAME_ViewPos, viewPos[0], viewPos[1], viewPos[2]);
 }
 
 void Shader::updateMaterialBlock(const void* data, size_t size) {
+    if (Shader* placeholder = getPlaceholder()) {
+        placeholder->updateMaterialBlock(data, size);
+        return;
+    }
     if (materialUBO && materialUBO->isValid() && materialUBOSize >= size) {
-        materialUBO->update(data, size, 0);
+        uploadUniformBlock(*materialUBO, data, size, materialUBOSize);
     } else {
         LOG("updateMaterialBlock: no material UBO available for program " << getID());
     }
 }
 
-int32_t Shader::getUBOOffset(const std::string& field) const {
+size_t Shader::getMaterialUBOSize() const {
+    if (Shader* placeholder = getPlaceholder()) {
+        return placeholder->getMaterialUBOSize();
+    }
+    return materialUBOSize;
+}
+
+int32_t Shader::getUBOOffset(const FName& field) const {
+    if (Shader* placeholder = getPlaceholder()) {
+        return placeholder->getUBOOffset(field);
+    }
     uintptr_t programID = getID();
-    if (!g_ProgramUBOs.count(programID)) return -1;
+    auto cacheIt = g_ProgramUBOs.find(programID);
+    if (cacheIt == g_ProgramUBOs.end()) return -1;
     
-    const auto& cache = g_ProgramUBOs.at(programID);
+    const auto& cache = cacheIt->second;
     
-    // exact match
+    // exact match (short names are stored at link time, so this is the common path). All three
+    // matches are case-sensitive: "Albedo" must not resolve to a member declared as "albedo".
     auto it = cache.vars.find(field);
     if (it != cache.vars.end()) return it->second.offset;
     
     // dot-suffix match
-    std::string dot = std::string(".") + field;
+    const std::string& fieldStr = field.ToString();
+    std::string dot = std::string(".") + fieldStr;
     for (const auto& kv : cache.vars) {
-        if (kv.first.size() > dot.size() && 
-            kv.first.compare(kv.first.size() - dot.size(), dot.size(), dot) == 0) {
+        const std::string& key = kv.first.ToString();
+        if (key.size() > dot.size() && 
+            key.compare(key.size() - dot.size(), dot.size(), dot) == 0) {
             return kv.second.offset;
         }
     }
     
     // ends-with match
     for (const auto& kv : cache.vars) {
-        if (kv.first.size() >= field.size() && 
-            kv.first.compare(kv.first.size() - field.size(), field.size(), field) == 0) {
+        const std::string& key = kv.first.ToString();
+        if (key.size() >= fieldStr.size() && 
+            key.compare(key.size() - fieldStr.size(), fieldStr.size(), fieldStr) == 0) {
             return kv.second.offset;
         }
     }
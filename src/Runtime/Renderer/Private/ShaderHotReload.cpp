@@ -0,0 +1,127 @@
+#include "ShaderHotReload.h"
+#include "Shader.h"
+#include "ShaderCooker.h"
+#include "Misc/Path.h"
+#include <algorithm>
+#include <filesystem>
+
+namespace CarrotToy {
+
+static std::string toAbsolutePath(const std::string& path) {
+    std::error_code ec;
+    std::filesystem::path absolute = std::filesystem::absolute(path, ec);
+    return (ec ? std::filesystem::path(path) : absolute).lexically_normal().generic_string();
+}
+
+// Files the cooker itself writes when sources and outputs share a folder tree: its state, the
+// archive and its temporary files, and .spv files cooked from an .hlsl next to them. Reacting to
+// them would make every cook trigger the next one.
+static bool isCookerOutput(const std::string& path) {
+    const std::filesystem::path file(path);
+    const std::string extension = file.extension().string();
+    if (file.filename() == ".cookstate" || extension == ".pak" || extension == ".tmp") {
+        return true;
+    }
+    if (extension == ".spv") {
+        std::error_code ec;
+        return std::filesystem::exists(std::filesystem::path(file).replace_extension(".hlsl"), ec);
+    }
+    return false;
+}
+
+ShaderHotReloader::~ShaderHotReloader() {
+    stop();
+}
+
+bool ShaderHotReloader::start(const std::string& inSourceDir, const std::string& inOutputDir, const std::string& inCompilerPath) {
+    stop();
+
+    // Cooking a folder onto itself copies every file onto itself and rewrites the watched folder
+    // on each cook
+    std::error_code ec;
+    if (std::filesystem::equivalent(inSourceDir, inOutputDir, ec)) {
+        LOG("ShaderHotReloader: Source and output are both " << toAbsolutePath(inSourceDir) << ", hot reload disabled");
+        return false;
+    }
+    if (!watcher.Start(inSourceDir)) {
+        return false;
+    }
+    sourceDir = inSourceDir;
+    outputDir = toAbsolutePath(inOutputDir);
+    compilerPath = inCompilerPath.empty() ? FShaderCooker::GetLastCompilerPath(outputDir) : inCompilerPath;
+
+    LOG("ShaderHotReloader: Watching " << watcher.GetDirectory() << (watcher.IsPolling() ? " (polling)" : " (inotify)"));
+    if (compilerPath.empty()) {
+        LOG("ShaderHotReloader: Warning - no shader compiler known for " << outputDir << ", HLSL changes will not be compiled");
+    }
+    return true;
+}
+
+void ShaderHotReloader::stop() {
+    watcher.Stop();
+    if (cookThread.joinable()) {
+        cookThread.join();
+    }
+    cookFinished = false;
+    cookRequested = false;
+}
+
+void ShaderHotReloader::tick() {
+    if (!watcher.IsRunning()) return;
+
+    for (const FString& path : watcher.ConsumeChanges()) {
+        if (!isCookerOutput(path)) {
+            cookRequested = true;
+        }
+    }
+
+    if (cookThread.joinable() && cookFinished) {
+        cookThread.join();
+        cookFinished = false;
+        reloadCookedShaders();
+    }
+
+    // Changes made while a cook is running are picked up by the next one
+    if (cookRequested && !cookThread.joinable()) {
+        cookRequested = false;
+        startCook();
+    }
+}
+
+void ShaderHotReloader::startCook() {
+    FShaderCookOptions options;
+    options.SourceDir = sourceDir;
+    options.OutputDir = outputDir;
+    options.ArchivePath = outputDir + "/Shaders.pak";
+    options.CompilerPath = compilerPath;
+
+    cookedFiles.clear();
+    cookThread = std::thread([this, options]() {
+        FShaderCooker cooker(options);
+        cooker.Cook();
+        for (const FString& output : cooker.GetCookedOutputs()) {
+            cookedFiles.push_back(outputDir + "/" + output);
+        }
+        cookFinished = true;
+    });
+}
+
+void ShaderHotReloader::reloadCookedShaders() {
+    if (cookedFiles.empty()) return;
+
+    auto isCooked = [this](const std::string& path) {
+        return std::find(cookedFiles.begin(), cookedFiles.end(), toAbsolutePath(path)) != cookedFiles.end();
+    };
+
+    // Variants follow their base shader
+    Shader::forEachShader([&](Shader& shader) {
+        if (shader.isVariant()) return;
+        if (isCooked(shader.getVertexPath()) || isCooked(shader.getFragmentPath())) {
+            LOG("ShaderHotReloader: Reloading " << shader.getVertexPath() << " | " << shader.getFragmentPath());
+            shader.reloadAsync();
+        }
+    });
+    cookedFiles.clear();
+}
+
+} // namespace CarrotToy
@@ -0,0 +1,98 @@
+#include "ShaderKeywords.h"
+
+namespace CarrotToy {
+
+bool ShaderKeywordLayout::declareBool(const FName& name, uint32_t constantID, bool defaultValue) {
+    ShaderKeyword keyword;
+    keyword.name = name;
+    keyword.constantID = constantID;
+    keyword.defaultValue = defaultValue ? 1u : 0u;
+    return addKeyword(std::move(keyword));
+}
+
+bool ShaderKeywordLayout::declareEnum(const FName& name, uint32_t constantID, std::vector<std::string> valueNames, uint32_t defaultValue) {
+    if (valueNames.size() < 2 || defaultValue >= valueNames.size()) {
+        LOG("ShaderKeywordLayout: Enum keyword " << name << " needs at least two values and a valid default");
+        return false;
+    }
+    ShaderKeyword keyword;
+    keyword.name = name;
+    keyword.constantID = constantID;
+    keyword.valueNames = std::move(valueNames);
+    keyword.defaultValue = defaultValue;
+    return addKeyword(std::move(keyword));
+}
+
+bool ShaderKeywordLayout::addKeyword(ShaderKeyword keyword) {
+    if (findKeyword(keyword.name)) {
+        LOG("ShaderKeywordLayout: Keyword " << keyword.name << " is already declared");
+        return false;
+    }
+
+    keyword.bitCount = 1;
+    while ((1u << keyword.bitCount) < keyword.getNumValues()) {
+        ++keyword.bitCount;
+    }
+    if (usedBits + keyword.bitCount > 64) {
+        LOG("ShaderKeywordLayout: No room for keyword " << keyword.name << " in the 64-bit variant mask");
+        return false;
+    }
+    keyword.bitOffset = usedBits;
+    usedBits += keyword.bitCount;
+
+    defaultMask |= static_cast<ShaderKeywordMask>(keyword.defaultValue) << keyword.bitOffset;
+    keywords.push_back(std::move(keyword));
+    return true;
+}
+
+const ShaderKeyword* ShaderKeywordLayout::findKeyword(const FName& name) const {
+    for (const ShaderKeyword& keyword : keywords) {
+        if (keyword.name == name) {
+            return &keyword;
+        }
+    }
+    return nullptr;
+}
+
+uint32_t ShaderKeywordLayout::extract(ShaderKeywordMask mask, const ShaderKeyword& keyword) {
+    const ShaderKeywordMask bits = (ShaderKeywordMask(1) << keyword.bitCount) - 1;
+    return static_cast<uint32_t>((mask >> keyword.bitOffset) & bits);
+}
+
+uint32_t ShaderKeywordLayout::getValue(ShaderKeywordMask mask, const FName& name) const {
+    const ShaderKeyword* keyword = findKeyword(name);
+    return keyword ? extract(mask, *keyword) : 0;
+}
+
+ShaderKeywordMask ShaderKeywordLayout::setValue(ShaderKeywordMask mask, const FName& name, uint32_t value) const {
+    const ShaderKeyword* keyword = findKeyword(name);
+    if (!keyword || value >= keyword->getNumValues()) {
+        return mask;
+    }
+    const ShaderKeywordMask bits = ((ShaderKeywordMask(1) << keyword->bitCount) - 1) << keyword->bitOffset;
+    return (mask & ~bits) | (static_cast<ShaderKeywordMask>(value) << keyword->bitOffset);
+}
+
+std::vector<RHI::ShaderSpecializationConstant> ShaderKeywordLayout::getSpecializationConstants(ShaderKeywordMask mask) const {
+    std::vector<RHI::ShaderSpecializationConstant> constants;
+    constants.reserve(keywords.size());
+    for (const ShaderKeyword& keyword : keywords) {
+        constants.push_back({ keyword.constantID, extract(mask, keyword) });
+    }
+    return constants;
+}
+
+std::string ShaderKeywordLayout::describe(ShaderKeywordMask mask) const {
+    std::string result;
+    for (const ShaderKeyword& keyword : keywords) {
+        const uint32_t value = extract(mask, keyword);
+        if (!result.empty()) {
+            result += ' ';
+        }
+        result += keyword.name.ToString() + "=";
+        result += (keyword.isBool() || value >= keyword.valueNames.size()) ? std::to_string(value) : keyword.valueNames[value];
+    }
+    return result;
+}
+
+} // namespace CarrotToy
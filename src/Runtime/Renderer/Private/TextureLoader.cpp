@@ -0,0 +1,197 @@
+#include "TextureLoader.h"
+#include "CoreUtils.h"
+#include "Image/TextureCompression.h"
+#include <algorithm>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+namespace CarrotToy {
+
+struct TextureLoader::DecodedImage {
+    Request request;
+    std::unique_ptr<stbi_uc, void (*)(void*)> texels{ nullptr, stbi_image_free };
+    uint32_t width = 0;
+    uint32_t height = 0;
+    // Compressed formats only: encoded mip levels, level 0 first
+    std::vector<TArray<uint8_t>> mips;
+    // Next level to upload; an image can span several frames of upload budget
+    uint32_t nextMip = 0;
+    // Created by tick(); kept while the staging memory is full
+    std::shared_ptr<RHI::IRHITexture> texture;
+};
+
+TextureLoader& TextureLoader::getInstance() {
+    static TextureLoader instance;
+    return instance;
+}
+
+TextureLoader::~TextureLoader() {
+    shutdown();
+}
+
+static EBlockCompression toBlockCompression(RHI::TextureFormat format) {
+    switch (format) {
+        case RHI::TextureFormat::BC1: return EBlockCompression::BC1;
+        case RHI::TextureFormat::BC3: return EBlockCompression::BC3;
+        case RHI::TextureFormat::BC5: return EBlockCompression::BC5;
+        default:                      return EBlockCompression::BC7;
+    }
+}
+
+void TextureLoader::load(const std::string& path, Callback onLoaded, bool generateMipmaps, RHI::TextureFormat format) {
+    auto device = RHI::getGlobalDevice();
+    if (RHI::isCompressedFormat(format) && device && !device->supportsTextureFormat(format)) {
+        LOG("TextureLoader: Compressed format not supported by the device, loading " << path << " as RGBA8");
+        format = RHI::TextureFormat::RGBA8;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (workers.empty()) {
+        // Leave a core for the main thread
+        const unsigned int hardwareThreads = std::max(2u, std::thread::hardware_concurrency());
+        const unsigned int numWorkers = std::min(4u, hardwareThreads - 1);
+        stopping = false;
+        for (unsigned int i = 0; i < numWorkers; ++i) {
+            workers.emplace_back(&TextureLoader::workerMain, this);
+        }
+    }
+    requests.push_back({ path, generateMipmaps, format, std::move(onLoaded) });
+    wakeWorkers.notify_one();
+}
+
+void TextureLoader::workerMain() {
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeWorkers.wait(lock, [this]() { return stopping || !requests.empty(); });
+            if (stopping) return;
+            request = std::move(requests.front());
+            requests.pop_front();
+        }
+
+        auto image = std::make_unique<DecodedImage>();
+        int width = 0, height = 0, channels = 0;
+        image->texels.reset(stbi_load(request.path.c_str(), &width, &height, &channels, 4));
+        if (image->texels) {
+            image->width = static_cast<uint32_t>(width);
+            image->height = static_cast<uint32_t>(height);
+        } else {
+            LOG("TextureLoader: Failed to load " << request.path << ": " << stbi_failure_reason());
+        }
+        image->request = std::move(request);
+        if (image->texels && RHI::isCompressedFormat(image->request.format)) {
+            compress(*image);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        decoded.push_back(std::move(image));
+    }
+}
+
+void TextureLoader::compress(DecodedImage& image) {
+    const EBlockCompression blockFormat = toBlockCompression(image.request.format);
+    image.mips.push_back(FTextureCompression::Compress(blockFormat, image.texels.get(), image.width, image.height));
+    if (!image.request.generateMipmaps) return;
+
+    // Mips are filtered from the uncompressed level above, not from the decoded blocks
+    TArray<uint8_t> level;
+    const uint8_t* source = image.texels.get();
+    uint32_t width = image.width, height = image.height;
+    while (width > 1 || height > 1) {
+        level = FTextureCompression::DownsampleRGBA8(source, width, height);
+        width = std::max(1u, width / 2);
+        height = std::max(1u, height / 2);
+        source = level.GetData();
+        image.mips.push_back(FTextureCompression::Compress(blockFormat, source, width, height));
+    }
+}
+
+void TextureLoader::tick() {
+    auto device = RHI::getGlobalDevice();
+    if (!device) return;
+
+    size_t uploaded = 0;
+    for (;;) {
+        DecodedImage* image = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (decoded.empty()) break;
+            image = decoded.front().get();
+        }
+
+        if (!image->texels) {
+            if (image->request.onLoaded) image->request.onLoaded(nullptr);
+        } else {
+            // Uncompressed images upload level 0 and let the GPU generate the rest
+            const bool compressed = !image->mips.empty();
+            if (!image->texture) {
+                RHI::TextureDesc desc;
+                desc.width = image->width;
+                desc.height = image->height;
+                desc.format = compressed ? image->request.format : RHI::TextureFormat::RGBA8;
+                desc.mipLevels = compressed ? static_cast<uint32_t>(image->mips.size()) : 0;
+                desc.generateMipmaps = !compressed && image->request.generateMipmaps;
+                const bool mipmapped = desc.mipLevels > 1 || desc.generateMipmaps;
+                desc.minFilter = mipmapped ? RHI::TextureFilter::LinearMipmapLinear : RHI::TextureFilter::Linear;
+                image->texture = device->createTexture(desc);
+            }
+
+            const uint32_t levelCount = compressed ? static_cast<uint32_t>(image->mips.size()) : 1;
+            bool stalled = false;
+            for (; image->nextMip < levelCount; ++image->nextMip) {
+                const uint32_t level = image->nextMip;
+                const void* texels = compressed ? image->mips[level].GetData() : image->texels.get();
+                const size_t size = compressed ? image->mips[level].Num()
+                                               : RHI::getTextureDataSize(RHI::TextureFormat::RGBA8, image->width, image->height);
+                if (uploaded > 0 && uploaded + size > uploadBudget) {
+                    stalled = true;
+                    break;
+                }
+
+                RHI::TextureRegion region;
+                region.width = RHI::getMipSize(image->width, level);
+                region.height = RHI::getMipSize(image->height, level);
+                region.mipLevel = level;
+                // Uploads complete in order, so the last level completing means the texture is whole
+                std::function<void()> onComplete;
+                if (level + 1 == levelCount) {
+                    auto texture = image->texture;
+                    Callback onLoaded = image->request.onLoaded;
+                    onComplete = [texture, onLoaded]() {
+                        if (onLoaded) onLoaded(texture);
+                    };
+                }
+                // Staging memory is full until earlier uploads finish
+                if (!device->uploadTextureAsync(image->texture.get(), region, texels, std::move(onComplete))) {
+                    stalled = true;
+                    break;
+                }
+                uploaded += size;
+            }
+            if (stalled) break;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        decoded.pop_front();
+    }
+}
+
+void TextureLoader::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    requests.clear();
+    decoded.clear();
+}
+
+} // namespace CarrotToy
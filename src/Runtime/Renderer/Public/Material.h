@@ -22,39 +22,71 @@ enum class ShaderParamType {
 
 // Shader parameter structure
 struct ShaderParameter {
-    std::string name;
+    FName name;
     ShaderParamType type;
     void* data;
     
-    ShaderParameter(const std::string& name, ShaderParamType type, void* data)
+    ShaderParameter(const FName& name, ShaderParamType type, void* data)
         : name(name), type(type), data(data) {}
 };
 
 
 // Material class - represents a material with shader and parameters
-class RENDERER_API Material {
+class RENDERER_API Material : public std::enable_shared_from_this<Material> {
 public:
-    Material(const std::string& name, std::shared_ptr<Shader> shader);
+    Material(const FName& name, std::shared_ptr<Shader> shader);
     ~Material();
     
-    void bind();
+    // False when the material cannot be drawn: no shader, or a texture declared in the Material
+    // block has no bindless handle (see setTexture)
+    bool bind();
     void unbind();
     
     // Parameter management
-    void setFloat(const std::string& name, float value);
-    void setVec3(const std::string& name, float x, float y, float z);
-    void setVec4(const std::string& name, float x, float y, float z, float w);
-    void setTexture(const std::string& name, unsigned int textureID);
+    void setFloat(const FName& name, float value);
+    void setVec3(const FName& name, float x, float y, float z);
+    void setVec4(const FName& name, float x, float y, float z, float w);
+    // Textures are bound to consecutive texture units in parameter order. A shader that declares
+    // a texture in its Material block instead (GLSL: ARB_bindless_texture, layout(bindless_sampler))
+    // gets it as a resident handle when the device supports bindless textures, so switching
+    // between such materials only uploads the block and binds no textures. Only RHI textures
+    // have handles; a raw GL name, or any texture on a device without bindless support, cannot
+    // feed a sampler in the block and makes bind() fail.
+    void setTexture(const FName& name, unsigned int textureID);
+    void setTexture(const FName& name, std::shared_ptr<RHI::IRHITexture> texture);
+    // Loads the image in the background (see TextureLoader.h); the parameter is set once the
+    // texture is on the GPU. Needs the material to be owned by a shared_ptr. A compressed
+    // format is encoded on the loader's worker threads.
+    void loadTexture(const FName& name, const std::string& path,
+                     RHI::TextureFormat format = RHI::TextureFormat::RGBA8);
     
+    // Shader variant selected by the material's keywords
     std::shared_ptr<Shader> getShader() { return shader; }
-    std::string getName() const { return name; }
+    FName getName() const { return name; }
     
-    std::map<std::string, ShaderParameter>& getParameters() { return parameters; }
+    // Keywords select a variant of the base shader. Unknown keywords and values are ignored.
+    void setKeyword(const FName& keyword, uint32_t value);
+    uint32_t getKeyword(const FName& keyword) const;
+    ShaderKeywordMask getKeywordMask() const { return shader ? shader->getKeywordMask() : 0; }
+    const ShaderKeywordLayout* getKeywordLayout() const { return baseShader ? &baseShader->getKeywordLayout() : nullptr; }
+    
+    // Ordered alphabetically (case-insensitive), so the editor lists them in a stable order
+    std::map<FName, ShaderParameter, FNameLexicalLess>& getParameters() { return parameters; }
     
 private:
-    std::string name;
+    void setTextureParameter(const FName& name, unsigned int textureID);
+    // Bindless handle of an RHI texture parameter; 0 for raw GL names or without bindless support
+    uint64_t getTextureHandle(const FName& name) const;
+    
+    FName name;
+    std::shared_ptr<Shader> baseShader;
     std::shared_ptr<Shader> shader;
-    std::map<std::string, ShaderParameter> parameters;
+    std::map<FName, ShaderParameter, FNameLexicalLess> parameters;
+    // RHI textures set as parameters (including those from loadTexture()), kept alive while
+    // they are referenced by parameters. bind() takes their GL name from here, since it changes
+    // when the texture is resized; the parameter's own data is 0 for them.
+    std::map<FName, std::shared_ptr<RHI::IRHITexture>, FNameLexicalLess> textures;
+    bool warnedMissingHandle = false;
 };
 
 // Material Manager - manages all materials in the scene
@@ -62,15 +94,16 @@ class RENDERER_API MaterialManager {
 public:
     static MaterialManager& getInstance();
     
-    std::shared_ptr<Material> createMaterial(const std::string& name, std::shared_ptr<Shader> shader);
-    std::shared_ptr<Material> getMaterial(const std::string& name);
-    void removeMaterial(const std::string& name);
+    std::shared_ptr<Material> createMaterial(const FName& name, std::shared_ptr<Shader> shader);
+    std::shared_ptr<Material> getMaterial(const FName& name);
+    void removeMaterial(const FName& name);
     
-    std::map<std::string, std::shared_ptr<Material>>& getAllMaterials() { return materials; }
+    // Ordered alphabetically (case-insensitive)
+    std::map<FName, std::shared_ptr<Material>, FNameLexicalLess>& getAllMaterials() { return materials; }
     
 private:
     MaterialManager() = default;
-    std::map<std::string, std::shared_ptr<Material>> materials;
+    std::map<FName, std::shared_ptr<Material>, FNameLexicalLess> materials;
 };
 
 } // namespace CarrotToy
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "RHI/RHI.h"
+#include "RenderTargetPool.h"
+#include "RendererAPI.h"
+
+namespace CarrotToy {
+
+// Virtual texture of a RenderGraph; only meaningful for the graph that created it
+struct RenderGraphTexture {
+    static constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
+    uint32_t index = kInvalidIndex;
+
+    bool isValid() const { return index != kInvalidIndex; }
+};
+
+enum class RenderGraphLoadOp {
+    Load,   // Keep what earlier passes rendered
+    Clear
+};
+
+// A frame (or part of one) described as passes and the textures they read and write.
+//
+// Passes declare their accesses in a setup callback; nothing runs until execute(), which
+//  - culls passes whose results nothing reads: a pass survives only if it writes something a
+//    later pass reads, an imported or extracted texture, or the backbuffer,
+//  - gives each created texture a lifetime from its first to its last surviving access and takes
+//    the texture from the RenderTargetPool only for that span, so passes that do not overlap
+//    share targets,
+//  - binds the pass's render targets (cached framebuffers from the pool), sets the viewport to
+//    them and clears them when the pass asked for RenderGraphLoadOp::Clear, so no pass manages
+//    framebuffers or clears by hand,
+//  - inserts the memory barriers storage image writes need before their next access,
+//  - runs the passes in the order they were added. Accesses can only refer to textures created
+//    earlier, so that order respects every dependency.
+//
+// Recorded passes (addPass) write into their own RHI command list and may be recorded on worker
+// threads at the same time; they must not touch the device or GL directly. Immediate passes
+// (addImmediatePass) run on the calling thread at their place in the order and may use anything,
+// e.g. code that still draws with raw GL. A graph is built, executed and reset on the thread
+// owning the GL context.
+class RENDERER_API RenderGraph {
+public:
+    class Builder;
+    class Context;
+    using SetupFunc = std::function<void(Builder& builder)>;
+    using RecordFunc = std::function<void(const Context& context, RHI::IRHICommandList& commands)>;
+    using ExecuteFunc = std::function<void(const Context& context)>;
+
+    // What a pass declares about itself during setup
+    class RENDERER_API Builder {
+    public:
+        RenderGraphTexture createTexture(const FName& name, const RenderTargetDesc& desc);
+        // Sampled in shaders
+        void read(RenderGraphTexture texture);
+        // Storage image (IRHIDevice::bindStorageImage) access
+        void readStorage(RenderGraphTexture texture);
+        void writeStorage(RenderGraphTexture texture);
+        // Render targets; a pass has at most one color and one depth target. The backbuffer can
+        // be both, but not combined with created textures.
+        void setColorTarget(RenderGraphTexture texture, RenderGraphLoadOp loadOp,
+                            float r = 0.0f, float g = 0.0f, float b = 0.0f, float a = 1.0f);
+        void setDepthTarget(RenderGraphTexture texture, RenderGraphLoadOp loadOp, float depth = 1.0f);
+        // Never culled, e.g. because it writes something outside the graph
+        void setSideEffect();
+
+    private:
+        friend class RenderGraph;
+        Builder(RenderGraph& inGraph, uint32_t inPassIndex) : graph(inGraph), passIndex(inPassIndex) {}
+
+        RenderGraph& graph;
+        uint32_t passIndex;
+    };
+
+    // Given to the pass callbacks
+    class RENDERER_API Context {
+    public:
+        RHI::IRHITexture* getTexture(RenderGraphTexture texture) const { return graph.getTexture(texture); }
+        // For immediate passes only
+        RHI::IRHIDevice& getDevice() const { return device; }
+
+    private:
+        friend class RenderGraph;
+        Context(const RenderGraph& inGraph, RHI::IRHIDevice& inDevice) : graph(inGraph), device(inDevice) {}
+
+        const RenderGraph& graph;
+        RHI::IRHIDevice& device;
+    };
+
+    explicit RenderGraph(RenderTargetPool& pool);
+    ~RenderGraph();
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    // A pool texture alive only while passes use it
+    RenderGraphTexture createTexture(const FName& name, const RenderTargetDesc& desc);
+    // Textures owned outside the graph; their contents are kept, so their writers are never culled
+    RenderGraphTexture importTexture(const FName& name, RHI::IRHITexture* texture);
+    RenderGraphTexture importBackbuffer(uint32_t width, uint32_t height);
+    // Keeps a created texture acquired after execute() for getTexture(). The caller hands it back
+    // with RenderTargetPool::release once it is done with it.
+    void extractTexture(RenderGraphTexture texture);
+
+    void addPass(const FName& name, const SetupFunc& setup, RecordFunc record);
+    void addImmediatePass(const FName& name, const SetupFunc& setup, ExecuteFunc execute);
+
+    // Culls, computes lifetimes and barriers; execute() calls it when passes were added since
+    void compile();
+    // recordThreads > 1 records the recorded passes on that many threads at once. Leaves the
+    // default framebuffer bound.
+    void execute(RHI::IRHIDevice& device, uint32_t recordThreads = 1);
+    // Drops passes and textures (releasing extracted ones is up to their owner); keeps the
+    // command lists for the next frame
+    void reset();
+
+    // Imported textures, created ones while their passes run, extracted ones after execute()
+    RHI::IRHITexture* getTexture(RenderGraphTexture texture) const;
+
+    uint32_t getPassCount() const { return static_cast<uint32_t>(passes.size()); }
+    bool isPassCulled(uint32_t passIndex) const { return passes[passIndex].culled; }
+
+private:
+    enum class Access : uint8_t {
+        Sample,
+        StorageRead,
+        StorageWrite,
+        ColorTarget,
+        DepthTarget
+    };
+    struct ResourceAccess {
+        uint32_t resource;
+        Access access;
+    };
+    struct ResourceNode {
+        FName name;
+        RenderTargetDesc desc;
+        RHI::IRHITexture* texture = nullptr;
+        bool imported = false;
+        bool backbuffer = false;
+        bool extracted = false;
+        // Surviving passes using it first and last; kInvalidIndex when none does
+        uint32_t firstPass = RenderGraphTexture::kInvalidIndex;
+        uint32_t lastPass = RenderGraphTexture::kInvalidIndex;
+    };
+    struct PassNode {
+        FName name;
+        RecordFunc record;
+        ExecuteFunc execute;
+        std::vector<ResourceAccess> accesses;
+        uint32_t colorTarget = RenderGraphTexture::kInvalidIndex;
+        uint32_t depthTarget = RenderGraphTexture::kInvalidIndex;
+        RenderGraphLoadOp colorLoadOp = RenderGraphLoadOp::Load;
+        RenderGraphLoadOp depthLoadOp = RenderGraphLoadOp::Load;
+        float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        float clearDepth = 1.0f;
+        bool sideEffect = false;
+        bool culled = false;
+        RHI::BarrierFlags barriers = RHI::BarrierFlags::None;
+        RHI::IRHIFramebuffer* framebuffer = nullptr;
+        // Index into commandLists while executing; kInvalidIndex for immediate passes
+        uint32_t commandList = RenderGraphTexture::kInvalidIndex;
+    };
+
+    uint32_t addPassNode(const FName& name, const SetupFunc& setup, RecordFunc record, ExecuteFunc execute);
+    void addAccess(uint32_t passIndex, RenderGraphTexture texture, Access access);
+    static bool isWrite(Access access);
+    // Binds the targets, clears them and issues the pass's barriers, through commands or, when
+    // null, directly on the device
+    void beginPass(const PassNode& pass, RHI::IRHIDevice& device, RHI::IRHICommandList* commands) const;
+    uint32_t getTargetWidth(const PassNode& pass) const;
+    uint32_t getTargetHeight(const PassNode& pass) const;
+
+    RenderTargetPool& pool;
+    std::vector<ResourceNode> resources;
+    std::vector<PassNode> passes;
+    bool compiled = false;
+    std::vector<std::unique_ptr<RHI::IRHICommandList>> commandLists;
+};
+
+} // namespace CarrotToy
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "RHI/RHI.h"
+#include "RendererAPI.h"
+
+namespace CarrotToy {
+
+struct RenderTargetDesc {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    RHI::TextureFormat format = RHI::TextureFormat::RGBA8;
+
+    bool operator==(const RenderTargetDesc& other) const {
+        return width == other.width && height == other.height && format == other.format;
+    }
+};
+
+// Transient render targets, handed out by (size, format) instead of being owned by the passes
+// that render into them.
+//
+// acquire() returns a target no one holds right now, creating one only if none is free.
+// release() hands it back as soon as the last pass using it has been recorded, so a later pass
+// of the same frame asking for the same desc renders into the same texture: passes whose
+// lifetimes do not overlap share memory. Framebuffers are cached per attachment combination and
+// reused across frames like the textures. Targets that stay free for kMaxIdleFrames frames are
+// destroyed, so a pass that stops running gives its memory back.
+//
+// GL cannot place different textures in the same memory, so only targets of equal desc alias.
+// Main thread only.
+class RENDERER_API RenderTargetPool {
+public:
+    static constexpr uint32_t kMaxIdleFrames = 60;
+
+    RenderTargetPool() = default;
+    ~RenderTargetPool();
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+    // Null without a device. The contents are undefined; clear or overwrite them.
+    RHI::IRHITexture* acquire(const RenderTargetDesc& desc);
+    void release(RHI::IRHITexture* texture);
+
+    // Framebuffer with the given attachments; either may be null (depth-only or color-only),
+    // not both. They must come from this pool.
+    RHI::IRHIFramebuffer* getFramebuffer(RHI::IRHITexture* color, RHI::IRHITexture* depth = nullptr);
+
+    // Once per frame; destroys targets idle for too long
+    void endFrame();
+    // Destroys every target, including those still acquired
+    void shutdown();
+
+    uint32_t getTargetCount() const { return static_cast<uint32_t>(targets.size()); }
+    size_t getAllocatedBytes() const;
+
+private:
+    struct Target {
+        RenderTargetDesc desc;
+        std::shared_ptr<RHI::IRHITexture> texture;
+        bool acquired = false;
+        uint64_t lastUsedFrame = 0;
+    };
+    struct CachedFramebuffer {
+        RHI::IRHITexture* color = nullptr;
+        RHI::IRHITexture* depth = nullptr;
+        std::shared_ptr<RHI::IRHIFramebuffer> framebuffer;
+    };
+
+    std::vector<Target> targets;
+    std::vector<CachedFramebuffer> framebuffers;
+    uint64_t frame = 0;
+};
+
+} // namespace CarrotToy
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include "Platform/Platform.h"
 #include "Input/InputDevice.h"
 #include "RendererAPI.h"
@@ -10,6 +11,15 @@ namespace CarrotToy {
 
 class Shader;
 class Material;
+class ShaderHotReloader;
+class RenderTargetPool;
+class RenderGraph;
+
+namespace RHI {
+class IRHIBuffer;
+class IRHITexture;
+class IRHIVertexArray;
+}
 
 // Renderer class - manages the rendering pipeline
 class RENDERER_API Renderer {
@@ -29,6 +39,9 @@ public:
     void endFrame();
     
     void renderMaterialPreview(std::shared_ptr<Material> material);
+    // Renders the preview into a pooled size x size target instead of the window. The texture
+    // stays valid until endFrame(); null if the target could not be created.
+    RHI::IRHITexture* renderMaterialPreviewToTexture(std::shared_ptr<Material> material, uint32_t size);
     void renderScene();
     
     void setPreviewMaterial(std::shared_ptr<Material> m);
@@ -46,6 +59,13 @@ public:
     void getCursorPos(double& x, double& y) const;
     bool getMouseButton(int button) const;
     
+    // Recompiles and reloads shaders when files under sourceDir change (see ShaderHotReload.h)
+    bool enableShaderHotReload(const std::string& sourceDir, const std::string& outputDir);
+    ShaderHotReloader* getShaderHotReloader() const { return shaderHotReloader.get(); }
+    
+    // Offscreen targets for passes that do not render to the window
+    RenderTargetPool* getRenderTargetPool() const { return renderTargetPool.get(); }
+    
     // Offline ray tracing
     void exportSceneForRayTracing(const std::string& outputPath);
     void performOfflineRayTrace(const std::string& scenePath, const std::string& outputPath);
@@ -57,13 +77,25 @@ private:
     int width, height;
     RenderMode renderMode;
     
-    unsigned int sphereVAO, sphereVBO, sphereEBO;
-    unsigned int previewFBO, previewTexture;
+    // Preview sphere: half float positions and 10_10_10_2 normals, 12 bytes per vertex, with
+    // 16-bit indices
+    std::shared_ptr<RHI::IRHIBuffer> sphereVertexBuffer;
+    std::shared_ptr<RHI::IRHIBuffer> sphereIndexBuffer;
+    std::shared_ptr<RHI::IRHIVertexArray> sphereVertexArray;
+    uint32_t sphereIndexCount = 0;
     
     void setupPreviewGeometry();
-    void setupFramebuffer();
+    void drawPreview(Material& material, float aspect);
+    // Size of the window's framebuffer, which can differ from the size initialize() got
+    void getBackbufferSize(uint32_t& outWidth, uint32_t& outHeight) const;
 
     std::shared_ptr<Material> previewMaterial;
+    std::unique_ptr<ShaderHotReloader> shaderHotReloader;
+    std::unique_ptr<RenderTargetPool> renderTargetPool;
+    // Rebuilt by each rendering entry point; reused to keep its command lists
+    std::unique_ptr<RenderGraph> renderGraph;
+    // Acquired for this frame, released in endFrame()
+    std::vector<RHI::IRHITexture*> frameTargets;
 };
 
 } // namespace CarrotToy
@@ -14,6 +14,7 @@ public:
 
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+	virtual void GetModuleDescriptor(FModuleDescriptor& OutDescriptor) const override;
 	
 	virtual bool IsGameModule() const override { return false; }
 };
@@ -5,8 +5,11 @@
 #include <set>
 #include <map>
 #include <memory>
+#include <functional>
+#include "CoreUtils.h"
 #include "RHI/RHI.h"
 #include "RendererAPI.h"
+#include "ShaderKeywords.h"
 
 namespace CarrotToy {
 
@@ -18,48 +21,91 @@ struct UBOVarLocation {
 
 struct ProgramUBOCache {
     std::vector<uintptr_t> uboIDs; // All UBO Handles for cleanup
-    std::map<std::string, UBOVarLocation> vars; // Variable name -> {UBO ID, Offset}
+    // Variable name -> {UBO ID, Offset}; case-sensitive like the GLSL names it mirrors
+    TMap<FName, UBOVarLocation, FNameCaseSensitiveHash, FNameCaseSensitiveKeyEqual> vars;
 };
 
 static std::map<uintptr_t, ProgramUBOCache> g_ProgramUBOs;
 
 // Shader class - manages shader compilation and hot-reloading via RHI
-class RENDERER_API Shader {
+//
+// A shader that declares keywords (see ShaderKeywords.h) owns a cache of variants, one per
+// keyword mask. Each variant is a Shader of its own whose stages are specialized with the
+// keyword values. Recompiling the base shader recompiles its variants.
+class RENDERER_API Shader : public std::enable_shared_from_this<Shader> {
 public:
     Shader(const std::string& vertexPath, const std::string& fragmentPath);
     ~Shader();
     
     void use();
+    // Leaves no program bound; goes through the RHI so the device knows
+    void unuse();
     void reload();
     bool compile(const std::string& vertexSource, const std::string& fragmentSource);
     
+    // Asynchronous compile + link: submits the work and returns immediately. The current program
+    // keeps rendering until the new one is ready, and a shader that has never linked renders with
+    // the placeholder shader meanwhile. updatePendingLinks() swaps the finished program in.
+    void reloadAsync();
+    bool compileAsync(const std::string& vertexSource, const std::string& fragmentSource);
+    bool linkProgramAsync();
+    // Activates the pending program if its link has finished; true if a new program was swapped in
+    bool updatePendingLink();
+    bool isLinkPending() const { return pendingProgram != nullptr; }
+    bool hasProgram() const { return shaderProgram && shaderProgram->isValid(); }
+    
+    // Shader that stands in for shaders whose first program is still compiling
+    static void setPlaceholderShader(std::shared_ptr<Shader> shader);
+    
+    // Called by the renderer at the start of a frame: activates every finished pending link
+    static void updatePendingLinks();
+    // Every live shader, variants included. Main thread only.
+    static void forEachShader(const std::function<void(Shader&)>& callback);
+    
     uintptr_t getID() const;
     
     // Uniform setters
-    void setFloat(const std::string& name, float value);
-    void setVec2(const std::string& name, float x, float y);
-    void setVec3(const std::string& name, float x, float y, float z);
-    void setVec4(const std::string& name, float x, float y, float z, float w);
-    void setInt(const std::string& name, int value);
-    void setBool(const std::string& name, bool value);
-    void setMatrix4(const std::string& name, const float* value);
+    void setFloat(const FName& name, float value);
+    void setVec2(const FName& name, float x, float y);
+    void setVec3(const FName& name, float x, float y, float z);
+    void setVec4(const FName& name, float x, float y, float z, float w);
+    void setInt(const FName& name, int value);
+    void setBool(const FName& name, bool value);
+    void setMatrix4(const FName& name, const float* value);
     
     // High-level convenience uploads
     void setPerFrameMatrices(const float* model, const float* view, const float* projection);
     void setLightData(const float* lightPos, const float* lightColor, const float* viewPos);
     
     // Material block helpers
-    size_t getMaterialUBOSize() const { return materialUBOSize; }
+    size_t getMaterialUBOSize() const;
     void updateMaterialBlock(const void* data, size_t size);
     
     // Query cached UBO offset (from reflection) for a given field name
-    int32_t getUBOOffset(const std::string& field) const;
+    int32_t getUBOOffset(const FName& field) const;
 
     std::string getVertexPath() const { return vertexPath; }
     std::string getFragmentPath() const { return fragmentPath; }
     
     bool linkProgram();
     
+    // --- Variants ---
+    // Declare keywords before the first getVariant(). The defaults must match the defaults in the
+    // shader source: the default mask is this (unspecialized) shader.
+    bool declareKeyword(const FName& name, uint32_t constantID, bool defaultValue = false);
+    bool declareEnumKeyword(const FName& name, uint32_t constantID, std::vector<std::string> valueNames, uint32_t defaultValue = 0);
+    // Keywords of the base shader; variants share them
+    const ShaderKeywordLayout& getKeywordLayout() const;
+    ShaderKeywordMask getKeywordMask() const { return keywordMask; }
+    bool isVariant() const { return !variantBase.expired(); }
+    
+    // Variant for mask; compiled asynchronously on first request, rendering with the base shader
+    // until it is ready. Requires a shader owned by a shared_ptr.
+    std::shared_ptr<Shader> getVariant(ShaderKeywordMask mask);
+    // Starts compiling variants ahead of time, e.g. those the scene's materials use
+    void precompileVariants(const std::vector<ShaderKeywordMask>& masks);
+    size_t getNumVariants() const { return variants.Num(); }
+    
 private:
     bool linked = false;
     std::string vertexPath;
@@ -78,10 +124,34 @@ private:
     size_t lightUBOSize = 0;
     size_t materialUBOSize = 0;
     
+    // Async link in flight and the stages it was created from
+    std::shared_ptr<CarrotToy::RHI::IRHIShaderProgram> pendingProgram;
+    std::vector<std::shared_ptr<CarrotToy::RHI::IRHIShader>> pendingStages;
+    
+    static std::shared_ptr<Shader> placeholderShader;
+    static std::vector<Shader*> liveShaders;
+    
+    // Variants: the base shader owns the cache; a variant knows its base and specialization
+    ShaderKeywordLayout keywordLayout;
+    ShaderKeywordMask keywordMask = 0;
+    std::vector<RHI::ShaderSpecializationConstant> specialization;
+    std::weak_ptr<Shader> variantBase;
+    FMap<ShaderKeywordMask, std::shared_ptr<Shader>> variants;
+    // Last sources compiled by the base shader; new variants start from them
+    std::string lastVertexSource;
+    std::string lastFragmentSource;
+    
+    void reloadFromFiles(bool async);
+    bool compileStages(const std::string& vertexSource, const std::string& fragmentSource, bool async);
     bool compileShader(std::shared_ptr<CarrotToy::RHI::IRHIShader>& shader, 
                        CarrotToy::RHI::ShaderType type, 
                        const std::string& source,
-                       CarrotToy::RHI::ShaderSourceFormat format);
+                       CarrotToy::RHI::ShaderSourceFormat format,
+                       bool async);
+    std::shared_ptr<CarrotToy::RHI::IRHIShaderProgram> createProgram();
+    // Reflects the program's uniform blocks, creates its UBOs and makes it the active program
+    bool activateProgram(const std::shared_ptr<CarrotToy::RHI::IRHIShaderProgram>& newProgram);
+    Shader* getPlaceholder() const;
 };
 
 }
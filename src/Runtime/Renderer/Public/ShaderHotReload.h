@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Misc/FileWatcher.h"
+#include "RendererAPI.h"
+
+namespace CarrotToy {
+
+// Recompiles shader sources when they change on disk and reloads the shaders that use them.
+//
+// The watcher reports changed files under the source directory (Path::ShaderWorkingDir()). A
+// worker thread then cooks the source directory into the output directory with FShaderCooker:
+// only the changed shaders, and those including a changed file, go through dxc. Back on the main
+// thread, shaders loading a freshly cooked file are recompiled asynchronously; their new programs
+// are swapped in at a frame boundary by Shader::updatePendingLinks(). Rendering never waits for
+// dxc or the driver.
+class RENDERER_API ShaderHotReloader {
+public:
+    ShaderHotReloader() = default;
+    ~ShaderHotReloader();
+
+    // outputDir is where the shaders are loaded from (the build's cooked shaders). The compiler
+    // defaults to the one the build used for outputDir. Fails when sourceDir and outputDir are the
+    // same folder. Changes to the cooker's own outputs (.cookstate, *.pak, *.tmp, .spv files next
+    // to their .hlsl) never trigger a cook.
+    bool start(const std::string& sourceDir, const std::string& outputDir, const std::string& compilerPath = "");
+    void stop();
+    bool isRunning() const { return watcher.IsRunning(); }
+
+    // Cook now instead of waiting for the watcher, e.g. right after the editor saved a file
+    void requestCook() { cookRequested = true; }
+
+    // Main thread, once per frame before rendering
+    void tick();
+
+private:
+    void startCook();
+    void reloadCookedShaders();
+
+    FFileWatcher watcher;
+    std::string sourceDir;
+    std::string outputDir;
+    std::string compilerPath;
+
+    std::thread cookThread;
+    std::atomic<bool> cookFinished{false};
+    bool cookRequested = false;
+    // Absolute paths of the files written by the last cook; owned by the cook thread until cookFinished
+    std::vector<std::string> cookedFiles;
+};
+
+} // namespace CarrotToy
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "CoreUtils.h"
+#include "RHI/RHITypes.h"
+#include "RendererAPI.h"
+
+namespace CarrotToy {
+
+// Keyword values of one shader variant, packed into bit ranges (see ShaderKeywordLayout)
+using ShaderKeywordMask = uint64_t;
+
+// Compile-time switch of a shader, backed by a SPIR-V specialization constant. In HLSL:
+//   [[vk::constant_id(0)]] const bool ENABLE_SPECULAR = true;
+//   [[vk::constant_id(1)]] const uint TONEMAP = 1;
+// The driver folds the constant, so branches on it cost nothing in the specialized variant.
+struct ShaderKeyword {
+    FName name;
+    uint32_t constantID = 0;
+    // Empty for boolean keywords; otherwise the names of the enum values 0..N-1
+    std::vector<std::string> valueNames;
+    uint32_t defaultValue = 0;
+    uint32_t bitOffset = 0;
+    uint32_t bitCount = 1;
+
+    bool isBool() const { return valueNames.empty(); }
+    uint32_t getNumValues() const { return isBool() ? 2u : static_cast<uint32_t>(valueNames.size()); }
+};
+
+// The keywords a shader declares and how they map onto a ShaderKeywordMask.
+// Each keyword gets the smallest bit range that holds its values (1 bit for booleans).
+class RENDERER_API ShaderKeywordLayout {
+public:
+    // Both return false if the name is taken or the mask has no room left (64 bits)
+    bool declareBool(const FName& name, uint32_t constantID, bool defaultValue);
+    bool declareEnum(const FName& name, uint32_t constantID, std::vector<std::string> valueNames, uint32_t defaultValue = 0);
+
+    const std::vector<ShaderKeyword>& getKeywords() const { return keywords; }
+    const ShaderKeyword* findKeyword(const FName& name) const;
+    bool isEmpty() const { return keywords.empty(); }
+
+    ShaderKeywordMask getDefaultMask() const { return defaultMask; }
+    uint32_t getValue(ShaderKeywordMask mask, const FName& name) const;
+    // Mask with the keyword set to value; unknown keywords and out-of-range values leave it unchanged
+    ShaderKeywordMask setValue(ShaderKeywordMask mask, const FName& name, uint32_t value) const;
+
+    std::vector<RHI::ShaderSpecializationConstant> getSpecializationConstants(ShaderKeywordMask mask) const;
+    // "ENABLE_SPECULAR=0 TONEMAP=Reinhard", for logs
+    std::string describe(ShaderKeywordMask mask) const;
+
+private:
+    bool addKeyword(ShaderKeyword keyword);
+    static uint32_t extract(ShaderKeywordMask mask, const ShaderKeyword& keyword);
+
+    std::vector<ShaderKeyword> keywords;
+    ShaderKeywordMask defaultMask = 0;
+    uint32_t usedBits = 0;
+};
+
+} // namespace CarrotToy
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "RHI/RHI.h"
+#include "RendererAPI.h"
+
+namespace CarrotToy {
+
+// Loads image files into RHI textures without stalling the frame.
+//
+// Files are read and decoded (stb_image, to RGBA8) on worker threads. Once per frame, tick()
+// creates the textures of decoded images and hands their texels to
+// IRHIDevice::uploadTextureAsync, up to the upload budget per frame, so a material's texture set
+// arrives over a few frames instead of in one long one. A texture is passed to its callback once
+// the GPU has its texels, from the device's endFrame().
+//
+// Requesting a block-compressed format encodes the image (and its mip chain) on the worker
+// threads as well. The levels then go through uploadTextureAsync one at a time, sharing the
+// staging ring and the upload budget with uncompressed images; they are not passed to
+// createTexture through TextureDesc::mipData. Formats the device cannot sample fall back to RGBA8.
+class RENDERER_API TextureLoader {
+public:
+    // texture is null if the file could not be loaded
+    using Callback = std::function<void(std::shared_ptr<RHI::IRHITexture> texture)>;
+
+    static TextureLoader& getInstance();
+
+    void load(const std::string& path, Callback onLoaded, bool generateMipmaps = true,
+              RHI::TextureFormat format = RHI::TextureFormat::RGBA8);
+
+    // Main thread, once per frame
+    void tick();
+    // Stops the workers and drops loads in flight without calling their callbacks
+    void shutdown();
+
+    // Bytes of texels queued for upload per frame; one image is always let through
+    void setUploadBudget(size_t bytesPerFrame) { uploadBudget = bytesPerFrame; }
+
+private:
+    struct Request {
+        std::string path;
+        bool generateMipmaps = true;
+        RHI::TextureFormat format = RHI::TextureFormat::RGBA8;
+        Callback onLoaded;
+    };
+    struct DecodedImage;
+
+    TextureLoader() = default;
+    ~TextureLoader();
+
+    void workerMain();
+    // Encodes the decoded texels into image->mips (worker thread)
+    static void compress(DecodedImage& image);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    bool stopping = false;
+    std::deque<Request> requests;
+    // Decoded by the workers, uploaded by tick()
+    std::deque<std::unique_ptr<DecodedImage>> decoded;
+
+    size_t uploadBudget = 8 * 1024 * 1024;
+};
+
+} // namespace CarrotToy
@@ -10,10 +10,12 @@ end
 set_basename("Renderer")
 
 target("Renderer")
-    -- Renderer depends on Core, Platform, Input, and RHI
-    add_deps("Core", "Platform", "Input", "RHI")
+    -- Renderer depends on Core, Platform, Input, RHI and ShaderCore (shader archive)
+    add_deps("Core", "Platform", "Input", "RHI", "ShaderCore")
     -- GLAD is only used internally for direct GL calls (should be minimized)
     add_packages("glad", "glm", {public = true})
+    -- stb_image decodes textures on the TextureLoader's worker threads
+    add_packages("stb")
     add_files("Private/**.cpp")
     add_headerfiles("Public/**.h")
     add_includedirs("Public", {public = true})
@@ -0,0 +1,243 @@
+#include "ShaderArchive.h"
+#include "Misc/Hash.h"
+#include "Misc/Path.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+namespace
+{
+
+struct FArchiveHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 EntryCount;
+	uint32 Reserved;
+	uint64 TocOffset;
+	uint64 TocSize;
+};
+
+constexpr uint64 PayloadAlignment = 16;
+
+template<typename T>
+bool ReadValue(const std::vector<char>& Data, uint64& Cursor, T& OutValue)
+{
+	if (Cursor + sizeof(T) > Data.size()) return false;
+	std::memcpy(&OutValue, Data.data() + Cursor, sizeof(T));
+	Cursor += sizeof(T);
+	return true;
+}
+
+template<typename T>
+void WriteValue(std::ostream& Out, const T& Value)
+{
+	Out.write(reinterpret_cast<const char*>(&Value), sizeof(T));
+}
+
+struct FMountedArchive
+{
+	FString MountPoint;
+	std::unique_ptr<FShaderArchive> Archive;
+};
+
+std::mutex GMountMutex;
+TArray<FMountedArchive> GMountedArchives;
+
+} // namespace
+
+bool FShaderArchive::Open(const FString& Filename)
+{
+	Close();
+
+	std::ifstream File(Filename, std::ios::binary | std::ios::ate);
+	if (!File) {
+		return false;
+	}
+	const std::streamsize FileSize = File.tellg();
+	File.seekg(0, std::ios::beg);
+	Data.resize(static_cast<size_t>(FileSize));
+	if (FileSize <= 0 || !File.read(Data.data(), FileSize)) {
+		Close();
+		return false;
+	}
+
+	uint64 Cursor = 0;
+	FArchiveHeader Header{};
+	if (!ReadValue(Data, Cursor, Header) || Header.Magic != Magic || Header.Version != Version ||
+		Header.TocOffset + Header.TocSize > Data.size()) {
+		LOG("FShaderArchive: " << Filename << " is not a valid shader archive");
+		Close();
+		return false;
+	}
+
+	Cursor = Header.TocOffset;
+	Entries.Reserve(Header.EntryCount);
+	for (uint32 Index = 0; Index < Header.EntryCount; ++Index) {
+		FEntry Entry;
+		uint32 NameLength = 0;
+		if (!ReadValue(Data, Cursor, Entry.Hash) || !ReadValue(Data, Cursor, Entry.Offset) ||
+			!ReadValue(Data, Cursor, Entry.Size) || !ReadValue(Data, Cursor, NameLength) ||
+			Cursor + NameLength > Data.size() || Entry.Offset + Entry.Size > Header.TocOffset) {
+			LOG("FShaderArchive: Corrupt table of contents in " << Filename);
+			Close();
+			return false;
+		}
+		Entry.Name.assign(Data.data() + Cursor, NameLength);
+		Cursor += NameLength;
+
+		EntryIndices.Add(Entry.Name, static_cast<int32>(Entries.Num()));
+		Entries.Add(std::move(Entry));
+	}
+	return true;
+}
+
+void FShaderArchive::Close()
+{
+	Data.clear();
+	Entries.Empty();
+	EntryIndices.Empty();
+}
+
+const FShaderArchive::FEntry* FShaderArchive::FindEntry(const FString& Name) const
+{
+	const int32* Index = EntryIndices.Find(Name);
+	return Index ? &Entries[*Index] : nullptr;
+}
+
+bool FShaderArchive::Read(const FString& Name, FString& OutData) const
+{
+	const FEntry* Entry = FindEntry(Name);
+	if (!Entry) {
+		return false;
+	}
+	OutData.assign(Data.data() + Entry->Offset, static_cast<size_t>(Entry->Size));
+	return true;
+}
+
+bool FShaderArchive::Mount(const FString& Filename, const FString& MountPoint)
+{
+	auto Archive = std::make_unique<FShaderArchive>();
+	if (!Archive->Open(Filename)) {
+		return false;
+	}
+	LOG("FShaderArchive: Mounted " << Filename << " (" << Archive->GetEntries().Num() << " entries) at " << MountPoint);
+
+	std::lock_guard<std::mutex> Lock(GMountMutex);
+	FMountedArchive& Mounted = GMountedArchives.EmplaceGetRef();
+	Mounted.MountPoint = CarrotToy::Path::normalize(MountPoint, true);
+	Mounted.Archive = std::move(Archive);
+	return true;
+}
+
+void FShaderArchive::UnmountAll()
+{
+	std::lock_guard<std::mutex> Lock(GMountMutex);
+	GMountedArchives.Empty();
+}
+
+bool FShaderArchive::ReadMounted(const FString& Path, FString& OutData)
+{
+	const FString Normalized = CarrotToy::Path::normalize(Path);
+
+	std::lock_guard<std::mutex> Lock(GMountMutex);
+	for (int32 Index = static_cast<int32>(GMountedArchives.Num()) - 1; Index >= 0; --Index) {
+		const FMountedArchive& Mounted = GMountedArchives[Index];
+		FString Name = Normalized;
+		if (!Mounted.MountPoint.empty()) {
+			if (!CarrotToy::Path::startsWith(Normalized, Mounted.MountPoint + "/", true)) continue;
+			Name = Normalized.substr(Mounted.MountPoint.size() + 1);
+		}
+		if (Mounted.Archive->Read(Name, OutData)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void FShaderArchiveWriter::Add(const FString& Name, FString Payload)
+{
+	const FString Normalized = CarrotToy::Path::normalize(Name);
+	for (auto& Existing : Payloads) {
+		if (Existing.first == Normalized) {
+			Existing.second = std::move(Payload);
+			return;
+		}
+	}
+	Payloads.Emplace(Normalized, std::move(Payload));
+}
+
+bool FShaderArchiveWriter::Write(const FString& Filename) const
+{
+	// Sorted by name so identical inputs produce byte-identical archives
+	TArray<const std::pair<FString, FString>*> Sorted;
+	for (const auto& Payload : Payloads) {
+		Sorted.Add(&Payload);
+	}
+	Sorted.Sort([](const auto* A, const auto* B) { return A->first < B->first; });
+
+	std::error_code Ec;
+	const std::filesystem::path ArchivePath(Filename);
+	if (ArchivePath.has_parent_path()) {
+		std::filesystem::create_directories(ArchivePath.parent_path(), Ec);
+	}
+
+	const FString TempFilename = Filename + ".tmp";
+	{
+		std::ofstream File(TempFilename, std::ios::binary | std::ios::trunc);
+		if (!File) {
+			LOG("FShaderArchiveWriter: Cannot open " << TempFilename);
+			return false;
+		}
+
+		FArchiveHeader Header{};
+		Header.Magic = FShaderArchive::Magic;
+		Header.Version = FShaderArchive::Version;
+		Header.EntryCount = static_cast<uint32>(Sorted.Num());
+		WriteValue(File, Header);
+
+		TArray<FShaderArchive::FEntry> Toc;
+		uint64 Offset = sizeof(FArchiveHeader);
+		for (const auto* Payload : Sorted) {
+			const uint64 Aligned = (Offset + PayloadAlignment - 1) & ~(PayloadAlignment - 1);
+			static const char Padding[PayloadAlignment] = {};
+			File.write(Padding, static_cast<std::streamsize>(Aligned - Offset));
+
+			FShaderArchive::FEntry& Entry = Toc.EmplaceGetRef();
+			Entry.Name = Payload->first;
+			Entry.Hash = FHash::Fnv1a64(Payload->second);
+			Entry.Offset = Aligned;
+			Entry.Size = Payload->second.size();
+			File.write(Payload->second.data(), static_cast<std::streamsize>(Entry.Size));
+			Offset = Aligned + Entry.Size;
+		}
+
+		Header.TocOffset = Offset;
+		for (const FShaderArchive::FEntry& Entry : Toc) {
+			WriteValue(File, Entry.Hash);
+			WriteValue(File, Entry.Offset);
+			WriteValue(File, Entry.Size);
+			WriteValue(File, static_cast<uint32>(Entry.Name.size()));
+			File.write(Entry.Name.data(), static_cast<std::streamsize>(Entry.Name.size()));
+		}
+		Header.TocSize = static_cast<uint64>(File.tellp()) - Header.TocOffset;
+
+		File.seekp(0, std::ios::beg);
+		WriteValue(File, Header);
+		if (!File) {
+			LOG("FShaderArchiveWriter: Failed to write " << TempFilename);
+			return false;
+		}
+	}
+
+	std::filesystem::rename(TempFilename, Filename, Ec);
+	if (Ec) {
+		LOG("FShaderArchiveWriter: Cannot replace " << Filename << ": " << Ec.message());
+		std::filesystem::remove(TempFilename, Ec);
+		return false;
+	}
+	return true;
+}
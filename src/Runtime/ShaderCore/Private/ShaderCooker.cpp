@@ -0,0 +1,435 @@
+#include "ShaderCooker.h"
+#include "ShaderArchive.h"
+#include "Misc/Hash.h"
+#include "Misc/Path.h"
+
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#endif
+
+namespace fs = std::filesystem;
+using CarrotToy::Path;
+
+namespace
+{
+
+// Bump to invalidate every cooked file, e.g. when the compile command line changes
+constexpr uint32 CookerVersion = 1;
+const char* const StateFileName = ".cookstate";
+const char* const StateFileHeader = "# CarrotToy shader cook state v1";
+const char* const StateCompilerPrefix = "# compiler\t";
+
+bool ReadFileToString(const fs::path& Filename, FString& OutData)
+{
+	std::ifstream File(Filename, std::ios::binary);
+	if (!File) return false;
+	std::ostringstream Stream;
+	Stream << File.rdbuf();
+	OutData = Stream.str();
+	return true;
+}
+
+FString ToGeneric(const fs::path& Value)
+{
+	return Value.generic_string();
+}
+
+/** Runs CommandLine through the shell and captures stdout and stderr. Returns the exit code. */
+int32 RunProcess(const FString& CommandLine, FString& OutOutput)
+{
+#if defined(_WIN32)
+	// cmd.exe strips the outermost quotes of the whole line, keep the quoted executable intact
+	FILE* Pipe = _popen(("\"" + CommandLine + " 2>&1\"").c_str(), "r");
+#else
+	FILE* Pipe = popen((CommandLine + " 2>&1").c_str(), "r");
+#endif
+	if (!Pipe) {
+		OutOutput = "Failed to start: " + CommandLine;
+		return -1;
+	}
+
+	char Buffer[512];
+	while (size_t Read = std::fread(Buffer, 1, sizeof(Buffer), Pipe)) {
+		OutOutput.append(Buffer, Read);
+	}
+
+#if defined(_WIN32)
+	return _pclose(Pipe);
+#else
+	const int Status = pclose(Pipe);
+	return WIFEXITED(Status) ? WEXITSTATUS(Status) : -1;
+#endif
+}
+
+FString Quote(const FString& Value)
+{
+	return "\"" + Value + "\"";
+}
+
+/** The quoted or bracketed file name of an #include line, or empty. */
+FString ParseIncludeLine(const FString& Line)
+{
+	size_t Pos = Line.find_first_not_of(" \t");
+	if (Pos == FString::npos || Line[Pos] != '#') return {};
+	Pos = Line.find_first_not_of(" \t", Pos + 1);
+	if (Pos == FString::npos || Line.compare(Pos, 7, "include") != 0) return {};
+	Pos = Line.find_first_not_of(" \t", Pos + 7);
+	if (Pos == FString::npos || (Line[Pos] != '"' && Line[Pos] != '<')) return {};
+	const char Closing = Line[Pos] == '"' ? '"' : '>';
+	const size_t End = Line.find(Closing, Pos + 1);
+	if (End == FString::npos) return {};
+	return Line.substr(Pos + 1, End - Pos - 1);
+}
+
+void CollectIncludes(const fs::path& SourceFile, const TArray<FString>& IncludeDirs, TArray<FString>& InOutIncludes)
+{
+	std::ifstream File(SourceFile);
+	FString Line;
+	while (std::getline(File, Line)) {
+		const FString Name = ParseIncludeLine(Line);
+		if (Name.empty()) continue;
+
+		fs::path Resolved = SourceFile.parent_path() / Name;
+		for (int32 Index = 0; !fs::exists(Resolved) && Index < static_cast<int32>(IncludeDirs.Num()); ++Index) {
+			Resolved = fs::path(IncludeDirs[Index]) / Name;
+		}
+
+		// Unresolved includes are recorded by name, so creating the file later changes the key
+		const FString Entry = fs::exists(Resolved) ? ToGeneric(fs::weakly_canonical(Resolved)) : "?" + Name;
+		if (InOutIncludes.Contains(Entry)) continue;
+		InOutIncludes.Add(Entry);
+		if (Entry[0] != '?') {
+			CollectIncludes(Resolved, IncludeDirs, InOutIncludes);
+		}
+	}
+}
+
+} // namespace
+
+FShaderCooker::FShaderCooker(FShaderCookOptions InOptions)
+	: Options(std::move(InOptions))
+{
+	CompilerHash = FHash::Fnv1a64(&CookerVersion, sizeof(CookerVersion));
+	if (!Options.CompilerPath.empty()) {
+		// A different dxc build produces different SPIR-V; its size and timestamp stand in for a version
+		std::error_code Ec;
+		const uint64 Size = fs::file_size(Options.CompilerPath, Ec);
+		const int64 Time = static_cast<int64>(fs::last_write_time(Options.CompilerPath, Ec).time_since_epoch().count());
+		CompilerHash = FHash::Fnv1a64(Options.CompilerPath, CompilerHash);
+		CompilerHash = FHash::Fnv1a64(&Size, sizeof(Size), CompilerHash);
+		CompilerHash = FHash::Fnv1a64(&Time, sizeof(Time), CompilerHash);
+	}
+}
+
+void FShaderCooker::GetStageInfo(const FString& SourceFile, FString& OutProfile, FString& OutEntryPoint)
+{
+	const FString Stage = Path::getExtension(Path::removeExtension(Path::getFilename(SourceFile)), false);
+	if (Stage == "vs" || Stage == "vert") {
+		OutProfile = "vs_6_0";
+		OutEntryPoint = "VSMain";
+	} else if (Stage == "cs" || Stage == "comp") {
+		OutProfile = "cs_6_0";
+		OutEntryPoint = "CSMain";
+	} else {
+		OutProfile = "ps_6_0";
+		OutEntryPoint = "PSMain";
+	}
+}
+
+TArray<FString> FShaderCooker::FindIncludes(const FString& SourceFile, const TArray<FString>& IncludeDirs)
+{
+	TArray<FString> Includes;
+	CollectIncludes(fs::path(SourceFile), IncludeDirs, Includes);
+	return Includes;
+}
+
+uint64 FShaderCooker::ComputeKey(const FJob& Job) const
+{
+	uint64 Key = FHash::Fnv1a64(Job.OutputName, CompilerHash);
+
+	FString Contents;
+	if (!ReadFileToString(Job.SourceFile, Contents)) {
+		return 0;
+	}
+	Key = FHash::Fnv1a64(Contents, Key);
+	if (!Job.bCompile) {
+		return Key;
+	}
+
+	FString Profile, EntryPoint;
+	GetStageInfo(Job.SourceFile, Profile, EntryPoint);
+	Key = FHash::Fnv1a64(Profile + "|" + EntryPoint, Key);
+	for (const FString& Define : Options.Defines) {
+		Key = FHash::Fnv1a64("-D" + Define, Key);
+	}
+	for (const FString& IncludeDir : Options.IncludeDirs) {
+		Key = FHash::Fnv1a64("-I" + IncludeDir, Key);
+	}
+
+	TArray<FString> SearchDirs = Options.IncludeDirs;
+	SearchDirs.Add(Options.SourceDir);
+	for (const FString& Include : FindIncludes(Job.SourceFile, SearchDirs)) {
+		Key = FHash::Fnv1a64(Include, Key);
+		if (Include[0] != '?' && ReadFileToString(Include, Contents)) {
+			Key = FHash::Fnv1a64(Contents, Key);
+		}
+	}
+	return Key;
+}
+
+bool FShaderCooker::CompileJob(FJob& Job) const
+{
+	FString Profile, EntryPoint;
+	GetStageInfo(Job.SourceFile, Profile, EntryPoint);
+
+	const fs::path Output = fs::path(Options.OutputDir) / Job.OutputName;
+	std::error_code Ec;
+	fs::create_directories(Output.parent_path(), Ec);
+
+	// Compile next to the output and rename, so a failed compile keeps the last good binary
+	const FString TempOutput = ToGeneric(Output) + ".tmp";
+
+	FString CommandLine = Quote(Options.CompilerPath) + " -T " + Profile + " -E " + EntryPoint + " -spirv";
+	for (const FString& IncludeDir : Options.IncludeDirs) {
+		CommandLine += " -I " + Quote(IncludeDir);
+	}
+	CommandLine += " -I " + Quote(Options.SourceDir);
+	for (const FString& Define : Options.Defines) {
+		CommandLine += " -D " + Define;
+	}
+	CommandLine += " -Fo " + Quote(TempOutput) + " " + Quote(Job.SourceFile);
+
+	const int32 ExitCode = RunProcess(CommandLine, Job.Log);
+	if (ExitCode != 0 || !fs::exists(TempOutput)) {
+		Job.Log = CommandLine + "\n" + Job.Log;
+		fs::remove(TempOutput, Ec);
+		return false;
+	}
+
+	fs::rename(TempOutput, Output, Ec);
+	if (Ec) {
+		Job.Log = "Cannot write " + ToGeneric(Output) + ": " + Ec.message();
+		return false;
+	}
+	return true;
+}
+
+bool FShaderCooker::CopyJob(FJob& Job) const
+{
+	const fs::path Output = fs::path(Options.OutputDir) / Job.OutputName;
+	std::error_code Ec;
+	fs::create_directories(Output.parent_path(), Ec);
+	fs::copy_file(Job.SourceFile, Output, fs::copy_options::overwrite_existing, Ec);
+	if (Ec) {
+		Job.Log = "Cannot copy to " + ToGeneric(Output) + ": " + Ec.message();
+		return false;
+	}
+	return true;
+}
+
+void FShaderCooker::RunJob(FJob& Job, const TMap<FString, uint64>& PreviousState)
+{
+	Job.Key = ComputeKey(Job);
+	if (Job.Key == 0) {
+		Job.Log = "Cannot read " + Job.SourceFile;
+		Job.Result = FJob::EResult::Failed;
+		return;
+	}
+
+	const uint64* PreviousKey = PreviousState.Find(Job.OutputName);
+	if (!Options.bForce && PreviousKey && *PreviousKey == Job.Key && fs::exists(fs::path(Options.OutputDir) / Job.OutputName)) {
+		Job.Result = FJob::EResult::UpToDate;
+		return;
+	}
+
+	if (Job.bCompile) {
+		Job.Result = CompileJob(Job) ? FJob::EResult::Compiled : FJob::EResult::Failed;
+	} else {
+		Job.Result = CopyJob(Job) ? FJob::EResult::Copied : FJob::EResult::Failed;
+	}
+}
+
+TMap<FString, uint64> FShaderCooker::LoadState() const
+{
+	TMap<FString, uint64> State;
+	std::ifstream File(fs::path(Options.OutputDir) / StateFileName);
+	FString Line;
+	if (!std::getline(File, Line) || Line != StateFileHeader) {
+		return State;
+	}
+	while (std::getline(File, Line)) {
+		const size_t Tab = Line.find('\t');
+		if (Tab == FString::npos || Line[0] == '#') continue;
+		uint64 Key = 0;
+		const std::from_chars_result Parsed = std::from_chars(Line.data(), Line.data() + Tab, Key, 16);
+		if (Parsed.ec != std::errc() || Parsed.ptr != Line.data() + Tab) {
+			// Corrupt (e.g. a cook interrupted while writing it): forget everything and rebuild
+			return {};
+		}
+		State.Add(Line.substr(Tab + 1), Key);
+	}
+	return State;
+}
+
+void FShaderCooker::SaveState(const TArray<FJob>& Jobs, const TMap<FString, uint64>& PreviousState) const
+{
+	std::ofstream File(fs::path(Options.OutputDir) / StateFileName, std::ios::trunc);
+	File << StateFileHeader << "\n";
+	File << StateCompilerPrefix << Options.CompilerPath << "\n";
+	for (const FJob& Job : Jobs) {
+		uint64 Key = Job.Key;
+		if (Job.Result == FJob::EResult::Failed) {
+			// The previous output is still on disk; keep its key so it is rebuilt, not orphaned
+			const uint64* PreviousKey = PreviousState.Find(Job.OutputName);
+			if (!PreviousKey) continue;
+			Key = *PreviousKey;
+		}
+		File << FHash::ToHex(Key) << "\t" << Job.OutputName << "\n";
+	}
+}
+
+FString FShaderCooker::GetLastCompilerPath(const FString& OutputDir)
+{
+	std::ifstream File(fs::path(OutputDir) / StateFileName);
+	FString Line;
+	if (!std::getline(File, Line) || Line != StateFileHeader) {
+		return {};
+	}
+	while (std::getline(File, Line)) {
+		if (Path::startsWith(Line, StateCompilerPrefix, true)) {
+			return Line.substr(std::strlen(StateCompilerPrefix));
+		}
+	}
+	return {};
+}
+
+bool FShaderCooker::WriteArchive(const TArray<FJob>& Jobs) const
+{
+	FShaderArchiveWriter Writer;
+	for (const FJob& Job : Jobs) {
+		FString Payload;
+		if (ReadFileToString(fs::path(Options.OutputDir) / Job.OutputName, Payload)) {
+			Writer.Add(Job.OutputName, std::move(Payload));
+		}
+	}
+	return Writer.Write(Options.ArchivePath);
+}
+
+bool FShaderCooker::Cook()
+{
+	Stats = FShaderCookStats();
+	CookedOutputs.Empty();
+
+	std::error_code Ec;
+	if (!fs::is_directory(Options.SourceDir, Ec)) {
+		LOG("ShaderCooker: Source directory " << Options.SourceDir << " does not exist");
+		return false;
+	}
+	fs::create_directories(Options.OutputDir, Ec);
+
+	const bool bHasCompiler = !Options.CompilerPath.empty();
+	if (!bHasCompiler) {
+		LOG("ShaderCooker: Warning - no shader compiler given, HLSL sources are copied uncompiled");
+	}
+
+	TArray<FJob> Jobs;
+	for (const auto& Entry : fs::recursive_directory_iterator(Options.SourceDir, Ec)) {
+		if (!Entry.is_regular_file()) continue;
+
+		FJob& Job = Jobs.EmplaceGetRef();
+		Job.SourceFile = ToGeneric(Entry.path());
+		Job.OutputName = ToGeneric(fs::relative(Entry.path(), Options.SourceDir));
+		Job.bCompile = bHasCompiler && Path::endsWith(Job.OutputName, ".hlsl");
+		if (Job.bCompile) {
+			Job.OutputName = Path::changeExtension(Job.OutputName, ".spv");
+		}
+	}
+	// Deterministic order for the state file and the log
+	Jobs.Sort([](const FJob& A, const FJob& B) { return A.OutputName < B.OutputName; });
+
+	const TMap<FString, uint64> PreviousState = LoadState();
+
+	// Jobs are independent: each worker claims the next index until all are done
+	const int32 NumJobs = static_cast<int32>(Jobs.Num());
+	int32 NumThreads = Options.NumJobs > 0 ? Options.NumJobs : static_cast<int32>(std::thread::hardware_concurrency());
+	NumThreads = std::max(1, std::min(NumThreads, NumJobs));
+
+	std::atomic<int32> NextJob{0};
+	std::atomic<int32> Finished{0};
+	std::mutex LogMutex;
+	auto Worker = [&]() {
+		for (int32 Index = NextJob++; Index < NumJobs; Index = NextJob++) {
+			FJob& Job = Jobs[Index];
+			RunJob(Job, PreviousState);
+
+			const int32 Done = ++Finished;
+			if (Job.Result == FJob::EResult::UpToDate) continue;
+
+			std::lock_guard<std::mutex> Lock(LogMutex);
+			const char* Action = Job.Result == FJob::EResult::Compiled ? "Compiled" :
+				Job.Result == FJob::EResult::Copied ? "Copied" : "FAILED";
+			LOG("ShaderCooker: [" << Done << "/" << NumJobs << "] " << Action << " " << Job.OutputName);
+			if (Job.Result == FJob::EResult::Failed) {
+				LOG(Job.Log);
+			}
+		}
+	};
+
+	TArray<std::thread> Threads;
+	for (int32 Index = 1; Index < NumThreads; ++Index) {
+		Threads.Emplace(Worker);
+	}
+	Worker();
+	for (std::thread& Thread : Threads) {
+		Thread.join();
+	}
+
+	for (const FJob& Job : Jobs) {
+		switch (Job.Result) {
+		case FJob::EResult::UpToDate: ++Stats.UpToDate; break;
+		case FJob::EResult::Compiled: ++Stats.Compiled; break;
+		case FJob::EResult::Copied:   ++Stats.Copied; break;
+		default:                      ++Stats.Failed; break;
+		}
+		if (Job.Result == FJob::EResult::Compiled || Job.Result == FJob::EResult::Copied) {
+			CookedOutputs.Add(Job.OutputName);
+		}
+	}
+
+	// Outputs whose source was deleted or renamed
+	TMap<FString, bool> CurrentOutputs;
+	for (const FJob& Job : Jobs) {
+		CurrentOutputs.Add(Job.OutputName, true);
+	}
+	for (const auto& Previous : PreviousState) {
+		if (!CurrentOutputs.Contains(Previous.first)) {
+			fs::remove(fs::path(Options.OutputDir) / Previous.first, Ec);
+			++Stats.Removed;
+		}
+	}
+
+	SaveState(Jobs, PreviousState);
+
+	const bool bChanged = Stats.Compiled + Stats.Copied + Stats.Removed > 0;
+	if (!Options.ArchivePath.empty() && (bChanged || Options.bForce || !fs::exists(Options.ArchivePath))) {
+		Stats.bArchiveWritten = WriteArchive(Jobs);
+		if (!Stats.bArchiveWritten) {
+			++Stats.Failed;
+		}
+	}
+
+	LOG("ShaderCooker: " << Stats.Compiled << " compiled, " << Stats.Copied << " copied, " << Stats.UpToDate
+		<< " up to date, " << Stats.Removed << " removed, " << Stats.Failed << " failed ("
+		<< NumThreads << " thread(s))" << (Stats.bArchiveWritten ? ", archive written" : ""));
+	return Stats.Failed == 0;
+}
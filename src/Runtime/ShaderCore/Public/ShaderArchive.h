@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreUtils.h"
+#include "ShaderCoreAPI.h"
+
+/**
+ * FShaderArchive - single packed file holding every cooked shader
+ *
+ * Layout (little endian):
+ *   FHeader   magic 'CTSA', version, entry count, offset and size of the table of contents
+ *   blobs     entry payloads, each aligned to 16 bytes
+ *   TOC       per entry: content hash, offset, size, name length, name bytes
+ *
+ * Entry names are relative paths with forward slashes (e.g. "default.vs.spv"). The TOC sits at
+ * the end so the writer can stream the payloads first; the reader loads the whole archive,
+ * which is small, and looks entries up by name.
+ *
+ * Mounted archives back Shader loading at runtime: a path below the mount point that does not
+ * exist as a loose file is read from the archive instead (see ReadMounted).
+ */
+class SHADERCORE_API FShaderArchive
+{
+public:
+	struct FEntry
+	{
+		FString Name;
+		uint64 Hash = 0;   // FHash::Fnv1a64 of the payload
+		uint64 Offset = 0;
+		uint64 Size = 0;
+	};
+
+	static constexpr uint32 Magic = 0x41535443; // 'CTSA'
+	static constexpr uint32 Version = 1;
+
+	bool Open(const FString& Filename);
+	void Close();
+	bool IsOpen() const { return !Data.empty(); }
+
+	const FEntry* FindEntry(const FString& Name) const;
+	bool Contains(const FString& Name) const { return FindEntry(Name) != nullptr; }
+	/** Copies the payload of Name into OutData. */
+	bool Read(const FString& Name, FString& OutData) const;
+
+	const TArray<FEntry>& GetEntries() const { return Entries; }
+
+	/** Makes Filename's entries visible below MountPoint (e.g. "shaders/"). Later mounts win. */
+	static bool Mount(const FString& Filename, const FString& MountPoint);
+	static void UnmountAll();
+	/** Reads Path from the mounted archives; false if no archive contains it. */
+	static bool ReadMounted(const FString& Path, FString& OutData);
+
+private:
+	std::vector<char> Data;
+	TArray<FEntry> Entries;
+	TMap<FString, int32> EntryIndices;
+};
+
+/** Builds an archive in memory and writes it in one go. Entries are stored sorted by name. */
+class SHADERCORE_API FShaderArchiveWriter
+{
+public:
+	void Add(const FString& Name, FString Payload);
+	int32 Num() const { return static_cast<int32>(Payloads.Num()); }
+
+	/** Writes to a temporary file and renames it over Filename. */
+	bool Write(const FString& Filename) const;
+
+private:
+	TArray<std::pair<FString, FString>> Payloads;
+};
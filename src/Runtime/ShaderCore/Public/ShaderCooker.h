@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreUtils.h"
+#include "ShaderCoreAPI.h"
+
+struct FShaderCookOptions
+{
+	FString SourceDir;              // shader sources, e.g. <project>/shaders
+	FString OutputDir;              // cooked loose files; also holds the incremental cook state
+	FString ArchivePath;            // packed FShaderArchive of all cooked files; empty to skip
+	FString CompilerPath;           // dxc; when empty, HLSL sources are copied uncompiled
+	TArray<FString> IncludeDirs;    // extra -I directories
+	TArray<FString> Defines;        // NAME or NAME=VALUE, applied to every shader
+	int32 NumJobs = 0;              // 0 uses every hardware thread
+	bool bForce = false;            // ignore the cook state and rebuild everything
+};
+
+struct FShaderCookStats
+{
+	int32 Compiled = 0;
+	int32 Copied = 0;
+	int32 UpToDate = 0;
+	int32 Failed = 0;
+	int32 Removed = 0;
+	bool bArchiveWritten = false;
+};
+
+/**
+ * FShaderCooker - incremental, parallel shader build
+ *
+ * Every file below SourceDir becomes a job. *.hlsl files are compiled to SPIR-V with dxc
+ * (<name>.hlsl -> <name>.spv); everything else is copied. Each job has a key hashing:
+ *  - the source and, transitively, every file it #includes
+ *  - the defines, include directories, target profile and entry point
+ *  - the compiler executable (path, size and timestamp) and the cooker version
+ *
+ * Keys of the last successful cook are kept in <OutputDir>/.cookstate; a job whose key is
+ * unchanged and whose output still exists is skipped. Outputs whose source disappeared are
+ * deleted. Jobs run on NumJobs threads.
+ *
+ * When ArchivePath is set, all cooked files are packed into one FShaderArchive afterwards. It is
+ * only rewritten when something changed.
+ */
+class SHADERCORE_API FShaderCooker
+{
+public:
+	explicit FShaderCooker(FShaderCookOptions InOptions);
+
+	/** Returns false if any job failed. Successful jobs are kept either way. */
+	bool Cook();
+	const FShaderCookStats& GetStats() const { return Stats; }
+	/** Output names (relative to OutputDir) compiled or copied by the last Cook() */
+	const TArray<FString>& GetCookedOutputs() const { return CookedOutputs; }
+
+	/** Compiler used by the last cook into OutputDir, so later cooks (e.g. hot reload) match it. */
+	static FString GetLastCompilerPath(const FString& OutputDir);
+
+	/** *.vs / *.vert -> vs_6_0 + VSMain, *.cs / *.comp -> cs_6_0 + CSMain, otherwise ps_6_0 + PSMain */
+	static void GetStageInfo(const FString& SourceFile, FString& OutProfile, FString& OutEntryPoint);
+
+	/** Transitive #include dependencies, resolved relative to the including file, then IncludeDirs. */
+	static TArray<FString> FindIncludes(const FString& SourceFile, const TArray<FString>& IncludeDirs);
+
+private:
+	struct FJob
+	{
+		FString SourceFile;
+		FString OutputName;     // relative to OutputDir, forward slashes
+		bool bCompile = false;
+		uint64 Key = 0;
+		enum class EResult { Pending, UpToDate, Compiled, Copied, Failed } Result = EResult::Pending;
+		FString Log;
+	};
+
+	uint64 ComputeKey(const FJob& Job) const;
+	void RunJob(FJob& Job, const TMap<FString, uint64>& PreviousState);
+	bool CompileJob(FJob& Job) const;
+	bool CopyJob(FJob& Job) const;
+
+	TMap<FString, uint64> LoadState() const;
+	void SaveState(const TArray<FJob>& Jobs, const TMap<FString, uint64>& PreviousState) const;
+	bool WriteArchive(const TArray<FJob>& Jobs) const;
+
+	FShaderCookOptions Options;
+	FShaderCookStats Stats;
+	TArray<FString> CookedOutputs;
+	uint64 CompilerHash = 0;
+};
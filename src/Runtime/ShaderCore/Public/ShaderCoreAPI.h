@@ -0,0 +1,16 @@
+#pragma once
+
+// ShaderCore API export/import macro
+#ifndef SHADERCORE_API
+#if defined(_WIN32) || defined(_WIN64)
+    #ifdef SHADERCORE_BUILD_SHARED
+        #define SHADERCORE_API __declspec(dllexport)
+    #elif defined(SHADERCORE_IMPORT_SHARED)
+        #define SHADERCORE_API __declspec(dllimport)
+    #else
+        #define SHADERCORE_API
+    #endif
+#else
+    #define SHADERCORE_API
+#endif
+#endif
@@ -0,0 +1,25 @@
+-- ShaderCore module for CarrotToy
+-- Shader archive (runtime) and the shader cooking pipeline used by the ShaderCooker tool
+
+local kind = get_config("module_kind") or "shared"
+if kind == "shared" then
+    set_kind("shared")
+else
+    set_kind("static")
+end
+
+set_basename("ShaderCore")
+
+target("ShaderCore")
+    -- ShaderCore only depends on Core; it must stay usable from command line tools
+    add_deps("Core")
+    add_files("Private/**.cpp")
+    add_headerfiles("Public/**.h")
+    add_includedirs("Public", {public = true})
+
+    -- Add defines for shared library build
+    if kind == "shared" then
+        add_defines("SHADERCORE_BUILD_SHARED", {public = false})
+        add_defines("SHADERCORE_IMPORT_SHARED", {public = true})
+    end
+target_end()
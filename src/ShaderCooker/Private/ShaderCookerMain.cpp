@@ -0,0 +1,70 @@
+#include "CoreUtils.h"
+#include "Misc/Path.h"
+#include "ShaderCooker.h"
+
+#include <cstdlib>
+#include <cstring>
+
+// Core expects the project name from the application; the tool has no game module
+TCHAR GInternalProjectName[64] = TEXT("ShaderCooker");
+
+using CarrotToy::Path;
+
+namespace
+{
+
+void PrintUsage()
+{
+	LOG("Usage: ShaderCooker -Source=<dir> -Output=<dir> [-Archive=<file>] [-Compiler=<dxc>]");
+	LOG("                    [-I=<dir>]... [-D=<NAME[=VALUE]>]... [-Jobs=<n>] [-Force]");
+}
+
+bool ParseValue(const FString& Arg, const char* Prefix, FString& OutValue)
+{
+	if (!Path::startsWith(Arg, Prefix)) {
+		return false;
+	}
+	OutValue = Arg.substr(std::strlen(Prefix));
+	return true;
+}
+
+} // namespace
+
+/** Exit code: 0 on success, 1 if any shader failed, 2 on bad arguments. */
+int main(int argc, char** argv)
+{
+	FShaderCookOptions Options;
+	for (int i = 1; i < argc; ++i) {
+		const FString Arg = argv[i];
+		FString Value;
+		if (ParseValue(Arg, "-Source=", Value)) {
+			Options.SourceDir = Value;
+		} else if (ParseValue(Arg, "-Output=", Value)) {
+			Options.OutputDir = Value;
+		} else if (ParseValue(Arg, "-Archive=", Value)) {
+			Options.ArchivePath = Value;
+		} else if (ParseValue(Arg, "-Compiler=", Value)) {
+			Options.CompilerPath = Value;
+		} else if (ParseValue(Arg, "-I=", Value)) {
+			Options.IncludeDirs.Add(Value);
+		} else if (ParseValue(Arg, "-D=", Value)) {
+			Options.Defines.Add(Value);
+		} else if (ParseValue(Arg, "-Jobs=", Value)) {
+			Options.NumJobs = std::atoi(Value.c_str());
+		} else if (Arg == "-Force") {
+			Options.bForce = true;
+		} else {
+			LOG("ShaderCooker: Unknown argument " << Arg);
+			PrintUsage();
+			return 2;
+		}
+	}
+
+	if (Options.SourceDir.empty() || Options.OutputDir.empty()) {
+		PrintUsage();
+		return 2;
+	}
+
+	FShaderCooker Cooker(Options);
+	return Cooker.Cook() ? 0 : 1;
+}
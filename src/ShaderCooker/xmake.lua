@@ -0,0 +1,17 @@
+-- ShaderCooker - command line shader build tool, run by the utils.compile_shaders rule
+
+set_basename("ShaderCooker")
+
+target("ShaderCooker")
+    set_kind("binary")
+
+    add_files("Private/**.cpp")
+    add_deps("Core", "ShaderCore")
+
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+
+    set_targetdir("$(builddir)/bin")
+    set_objectdir("$(builddir)/obj/ShaderCooker")
+target_end()
@@ -19,7 +19,7 @@ add_requires("glm", "stb", "directxshadercompiler",
 add_requires("glad", {
     configs = {
         version = "4.6", 
-        extensions = "GL_ARB_gl_spirv",
+        extensions = "GL_ARB_gl_spirv,GL_KHR_parallel_shader_compile,GL_ARB_parallel_shader_compile,GL_ARB_direct_state_access,GL_ARB_buffer_storage,GL_ARB_texture_storage,GL_EXT_texture_compression_s3tc,GL_ARB_texture_compression_bptc,GL_ARB_multi_draw_indirect,GL_ARB_compute_shader,GL_ARB_shader_storage_buffer_object,GL_ARB_bindless_texture",
         shared = true
     }
 })
@@ -39,16 +39,18 @@ option("module_kind")
     set_showmenu(true)
     set_description("Build modules as shared or static (shared/static)")
 option_end()
+-- Cooks <projdir>/shaders into <targetdir>/shaders with the ShaderCooker tool: only changed
+-- shaders are recompiled (source, includes, defines and dxc are hashed), compiles run in
+-- parallel and everything is also packed into shaders/Shaders.pak.
 rule("utils.compile_shaders")
+    on_load(function (target)
+        target:add("deps", "ShaderCooker")
+    end)
     after_build(function (target)
         local projdir = os.projectdir()
         local srcdir = path.join(projdir, "shaders")
         local outdir = path.join(target:targetdir(), "shaders")
 
-        -- recreate output shaders dir
-        os.rm(outdir)
-        os.mkdir(outdir)
-
         -- locate dxc
         local dxc_path = nil
         local pkg = target:pkg("directxshadercompiler")
@@ -71,50 +73,39 @@ rule("utils.compile_shaders")
              print("using dxc from package: " .. dxc_path)
         end
 
-        import("core.base.option")
-        for _, f in ipairs(os.files(path.join(srcdir, "**"))) do
-            if os.isfile(f) then
-                local name = path.filename(f)
-                local lname = name:lower()
-
-                if lname:sub(-5) == '.hlsl' then
-                    local basename = name:gsub("%.hlsl$", "")
-                    local stage = "ps_6_0"
-                    local entry = "PSMain"
-                    if basename:lower():find('%.vs$') or basename:lower():find('%.vert$') then
-                        stage = "vs_6_0"
-                        entry = "VSMain"
-                    elseif basename:lower():find('%.ps$') or basename:lower():find('%.frag$') then
-                        stage = "ps_6_0"
-                        entry = "PSMain"
-                    end
-
-                    local outspv = path.join(outdir, basename .. ".spv")
+        local cooker = target:dep("ShaderCooker")
+        local args = {
+            "-Source=" .. srcdir,
+            "-Output=" .. outdir,
+            "-Archive=" .. path.join(outdir, "Shaders.pak")
+        }
+        if dxc_path then
+            table.insert(args, "-Compiler=" .. dxc_path)
+        end
 
-                    if dxc_path then
-                        local cmd = string.format('"%s" -T %s -E %s -spirv -Fo "%s" "%s"', dxc_path, stage, entry, outspv, f)
-                        print('> ' .. cmd)
-                        local out = nil
-                        try {
-                            function () out = os.iorun(cmd) end,
-                            catch { function (e) out = tostring(e) end }
-                        }
-                        if not os.isfile(outspv) then
-                            print('warning: dxc failed for ' .. f .. ', copying original')
-                            os.cp(f, outdir)
-                        end
-                    else
-                        os.cp(f, outdir)
-                    end
-                else
-                    os.cp(f, outdir)
-                end
-            end
+        -- the cooker links Core and ShaderCore, which may be shared libraries in other directories
+        local libdirs = {}
+        for _, dep in ipairs(cooker:orderdeps()) do
+            table.insert(libdirs, dep:targetdir())
         end
+        local envs = {}
+        if is_plat("windows") then
+            envs.PATH = path.joinenv(table.join(libdirs, os.getenv("PATH") or ""))
+        elseif is_plat("macosx") then
+            envs.DYLD_LIBRARY_PATH = path.joinenv(table.join(libdirs, os.getenv("DYLD_LIBRARY_PATH") or ""))
+        else
+            envs.LD_LIBRARY_PATH = path.joinenv(table.join(libdirs, os.getenv("LD_LIBRARY_PATH") or ""))
+        end
+
+        try {
+            function () os.execv(cooker:targetfile(), args, {envs = envs}) end,
+            catch { function (e) print("warning: shader cook failed, see the log above") end }
+        }
     end)
 rule_end()
 
 includes("src/Runtime/Core")
+includes("src/Runtime/ShaderCore")
 includes("src/Runtime/Platform")
 includes("src/Runtime/Input")
 includes("src/Runtime/RHI")
@@ -125,3 +116,4 @@ includes("src/DefaultGame")
 includes("src/TestRHIApp")
 includes("src/CustomModule")
 includes("src/RenderBackendSandbox")
+includes("src/ShaderCooker")